@@ -27,6 +27,12 @@
 #ifndef _GALOIS_CUSP_PSCAFFOLD_H_
 #define _GALOIS_CUSP_PSCAFFOLD_H_
 
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/unordered_map.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
 namespace galois {
 namespace graphs {
 
@@ -65,6 +71,27 @@ public:
   void saveGIDToHost(std::vector<std::pair<uint64_t, uint64_t>>& gid2host) {
     _gid2host = gid2host;
   }
+
+  /**
+   * Saves the node to master assignment so that a partition saved to disk
+   * can answer ownership queries without repartitioning. Policy specific
+   * state is saved separately by serializePartition; both end up in the
+   * PARTITION section of the file (see LocalGraphHeader).
+   *
+   * @param ar Boost archive to serialize to
+   */
+  void serializeAssignment(boost::archive::binary_oarchive& ar) const {
+    ar << _gid2host;
+  }
+
+  /**
+   * Restores the assignment saved by serializeAssignment.
+   *
+   * @param ar Boost archive to deserialize from
+   */
+  void deserializeAssignment(boost::archive::binary_iarchive& ar) {
+    ar >> _gid2host;
+  }
 };
 
 /**
@@ -270,6 +297,24 @@ public:
   //! Shifts master assignment phase to stage 2.
   void enterStage2() { _status = 2; }
 
+  //! Saves the reader assignment and the masters assigned to nodes
+  void serializeAssignment(boost::archive::binary_oarchive& ar) const {
+    PartitioningScaffold::serializeAssignment(ar);
+    ar << _status;
+    ar << _localNodeToMaster;
+    ar << _gid2masters;
+    ar << _nodeOffset;
+  }
+
+  //! Restores the assignment saved by serializeAssignment
+  void deserializeAssignment(boost::archive::binary_iarchive& ar) {
+    PartitioningScaffold::deserializeAssignment(ar);
+    ar >> _status;
+    ar >> _localNodeToMaster;
+    ar >> _gid2masters;
+    ar >> _nodeOffset;
+  }
+
   /**
    * CuSP's "getMaster" function.
    * This function should be defined by user in child class to assign a node to
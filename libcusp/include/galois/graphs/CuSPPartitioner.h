@@ -66,6 +66,10 @@ using DistGraphPtr =
  * this argument assigns a weight to give each node.
  * @param edgeWeight When using a read policy that involves nodes and edges,
  * this argument assigns a weight to give each edge.
+ * @param readFromFile If true, the partition is read back from
+ * localGraphFileName (written by save_local_graph_to_file) instead of being
+ * computed from graphFile
+ * @param localGraphFileName File this host's partition is read from
  *
  * @tparam PartitionPolicy Partitioning policy object that specifies the
  * placement of nodes/edges during partitioning.
@@ -89,13 +93,13 @@ cuspPartitionGraph(std::string graphFile, CUSP_GRAPH_TYPE inputType,
                    uint32_t cuspStateRounds = 100,
                    galois::graphs::MASTERS_DISTRIBUTION readPolicy =
                        galois::graphs::BALANCED_EDGES_OF_MASTERS,
-                   uint32_t nodeWeight = 0, uint32_t edgeWeight = 0) {
+                   uint32_t nodeWeight = 0, uint32_t edgeWeight = 0,
+                   bool readFromFile              = false,
+                   std::string localGraphFileName = "local_graph") {
   auto& net = galois::runtime::getSystemNetworkInterface();
   using DistGraphConstructor =
       galois::graphs::NewDistGraphGeneric<NodeData, EdgeData, PartitionPolicy>;
 
-  // TODO @todo bring back graph saving/reading functionality?
-
   if (!symmetricGraph) {
     // out edges or in edges
     std::string inputToUse;
@@ -127,13 +131,15 @@ cuspPartitionGraph(std::string graphFile, CUSP_GRAPH_TYPE inputType,
 
     return std::make_unique<DistGraphConstructor>(
         inputToUse, net.ID, net.Num, cuspAsync, cuspStateRounds, useTranspose,
-        readPolicy, nodeWeight, edgeWeight, masterBlockFile);
+        readPolicy, nodeWeight, edgeWeight, masterBlockFile, readFromFile,
+        localGraphFileName);
   } else {
     // symmetric graph path: assume the passed in graphFile is a symmetric
     // graph; output is also symmetric
     return std::make_unique<DistGraphConstructor>(
         graphFile, net.ID, net.Num, cuspAsync, cuspStateRounds, false,
-        readPolicy, nodeWeight, edgeWeight, masterBlockFile);
+        readPolicy, nodeWeight, edgeWeight, masterBlockFile, readFromFile,
+        localGraphFileName);
   }
 }
 } // end namespace galois
@@ -27,8 +27,15 @@
 #ifndef _GALOIS_DIST_HGRAPH_H_
 #define _GALOIS_DIST_HGRAPH_H_
 
+#include <limits>
 #include <unordered_map>
 #include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "galois/graphs/LC_CSR_Graph.h"
 #include "galois/graphs/BufferedGraph.h"
@@ -39,9 +46,68 @@
 /*
  * Headers for boost serialization
  */
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
 
 namespace galois {
 namespace graphs {
+
+namespace internal {
+/**
+ * Header of a partition saved by DistGraph::save_local_graph_to_file. It is
+ * followed by the sections listed in Section, each starting at a page
+ * boundary so that its array is aligned once the file is mapped.
+ * read_local_graph_from_file maps the file and copies every section into
+ * the graph and its vectors; nothing is used in place.
+ */
+struct LocalGraphHeader {
+  //! Section of the file, in the order they are written
+  enum Section {
+    EDGE_INDEX,      //!< edge_end of every node; uint64_t
+    EDGE_DST,        //!< local destination of every edge; uint32_t
+    EDGE_DATA,       //!< data of every edge, if any
+    LOCAL_TO_GLOBAL, //!< global id of every node; uint64_t
+    GID_TO_HOST,     //!< range of nodes read by every host; uint64_t pairs
+    MIRROR_COUNTS,   //!< number of mirrors of every host; uint64_t
+    MIRRORS,         //!< mirror lists of all hosts, in order; uint64_t
+    PARTITION,       //!< policy state, a boost archive
+    NUM_SECTIONS
+  };
+  constexpr static uint64_t MAGIC   = 0x4850524150534c47; // "GLSPARPH"
+  constexpr static uint64_t VERSION = 1;
+  constexpr static uint64_t ALIGN   = 4096;
+
+  uint64_t magic;
+  uint64_t version;
+  //! identity of the input graph file; 0 if unknown
+  uint64_t inputHash;
+  //! identity of the partitioning policy and its parameters; 0 if unknown
+  uint64_t policyHash;
+  uint32_t hostID;
+  uint32_t numHosts;
+  uint64_t edgeDataSize;
+  uint64_t numGlobalNodes;
+  uint64_t numGlobalEdges;
+  uint64_t numNodes;
+  uint64_t numEdges;
+  uint32_t numOwned;
+  uint32_t beginMaster;
+  uint32_t numNodesWithEdges;
+  uint32_t transposed;
+  uint64_t offset[NUM_SECTIONS];
+  uint64_t size[NUM_SECTIONS];
+};
+
+//! 64-bit FNV-1a hash of a string
+inline uint64_t hashString(const std::string& key) {
+  uint64_t h = 14695981039346656037ULL;
+  for (unsigned char c : key) {
+    h ^= c;
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+} // namespace internal
 /**
  * Enums specifying how masters are to be distributed among hosts.
  */
@@ -127,6 +193,39 @@ protected:
   //! LID = globalToLocalMap[GID]
   std::unordered_map<uint64_t, uint32_t> globalToLocalMap;
 
+  //! Identity of the input graph file, checked when reading a saved
+  //! partition; 0 if unknown
+  uint64_t inputHash = 0;
+  //! Identity of the partitioning policy and its parameters, checked when
+  //! reading a saved partition; 0 if unknown
+  uint64_t policyHash = 0;
+
+  /**
+   * Sets the identity a saved partition is checked against: the size,
+   * modification time and header of the input graph file, and a description
+   * of the partitioning policy.
+   *
+   * @param filename input graph file
+   * @param policy anything that changes the partition given the same input
+   */
+  void setPartitionIdentity(const std::string& filename,
+                            const std::string& policy) {
+    struct stat buf;
+    uint64_t header[4];
+    std::ifstream headerFile(filename, std::ios::binary);
+    if (stat(filename.c_str(), &buf) == 0 &&
+        headerFile.read(reinterpret_cast<char*>(header), sizeof(header))) {
+      std::string key = std::to_string(buf.st_size) + ":" +
+                        std::to_string(buf.st_mtime);
+      for (uint64_t h : header)
+        key += ":" + std::to_string(h);
+      inputHash = internal::hashString(key);
+    } else {
+      inputHash = 0;
+    }
+    policyHash = internal::hashString(policy);
+  }
+
   //! Increments evilPhase, a phase counter used by communication.
   void inline increment_evilPhase() {
     ++galois::runtime::evilPhase;
@@ -677,6 +776,36 @@ public:
    */
   inline size_t getNumNodesWithEdges() const { return numNodesWithEdges; }
 
+  /**
+   * Identity of this host's partition: its input and policy along with the
+   * global ids and masters of its proxies. Per-proxy state saved on one
+   * partition only applies to another with the same identity.
+   *
+   * @returns hash of the partition of this host
+   */
+  uint64_t partitionHash() const {
+    // splitmix64 finalizer
+    auto mix = [](uint64_t z) {
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      return z ^ (z >> 31);
+    };
+    galois::GAccumulator<uint64_t> proxies;
+    galois::do_all(
+        galois::iterate(size_t{0}, localToGlobalVector.size()),
+        [&](size_t lid) {
+          // (lid, gid) pairs are summed so order is free
+          proxies += mix(localToGlobalVector[lid] * 0x9e3779b97f4a7c15ULL + lid);
+        },
+        galois::no_stats(), galois::loopname("PartitionHash"));
+    uint64_t hash = proxies.reduce();
+    for (uint64_t field : std::initializer_list<uint64_t>{
+             inputHash, policyHash, numGlobalNodes, numGlobalEdges, numHosts,
+             beginMaster, numOwned})
+      hash = mix(hash * 0x9e3779b97f4a7c15ULL + field);
+    return hash;
+  }
+
   /**
    * Gets number of nodes on the global unpartitioned graph.
    *
@@ -845,21 +974,326 @@ protected:
    */
   void edgesEqualMasters() { specificRanges[2] = specificRanges[1]; }
 
+protected:
+  /**
+   * Saves the state of the partitioning policy that ownership queries need
+   * into the PARTITION section of a saved partition, the only section that
+   * is not a raw array. Graphs built by a partitioner override this; the
+   * default saves nothing.
+   *
+   * @param ar Boost archive to serialize to
+   */
+  virtual void serializePartition(boost::archive::binary_oarchive&) const {}
+
+  /**
+   * Restores the state saved by serializePartition.
+   *
+   * @param ar Boost archive to deserialize from
+   */
+  virtual void deserializePartition(boost::archive::binary_iarchive&) {}
+
 public:
   /**
-   * Write the local LC_CSR graph to the file on a disk.
+   * Write the partition of this host to a file on a disk: the local CSR
+   * graph, the master/mirror metadata and the state of the partitioning
+   * policy. Node data is not saved. read_local_graph_from_file restores it
+   * without repartitioning.
+   *
+   * Arrays are written raw, each at a page boundary, behind a header that
+   * records the host, the number of hosts, and the identity of the input and
+   * of the partitioning policy (see setPartitionIdentity).
    *
-   * @todo revive this
+   * @param localGraphFileName file to write to
    */
-  void save_local_graph_to_file(std::string) { GALOIS_DIE("not implemented"); }
+  void save_local_graph_to_file(std::string localGraphFileName) {
+    using Header = internal::LocalGraphHeader;
+    using EdgeDataTy =
+        std::conditional_t<std::is_void<EdgeTy>::value, char, EdgeTy>;
+    galois::CondStatTimer<MORE_DIST_STATS> timer("LocalGraphSaveTime",
+                                                 "DistGraph");
+    timer.start();
+
+    constexpr size_t edgeDataSize =
+        std::is_void<EdgeTy>::value ? 0 : sizeof(EdgeDataTy);
+    std::vector<uint64_t> edgeIndex(numNodes);
+    std::vector<uint32_t> edgeDst(numEdges);
+    std::vector<char> edgeData(numEdges * edgeDataSize);
+    galois::do_all(
+        galois::iterate(size_t{0}, size_t{numNodes}),
+        [&](size_t n) {
+          edgeIndex[n] = *graph.edge_end(n);
+          for (auto e : graph.edges(n)) {
+            edgeDst[*e] = graph.getEdgeDst(e);
+            if constexpr (edgeDataSize != 0) {
+              EdgeDataTy data = graph.getEdgeData(e);
+              memcpy(&edgeData[*e * edgeDataSize], &data, edgeDataSize);
+            }
+          }
+        },
+        galois::no_stats(), galois::loopname("LocalGraphSave"));
+
+    std::vector<uint64_t> mirrorCounts(numHosts), mirrors;
+    for (uint32_t h = 0; h < numHosts; ++h) {
+      mirrorCounts[h] = mirrorNodes[h].size();
+      mirrors.insert(mirrors.end(), mirrorNodes[h].begin(),
+                     mirrorNodes[h].end());
+    }
+
+    std::ostringstream partition;
+    {
+      boost::archive::binary_oarchive ar(partition);
+      serializePartition(ar);
+    }
+    std::string partitionState = partition.str();
+
+    Header header{};
+    header.magic             = Header::MAGIC;
+    header.version           = Header::VERSION;
+    header.inputHash         = inputHash;
+    header.policyHash        = policyHash;
+    header.hostID            = id;
+    header.numHosts          = numHosts;
+    header.edgeDataSize      = edgeDataSize;
+    header.numGlobalNodes    = numGlobalNodes;
+    header.numGlobalEdges    = numGlobalEdges;
+    header.numNodes          = numNodes;
+    header.numEdges          = numEdges;
+    header.numOwned          = numOwned;
+    header.beginMaster       = beginMaster;
+    header.numNodesWithEdges = numNodesWithEdges;
+    header.transposed        = transposed;
+
+    const void* sections[Header::NUM_SECTIONS] = {
+        edgeIndex.data(),           edgeDst.data(),  edgeData.data(),
+        localToGlobalVector.data(), gid2host.data(), mirrorCounts.data(),
+        mirrors.data(),             partitionState.data()};
+    header.size[Header::EDGE_INDEX]      = edgeIndex.size() * sizeof(uint64_t);
+    header.size[Header::EDGE_DST]        = edgeDst.size() * sizeof(uint32_t);
+    header.size[Header::EDGE_DATA]       = edgeData.size();
+    header.size[Header::LOCAL_TO_GLOBAL] =
+        localToGlobalVector.size() * sizeof(uint64_t);
+    header.size[Header::GID_TO_HOST]   = gid2host.size() * 2 * sizeof(uint64_t);
+    header.size[Header::MIRROR_COUNTS] = mirrorCounts.size() * sizeof(uint64_t);
+    header.size[Header::MIRRORS]       = mirrors.size() * sizeof(uint64_t);
+    header.size[Header::PARTITION]     = partitionState.size();
+    uint64_t offset = sizeof(Header);
+    for (unsigned i = 0; i < Header::NUM_SECTIONS; ++i) {
+      offset           = (offset + Header::ALIGN - 1) & ~(Header::ALIGN - 1);
+      header.offset[i] = offset;
+      offset += header.size[i];
+    }
+
+    std::ofstream outputStream(localGraphFileName, std::ios::binary);
+    if (!outputStream.is_open()) {
+      GALOIS_SYS_DIE("failed opening ", localGraphFileName);
+    }
+    outputStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (unsigned i = 0; i < Header::NUM_SECTIONS; ++i) {
+      outputStream.seekp(header.offset[i]);
+      outputStream.write(static_cast<const char*>(sections[i]),
+                         header.size[i]);
+    }
+    outputStream.close();
+    if (outputStream.fail()) {
+      GALOIS_SYS_DIE("failed writing ", localGraphFileName);
+    }
+    timer.stop();
+  }
 
   /**
-   * Read the local LC_CSR graph from the file on a disk.
+   * Read the partition of this host written by save_local_graph_to_file.
+   * Dies if the file was saved for another host, number of hosts, input or
+   * partitioning policy; identities that are unknown (0) on either side are
+   * not checked.
    *
-   * @todo revive this
+   * @param localGraphFileName file to read from
    */
-  void read_local_graph_from_file(std::string) {
-    GALOIS_DIE("not implemented");
+  void read_local_graph_from_file(std::string localGraphFileName) {
+    using Header = internal::LocalGraphHeader;
+    using EdgeDataTy =
+        std::conditional_t<std::is_void<EdgeTy>::value, char, EdgeTy>;
+    galois::CondStatTimer<MORE_DIST_STATS> timer("LocalGraphReadTime",
+                                                 "DistGraph");
+    timer.start();
+
+    int fd = open(localGraphFileName.c_str(), O_RDONLY);
+    if (fd == -1) {
+      GALOIS_SYS_DIE("failed opening ", localGraphFileName);
+    }
+    struct stat buf;
+    if (fstat(fd, &buf) == -1) {
+      GALOIS_SYS_DIE("failed reading ", localGraphFileName);
+    }
+    size_t fileSize = buf.st_size;
+    if (fileSize < sizeof(Header)) {
+      GALOIS_DIE(localGraphFileName, " is not a saved partition");
+    }
+    void* base = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+      GALOIS_SYS_DIE("failed mapping ", localGraphFileName);
+    }
+    const char* file = static_cast<const char*>(base);
+    Header header;
+    memcpy(&header, file, sizeof(header));
+
+    constexpr size_t edgeDataSize =
+        std::is_void<EdgeTy>::value ? 0 : sizeof(EdgeDataTy);
+    if (header.magic != Header::MAGIC || header.version != Header::VERSION) {
+      GALOIS_DIE(localGraphFileName, " is not a saved partition");
+    }
+    if (header.hostID != id || header.numHosts != numHosts) {
+      GALOIS_DIE(localGraphFileName, " holds the partition of host ",
+                 header.hostID, " of ", header.numHosts, ", not of host ", id,
+                 " of ", numHosts);
+    }
+    if (header.inputHash && inputHash && header.inputHash != inputHash) {
+      GALOIS_DIE(localGraphFileName, " was saved for another input graph");
+    }
+    if (header.policyHash && policyHash && header.policyHash != policyHash) {
+      GALOIS_DIE(localGraphFileName,
+                 " was saved with another partitioning policy");
+    }
+    if (header.edgeDataSize != edgeDataSize) {
+      GALOIS_DIE(localGraphFileName, " has edge data of size ",
+                 header.edgeDataSize, ", expected ", edgeDataSize);
+    }
+    for (unsigned i = 0; i < Header::NUM_SECTIONS; ++i) {
+      if (header.offset[i] > fileSize ||
+          header.size[i] > fileSize - header.offset[i]) {
+        GALOIS_DIE(localGraphFileName, " is truncated");
+      }
+    }
+    auto section = [&](Header::Section i) {
+      return file + header.offset[i];
+    };
+
+    // the sections must hold the arrays the header describes; sizes are
+    // compared by division so that edited counts cannot overflow
+    auto holds = [&](Header::Section i, uint64_t count, uint64_t width) {
+      return header.size[i] / width >= count;
+    };
+    auto holdsExactly = [&](Header::Section i, uint64_t count,
+                            uint64_t width) {
+      return header.size[i] % width == 0 && header.size[i] / width == count;
+    };
+    if (header.numNodes > std::numeric_limits<uint32_t>::max() ||
+        header.beginMaster > header.numNodes ||
+        header.numOwned > header.numNodes - header.beginMaster ||
+        header.numNodesWithEdges > header.numNodes ||
+        !holdsExactly(Header::EDGE_INDEX, header.numNodes, sizeof(uint64_t)) ||
+        !holds(Header::EDGE_DST, header.numEdges, sizeof(uint32_t)) ||
+        (edgeDataSize &&
+         !holds(Header::EDGE_DATA, header.numEdges, edgeDataSize)) ||
+        !holdsExactly(Header::LOCAL_TO_GLOBAL, header.numNodes,
+                      sizeof(uint64_t)) ||
+        !holdsExactly(Header::GID_TO_HOST, numHosts, 2 * sizeof(uint64_t)) ||
+        !holdsExactly(Header::MIRROR_COUNTS, numHosts, sizeof(uint64_t)) ||
+        header.size[Header::MIRRORS] % sizeof(uint64_t) != 0) {
+      GALOIS_DIE(localGraphFileName, " is not a saved partition");
+    }
+
+    const uint64_t* edgeIndex =
+        reinterpret_cast<const uint64_t*>(section(Header::EDGE_INDEX));
+    const uint32_t* edgeDst =
+        reinterpret_cast<const uint32_t*>(section(Header::EDGE_DST));
+    const char* edgeData = section(Header::EDGE_DATA);
+
+    // edges are placed by index, so the index must be monotone and end at
+    // numEdges
+    galois::GReduceLogicalOr badIndex;
+    galois::do_all(
+        galois::iterate(uint64_t{0}, header.numNodes),
+        [&](uint64_t n) {
+          if (edgeIndex[n] < (n ? edgeIndex[n - 1] : 0))
+            badIndex.update(true);
+        },
+        galois::no_stats(), galois::loopname("LocalGraphCheck"));
+    uint64_t lastEdge = header.numNodes ? edgeIndex[header.numNodes - 1] : 0;
+    if (badIndex.reduce() || lastEdge != header.numEdges) {
+      GALOIS_DIE(localGraphFileName, " is not a saved partition");
+    }
+
+    transposed        = header.transposed;
+    numGlobalNodes    = header.numGlobalNodes;
+    numGlobalEdges    = header.numGlobalEdges;
+    numNodes          = header.numNodes;
+    numEdges          = header.numEdges;
+    numOwned          = header.numOwned;
+    beginMaster       = header.beginMaster;
+    numNodesWithEdges = header.numNodesWithEdges;
+
+    galois::GReduceLogicalOr badDst;
+    graph.allocateFrom(numNodes, numEdges);
+    graph.constructNodes();
+    galois::do_all(
+        galois::iterate(size_t{0}, size_t{numNodes}),
+        [&](size_t n) {
+          uint64_t e = n ? edgeIndex[n - 1] : 0;
+          for (; e < edgeIndex[n]; ++e) {
+            if (edgeDst[e] >= numNodes)
+              badDst.update(true);
+            if constexpr (edgeDataSize != 0) {
+              EdgeDataTy data;
+              memcpy(&data, &edgeData[e * edgeDataSize], edgeDataSize);
+              graph.constructEdge(e, edgeDst[e], data);
+            } else {
+              graph.constructEdge(e, edgeDst[e]);
+            }
+          }
+          graph.fixEndEdge(n, edgeIndex[n]);
+        },
+        galois::no_stats(), galois::loopname("LocalGraphRead"));
+    if (badDst.reduce()) {
+      GALOIS_DIE(localGraphFileName, " is not a saved partition");
+    }
+
+    auto readVector = [&](auto& vec, Header::Section i) {
+      using T = typename std::remove_reference_t<decltype(vec)>::value_type;
+      vec.resize(header.size[i] / sizeof(T));
+      memcpy(static_cast<void*>(vec.data()), section(i), header.size[i]);
+    };
+    readVector(localToGlobalVector, Header::LOCAL_TO_GLOBAL);
+    readVector(gid2host, Header::GID_TO_HOST);
+    std::vector<uint64_t> mirrorCounts, mirrors;
+    readVector(mirrorCounts, Header::MIRROR_COUNTS);
+    readVector(mirrors, Header::MIRRORS);
+    uint64_t numMirrors = 0;
+    for (uint64_t count : mirrorCounts) {
+      if (count > mirrors.size() - numMirrors) {
+        GALOIS_DIE(localGraphFileName, " is not a saved partition");
+      }
+      numMirrors += count;
+    }
+    if (numMirrors != mirrors.size()) {
+      GALOIS_DIE(localGraphFileName, " is not a saved partition");
+    }
+    mirrorNodes.assign(numHosts, std::vector<size_t>());
+    auto mirror = mirrors.begin();
+    for (uint32_t h = 0; h < numHosts; ++h) {
+      mirrorNodes[h].assign(mirror, mirror + mirrorCounts[h]);
+      mirror += mirrorCounts[h];
+    }
+
+    globalToLocalMap.clear();
+    globalToLocalMap.reserve(numNodes);
+    for (uint32_t i = 0; i < numNodes; ++i) {
+      globalToLocalMap[localToGlobalVector[i]] = i;
+    }
+
+    std::istringstream partition(std::string(section(Header::PARTITION),
+                                              header.size[Header::PARTITION]));
+    {
+      boost::archive::binary_iarchive ar(partition);
+      deserializePartition(ar);
+    }
+    munmap(base, fileSize);
+
+    determineThreadRanges();
+    determineThreadRangesMaster();
+    determineThreadRangesWithEdges();
+    initializeSpecificRanges();
+    timer.stop();
   }
 
   /**
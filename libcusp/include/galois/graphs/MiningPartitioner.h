@@ -32,6 +32,7 @@
 
 #include "galois/graphs/DistributedGraph.h"
 #include "galois/DReducible.h"
+#include "galois/ParallelSTL.h"
 
 namespace galois {
 namespace graphs {
@@ -773,10 +774,11 @@ private:
    * finalize metadata maps
    */
   void finalizeInspection(galois::gstl::Vector<uint64_t>& prefixSumOfEdges) {
-    for (unsigned i = 1; i < base_DistGraph::numNodes; i++) {
-      // finalize prefix sum
-      prefixSumOfEdges[i] += prefixSumOfEdges[i - 1];
-    }
+    // finalize prefix sum
+    galois::ParallelSTL::partial_sum(
+        prefixSumOfEdges.begin(),
+        prefixSumOfEdges.begin() + base_DistGraph::numNodes,
+        prefixSumOfEdges.begin());
     if (prefixSumOfEdges.size() != 0) {
       base_DistGraph::numEdges = prefixSumOfEdges.back();
     } else {
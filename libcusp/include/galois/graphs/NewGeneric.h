@@ -29,8 +29,10 @@
 
 #include "galois/graphs/DistributedGraph.h"
 #include "galois/DReducible.h"
+#include "galois/ParallelSTL.h"
 #include <optional>
 #include <sstream>
+#include <typeinfo>
 
 #define CUSP_PT_TIMER 0
 
@@ -107,6 +109,22 @@ private:
     return graphPartitioner->cartesianGrid();
   }
 
+protected:
+  virtual void
+  serializePartition(boost::archive::binary_oarchive& ar) const override {
+    graphPartitioner->serializeAssignment(ar);
+    graphPartitioner->serializePartition(ar);
+  }
+
+  virtual void
+  deserializePartition(boost::archive::binary_iarchive& ar) override {
+    graphPartitioner = std::make_unique<Partitioner>(
+        base_DistGraph::id, base_DistGraph::numHosts,
+        base_DistGraph::numGlobalNodes, base_DistGraph::numGlobalEdges);
+    graphPartitioner->deserializeAssignment(ar);
+    graphPartitioner->deserializePartition(ar);
+  }
+
 public:
   /**
    * Reset load balance on host reducibles.
@@ -169,6 +187,12 @@ public:
         "GraphPartitioningTime", GRNAME);
     Tgraph_construct.start();
 
+    base_DistGraph::setPartitionIdentity(
+        filename, std::string(typeid(Partitioner).name()) + ":" +
+                      std::to_string(transpose) + ":" + std::to_string(md) +
+                      ":" + std::to_string(nodeWeight) + ":" +
+                      std::to_string(edgeWeight) + ":" + masterBlockFile);
+
     if (readFromFile) {
       galois::gPrint("[", base_DistGraph::id,
                      "] Reading local graph from file ", localGraphFileName,
@@ -386,9 +410,8 @@ private:
         },
         galois::no_stats());
 
-    for (unsigned i = 1; i < numLocalNodes; i++) {
-      edgePrefixSum[i] += edgePrefixSum[i - 1];
-    }
+    galois::ParallelSTL::partial_sum(edgePrefixSum.begin(), edgePrefixSum.end(),
+                                     edgePrefixSum.begin());
 
     assignedThreadRanges = galois::graphs::determineUnitRangesFromPrefixSum(
         galois::runtime::activeThreads, edgePrefixSum);
@@ -31,6 +31,7 @@
 #include "galois/Reduction.h"
 #include "galois/AtomicHelpers.h"
 #include "galois/runtime/LWCI.h"
+#include "galois/runtime/NetworkIO.h"
 #include "galois/runtime/DistStats.h"
 
 namespace galois {
@@ -58,6 +59,15 @@ class DGAccumulator {
                 &galois::runtime::internal::ompi_op_sum<Ty>, lc_col_ep);
   }
 #else
+  /**
+   * Sum reduction over the shared memory IO layer
+   */
+  inline void reduce_shm() {
+    galois::runtime::shmAllreduce(
+        &local_mdata, &global_mdata, sizeof(Ty),
+        &galois::runtime::internal::ompi_op_sum<Ty>);
+  }
+
   /**
    * Sum reduction using MPI
    */
@@ -179,7 +189,11 @@ public:
 #ifdef GALOIS_USE_LCI
     reduce_lwci();
 #else
-    reduce_mpi();
+    if (galois::runtime::networkIOShmEnabled()) {
+      reduce_shm();
+    } else {
+      reduce_mpi();
+    }
 #endif
 
     reduceTimer.stop();
@@ -213,6 +227,15 @@ class DGReduceMax {
                 &galois::runtime::internal::ompi_op_max<Ty>, lc_col_ep);
   }
 #else
+  /**
+   * Max reduction over the shared memory IO layer
+   */
+  inline void reduce_shm() {
+    galois::runtime::shmAllreduce(
+        &local_mdata, &global_mdata, sizeof(Ty),
+        &galois::runtime::internal::ompi_op_max<Ty>);
+  }
+
   /**
    * Use MPI to reduce max across hosts
    */
@@ -315,7 +338,11 @@ public:
 #ifdef GALOIS_USE_LCI
     reduce_lwci();
 #else
-    reduce_mpi();
+    if (galois::runtime::networkIOShmEnabled()) {
+      reduce_shm();
+    } else {
+      reduce_mpi();
+    }
 #endif
     reduceTimer.stop();
 
@@ -348,6 +375,15 @@ class DGReduceMin {
                 &galois::runtime::internal::ompi_op_min<Ty>, lc_col_ep);
   }
 #else
+  /**
+   * Min reduction over the shared memory IO layer
+   */
+  inline void reduce_shm() {
+    galois::runtime::shmAllreduce(
+        &local_mdata, &global_mdata, sizeof(Ty),
+        &galois::runtime::internal::ompi_op_min<Ty>);
+  }
+
   /**
    * Use MPI to reduce min across hosts
    */
@@ -451,7 +487,11 @@ public:
 #ifdef GALOIS_USE_LCI
     reduce_lwci();
 #else
-    reduce_mpi();
+    if (galois::runtime::networkIOShmEnabled()) {
+      reduce_shm();
+    } else {
+      reduce_mpi();
+    }
 #endif
     reduceTimer.stop();
 
@@ -31,6 +31,7 @@
 #include "galois/Reduction.h"
 #include "galois/AtomicHelpers.h"
 #include "galois/runtime/LWCI.h"
+#include "galois/runtime/NetworkIO.h"
 #include "galois/runtime/DistStats.h"
 
 namespace galois {
@@ -55,6 +56,11 @@ class DGTerminator {
   bool work_done;
 #ifndef GALOIS_USE_LCI
   MPI_Request snapshot_request;
+  //! request of the snapshot on the shared memory IO layer
+  uint64_t shm_snapshot_request;
+  //! if the shared memory request has yet to complete (once complete, it
+  //! tests as ended like a null MPI request)
+  bool shm_snapshot_pending = false;
 #else
   lc_colreq snapshot_request;
 #endif
@@ -143,8 +149,14 @@ public:
                  &galois::runtime::internal::ompi_op_max<Ty>, lc_col_ep,
                  &snapshot_request);
 #else
-    MPI_Iallreduce(&snapshot, &global_snapshot, 1, MPI_UNSIGNED_LONG, MPI_MAX,
-                   MPI_COMM_WORLD, &snapshot_request);
+    if (galois::runtime::networkIOShmEnabled()) {
+      shm_snapshot_request =
+          galois::runtime::shmIallreduce(&snapshot, sizeof(uint64_t));
+      shm_snapshot_pending = true;
+    } else {
+      MPI_Iallreduce(&snapshot, &global_snapshot, 1, MPI_UNSIGNED_LONG,
+                     MPI_MAX, MPI_COMM_WORLD, &snapshot_request);
+    }
 #endif
   }
 
@@ -156,7 +168,16 @@ public:
     int snapshot_ended = 0;
     if (!active) {
 #ifndef GALOIS_USE_LCI
-      MPI_Test(&snapshot_request, &snapshot_ended, MPI_STATUS_IGNORE);
+      if (galois::runtime::networkIOShmEnabled()) {
+        if (shm_snapshot_pending) {
+          shm_snapshot_pending = !galois::runtime::shmTestAllreduce(
+              shm_snapshot_request, &global_snapshot, sizeof(uint64_t),
+              &galois::runtime::internal::ompi_op_max<uint64_t>);
+        }
+        snapshot_ended = !shm_snapshot_pending;
+      } else {
+        MPI_Test(&snapshot_request, &snapshot_ended, MPI_STATUS_IGNORE);
+      }
 #else
       lc_col_progress(&snapshot_request);
       snapshot_ended = snapshot_request.flag;
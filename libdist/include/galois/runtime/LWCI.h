@@ -21,10 +21,13 @@
  * @file LWCI.h
  *
  * LWCI header that includes lc.h (LCI library) and internal helper functions
- * on arrays.
+ * on arrays. The helpers are also used by the shared memory collectives, so
+ * they are available without LCI.
  */
 
 #pragma once
+#include <cstddef>
+
 #ifdef GALOIS_USE_LCI
 GALOIS_IGNORE_UNUSED_PARAMETERS
 #include "lc.h"
@@ -32,6 +35,7 @@ GALOIS_END_IGNORE_UNUSED_PARAMETERS
 
 extern lc_ep lc_col_ep;
 extern lc_ep lc_p2p_ep[3];
+#endif
 
 namespace galois {
 namespace runtime {
@@ -98,4 +102,3 @@ void ompi_op_min(void* dst, void* src, size_t count) {
 } // namespace internal
 } // namespace runtime
 } // namespace galois
-#endif
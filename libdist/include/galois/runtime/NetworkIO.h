@@ -21,8 +21,8 @@
  * @file NetworkIO.h
  *
  * Contains NetworkIO, a base class that is inherited by classes that want to
- * implement the communication layer of Galois. (e.g. NetworkIOMPI and
- * NetworkIOLWCI)
+ * implement the communication layer of Galois. (e.g. NetworkIOMPI,
+ * NetworkIOShm and NetworkIOLWCI)
  */
 
 #ifndef GALOIS_RUNTIME_NETWORKTHREAD_H
@@ -124,6 +124,63 @@ public:
 std::tuple<std::unique_ptr<NetworkIO>, uint32_t, uint32_t>
 makeNetworkIOMPI(galois::runtime::MemUsageTracker& tracker,
                  std::atomic<size_t>& sends, std::atomic<size_t>& recvs);
+
+/**
+ * Returns true if hosts should communicate through shared memory, i.e., if
+ * GALOIS_SHM_HOSTS is set.
+ */
+bool networkIOShmEnabled();
+
+/**
+ * Creates/returns a network IO layer for hosts that are processes on the same
+ * machine and communicate through POSIX shared memory. MPI is not used.
+ *
+ * Every host needs GALOIS_SHM_HOSTS (number of hosts) and GALOIS_SHM_HOST_ID
+ * (its id) set; GALOIS_SHM_NAME names the segment (default /galois-shm) and
+ * GALOIS_SHM_RING_KB sets the capacity of each host-to-host ring (default
+ * 4096).
+ *
+ * @returns tuple with pointer to the shared memory IO layer, this host's ID,
+ * and the total number of hosts in the system
+ */
+std::tuple<std::unique_ptr<NetworkIO>, uint32_t, uint32_t>
+makeNetworkIOShm(galois::runtime::MemUsageTracker& tracker,
+                 std::atomic<size_t>& sends, std::atomic<size_t>& recvs);
+
+//! Reduction operator of shared memory collectives: combines count bytes of
+//! src into dst (see the operators in LWCI.h)
+typedef void (*ShmReduceOp)(void* dst, void* src, size_t count);
+
+/**
+ * Starts a nonblocking all-reduce across the hosts of the shared memory IO
+ * layer. Like MPI collectives, every host must start collectives in the same
+ * order.
+ *
+ * @param in contribution of this host, at most 64 bytes; copied
+ * @param size number of bytes of in
+ * @returns request to pass to shmTestAllreduce
+ */
+uint64_t shmIallreduce(const void* in, size_t size);
+
+/**
+ * Completes a nonblocking all-reduce if every host has contributed. Must not
+ * be called again for a request once it returned true.
+ *
+ * @param request returned by shmIallreduce
+ * @param out OUTPUT: reduced value; written only on completion
+ * @param size number of bytes of the value
+ * @param op reduction operator
+ * @returns true if the all-reduce completed
+ */
+bool shmTestAllreduce(uint64_t request, void* out, size_t size,
+                      ShmReduceOp op);
+
+//! Blocking all-reduce across the hosts of the shared memory IO layer
+void shmAllreduce(const void* in, void* out, size_t size, ShmReduceOp op);
+
+//! Control-flow barrier across hosts of the shared memory IO layer
+void shmHostBarrier();
+
 // #ifdef GALOIS_USE_LCI
 // /**
 //  * Creates/returns a network IO layer that uses LWCI to do communication.
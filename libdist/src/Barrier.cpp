@@ -31,6 +31,7 @@
 #include "galois/runtime/Substrate.h"
 #include "galois/substrate/CompilerSpecific.h"
 #include "galois/runtime/Network.h"
+#include "galois/runtime/NetworkIO.h"
 #include "galois/runtime/LWCI.h"
 
 #include <cstdlib>
@@ -99,7 +100,13 @@ public:
 #ifdef GALOIS_USE_LCI
     lc_barrier(lc_col_ep);
 #else
-    MPI_Barrier(MPI_COMM_WORLD); // assumes MPI_THREAD_MULTIPLE
+    if (galois::runtime::networkIOShmEnabled()) {
+      // make sure this host has attached to the shared segment
+      galois::runtime::getSystemNetworkInterface();
+      galois::runtime::shmHostBarrier();
+    } else {
+      MPI_Barrier(MPI_COMM_WORLD); // assumes MPI_THREAD_MULTIPLE
+    }
 #endif
   }
 };
@@ -372,26 +372,34 @@ class NetworkInterfaceBuffered : public NetworkInterface {
   std::vector<sendBuffer> sendData;
 
   void workerThread() {
-    initializeMPI();
-    int rank;
-    int hostSize;
-
-    int rankSuccess = MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-    if (rankSuccess != MPI_SUCCESS) {
-      MPI_Abort(MPI_COMM_WORLD, rankSuccess);
-    }
+    // hosts on one machine may skip MPI entirely
+    const bool useShm = networkIOShmEnabled();
+    if (useShm) {
+      std::tie(netio, ID, Num) =
+          makeNetworkIOShm(memUsageTracker, inflightSends, inflightRecvs);
+      galois::gDebug("[", NetworkInterface::ID, "] shared memory attached");
+    } else {
+      initializeMPI();
+      int rank;
+      int hostSize;
+
+      int rankSuccess = MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+      if (rankSuccess != MPI_SUCCESS) {
+        MPI_Abort(MPI_COMM_WORLD, rankSuccess);
+      }
 
-    int sizeSuccess = MPI_Comm_size(MPI_COMM_WORLD, &hostSize);
-    if (sizeSuccess != MPI_SUCCESS) {
-      MPI_Abort(MPI_COMM_WORLD, sizeSuccess);
-    }
+      int sizeSuccess = MPI_Comm_size(MPI_COMM_WORLD, &hostSize);
+      if (sizeSuccess != MPI_SUCCESS) {
+        MPI_Abort(MPI_COMM_WORLD, sizeSuccess);
+      }
 
-    galois::gDebug("[", NetworkInterface::ID, "] MPI initialized");
-    std::tie(netio, ID, Num) =
-        makeNetworkIOMPI(memUsageTracker, inflightSends, inflightRecvs);
+      galois::gDebug("[", NetworkInterface::ID, "] MPI initialized");
+      std::tie(netio, ID, Num) =
+          makeNetworkIOMPI(memUsageTracker, inflightSends, inflightRecvs);
 
-    assert(ID == (unsigned)rank);
-    assert(Num == (unsigned)hostSize);
+      assert(ID == (unsigned)rank);
+      assert(Num == (unsigned)hostSize);
+    }
 
     ready = 1;
     while (ready < 2) { /*fprintf(stderr, "[WaitOnReady-2]");*/
@@ -423,7 +431,9 @@ class NetworkInterfaceBuffered : public NetworkInterface {
         }
       }
     }
-    finalizeMPI();
+    if (!useShm) {
+      finalizeMPI();
+    }
   }
 
   std::thread worker;
@@ -0,0 +1,567 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file NetworkIOShm.cpp
+ *
+ * Contains an implementation of network IO for hosts that are processes on
+ * the same machine. Hosts share one POSIX shared memory segment that holds a
+ * single-producer single-consumer byte ring for every ordered pair of hosts,
+ * along with the slots the all-reduce and barrier collectives use in place of
+ * MPI's.
+ */
+
+#include "galois/runtime/NetworkIO.h"
+#include "galois/runtime/Tracer.h"
+#include "galois/substrate/CompilerSpecific.h"
+#include "galois/substrate/EnvCheck.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+//! Environment variable with the number of hosts; enables this layer
+constexpr const char* SHM_HOSTS_ENV = "GALOIS_SHM_HOSTS";
+//! Environment variable with the id of this host
+constexpr const char* SHM_HOST_ID_ENV = "GALOIS_SHM_HOST_ID";
+//! Environment variable with the name of the segment (default /galois-shm)
+constexpr const char* SHM_NAME_ENV = "GALOIS_SHM_NAME";
+//! Environment variable with the capacity of each ring in KB (default 4096)
+constexpr const char* SHM_RING_KB_ENV = "GALOIS_SHM_RING_KB";
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared memory rings need address-free atomics");
+
+//! Number of collectives that may be in flight at once
+constexpr uint64_t COLLECTIVE_SLOTS = 8;
+//! Largest value a host may contribute to a collective
+constexpr size_t COLLECTIVE_BYTES = 64;
+
+/**
+ * Header of the segment. Host 0 creates the segment of a run and publishes a
+ * fresh generation in it once it is initialized; the other hosts attach to
+ * the segment under the name only if it carries a generation and wait for
+ * host 0 to confirm it as ready, so a segment left behind by a crashed run
+ * is never used.
+ */
+struct SegmentHeader {
+  alignas(64) std::atomic<uint64_t> generation; //!< 0 until initialized
+  //! generation once every host attached, or STALE_GENERATION
+  alignas(64) std::atomic<uint64_t> ready;
+  alignas(64) std::atomic<uint64_t> attached;
+  alignas(64) uint64_t ringBytes;
+  uint64_t hosts;
+};
+
+//! Marks a segment superseded by a new run; hosts waiting on it reattach
+constexpr uint64_t STALE_GENERATION = ~uint64_t{0};
+
+/**
+ * A collective in flight. Collective number s uses slot s % COLLECTIVE_SLOTS
+ * once the slot reaches round s / COLLECTIVE_SLOTS, i.e., once every host has
+ * read the result of the collective that used it before. The contribution of
+ * every host follows.
+ */
+struct CollectiveSlot {
+  alignas(64) std::atomic<uint64_t> arrived; //!< hosts that contributed
+  alignas(64) std::atomic<uint64_t> read;    //!< hosts that read the result
+  alignas(64) std::atomic<uint64_t> round;
+};
+
+/**
+ * Head and tail of a ring, on separate cache lines since they are written by
+ * different processes. The bytes of the ring follow.
+ */
+struct RingHeader {
+  alignas(64) std::atomic<uint64_t> head; //!< total bytes written
+  alignas(64) std::atomic<uint64_t> tail; //!< total bytes read
+};
+
+//! Framing of a message in a ring
+struct FrameHeader {
+  uint64_t size;
+  uint32_t tag;
+  uint32_t pad;
+};
+
+//! Collectives of the segment this process is attached to, if any
+uint8_t* collectives  = nullptr;
+uint32_t segmentID    = 0;
+uint32_t segmentHosts = 0;
+//! Number of collectives this host has started
+std::atomic<uint64_t> nextCollective(0);
+
+size_t collectiveStride(uint32_t num) {
+  return sizeof(CollectiveSlot) + num * COLLECTIVE_BYTES;
+}
+
+CollectiveSlot& collectiveSlot(uint64_t request) {
+  assert(collectives);
+  return *reinterpret_cast<CollectiveSlot*>(
+      collectives +
+      (request % COLLECTIVE_SLOTS) * collectiveStride(segmentHosts));
+}
+
+uint8_t* collectiveValue(uint64_t request, uint32_t host) {
+  return reinterpret_cast<uint8_t*>(&collectiveSlot(request)) +
+         sizeof(CollectiveSlot) + host * COLLECTIVE_BYTES;
+}
+
+//! Spins, then yields: hosts may well outnumber cores
+template <typename Pred>
+void spinUntil(Pred pred) {
+  for (unsigned i = 0; !pred(); ++i) {
+    if (i < 1024) {
+      galois::substrate::asmPause();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+} // namespace
+
+/**
+ * Shared memory implementation of network IO. Each process is a host; a ring
+ * per ordered pair of hosts carries framed messages. Only the network worker
+ * thread calls into this class, so every ring has a single producer and a
+ * single consumer and needs no locks.
+ *
+ * Messages larger than a ring are streamed through it in pieces by
+ * progress(). A received message is copied once, from the ring into the
+ * buffer that is handed to the receive queue.
+ */
+class NetworkIOShm : public galois::runtime::NetworkIO {
+  //! Ring from host src to host dst
+  struct Ring {
+    RingHeader* header;
+    uint8_t* data;
+    uint64_t capacity;
+
+    //! Copies len bytes at stream position pos into the ring
+    void write(uint64_t pos, const uint8_t* src, uint64_t len) {
+      uint64_t off   = pos % capacity;
+      uint64_t first = std::min(len, capacity - off);
+      std::memcpy(data + off, src, first);
+      std::memcpy(data, src + first, len - first);
+    }
+
+    //! Copies len bytes at stream position pos out of the ring
+    void read(uint64_t pos, uint8_t* dst, uint64_t len) const {
+      uint64_t off   = pos % capacity;
+      uint64_t first = std::min(len, capacity - off);
+      std::memcpy(dst, data + off, first);
+      std::memcpy(dst + first, data, len - first);
+    }
+  };
+
+  //! Messages to a host; the front one may be partially written
+  struct sendQueueTy {
+    std::deque<message> pending;
+    uint64_t written = 0; //!< bytes of the front message in the ring
+    bool framed      = false;
+    //! ring offsets where messages fully written to the ring end; a send
+    //! completes only once the receiver reads past its end, so termination
+    //! detection never misses a message sitting in the ring
+    std::deque<uint64_t> unread;
+  };
+
+  //! Message from a host that is partially read
+  struct recvStateTy {
+    message current;
+    uint64_t read = 0;
+    bool active   = false;
+  };
+
+  uint32_t ID;
+  uint32_t Num;
+  std::string name;
+  void* base;
+  size_t baseSize;
+  std::vector<Ring> rings; //!< rings[src * Num + dst]
+  std::vector<sendQueueTy> sendQueues;
+  std::vector<recvStateTy> recvStates;
+  std::deque<message> done;
+
+  Ring& ring(uint32_t src, uint32_t dst) { return rings[src * Num + dst]; }
+
+  void sendProgress(uint32_t dst) {
+    auto& q = sendQueues[dst];
+    auto& r = ring(ID, dst);
+    if (!q.unread.empty()) {
+      uint64_t tail = r.header->tail.load(std::memory_order_acquire);
+      while (!q.unread.empty() && q.unread.front() <= tail) {
+        --inflightSends;
+        q.unread.pop_front();
+      }
+    }
+    while (!q.pending.empty()) {
+      auto& m       = q.pending.front();
+      uint64_t head = r.header->head.load(std::memory_order_relaxed);
+      uint64_t free =
+          r.capacity - (head - r.header->tail.load(std::memory_order_acquire));
+
+      if (!q.framed) {
+        if (free < sizeof(FrameHeader)) {
+          return;
+        }
+        FrameHeader f{m.data.size(), m.tag, 0};
+        r.write(head, reinterpret_cast<uint8_t*>(&f), sizeof(f));
+        head += sizeof(f);
+        free -= sizeof(f);
+        q.framed = true;
+      }
+
+      uint64_t len = std::min(free, m.data.size() - q.written);
+      r.write(head, m.data.data() + q.written, len);
+      q.written += len;
+      r.header->head.store(head + len, std::memory_order_release);
+
+      if (q.written < m.data.size()) {
+        return;
+      }
+      memUsageTracker.decrementMemUsage(m.data.size());
+      q.unread.push_back(head + len);
+      q.pending.pop_front();
+      q.written = 0;
+      q.framed  = false;
+    }
+  }
+
+  void recvProgress(uint32_t src) {
+    auto& s = recvStates[src];
+    auto& r = ring(src, ID);
+    while (true) {
+      uint64_t tail = r.header->tail.load(std::memory_order_relaxed);
+      uint64_t avail =
+          r.header->head.load(std::memory_order_acquire) - tail;
+
+      if (!s.active) {
+        if (avail < sizeof(FrameHeader)) {
+          return;
+        }
+        FrameHeader f;
+        r.read(tail, reinterpret_cast<uint8_t*>(&f), sizeof(f));
+        tail += sizeof(f);
+        avail -= sizeof(f);
+        s.current = message(src, f.tag, vTy(f.size));
+        s.read    = 0;
+        s.active  = true;
+        ++inflightRecvs;
+        memUsageTracker.incrementMemUsage(f.size);
+      }
+
+      uint64_t len = std::min(avail, s.current.data.size() - s.read);
+      r.read(tail, s.current.data.data() + s.read, len);
+      s.read += len;
+      r.header->tail.store(tail + len, std::memory_order_release);
+
+      if (s.read < s.current.data.size()) {
+        return;
+      }
+      galois::runtime::trace("SHM RECV", src, s.current.tag,
+                             s.current.data.size());
+      done.emplace_back(std::move(s.current));
+      s.active = false;
+    }
+  }
+
+  //! Maps the segment open as fd, which is baseSize bytes
+  SegmentHeader* mapSegment(int fd) {
+    base = mmap(nullptr, baseSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+      GALOIS_SYS_DIE("failed mapping shared memory segment ", name);
+    }
+    return static_cast<SegmentHeader*>(base);
+  }
+
+  /**
+   * Host 0: marks a segment left under the name by an earlier run as stale
+   * and removes it, then creates the segment of this run. A new segment
+   * reads as zero, which is the initial state of every ring and collective.
+   */
+  SegmentHeader* createSegment(uint64_t ringBytes) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd >= 0) {
+      struct stat st;
+      if (fstat(fd, &st) == 0 &&
+          static_cast<size_t>(st.st_size) >= sizeof(SegmentHeader)) {
+        void* old = mmap(nullptr, sizeof(SegmentHeader),
+                         PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (old != MAP_FAILED) {
+          static_cast<SegmentHeader*>(old)->ready.store(STALE_GENERATION);
+          munmap(old, sizeof(SegmentHeader));
+        }
+      }
+      close(fd);
+      galois::gWarn("removing stale shared memory segment ", name);
+      shm_unlink(name.c_str());
+    }
+
+    fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+      GALOIS_SYS_DIE("failed creating shared memory segment ", name, "; set ",
+                     SHM_NAME_ENV, " to a name unique to this run");
+    }
+    if (ftruncate(fd, baseSize) != 0) {
+      GALOIS_SYS_DIE("failed sizing shared memory segment ", name);
+    }
+    auto* header      = mapSegment(fd);
+    header->ringBytes = ringBytes;
+    header->hosts     = Num;
+
+    std::random_device rd;
+    uint64_t generation =
+        (static_cast<uint64_t>(rd()) << 32 ^ rd()) ^
+        static_cast<uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+    if (generation == 0 || generation == STALE_GENERATION) {
+      generation = 1;
+    }
+    header->attached.fetch_add(1);
+    header->generation.store(generation);
+    return header;
+  }
+
+  /**
+   * Other hosts: attaches to the segment host 0 created for this run,
+   * waiting for it to appear; gives up any segment that host 0 marks stale
+   * and tries again.
+   */
+  SegmentHeader* attachSegment(uint64_t ringBytes) {
+    while (true) {
+      int fd = shm_open(name.c_str(), O_RDWR, 0600);
+      if (fd < 0 && errno != ENOENT) {
+        GALOIS_SYS_DIE("failed opening shared memory segment ", name);
+      }
+      struct stat st;
+      if (fd >= 0 && fstat(fd, &st) != 0) {
+        GALOIS_SYS_DIE("failed opening shared memory segment ", name);
+      }
+      // not there, not sized yet or from a run with other parameters
+      if (fd < 0 || static_cast<size_t>(st.st_size) != baseSize) {
+        if (fd >= 0) {
+          close(fd);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        continue;
+      }
+
+      auto* header        = mapSegment(fd);
+      uint64_t generation = 0;
+      spinUntil([&] {
+        generation = header->generation.load();
+        return generation != 0 || header->ready.load() == STALE_GENERATION;
+      });
+      if (header->ready.load() != STALE_GENERATION) {
+        if (header->ringBytes != ringBytes || header->hosts != Num) {
+          GALOIS_DIE("shared memory segment ", name, " has other parameters; ",
+                     "set ", SHM_HOSTS_ENV, " and ", SHM_RING_KB_ENV,
+                     " alike on all hosts");
+        }
+        header->attached.fetch_add(1);
+        uint64_t ready = 0;
+        spinUntil([&] {
+          ready = header->ready.load();
+          return ready == generation || ready == STALE_GENERATION;
+        });
+        if (ready == generation) {
+          return header;
+        }
+      }
+      munmap(base, baseSize);
+    }
+  }
+
+public:
+  /**
+   * Constructor. Host 0 creates the shared segment and the others attach to
+   * it; returns once all hosts have.
+   *
+   * @param tracker memory usage tracker
+   * @param sends
+   * @param recvs
+   * @param [out] _ID this process's host id
+   * @param [out] NUM total number of hosts in the system
+   */
+  NetworkIOShm(galois::runtime::MemUsageTracker& tracker,
+               std::atomic<size_t>& sends, std::atomic<size_t>& recvs,
+               uint32_t& _ID, uint32_t& NUM)
+      : NetworkIO(tracker, sends, recvs), name("/galois-shm") {
+    int num = 0, id = -1, ringKB = 4096;
+    galois::substrate::EnvCheck(SHM_HOSTS_ENV, num);
+    if (!galois::substrate::EnvCheck(SHM_HOST_ID_ENV, id) || num <= 0 ||
+        id < 0 || id >= num) {
+      GALOIS_DIE("set ", SHM_HOSTS_ENV, " to the number of hosts and ",
+                 SHM_HOST_ID_ENV, " to an id below it");
+    }
+    galois::substrate::EnvCheck(SHM_NAME_ENV, name);
+    galois::substrate::EnvCheck(SHM_RING_KB_ENV, ringKB);
+    ID  = id;
+    Num = num;
+
+    uint64_t ringBytes  = static_cast<uint64_t>(std::max(ringKB, 1)) * 1024;
+    uint64_t ringStride = sizeof(RingHeader) + ringBytes;
+    baseSize = sizeof(SegmentHeader) + COLLECTIVE_SLOTS * collectiveStride(Num) +
+               ringStride * Num * Num;
+
+    auto* header =
+        ID == 0 ? createSegment(ringBytes) : attachSegment(ringBytes);
+
+    uint8_t* p = static_cast<uint8_t*>(base) + sizeof(SegmentHeader);
+    collectives = p;
+    p += COLLECTIVE_SLOTS * collectiveStride(Num);
+    rings.resize(Num * Num);
+    for (auto& r : rings) {
+      r.header   = reinterpret_cast<RingHeader*>(p);
+      r.data     = p + sizeof(RingHeader);
+      r.capacity = ringBytes;
+      p += ringStride;
+    }
+    sendQueues = std::vector<sendQueueTy>(Num);
+    recvStates = std::vector<recvStateTy>(Num);
+
+    segmentID    = ID;
+    segmentHosts = Num;
+    if (ID == 0) {
+      spinUntil([&] { return header->attached.load() == Num; });
+      // everyone has the segment mapped, so the name is no longer needed;
+      // this also keeps a crashed run from leaving a segment behind
+      shm_unlink(name.c_str());
+      header->ready.store(header->generation.load());
+    }
+
+    _ID = ID;
+    NUM = Num;
+  }
+
+  virtual ~NetworkIOShm() {
+    collectives = nullptr;
+    munmap(base, baseSize);
+  }
+
+  /**
+   * Adds a message to the send queue of its destination
+   */
+  virtual void enqueue(message m) {
+    memUsageTracker.incrementMemUsage(m.data.size());
+    galois::runtime::trace("SHM SEND", m.host, m.tag, m.data.size());
+    uint32_t dst = m.host;
+    sendQueues[dst].pending.emplace_back(std::move(m));
+    sendProgress(dst);
+  }
+
+  /**
+   * Attempts to get a message from the recv queue.
+   */
+  virtual message dequeue() {
+    if (!done.empty()) {
+      auto msg = std::move(done.front());
+      done.pop_front();
+      return msg;
+    }
+    return message{~0U, 0, vTy()};
+  }
+
+  /**
+   * Push progress forward in the system.
+   */
+  virtual void progress() {
+    for (uint32_t h = 0; h < Num; ++h) {
+      if (h != ID) {
+        sendProgress(h);
+        recvProgress(h);
+      }
+    }
+  }
+}; // end NetworkIOShm class
+
+bool galois::runtime::networkIOShmEnabled() {
+  static const bool enabled = galois::substrate::EnvCheck(SHM_HOSTS_ENV);
+  return enabled;
+}
+
+std::tuple<std::unique_ptr<galois::runtime::NetworkIO>, uint32_t, uint32_t>
+galois::runtime::makeNetworkIOShm(galois::runtime::MemUsageTracker& tracker,
+                                  std::atomic<size_t>& sends,
+                                  std::atomic<size_t>& recvs) {
+  uint32_t ID, NUM;
+  std::unique_ptr<galois::runtime::NetworkIO> n{
+      new NetworkIOShm(tracker, sends, recvs, ID, NUM)};
+  return std::make_tuple(std::move(n), ID, NUM);
+}
+
+uint64_t galois::runtime::shmIallreduce(const void* in, size_t size) {
+  if (size > COLLECTIVE_BYTES) {
+    GALOIS_DIE("shared memory collectives take at most ", COLLECTIVE_BYTES,
+               " bytes");
+  }
+  uint64_t request = nextCollective++;
+  auto& slot       = collectiveSlot(request);
+  spinUntil([&] { return slot.round.load() == request / COLLECTIVE_SLOTS; });
+  if (size > 0) {
+    std::memcpy(collectiveValue(request, segmentID), in, size);
+  }
+  slot.arrived.fetch_add(1);
+  return request;
+}
+
+bool galois::runtime::shmTestAllreduce(uint64_t request, void* out,
+                                       size_t size, ShmReduceOp op) {
+  auto& slot = collectiveSlot(request);
+  if (slot.arrived.load() < segmentHosts) {
+    return false;
+  }
+  // every host combines in host order, so all get bitwise equal results
+  if (size > 0) {
+    std::memcpy(out, collectiveValue(request, 0), size);
+    for (uint32_t h = 1; h < segmentHosts; ++h) {
+      op(out, collectiveValue(request, h), size);
+    }
+  }
+  if (slot.read.fetch_add(1) + 1 == segmentHosts) {
+    slot.arrived.store(0);
+    slot.read.store(0);
+    slot.round.fetch_add(1);
+  }
+  return true;
+}
+
+void galois::runtime::shmAllreduce(const void* in, void* out, size_t size,
+                                   ShmReduceOp op) {
+  uint64_t request = shmIallreduce(in, size);
+  spinUntil([&] { return shmTestAllreduce(request, out, size, op); });
+}
+
+void galois::runtime::shmHostBarrier() {
+  shmAllreduce(nullptr, nullptr, 0, nullptr);
+}
@@ -0,0 +1,142 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+// Runs two hosts as processes connected by the shared memory network IO
+// layer, after leaving a stale segment behind from a killed host
+
+#include "galois/DistGalois.h"
+#include "galois/DReducible.h"
+#include "galois/runtime/Network.h"
+#include "galois/runtime/Serialize.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+//! Starts host id of 2 in a child process running f
+template <typename F>
+pid_t spawn(const std::string& name, unsigned id, F f) {
+  pid_t pid = fork();
+  GALOIS_ASSERT(pid >= 0, "fork");
+  if (pid == 0) {
+    alarm(60);
+    setenv("GALOIS_SHM_HOSTS", "2", 1);
+    setenv("GALOIS_SHM_HOST_ID", std::to_string(id).c_str(), 1);
+    setenv("GALOIS_SHM_NAME", name.c_str(), 1);
+    // smaller than the large message, so it is streamed in pieces
+    setenv("GALOIS_SHM_RING_KB", "64", 1);
+    setenv("GALOIS_DO_NOT_BIND_THREADS", "1", 1);
+    f(id);
+    _exit(0);
+  }
+  return pid;
+}
+
+void exchange(unsigned id) {
+  galois::DistMemSys G;
+  galois::setActiveThreads(2);
+  auto& net = galois::runtime::getSystemNetworkInterface();
+  GALOIS_ASSERT(net.ID == id && net.Num == 2, "host ids");
+  unsigned other = 1 - id;
+
+  for (size_t len : {size_t{10}, size_t{1} << 20}) {
+    std::vector<uint64_t> out(len);
+    for (size_t i = 0; i < len; ++i)
+      out[i] = i * 2 + id;
+    galois::runtime::SendBuffer b;
+    galois::runtime::gSerialize(b, out);
+    net.sendTagged(other, galois::runtime::evilPhase, b);
+    net.flush();
+
+    decltype(net.recieveTagged(galois::runtime::evilPhase, nullptr)) p;
+    do {
+      p = net.recieveTagged(galois::runtime::evilPhase, nullptr);
+    } while (!p);
+    GALOIS_ASSERT(p->first == other, "sender");
+    std::vector<uint64_t> in;
+    galois::runtime::gDeserialize(p->second, in);
+    GALOIS_ASSERT(in.size() == len, "message size");
+    for (size_t i = 0; i < len; ++i)
+      GALOIS_ASSERT(in[i] == i * 2 + other, "message contents");
+    ++galois::runtime::evilPhase;
+  }
+
+  galois::DGAccumulator<uint64_t> sum;
+  galois::DGReduceMax<uint64_t> max;
+  for (unsigned round = 0; round < 20; ++round) {
+    sum.reset();
+    max.reset();
+    sum += id + round;
+    max.update(id * 10 + round);
+    GALOIS_ASSERT(sum.reduce() == 1 + 2 * round, "all-reduce sum");
+    GALOIS_ASSERT(max.reduce() == 10 + round, "all-reduce max");
+  }
+  galois::runtime::getHostBarrier().wait();
+}
+
+bool exited(pid_t pid) {
+  int status;
+  GALOIS_ASSERT(waitpid(pid, &status, 0) == pid, "waitpid");
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main() {
+  std::string name = "/galois-shm-test-" + std::to_string(getpid());
+
+  // host 0 of a run that never completes leaves its segment behind
+  pid_t crashed = spawn(name, 0, [](unsigned) {
+    galois::DistMemSys G;
+    galois::runtime::getSystemNetworkInterface();
+  });
+  std::string path = "/dev/shm" + name;
+  struct stat st;
+  while (stat(path.c_str(), &st) != 0 || st.st_size == 0)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  kill(crashed, SIGKILL);
+  waitpid(crashed, nullptr, 0);
+
+  // host 1 first finds the stale segment
+  pid_t host1 = spawn(name, 1, exchange);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  pid_t host0 = spawn(name, 0, exchange);
+  bool ok0    = exited(host0);
+  bool ok1    = exited(host1);
+  shm_unlink(name.c_str());
+  GALOIS_ASSERT(ok0 && ok1, "hosts exit cleanly");
+
+  // a second run under the same name starts from scratch
+  host0 = spawn(name, 0, exchange);
+  host1 = spawn(name, 1, exchange);
+  ok0   = exited(host0);
+  ok1   = exited(host1);
+  shm_unlink(name.c_str());
+  GALOIS_ASSERT(ok0 && ok1, "second run exits cleanly");
+
+  return 0;
+}
@@ -26,6 +26,7 @@
 #ifndef _GALOIS_DYNAMIC_BIT_SET_
 #define _GALOIS_DYNAMIC_BIT_SET_
 
+#include <algorithm>
 #include <climits>
 #include <vector>
 #include <cassert>
@@ -39,6 +40,7 @@
 #include "galois/GaloisForwardDecl.h"
 #include "galois/Traits.h"
 #include "galois/Galois.h"
+#include "galois/substrate/ThreadPool.h"
 
 namespace galois {
 /**
@@ -50,6 +52,73 @@ protected:
   size_t num_bits;
   static constexpr uint32_t bits_uint64 = sizeof(uint64_t) * CHAR_BIT;
 
+  //! Words handled at a time by one thread in bulk operations
+  static constexpr size_t block_words = 1024;
+
+  static_assert(sizeof(galois::CopyableAtomic<uint64_t>) == sizeof(uint64_t),
+                "bulk operations access the words as plain integers");
+
+  /**
+   * Plain view of the words for bulk operations, which may be vectorized.
+   * Only valid while no bits are set or reset concurrently.
+   */
+  uint64_t* words() { return reinterpret_cast<uint64_t*>(bitvec.data()); }
+  const uint64_t* words() const {
+    return reinterpret_cast<const uint64_t*>(bitvec.data());
+  }
+
+  static uint64_t popcount(uint64_t n) {
+#ifdef __GNUC__
+    return __builtin_popcountll(n);
+#else
+    n = n - ((n >> 1) & 0x5555555555555555UL);
+    n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
+    return (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >> 56;
+#endif
+  }
+
+  static size_t num_blocks(size_t num_words) {
+    return (num_words + block_words - 1) / block_words;
+  }
+
+  /**
+   * Calls fn(block, begin, end) for every block of words [begin, end) of
+   * [first, last). Blocks are processed in parallel unless there is only one
+   * or the caller is already in a parallel loop; contiguous blocks go to the
+   * same thread, so resetting a new bitset places its pages blocked across
+   * NUMA nodes by first touch. The parallel loop reports statistics only if
+   * it is given a loopname.
+   */
+  template <typename FnTy>
+  static void for_blocks(size_t first, size_t last, const FnTy& fn,
+                         const char* loopname = nullptr) {
+    size_t blocks = num_blocks(last - first);
+    auto block    = [&](size_t b) {
+      size_t begin = first + b * block_words;
+      fn(b, begin, std::min(last, begin + block_words));
+    };
+    if (blocks <= 1 || galois::substrate::getThreadPool().isRunning()) {
+      for (size_t b = 0; b < blocks; ++b)
+        block(b);
+    } else if (loopname) {
+      galois::do_all(galois::iterate(size_t{0}, blocks), block,
+                     galois::loopname(loopname));
+    } else {
+      galois::do_all(galois::iterate(size_t{0}, blocks), block,
+                     galois::no_stats());
+    }
+  }
+
+  //! Sets every word w of this bitset to fn(w, i) where i is its index
+  template <typename FnTy>
+  void transform_words(const FnTy& fn) {
+    uint64_t* w = words();
+    for_blocks(0, bitvec.size(), [&](size_t, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+        w[i] = fn(w[i], i);
+    });
+  }
+
 public:
   //! Constructor which initializes to an empty bitset.
   DynamicBitSet() : num_bits(0) {}
@@ -107,7 +176,9 @@ public:
   /**
    * Unset every bit in the bitset.
    */
-  void reset() { std::fill(bitvec.begin(), bitvec.end(), 0); }
+  void reset() {
+    transform_words([](uint64_t, size_t) { return uint64_t(0); });
+  }
 
   /**
    * Unset a range of bits given an inclusive range
@@ -141,7 +212,10 @@ public:
       vec_end = (end + 1) / bits_uint64; // floor
 
     if (vec_begin < vec_end) {
-      std::fill(bitvec.begin() + vec_begin, bitvec.begin() + vec_end, 0);
+      uint64_t* w = words();
+      for_blocks(vec_begin, vec_end, [&](size_t, size_t b, size_t e) {
+        std::fill(w + b, w + e, 0);
+      });
     }
 
     vec_begin *= bits_uint64;
@@ -240,10 +314,8 @@ public:
   // assumes bit_vector is not updated (set) in parallel
   void bitwise_or(const DynamicBitSet& other) {
     assert(size() == other.size());
-    auto& other_bitvec = other.get_vec();
-    galois::do_all(
-        galois::iterate(size_t{0}, bitvec.size()),
-        [&](size_t i) { bitvec[i] |= other_bitvec[i]; }, galois::no_stats());
+    const uint64_t* o = other.words();
+    transform_words([&](uint64_t w, size_t i) { return w | o[i]; });
   }
 
   // assumes bit_vector is not updated (set) in parallel
@@ -255,10 +327,8 @@ public:
    */
   void bitwise_and(const DynamicBitSet& other) {
     assert(size() == other.size());
-    auto& other_bitvec = other.get_vec();
-    galois::do_all(
-        galois::iterate(size_t{0}, bitvec.size()),
-        [&](size_t i) { bitvec[i] &= other_bitvec[i]; }, galois::no_stats());
+    const uint64_t* o = other.words();
+    transform_words([&](uint64_t w, size_t i) { return w & o[i]; });
   }
 
   /**
@@ -271,13 +341,9 @@ public:
   void bitwise_and(const DynamicBitSet& other1, const DynamicBitSet& other2) {
     assert(size() == other1.size());
     assert(size() == other2.size());
-    auto& other_bitvec1 = other1.get_vec();
-    auto& other_bitvec2 = other2.get_vec();
-
-    galois::do_all(
-        galois::iterate(size_t{0}, bitvec.size()),
-        [&](size_t i) { bitvec[i] = other_bitvec1[i] & other_bitvec2[i]; },
-        galois::no_stats());
+    const uint64_t* o1 = other1.words();
+    const uint64_t* o2 = other2.words();
+    transform_words([&](uint64_t, size_t i) { return o1[i] & o2[i]; });
   }
 
   /**
@@ -287,10 +353,8 @@ public:
    */
   void bitwise_xor(const DynamicBitSet& other) {
     assert(size() == other.size());
-    auto& other_bitvec = other.get_vec();
-    galois::do_all(
-        galois::iterate(size_t{0}, bitvec.size()),
-        [&](size_t i) { bitvec[i] ^= other_bitvec[i]; }, galois::no_stats());
+    const uint64_t* o = other.words();
+    transform_words([&](uint64_t w, size_t i) { return w ^ o[i]; });
   }
 
   /**
@@ -303,13 +367,9 @@ public:
   void bitwise_xor(const DynamicBitSet& other1, const DynamicBitSet& other2) {
     assert(size() == other1.size());
     assert(size() == other2.size());
-    auto& other_bitvec1 = other1.get_vec();
-    auto& other_bitvec2 = other2.get_vec();
-
-    galois::do_all(
-        galois::iterate(size_t{0}, bitvec.size()),
-        [&](size_t i) { bitvec[i] = other_bitvec1[i] ^ other_bitvec2[i]; },
-        galois::no_stats());
+    const uint64_t* o1 = other1.words();
+    const uint64_t* o2 = other2.words();
+    transform_words([&](uint64_t, size_t i) { return o1[i] ^ o2[i]; });
   }
 
   /**
@@ -319,86 +379,77 @@ public:
    */
   uint64_t count() const {
     galois::GAccumulator<uint64_t> ret;
-    galois::do_all(
-        galois::iterate(bitvec.begin(), bitvec.end()),
-        [&](uint64_t n) {
-#ifdef __GNUC__
-          ret += __builtin_popcountll(n);
-#else
-          n = n - ((n >> 1) & 0x5555555555555555UL);
-          n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-          ret +=
-              (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >>
-              56;
-#endif
-        },
-        galois::no_stats());
+    const uint64_t* w = words();
+    for_blocks(0, bitvec.size(), [&](size_t, size_t begin, size_t end) {
+      uint64_t c = 0;
+      for (size_t i = begin; i < end; ++i)
+        c += popcount(w[i]);
+      ret += c;
+    });
     return ret.reduce();
   }
 
+  /**
+   * Calls fn(index) for every set bit. Calls may be concurrent unless the
+   * caller is itself in a parallel loop. Bits must not be set or reset
+   * meanwhile.
+   *
+   * @param loopname if not null, name of the parallel loop for statistics
+   */
+  template <typename FnTy>
+  void for_each_set_bit(const FnTy& fn, const char* loopname = nullptr) const {
+    const uint64_t* w = words();
+    for_blocks(
+        0, bitvec.size(),
+        [&](size_t, size_t begin, size_t end) {
+          for (size_t i = begin; i < end; ++i)
+            for (uint64_t word = w[i]; word; word &= word - 1)
+              fn(i * bits_uint64 + __builtin_ctzll(word));
+        },
+        loopname);
+  }
+
+  /**
+   * Fills offsets with the indices of the set bits in increasing order.
+   * Blocks of words are counted with popcount, and each block then writes
+   * its indices after the prefix sum of the counts of the blocks before it.
+   *
+   * @param offsets resizable vector of integers, e.g., std::vector or
+   * PODResizeableArray; its previous contents are discarded
+   */
+  template <typename VecTy>
+  void getOffsets(VecTy& offsets) const {
+    const uint64_t* w = words();
+    std::vector<size_t> prefix(num_blocks(bitvec.size()) + 1);
+    for_blocks(0, bitvec.size(), [&](size_t b, size_t begin, size_t end) {
+      size_t c = 0;
+      for (size_t i = begin; i < end; ++i)
+        c += popcount(w[i]);
+      prefix[b + 1] = c;
+    });
+    for (size_t b = 1; b < prefix.size(); ++b)
+      prefix[b] += prefix[b - 1];
+
+    offsets.resize(prefix.back());
+    auto* out = offsets.data();
+    for_blocks(0, bitvec.size(), [&](size_t b, size_t begin, size_t end) {
+      size_t pos = prefix[b];
+      for (size_t i = begin; i < end; ++i)
+        for (uint64_t word = w[i]; word; word &= word - 1)
+          out[pos++] = i * bits_uint64 + __builtin_ctzll(word);
+    });
+  }
+
   /**
    * Returns a vector containing the set bits in this bitset in order
    * from left to right.
-   * Do NOT call in a parallel region as it uses galois::on_each.
    *
    * @returns vector with offsets into set bits
    */
   // TODO uint32_t is somewhat dangerous; change in the future
   std::vector<uint32_t> getOffsets() const {
-    uint32_t activeThreads = galois::getActiveThreads();
-    std::vector<unsigned int> tPrefixBitCounts(activeThreads);
-
-    // count how many bits are set on each thread
-    galois::on_each([&](unsigned tid, unsigned nthreads) {
-      size_t start;
-      size_t end;
-      std::tie(start, end) =
-          galois::block_range((size_t)0, this->size(), tid, nthreads);
-
-      unsigned int count = 0;
-      for (unsigned int i = start; i < end; ++i) {
-        if (this->test(i))
-          ++count;
-      }
-
-      tPrefixBitCounts[tid] = count;
-    });
-
-    // calculate prefix sum of bits per thread
-    for (unsigned int i = 1; i < activeThreads; ++i) {
-      tPrefixBitCounts[i] += tPrefixBitCounts[i - 1];
-    }
-
-    // total num of set bits
-    uint64_t bitsetCount = tPrefixBitCounts[activeThreads - 1];
     std::vector<uint32_t> offsets;
-
-    // calculate the indices of the set bits and save them to the offset
-    // vector
-    if (bitsetCount > 0) {
-      offsets.resize(bitsetCount);
-      galois::on_each([&](unsigned tid, unsigned nthreads) {
-        size_t start;
-        size_t end;
-        std::tie(start, end) =
-            galois::block_range((size_t)0, this->size(), tid, nthreads);
-        unsigned int count = 0;
-        unsigned int tPrefixBitCount;
-        if (tid == 0) {
-          tPrefixBitCount = 0;
-        } else {
-          tPrefixBitCount = tPrefixBitCounts[tid - 1];
-        }
-
-        for (unsigned int i = start; i < end; ++i) {
-          if (this->test(i)) {
-            offsets[tPrefixBitCount + count] = i;
-            ++count;
-          }
-        }
-      });
-    }
-
+    getOffsets(offsets);
     return offsets;
   }
 
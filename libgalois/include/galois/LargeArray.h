@@ -21,6 +21,7 @@
 #define GALOIS_LARGEARRAY_H
 
 #include <iostream>
+#include <string>
 #include <utility>
 
 #include <boost/archive/binary_iarchive.hpp>
@@ -34,6 +35,7 @@
 #include "galois/Galois.h"
 #include "galois/gIO.h"
 #include "galois/ParallelSTL.h"
+#include "galois/PlacementPolicy.h"
 #include "galois/runtime/Mem.h"
 #include "galois/substrate/NumaMem.h"
 
@@ -74,28 +76,29 @@ public:
   };
 
 protected:
-  enum AllocType { Blocked, Local, Interleaved, Floating };
-  void allocate(size_type n, AllocType t) {
+  typedef PlacementPolicy::Placement AllocType;
+  void allocate(size_type n, AllocType t,
+                substrate::PageKind k = substrate::PageKind::Default) {
     assert(!m_data);
     m_size = n;
     switch (t) {
-    case Blocked:
+    case PlacementPolicy::Blocked:
       galois::gDebug("Block-alloc'd");
-      m_realdata =
-          substrate::largeMallocBlocked(n * sizeof(T), runtime::activeThreads);
+      m_realdata = substrate::largeMallocBlocked(n * sizeof(T),
+                                                 runtime::activeThreads, k);
       break;
-    case Interleaved:
+    case PlacementPolicy::Interleaved:
       galois::gDebug("Interleave-alloc'd");
-      m_realdata = substrate::largeMallocInterleaved(n * sizeof(T),
-                                                     runtime::activeThreads);
+      m_realdata = substrate::largeMallocInterleaved(
+          n * sizeof(T), runtime::activeThreads, k);
       break;
-    case Local:
+    case PlacementPolicy::Local:
       galois::gDebug("Local-allocd");
-      m_realdata = substrate::largeMallocLocal(n * sizeof(T));
+      m_realdata = substrate::largeMallocLocal(n * sizeof(T), k);
       break;
-    case Floating:
+    case PlacementPolicy::Floating:
       galois::gDebug("Floating-alloc'd");
-      m_realdata = substrate::largeMallocFloating(n * sizeof(T));
+      m_realdata = substrate::largeMallocFloating(n * sizeof(T), k);
       break;
     };
     m_data = reinterpret_cast<T*>(m_realdata.get());
@@ -203,28 +206,44 @@ public:
 
   //! [allocatefunctions]
   //! Allocates interleaved across NUMA (memory) nodes.
-  void allocateInterleaved(size_type n) { allocate(n, Interleaved); }
+  void allocateInterleaved(size_type n) {
+    allocate(n, PlacementPolicy::Interleaved);
+  }
 
   /**
    * Allocates using blocked memory policy
    *
    * @param  n         number of elements to allocate
    */
-  void allocateBlocked(size_type n) { allocate(n, Blocked); }
+  void allocateBlocked(size_type n) { allocate(n, PlacementPolicy::Blocked); }
 
   /**
    * Allocates using Thread Local memory policy
    *
    * @param  n         number of elements to allocate
    */
-  void allocateLocal(size_type n) { allocate(n, Local); }
+  void allocateLocal(size_type n) { allocate(n, PlacementPolicy::Local); }
 
   /**
    * Allocates using no memory policy (no pre alloc)
    *
    * @param  n         number of elements to allocate
    */
-  void allocateFloating(size_type n) { allocate(n, Floating); }
+  void allocateFloating(size_type n) { allocate(n, PlacementPolicy::Floating); }
+
+  /**
+   * Allocates using the placement policy of a role, which is dflt unless
+   * overridden (see PlacementPolicy)
+   *
+   * @param  n         number of elements to allocate
+   * @param  role      role of this array, e.g., "edgeDst"
+   * @param  dflt      policy of the role if it is not overridden
+   */
+  void allocateForRole(size_type n, const std::string& role,
+                       const PlacementPolicy& dflt) {
+    PlacementPolicy p = PlacementPolicy::forRole(role, dflt);
+    allocate(n, p.placement, p.pages);
+  }
 
   /**
    * Allocate memory to threads based on a provided array specifying which
@@ -345,6 +364,8 @@ public:
   void allocateBlocked(size_type) {}
   void allocateLocal(size_type, bool = true) {}
   void allocateFloating(size_type) {}
+  void allocateForRole(size_type, const std::string&,
+                       const PlacementPolicy&) {}
   template <typename RangeArrayTy>
   void allocateSpecified(size_type, RangeArrayTy) {}
 
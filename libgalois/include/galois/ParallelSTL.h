@@ -306,75 +306,98 @@ std::enable_if_t<!std::is_scalar<internal::Val_ty<I>>::value> destroy(I first,
 template <class I>
 std::enable_if_t<std::is_scalar<internal::Val_ty<I>>::value> destroy(I, I) {}
 
+//! Number of elements scanned per block; keeps a block of 8-byte values
+//! resident in L2 between reading it and writing it back
+constexpr size_t SCAN_BLOCK_SIZE = 1 << 15;
+
 /**
- * Does a partial sum from first -> last and writes the results to the d_first
- * iterator.
+ * Cache-blocked reduce-then-scan. The input is split into blocks of at most
+ * SCAN_BLOCK_SIZE elements; the first pass only reads each block to get its
+ * sum, and the second pass scans each block starting from the sum of all
+ * blocks before it. Output is written exactly once, and first may equal
+ * d_first.
+ *
+ * @tparam Inclusive true to include element i in output i
+ */
+template <bool Inclusive, class InputIt, class OutputIt, class T>
+OutputIt blocked_scan(InputIt first, InputIt last, OutputIt d_first, T init) {
+  const size_t size       = std::distance(first, last);
+  const size_t numThreads = galois::getActiveThreads();
+
+  auto scanBlock = [&](size_t begin, size_t end, T sum) {
+    for (size_t i = begin; i < end; ++i) {
+      // read before write so that scanning in place is safe
+      T v = *(first + i);
+      if (Inclusive) {
+        sum += v;
+        *(d_first + i) = sum;
+      } else {
+        *(d_first + i) = sum;
+        sum += v;
+      }
+    }
+  };
+
+  // only bother with parallel execution if there is more than a block of work
+  if (numThreads == 1 || size < SCAN_BLOCK_SIZE) {
+    scanBlock(0, size, init);
+    return d_first + size;
+  }
+
+  // at least one block per thread; more if blocks would fall out of cache
+  const size_t blockSize =
+      std::min(SCAN_BLOCK_SIZE, (size + numThreads - 1) / numThreads);
+  const size_t numBlocks = (size + blockSize - 1) / blockSize;
+
+  // blockPrefix[b] is the sum of all elements before block b
+  std::vector<T> blockPrefix(numBlocks + 1);
+  galois::do_all(
+      galois::iterate((size_t)0, numBlocks),
+      [&](size_t block) {
+        size_t blockEnd = std::min((block + 1) * blockSize, size);
+        T sum           = T();
+        for (size_t i = block * blockSize; i < blockEnd; ++i) {
+          sum += *(first + i);
+        }
+        blockPrefix[block + 1] = sum;
+      },
+      galois::steal(), galois::chunk_size<1>(), galois::no_stats());
+
+  blockPrefix[0] = init;
+  for (size_t block = 1; block <= numBlocks; ++block) {
+    blockPrefix[block] += blockPrefix[block - 1];
+  }
+
+  galois::do_all(
+      galois::iterate((size_t)0, numBlocks),
+      [&](size_t block) {
+        scanBlock(block * blockSize, std::min((block + 1) * blockSize, size),
+                  blockPrefix[block]);
+      },
+      galois::steal(), galois::chunk_size<1>(), galois::no_stats());
+
+  return d_first + size;
+}
+
+/**
+ * Does a partial sum (inclusive scan) from first -> last and writes the
+ * results to the d_first iterator. first may equal d_first.
  */
 template <class InputIt, class OutputIt>
 OutputIt partial_sum(InputIt first, InputIt last, OutputIt d_first) {
   using ValueType = typename std::iterator_traits<InputIt>::value_type;
+  return blocked_scan<true>(first, last, d_first, ValueType());
+}
 
-  size_t sizeOfVector = std::distance(first, last);
-
-  // only bother with parallel execution if vector is larger than some size
-  if (sizeOfVector >= 1024) {
-    const size_t numBlocks = galois::getActiveThreads();
-    const size_t blockSize = (sizeOfVector + numBlocks - 1) / numBlocks;
-    assert(numBlocks * blockSize >= sizeOfVector);
-
-    std::vector<ValueType> localSums(numBlocks);
-
-    // get the block sums
-    galois::do_all(
-        galois::iterate((size_t)0, numBlocks), [&](const size_t& block) {
-          // block start can extend past sizeOfVector if doesn't divide evenly
-          size_t blockStart = std::min(block * blockSize, sizeOfVector);
-          size_t blockEnd   = std::min((block + 1) * blockSize, sizeOfVector);
-          assert(blockStart <= blockEnd);
-
-          // partial accumulation of each block done now
-          std::partial_sum(first + blockStart, first + blockEnd,
-                           d_first + blockStart);
-          // save the last number in this block: used for block prefix sum
-          if (blockEnd > 0) {
-            localSums[block] = *(d_first + blockEnd - 1);
-          } else {
-            localSums[block] = 0;
-          }
-        });
-
-    // bulkPrefix[i] holds the starting sum of a particular block i
-    std::vector<ValueType> bulkPrefix(numBlocks);
-    // exclusive scan on local sums to get number to add to each block's
-    // set of indices
-    // Not using std::exclusive_scan because apparently it doesn't work for
-    // some compilers
-    ValueType runningSum = 0;
-    for (size_t i = 0; i < numBlocks; i++) {
-      bulkPrefix[i] = runningSum;
-      runningSum += localSums[i];
-    }
-
-    galois::do_all(
-        galois::iterate((size_t)0, numBlocks), [&](const size_t& block) {
-          // add the sums of previous elements to blocks
-          ValueType numToAdd = bulkPrefix[block];
-          size_t blockStart  = std::min(block * blockSize, sizeOfVector);
-          size_t blockEnd    = std::min((block + 1) * blockSize, sizeOfVector);
-          assert(blockStart <= blockEnd);
-
-          // transform applies addition to appropriate range
-          std::transform(d_first + blockStart, d_first + blockEnd,
-                         d_first + blockStart,
-                         [&](ValueType& val) { return val + numToAdd; });
-        });
-
-    // return the iterator past the last element written
-    return d_first + sizeOfVector;
-  } else {
-    // vector is small; do it serially using standard library
-    return std::partial_sum(first, last, d_first);
-  }
+/**
+ * Does an exclusive scan from first -> last starting at init and writes the
+ * results to the d_first iterator: element i of the output is init plus the
+ * sum of input elements [0, i). first may equal d_first.
+ */
+template <class InputIt, class OutputIt, class T>
+OutputIt exclusive_scan(InputIt first, InputIt last, OutputIt d_first,
+                        T init) {
+  return blocked_scan<false>(first, last, d_first, init);
 }
 
 } // end namespace ParallelSTL
@@ -0,0 +1,77 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_PLACEMENTPOLICY_H
+#define GALOIS_PLACEMENTPOLICY_H
+
+#include <string>
+
+#include "galois/config.h"
+#include "galois/substrate/PageAlloc.h"
+
+namespace galois {
+
+/**
+ * How the memory of a LargeArray is placed: the NUMA distribution of its
+ * pages and the kind of pages backing it.
+ *
+ * Arrays allocated for a role (e.g., "edgeDst" of a graph) use the default
+ * policy of their call site unless it is overridden for that role, either
+ * programmatically with setOverride or by the GALOIS_PLACEMENT environment
+ * variable, a comma separated list of role=placement[:pages] entries, e.g.
+ *
+ *   GALOIS_PLACEMENT=edgeDst=interleaved:1g,nodeData=blocked:thp
+ *
+ * placement is one of blocked, local, interleaved or floating, and pages one
+ * of default, small, thp or 1g. The role * applies to every role without an
+ * entry of its own.
+ */
+struct PlacementPolicy {
+  enum Placement { Blocked, Local, Interleaved, Floating };
+
+  Placement placement;
+  substrate::PageKind pages;
+
+  PlacementPolicy(Placement p              = Interleaved,
+                  substrate::PageKind k = substrate::PageKind::Default)
+      : placement(p), pages(k) {}
+
+  /**
+   * Returns the policy of arrays with the given role
+   *
+   * @param role role of the array
+   * @param dflt policy if there is no override for the role
+   */
+  static PlacementPolicy forRole(const std::string& role,
+                                 const PlacementPolicy& dflt);
+
+  //! Overrides the policy of a role, taking precedence over GALOIS_PLACEMENT
+  static void setOverride(const std::string& role,
+                          const PlacementPolicy& policy);
+
+  //! Parses a placement[:pages] specification; dies if it is malformed
+  static PlacementPolicy parse(const std::string& spec);
+
+  //! Returns the specification of this policy in the format parse takes
+  std::string str() const;
+};
+
+} // namespace galois
+
+#endif
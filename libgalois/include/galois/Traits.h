@@ -205,6 +205,17 @@ struct loopname : public trait_has_value<const char*>, loopname_tag {
 struct steal_tag {};
 struct steal : public trait_has_type<bool>, steal_tag {};
 
+/**
+ * Indicate that @{link do_all()} loops should perform work-stealing without
+ * per-thread locks. Each thread's remaining range is kept as a packed pair of
+ * chunk indices that the owner advances with an atomic add and thieves split
+ * with a CAS. Implies {@link steal}. Ranges whose local iterators are not
+ * random access fall back to the locking stealer. Optional argument to {@link
+ * do_all()} loops.
+ */
+struct lockfree_steal_tag {};
+struct lockfree_steal : public trait_has_type<bool>, lockfree_steal_tag {};
+
 /**
  * Indicates worklist to use. Optional argument to {@link for_each()} loops.
  */
@@ -260,6 +271,17 @@ struct disable_conflict_detection_tag {};
 struct disable_conflict_detection : public trait_has_type<bool>,
                                     disable_conflict_detection_tag {};
 
+/**
+ * Indicates the operator checks for conflicts itself instead of being
+ * unwound. A lock that cannot be acquired marks the iteration conflicted and
+ * makes galois::runtime::acquire return false; the operator must check
+ * UserContext::isConflicted (or the result of acquire) before writing shared
+ * data and return early. The iteration is then aborted without a longjmp or
+ * exception, which is cheaper for operators with frequent conflicts.
+ */
+struct no_exceptions_tag {};
+struct no_exceptions : public trait_has_type<bool>, no_exceptions_tag {};
+
 /**
  * Indicates that the neighborhood set does not change through out i.e. is not
  * dependent on computed values. Examples of such fixed neighborhood is e.g.
@@ -0,0 +1,202 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_UNIONFINDARRAY_H
+#define GALOIS_UNIONFINDARRAY_H
+
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+#include "galois/config.h"
+
+namespace galois {
+
+//! How UnionFindArray::find shortens the paths it walks
+enum class PathCompression {
+  //! leave the path alone
+  None,
+  //! point every node on the path to its grandparent
+  Splitting,
+  //! point every other node on the path to its grandparent
+  Halving,
+  //! point every node on the path to the root, in a second pass
+  Full
+};
+
+/**
+ * Concurrent union-find over the indices [0, size()), with the parents in a
+ * LargeArray of 32-bit indices. Unlike UnionFindNode, it does not live in the
+ * node data and takes 4 bytes per element instead of a pointer.
+ *
+ * unite and find may be called concurrently. unite is lock-free: it links the
+ * root with the larger index below the one with the smaller index with a CAS,
+ * so every parent has a smaller index than its children and concurrent links
+ * cannot form cycles. Compression only ever replaces a parent with another
+ * ancestor, so its plain stores are safe as well.
+ *
+ * @tparam Compression path compression done by find
+ */
+template <PathCompression Compression = PathCompression::Halving>
+class UnionFindArray {
+public:
+  using index_type = uint32_t;
+
+private:
+  LargeArray<index_type> parents;
+
+  index_type parent(index_type x) const {
+    return __atomic_load_n(&parents[x], __ATOMIC_RELAXED);
+  }
+
+  void setParent(index_type x, index_type p) {
+    __atomic_store_n(&parents[x], p, __ATOMIC_RELAXED);
+  }
+
+public:
+  UnionFindArray() = default;
+
+  //! n singleton sets
+  explicit UnionFindArray(size_t n) { resize(n); }
+
+  UnionFindArray(const UnionFindArray&) = delete;
+  UnionFindArray& operator=(const UnionFindArray&) = delete;
+
+  //! Discards all unions and makes n singleton sets
+  void resize(size_t n) {
+    parents.deallocate();
+    parents.allocateInterleaved(n);
+    reset();
+  }
+
+  //! Makes every element a singleton set again
+  void reset() {
+    galois::do_all(
+        galois::iterate(size_t{0}, parents.size()),
+        [&](size_t x) { parents[x] = x; }, galois::no_stats(),
+        galois::loopname("UnionFindReset"));
+  }
+
+  size_t size() const { return parents.size(); }
+
+  bool isRep(index_type x) const { return parent(x) == x; }
+
+  //! Root of the set of x, without compressing the path
+  index_type findNoCompress(index_type x) const {
+    index_type p;
+    while ((p = parent(x)) != x)
+      x = p;
+    return x;
+  }
+
+  //! Root of the set of x, compressing the path on the way
+  index_type find(index_type x) {
+    switch (Compression) {
+    case PathCompression::None:
+      return findNoCompress(x);
+    case PathCompression::Splitting:
+      while (true) {
+        index_type p  = parent(x);
+        index_type gp = parent(p);
+        if (p == gp)
+          return p;
+        setParent(x, gp);
+        x = p;
+      }
+    case PathCompression::Halving:
+      while (true) {
+        index_type p  = parent(x);
+        index_type gp = parent(p);
+        if (p == gp)
+          return p;
+        setParent(x, gp);
+        x = gp;
+      }
+    case PathCompression::Full:
+    default: {
+      index_type root = findNoCompress(x);
+      while (x != root) {
+        index_type p = parent(x);
+        setParent(x, root);
+        x = p;
+      }
+      return root;
+    }
+    }
+  }
+
+  /**
+   * Merges the sets of a and b.
+   *
+   * @returns true if they were different sets
+   */
+  bool unite(index_type a, index_type b) {
+    while (true) {
+      a = find(a);
+      b = find(b);
+      if (a == b)
+        return false;
+      if (a < b)
+        std::swap(a, b);
+      // a > b: a may have been linked since find; retry then
+      if (__sync_bool_compare_and_swap(&parents[a], a, b))
+        return true;
+    }
+  }
+
+  /**
+   * Merges the endpoints of every edge of edges in parallel.
+   *
+   * @param edges range of pairs (or tuples) of indices
+   * @returns number of merges, i.e., by how much the number of sets dropped
+   */
+  template <typename EdgeRange>
+  size_t unite(EdgeRange& edges) {
+    GAccumulator<size_t> merges;
+    galois::do_all(
+        galois::iterate(edges),
+        [&](const auto& e) {
+          if (unite(std::get<0>(e), std::get<1>(e)))
+            merges += 1;
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("UnionFindUnite"));
+    return merges.reduce();
+  }
+
+  bool same(index_type a, index_type b) { return find(a) == find(b); }
+
+  //! Points every element directly to its root; not safe during unite
+  void compress() {
+    galois::do_all(
+        galois::iterate(size_t{0}, parents.size()),
+        [&](size_t x) { setParent(x, findNoCompress(x)); }, galois::steal(),
+        galois::no_stats(), galois::loopname("UnionFindCompress"));
+  }
+
+  //! Parent of x, which is its root after compress
+  index_type component(index_type x) const { return parent(x); }
+};
+
+} // namespace galois
+
+#endif
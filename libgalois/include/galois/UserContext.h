@@ -101,8 +101,13 @@ public:
     this->push(std::forward<Args>(args)...);
   }
 
-  //! Force the abort of this iteration
-  void abort() { galois::runtime::signalConflict(); }
+  //! Force the abort of this iteration. In loops with galois::no_exceptions,
+  //! the operator continues and should return without further writes.
+  void abort() { galois::runtime::abortIteration(); }
+
+  //! In loops with galois::no_exceptions, true once the iteration has lost a
+  //! conflict; the operator should then return without writing shared data
+  bool isConflicted() const { return galois::runtime::isConflicted(); }
 
   //! Store and retrieve local state for deterministic
   template <typename LS>
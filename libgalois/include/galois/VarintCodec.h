@@ -0,0 +1,73 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_VARINTCODEC_H
+#define GALOIS_VARINTCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "galois/config.h"
+
+namespace galois {
+
+/**
+ * Byte-aligned LEB128 varints: 7 bits of payload per byte, with the high bit
+ * set on every byte but the last.
+ */
+struct VarintCodec {
+  static size_t size(uint64_t v) {
+    size_t n = 1;
+    for (; v >= 0x80; v >>= 7) {
+      ++n;
+    }
+    return n;
+  }
+
+  static uint8_t* encode(uint64_t v, uint8_t* out) {
+    for (; v >= 0x80; v >>= 7) {
+      *out++ = static_cast<uint8_t>(v) | 0x80;
+    }
+    *out++ = static_cast<uint8_t>(v);
+    return out;
+  }
+
+  static const uint8_t* decode(const uint8_t* in, uint64_t& v) {
+    uint64_t b = *in++;
+    v          = b & 0x7F;
+    for (unsigned shift = 7; b & 0x80; shift += 7) {
+      b = *in++;
+      v |= (b & 0x7F) << shift;
+    }
+    return in;
+  }
+
+  //! Maps signed values of small magnitude to small unsigned values
+  static uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+  }
+
+  static int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+  }
+};
+
+} // namespace galois
+
+#endif
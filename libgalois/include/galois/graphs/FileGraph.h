@@ -712,6 +712,12 @@ public:
     outIdx[id] += delta;
   }
 
+  //! Increments degree of id by delta; may be called concurrently
+  void incrementDegreeAtomic(size_t id, uint64_t delta = 1) {
+    assert(id < numNodes);
+    __sync_fetch_and_add(&outIdx[id], delta);
+  }
+
   //! Marks the transition to next phase of parsing, adding edges
   void phase2();
 
@@ -739,6 +745,32 @@ public:
     return idx;
   }
 
+  //! Adds a neighbor between src and dst; may be called concurrently, in
+  //! which case the order of the neighbors of a node is arbitrary
+  size_t addNeighborAtomic(size_t src, size_t dst) {
+    size_t base = src ? outIdx[src - 1] : 0;
+    size_t idx  = base + __sync_fetch_and_add(&starts[src], 1);
+    assert(idx < outIdx[src]);
+
+    if (numNodes <= std::numeric_limits<uint32_t>::max())
+      reinterpret_cast<uint32_t*>(outs)[idx] = dst; // version 1
+    else
+      reinterpret_cast<uint64_t*>(outs)[idx] = dst; // version 2
+    return idx;
+  }
+
+  //! Adds a neighbor between src and dst w/ corresponding data; may be called
+  //! concurrently
+  template <typename T>
+  size_t addNeighborAtomic(
+      size_t src, size_t dst,
+      const typename std::enable_if<!std::is_void<T>::value, T>::type& data) {
+    assert(edgeData);
+    size_t idx                          = addNeighborAtomic(src, dst);
+    reinterpret_cast<T*>(edgeData)[idx] = data;
+    return idx;
+  }
+
   /**
    * Finish making graph.
    */
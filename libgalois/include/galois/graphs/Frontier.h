@@ -0,0 +1,373 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPHS_FRONTIER_H
+#define GALOIS_GRAPHS_FRONTIER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "galois/Bag.h"
+#include "galois/DynamicBitset.h"
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+#include "galois/config.h"
+
+namespace galois {
+namespace graphs {
+
+namespace internal {
+template <typename GraphTy, typename FnTy>
+struct EdgeMapImpl;
+} // namespace internal
+
+/**
+ * Set of active nodes for level-synchronous graph algorithms.
+ *
+ * A frontier is either sparse, a list of its nodes, or dense, a bitmap over
+ * all nodes. The bitmap is kept up to date in both cases, so membership tests
+ * are always cheap and a node pushed twice is only added once; the list is
+ * dropped while dense. Sparse frontiers suit operators that iterate over the
+ * active nodes, dense ones operators that iterate over all nodes and test for
+ * membership. See edgeMap, which picks between the two every round.
+ */
+class Frontier {
+public:
+  using GraphNode = uint32_t;
+
+private:
+  DynamicBitSet bits;
+  InsertBag<GraphNode> list;
+  GAccumulator<size_t> count;
+  bool dense = false;
+
+  // Set by edgeMap on its output to decide the direction of the next round
+  template <typename GraphTy, typename FnTy>
+  friend struct internal::EdgeMapImpl;
+  bool pulled       = false;
+  size_t parentSize = 0;
+  // out-edges of the nodes, valid while the frontier has outEdgesSize nodes
+  size_t outEdges     = 0;
+  size_t outEdgesSize = ~size_t(0);
+  // edges the traversal has not pushed along yet; ~0 for all of them, which
+  // is where a frontier filled by the user starts
+  size_t unexploredEdges = ~size_t(0);
+
+  void clearBits() {
+    if (dense) {
+      bits.reset();
+    } else {
+      auto& words = bits.get_vec();
+      // several threads may zero a word; they all store the same value
+      galois::do_all(
+          galois::iterate(list),
+          [&](GraphNode n) { words[n / 64] = 0; }, galois::no_stats(),
+          galois::loopname("FrontierClear"));
+    }
+  }
+
+public:
+  //! Empty sparse frontier over nodes [0, numNodes)
+  explicit Frontier(size_t numNodes = 0) { bits.resize(numNodes); }
+
+  Frontier(const Frontier&) = delete;
+  Frontier& operator=(const Frontier&) = delete;
+
+  //! Number of nodes the frontier can hold
+  size_t capacity() const { return bits.size(); }
+
+  //! Changes the capacity and empties the frontier
+  void resize(size_t numNodes) {
+    list.clear();
+    bits.resize(numNodes);
+    bits.reset();
+    count.reset();
+    dense           = false;
+    pulled          = false;
+    outEdgesSize    = ~size_t(0);
+    unexploredEdges = ~size_t(0);
+  }
+
+  /**
+   * Adds n to the frontier. May be called concurrently.
+   *
+   * @returns true if n was not in the frontier yet
+   */
+  bool push(GraphNode n) {
+    if (bits.set(n))
+      return false;
+    if (!dense)
+      list.push(n);
+    count += 1;
+    return true;
+  }
+
+  //! Returns true if n is in the frontier
+  bool contains(GraphNode n) const { return bits.test(n); }
+
+  //! Number of nodes in the frontier; not safe during concurrent pushes
+  size_t size() { return count.reduce(); }
+
+  bool empty() { return size() == 0; }
+
+  bool isDense() const { return dense; }
+
+  //! Bitmap of the frontier, valid in both representations
+  const DynamicBitSet& bitset() const { return bits; }
+
+  //! Nodes of the frontier; only valid while sparse
+  const InsertBag<GraphNode>& nodes() const {
+    assert(!dense);
+    return list;
+  }
+
+  //! Switches to the dense representation
+  void toDense() {
+    if (dense)
+      return;
+    list.clear();
+    dense = true;
+  }
+
+  //! Switches to the sparse representation, collecting the nodes from the
+  //! bitmap in parallel
+  void toSparse() {
+    if (!dense)
+      return;
+    bits.for_each_set_bit([&](size_t n) { list.push(GraphNode(n)); });
+    dense = false;
+  }
+
+  //! Removes all nodes; costs the size of the frontier while sparse. The
+  //! frontier becomes sparse.
+  void clear() {
+    clearBits();
+    list.clear();
+    count.reset();
+    dense           = false;
+    pulled          = false;
+    outEdgesSize    = ~size_t(0);
+    unexploredEdges = ~size_t(0);
+  }
+
+  //! Adds every node, which makes the frontier dense
+  void fill() {
+    list.clear();
+    dense       = true;
+    auto& words = bits.get_vec();
+    size_t n    = bits.size();
+    galois::do_all(
+        galois::iterate(size_t{0}, words.size()),
+        [&](size_t i) {
+          size_t left = n - i * 64;
+          words[i]    = left >= 64 ? ~uint64_t(0) : (uint64_t(1) << left) - 1;
+        },
+        galois::no_stats(), galois::loopname("FrontierFill"));
+    count.reset();
+    count += n;
+    pulled          = false;
+    outEdgesSize    = ~size_t(0);
+    unexploredEdges = ~size_t(0);
+  }
+
+  //! Calls fn(n) on every node n of the frontier in parallel, in either
+  //! representation
+  template <typename FnTy>
+  void forEach(const FnTy& fn, const char* loopname = "FrontierForEach") {
+    if (!dense) {
+      galois::do_all(galois::iterate(list), fn, galois::steal(),
+                     galois::loopname(loopname));
+      return;
+    }
+    bits.for_each_set_bit([&](size_t n) { fn(GraphNode(n)); }, loopname);
+  }
+};
+
+//! Thresholds and graph properties used by edgeMap
+struct EdgeMapOptions {
+  //! Pull once the out-edges of the frontier exceed 1/alpha of the edges the
+  //! traversal has not pushed along yet
+  unsigned alpha = 15;
+  //! After pulling, keep pulling while the frontier grows or holds more than
+  //! 1/beta of all nodes
+  unsigned beta = 18;
+  //! If the graph is symmetric, out-edges double as in-edges for pulling;
+  //! graphs with in_edges (e.g., LC_CSR_CSC_Graph) can always pull
+  bool symmetric = false;
+  //! Name of the loops for statistics
+  const char* loopname = "EdgeMap";
+};
+
+namespace internal {
+
+template <typename GraphTy, typename = void>
+struct HasInEdges : std::false_type {};
+
+template <typename GraphTy>
+struct HasInEdges<GraphTy,
+                  std::void_t<decltype(std::declval<GraphTy&>().getInEdgeDst(
+                      *std::declval<GraphTy&>()
+                           .in_edges(typename GraphTy::GraphNode())
+                           .begin()))>> : std::true_type {};
+
+template <typename GraphTy, typename FnTy>
+struct EdgeMapImpl {
+  using GNode = typename GraphTy::GraphNode;
+  constexpr static bool HasInEdges = internal::HasInEdges<GraphTy>::value;
+  constexpr static galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+
+  GraphTy& graph;
+  FnTy& fn;
+  const EdgeMapOptions& options;
+
+  // getDegree rather than an iterator distance, which decodes the edges of
+  // compressed graphs
+  size_t outDegree(GNode n) { return graph.getDegree(n); }
+
+  size_t frontierEdges(Frontier& in) {
+    if (in.outEdgesSize == in.size())
+      return in.outEdges;
+    GAccumulator<size_t> edges;
+    in.forEach([&](GNode n) { edges += outDegree(n); }, "EdgeMapScout");
+    in.outEdges     = edges.reduce();
+    in.outEdgesSize = in.size();
+    return in.outEdges;
+  }
+
+  size_t unexploredEdges(Frontier& in) {
+    return in.unexploredEdges == ~size_t(0) ? graph.sizeEdges()
+                                            : in.unexploredEdges;
+  }
+
+  bool choosePull(Frontier& in) {
+    if (!HasInEdges && !options.symmetric)
+      return false;
+    size_t size = in.size();
+    if (in.pulled)
+      return size >= in.parentSize || size > graph.size() / options.beta;
+    return frontierEdges(in) + size > unexploredEdges(in) / options.alpha;
+  }
+
+  void push(Frontier& in, Frontier& out) {
+    GAccumulator<size_t> edges;
+    in.toSparse();
+    galois::do_all(
+        galois::iterate(in.list),
+        [&](GNode src) {
+          for (auto e : graph.edges(src, flag)) {
+            GNode dst = graph.getEdgeDst(e);
+            if (fn.cond(dst) && fn.updateAtomic(src, dst) && out.push(dst))
+              edges += outDegree(dst);
+          }
+        },
+        galois::steal(), galois::chunk_size<64>(),
+        galois::loopname(options.loopname));
+    out.outEdges     = edges.reduce();
+    out.outEdgesSize = out.size();
+  }
+
+  template <typename EdgesFn, typename DstFn>
+  void pullWith(Frontier& in, Frontier& out, const EdgesFn& edgesOf,
+                const DstFn& srcOf) {
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode dst) {
+          if (!fn.cond(dst))
+            return;
+          for (auto e : edgesOf(dst)) {
+            GNode src = srcOf(e);
+            if (in.contains(src) && fn.update(src, dst)) {
+              out.push(dst);
+              if (!fn.cond(dst))
+                break;
+            }
+          }
+        },
+        galois::steal(), galois::chunk_size<64>(),
+        galois::loopname(options.loopname));
+  }
+
+  void pull(Frontier& in, Frontier& out) {
+    out.toDense();
+    if constexpr (HasInEdges) {
+      pullWith(
+          in, out, [&](GNode n) { return graph.in_edges(n, flag); },
+          [&](auto e) { return graph.getInEdgeDst(e); });
+    } else {
+      pullWith(
+          in, out, [&](GNode n) { return graph.edges(n, flag); },
+          [&](auto e) { return graph.getEdgeDst(e); });
+    }
+  }
+
+  void operator()(Frontier& in, Frontier& out) {
+    bool usePull      = choosePull(in);
+    size_t unexplored = unexploredEdges(in);
+    out.clear();
+    if (usePull) {
+      pull(in, out);
+    } else {
+      // as in Beamer et al.: pushing explores the out-edges of the frontier
+      unexplored -= std::min(unexplored, frontierEdges(in));
+      push(in, out);
+    }
+    out.pulled          = usePull;
+    out.parentSize      = in.size();
+    out.unexploredEdges = unexplored;
+  }
+};
+
+} // namespace internal
+
+/**
+ * Applies fn to the edges leaving the frontier in and collects the
+ * destinations it activates in out, in the style of Ligra's edgeMap.
+ *
+ * The direction is chosen every call: small frontiers push along the
+ * out-edges of their nodes, large ones pull, i.e., every node whose
+ * fn.cond holds scans its in-edges for nodes of the frontier. Pulling
+ * needs in-edges, so it is only used when the graph provides them or
+ * options.symmetric is set. Dense frontiers are converted to sparse ones in
+ * parallel before pushing; pulled frontiers are produced dense.
+ *
+ * fn must provide:
+ *   - bool cond(dst): false once dst needs no more updates; pulling stops
+ *     scanning the in-edges of dst as soon as it is false
+ *   - bool update(src, dst): called while pulling, by one thread per dst;
+ *     returns true if dst should be in the next frontier
+ *   - bool updateAtomic(src, dst): called while pushing, possibly
+ *     concurrently for the same dst
+ *
+ * @param in frontier to expand; may be converted between representations
+ * @param out next frontier; its previous contents are discarded
+ */
+template <typename GraphTy, typename FnTy>
+void edgeMap(GraphTy& graph, Frontier& in, Frontier& out, FnTy& fn,
+             const EdgeMapOptions& options = EdgeMapOptions()) {
+  assert(&in != &out);
+  internal::EdgeMapImpl<GraphTy, FnTy>{graph, fn, options}(in, out);
+}
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPHS_GRAPHCACHE_H
+#define GALOIS_GRAPHS_GRAPHCACHE_H
+
+#include <string>
+#include <type_traits>
+
+#include "galois/config.h"
+#include "galois/graphs/FileGraph.h"
+#include "galois/graphs/ReadGraph.h"
+
+namespace galois {
+namespace graphs {
+
+/**
+ * Preprocessing steps to apply to a graph file when loading it. Steps are
+ * applied in the order they are listed here, whatever order they are combined
+ * in.
+ */
+enum GraphTransform : unsigned {
+  //! Adds the reverse of every edge that is not a self loop
+  Symmetrize = 1 << 0,
+  //! Reverses every edge
+  Transpose = 1 << 1,
+  //! Renumbers nodes by decreasing out-degree (node 0 has the largest)
+  RelabelByDegree = 1 << 2,
+  //! Keeps only the edges from a node of lower to one of higher degree, ties
+  //! broken by id, which turns a symmetric graph into a DAG; self loops are
+  //! dropped
+  OrientByDegree = 1 << 4,
+  //! Keeps only the edges from a lower to a higher node id
+  OrientById = 1 << 5,
+  //! Keeps only the edges from a node to those after it in a degeneracy order
+  //! (repeatedly removing a node of minimum degree), so no node has more
+  //! out-edges than the core number of the graph
+  OrientByCore = 1 << 6,
+  //! Sorts the edges of every node by destination
+  SortByDst = 1 << 3,
+};
+
+/**
+ * Loads the graph in filename with transforms applied. At most one Orient
+ * transform may be given.
+ *
+ * The transformed graph is cached in filename.cache/<key>.gr, where key
+ * hashes the transforms and the identity of filename (size, modification
+ * time, header), so that later loads mmap the cached file instead of
+ * preprocessing again. On a miss the graph is transformed in parallel and
+ * the cache written if possible. Hits and misses are reported as the Hits and
+ * Misses statistics of the GraphCache region.
+ *
+ * The GALOIS_GRAPH_CACHE environment variable controls the cache: 0 disables
+ * it; any other value is a directory to keep cached files in instead of next
+ * to the input.
+ *
+ * @param out graph to load into; the previous graph is destroyed
+ * @param filename graph file to load
+ * @param transforms bitwise or of GraphTransform values
+ * @param keepEdgeData if false, edge data is dropped from the loaded graph
+ */
+void fromFileCached(FileGraph& out, const std::string& filename,
+                    unsigned transforms, bool keepEdgeData = true);
+
+/**
+ * Reads a graph from a file with transforms applied, using the cache of
+ * fromFileCached.
+ *
+ * @param graph graph to read into
+ * @param filename graph file to read
+ * @param transforms bitwise or of GraphTransform values
+ * @param readUnweighted if true, edge data of the file is not read
+ */
+template <typename GraphTy>
+void readGraphCached(GraphTy& graph, const std::string& filename,
+                     unsigned transforms, bool readUnweighted = false) {
+  FileGraph f;
+  fromFileCached(
+      f, filename, transforms,
+      !readUnweighted &&
+          !std::is_void<typename GraphTy::file_edge_data_type>::value);
+  readGraph(graph, f, readUnweighted);
+}
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -224,6 +224,54 @@ auto divideNodesBinarySearch(
       EdgeRange(edge_iterator(edgesLower), edge_iterator(edgesUpper)));
 }
 
+/**
+ * Node ranges of a graph divided among threads so that every thread gets
+ * about the same weight of nodes and edges: thread i owns
+ * [ranges[i], ranges[i + 1]). The last division is cached, so graphs keep one
+ * of these and clear it whenever their edge prefix sum changes.
+ */
+class EdgeBalancedRanges {
+  size_t threads    = 0;
+  size_t nodeWeight = 0;
+  size_t edgeWeight = 0;
+  std::vector<uint32_t> begins;
+
+public:
+  void clear() { begins.clear(); }
+
+  /**
+   * Returns the node each of total threads begins at, followed by numNodes.
+   *
+   * @param edgePrefixSum prefix sum of the edges in the graph
+   * @param nodeWeight weight to give to a node in division
+   * @param edgeWeight weight to give to an edge in division
+   * @returns array of total + 1 node ids
+   */
+  template <typename PrefixSumType>
+  const uint32_t* get(uint64_t numNodes, uint64_t numEdges,
+                      PrefixSumType& edgePrefixSum, size_t total,
+                      size_t nodeWeight, size_t edgeWeight) {
+    if (!begins.empty() && threads == total &&
+        this->nodeWeight == nodeWeight && this->edgeWeight == edgeWeight) {
+      return begins.data();
+    }
+
+    threads          = total;
+    this->nodeWeight = nodeWeight;
+    this->edgeWeight = edgeWeight;
+    begins.assign(total + 1, 0);
+    for (size_t tid = 0; tid + 1 < total; ++tid) {
+      auto nodes = divideNodesBinarySearch(numNodes, numEdges, nodeWeight,
+                                           edgeWeight, tid, total,
+                                           edgePrefixSum)
+                       .first;
+      begins[tid + 1] = *nodes.second;
+    }
+    begins[total] = numNodes;
+    return begins.data();
+  }
+};
+
 // second internal namespace
 namespace internal {
 
@@ -0,0 +1,103 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPHS_INTERSECT_H
+#define GALOIS_GRAPHS_INTERSECT_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "galois/MethodFlags.h"
+#include "galois/config.h"
+
+namespace galois {
+namespace graphs {
+
+/**
+ * Implementations of sorted set intersection. The fastest one supported by
+ * the CPU is chosen at runtime.
+ */
+enum class IntersectKernel {
+  //! Branch-free merge
+  Scalar,
+  //! Merge comparing blocks of 8 values with AVX2
+  AVX2,
+  //! Merge comparing blocks of 16 values with AVX-512
+  AVX512,
+};
+
+//! Fastest kernel supported by this CPU
+IntersectKernel bestIntersectKernel();
+
+//! Returns true if kernel can run on this CPU
+bool isSupported(IntersectKernel kernel);
+
+/**
+ * Counts the values in both [a, a + na) and [b, b + nb). Both ranges must be
+ * strictly increasing.
+ *
+ * When one range is much shorter than the other, the values of the short
+ * range are searched for in the long one (galloping) instead of merging.
+ */
+size_t intersectCount(const uint32_t* a, size_t na, const uint32_t* b,
+                      size_t nb);
+
+//! Like intersectCount but always merges with the given kernel, which must be
+//! supported
+size_t intersectCount(IntersectKernel kernel, const uint32_t* a, size_t na,
+                      const uint32_t* b, size_t nb);
+
+/**
+ * Counts the values of [b, b + nb) whose bits are set in bits. Useful when a
+ * high degree node is intersected with many others: its neighbors are set in
+ * the bitmap once and each intersection costs only the size of the other
+ * range.
+ */
+size_t intersectCount(const uint64_t* bits, const uint32_t* b, size_t nb);
+
+/**
+ * Counts the common destinations of two ranges of edges of a CSR graph,
+ * e.g., LC_CSR_Graph. The edges of each range must be sorted by destination
+ * without duplicates.
+ */
+template <typename GraphTy>
+size_t countCommonNeighbors(const GraphTy& g,
+                            typename GraphTy::edge_iterator aa,
+                            typename GraphTy::edge_iterator ea,
+                            typename GraphTy::edge_iterator bb,
+                            typename GraphTy::edge_iterator eb) {
+  const uint32_t* dsts = g.getEdgeDsts();
+  return intersectCount(dsts + *aa, ea - aa, dsts + *bb, eb - bb);
+}
+
+//! Counts the common neighbors of nodes a and b of a CSR graph whose edges
+//! are sorted by destination
+template <typename GraphTy>
+size_t countCommonNeighbors(GraphTy& g, typename GraphTy::GraphNode a,
+                            typename GraphTy::GraphNode b) {
+  return countCommonNeighbors(g, g.edge_begin(a, MethodFlag::UNPROTECTED),
+                              g.edge_end(a, MethodFlag::UNPROTECTED),
+                              g.edge_begin(b, MethodFlag::UNPROTECTED),
+                              g.edge_end(b, MethodFlag::UNPROTECTED));
+}
+
+} // namespace graphs
+} // namespace galois
+
+#endif
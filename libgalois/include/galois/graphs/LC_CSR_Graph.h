@@ -22,6 +22,7 @@
 
 #include <fstream>
 #include <type_traits>
+#include <vector>
 
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
@@ -34,7 +35,9 @@
 #include "galois/graphs/Details.h"
 #include "galois/graphs/FileGraph.h"
 #include "galois/graphs/GraphHelpers.h"
+#include "galois/ParallelSTL.h"
 #include "galois/PODResizeableArray.h"
+#include "galois/PlacementPolicy.h"
 
 namespace galois::graphs {
 /**
@@ -165,6 +168,9 @@ protected:
   uint64_t numNodes;
   uint64_t numEdges;
 
+  //! Thread ranges of the last getEdgeBalancedRanges
+  mutable EdgeBalancedRanges balancedRanges;
+
   typedef internal::EdgeSortIterator<
       GraphNode, typename EdgeIndData::value_type, EdgeDst, EdgeData>
       edge_sort_iterator;
@@ -222,6 +228,23 @@ protected:
 
   GraphNode getNode(size_t n) { return n; }
 
+  //! Default placement of the graph arrays; roles may override it
+  static PlacementPolicy placement() {
+    return PlacementPolicy(UseNumaAlloc ? PlacementPolicy::Blocked
+                                        : PlacementPolicy::Interleaved);
+  }
+
+  //! Allocates the node and edge arrays for numNodes and numEdges
+  void allocateArrays() {
+    //! [numaallocex]
+    nodeData.allocateForRole(numNodes, "nodeData", placement());
+    edgeIndData.allocateForRole(numNodes, "edgeIndData", placement());
+    edgeDst.allocateForRole(numEdges, "edgeDst", placement());
+    edgeData.allocateForRole(numEdges, "edgeData", placement());
+    //! [numaallocex]
+    balancedRanges.clear();
+  }
+
 private:
   friend class boost::serialization::access;
 
@@ -240,6 +263,7 @@ private:
   void load(Archive& ar, const unsigned int) {
     ar >> numNodes;
     ar >> numEdges;
+    balancedRanges.clear();
 
     // Large Arrays
     ar >> edgeIndData;
@@ -247,11 +271,10 @@ private:
     ar >> edgeData;
 
     if (!nodeData.data()) {
+      nodeData.allocateForRole(numNodes, "nodeData", placement());
       if (UseNumaAlloc) {
-        nodeData.allocateBlocked(numNodes);
         this->outOfLineAllocateBlocked(numNodes);
       } else {
-        nodeData.allocateInterleaved(numNodes);
         this->outOfLineAllocateInterleaved(numNodes);
       }
 
@@ -317,6 +340,7 @@ public:
   void deSerializeGraph(boost::archive::binary_iarchive& ar) {
     ar >> numNodes;
     ar >> numEdges;
+    balancedRanges.clear();
 
     // Large Arrays
     ar >> nodeData;
@@ -342,19 +366,10 @@ public:
   LC_CSR_Graph(uint32_t _numNodes, uint64_t _numEdges, EdgeNumFnTy edgeNum,
                EdgeDstFnTy _edgeDst, EdgeDataFnTy _edgeData)
       : numNodes(_numNodes), numEdges(_numEdges) {
+    allocateArrays();
     if (UseNumaAlloc) {
-      //! [numaallocex]
-      nodeData.allocateBlocked(numNodes);
-      edgeIndData.allocateBlocked(numNodes);
-      edgeDst.allocateBlocked(numEdges);
-      edgeData.allocateBlocked(numEdges);
-      //! [numaallocex]
-      this->outOfLineAllocateBlocked(numNodes, false);
+      this->outOfLineAllocateBlocked(numNodes);
     } else {
-      nodeData.allocateInterleaved(numNodes);
-      edgeIndData.allocateInterleaved(numNodes);
-      edgeDst.allocateInterleaved(numEdges);
-      edgeData.allocateInterleaved(numEdges);
       this->outOfLineAllocateInterleaved(numNodes);
     }
     for (size_t n = 0; n < numNodes; ++n) {
@@ -402,6 +417,9 @@ public:
 
   GraphNode getEdgeDst(edge_iterator ni) { return edgeDst[*ni]; }
 
+  //! Destinations of all edges, indexed by *edge_iterator
+  const uint32_t* getEdgeDsts() const { return edgeDst.data(); }
+
   size_t size() const { return numNodes; }
   size_t sizeEdges() const { return numEdges; }
 
@@ -515,17 +533,10 @@ public:
   void allocateFrom(const FileGraph& graph) {
     numNodes = graph.size();
     numEdges = graph.sizeEdges();
+    allocateArrays();
     if (UseNumaAlloc) {
-      nodeData.allocateBlocked(numNodes);
-      edgeIndData.allocateBlocked(numNodes);
-      edgeDst.allocateBlocked(numEdges);
-      edgeData.allocateBlocked(numEdges);
       this->outOfLineAllocateBlocked(numNodes);
     } else {
-      nodeData.allocateInterleaved(numNodes);
-      edgeIndData.allocateInterleaved(numNodes);
-      edgeDst.allocateInterleaved(numEdges);
-      edgeData.allocateInterleaved(numEdges);
       this->outOfLineAllocateInterleaved(numNodes);
     }
   }
@@ -534,17 +545,10 @@ public:
     numNodes = nNodes;
     numEdges = nEdges;
 
+    allocateArrays();
     if (UseNumaAlloc) {
-      nodeData.allocateBlocked(numNodes);
-      edgeIndData.allocateBlocked(numNodes);
-      edgeDst.allocateBlocked(numEdges);
-      edgeData.allocateBlocked(numEdges);
       this->outOfLineAllocateBlocked(numNodes);
     } else {
-      nodeData.allocateInterleaved(numNodes);
-      edgeIndData.allocateInterleaved(numNodes);
-      edgeDst.allocateInterleaved(numEdges);
-      edgeData.allocateInterleaved(numEdges);
       this->outOfLineAllocateInterleaved(numNodes);
     }
   }
@@ -554,17 +558,10 @@ public:
     numEdges = nEdges;
 
     deallocate();
+    allocateArrays();
     if (UseNumaAlloc) {
-      nodeData.allocateBlocked(numNodes);
-      edgeIndData.allocateBlocked(numNodes);
-      edgeDst.allocateBlocked(numEdges);
-      edgeData.allocateBlocked(numEdges);
       this->outOfLineAllocateBlocked(numNodes);
     } else {
-      nodeData.allocateInterleaved(numNodes);
-      edgeIndData.allocateInterleaved(numNodes);
-      edgeDst.allocateInterleaved(numEdges);
-      edgeData.allocateInterleaved(numEdges);
       this->outOfLineAllocateInterleaved(numNodes);
     }
   }
@@ -617,23 +614,17 @@ public:
   void transpose(const char* regionName = NULL) {
     galois::StatTimer timer("TIMER_GRAPH_TRANSPOSE", regionName);
     timer.start();
+    balancedRanges.clear();
 
     EdgeDst edgeDst_old;
     EdgeData edgeData_new;
     EdgeIndData edgeIndData_old;
     EdgeIndData edgeIndData_temp;
 
-    if (UseNumaAlloc) {
-      edgeIndData_old.allocateBlocked(numNodes);
-      edgeIndData_temp.allocateBlocked(numNodes);
-      edgeDst_old.allocateBlocked(numEdges);
-      edgeData_new.allocateBlocked(numEdges);
-    } else {
-      edgeIndData_old.allocateInterleaved(numNodes);
-      edgeIndData_temp.allocateInterleaved(numNodes);
-      edgeDst_old.allocateInterleaved(numEdges);
-      edgeData_new.allocateInterleaved(numEdges);
-    }
+    edgeIndData_old.allocateForRole(numNodes, "edgeIndData", placement());
+    edgeIndData_temp.allocateForRole(numNodes, "edgeIndData", placement());
+    edgeDst_old.allocateForRole(numEdges, "edgeDst", placement());
+    edgeData_new.allocateForRole(numEdges, "edgeData", placement());
 
     // Copy old node->index location + initialize the temp array
     galois::do_all(
@@ -656,17 +647,10 @@ public:
         },
         galois::no_stats(), galois::loopname("TRANSPOSE_EDGEINTDATA_INC"));
 
-    // TODO is it worth doing parallel prefix sum?
-    // prefix sum calculation of the edge index array
-    for (uint32_t n = 1; n < numNodes; ++n) {
-      edgeIndData_temp[n] += edgeIndData_temp[n - 1];
-    }
-
-    // copy over the new tranposed edge index data
-    galois::do_all(
-        galois::iterate(UINT64_C(0), numNodes),
-        [&](uint64_t n) { edgeIndData[n] = edgeIndData_temp[n]; },
-        galois::no_stats(), galois::loopname("TRANSPOSE_EDGEINTDATA_SET"));
+    // prefix sum of the counts is the new tranposed edge index data
+    galois::ParallelSTL::partial_sum(edgeIndData_temp.begin(),
+                                     edgeIndData_temp.begin() + numNodes,
+                                     edgeIndData.begin());
 
     // edgeIndData_temp[i] will now hold number of edges that all nodes
     // before the ith node have
@@ -800,6 +784,23 @@ public:
     return galois::graphs::divideNodesBinarySearch(
         numNodes, numEdges, nodeSize, edgeSize, id, total, edgeIndData);
   }
+
+  /**
+   * Returns the node each active thread begins at when the nodes are divided
+   * so that every thread gets about the same weight of nodes and edges:
+   * thread i owns [ranges[i], ranges[i + 1]). The division is cached on the
+   * graph until its arrays are reallocated or it is transposed.
+   *
+   * @param nodeWeight weight to give to a node in division
+   * @param edgeWeight weight to give to an edge in division
+   * @returns array of getActiveThreads() + 1 node ids
+   */
+  const uint32_t* getEdgeBalancedRanges(size_t nodeWeight = 1,
+                                        size_t edgeWeight = 1) const {
+    return balancedRanges.get(numNodes, numEdges, edgeIndData,
+                              galois::getActiveThreads(), nodeWeight,
+                              edgeWeight);
+  }
   /**
    *
    * custom allocator for vector<vector<>>
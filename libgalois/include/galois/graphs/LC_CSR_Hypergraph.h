@@ -33,6 +33,7 @@
 #include "galois/graphs/Details.h"
 #include "galois/graphs/FileGraph.h"
 #include "galois/graphs/GraphHelpers.h"
+#include "galois/ParallelSTL.h"
 #include "galois/PODResizeableArray.h"
 
 namespace galois {
@@ -641,17 +642,10 @@ public:
         },
         galois::no_stats(), galois::loopname("TRANSPOSE_EDGEINTDATA_INC"));
 
-    // TODO is it worth doing parallel prefix sum?
-    // prefix sum calculation of the edge index array
-    for (uint32_t n = 1; n < numNodes; ++n) {
-      edgeIndData_temp[n] += edgeIndData_temp[n - 1];
-    }
-
-    // copy over the new tranposed edge index data
-    galois::do_all(
-        galois::iterate(UINT64_C(0), numNodes),
-        [&](uint64_t n) { edgeIndData[n] = edgeIndData_temp[n]; },
-        galois::no_stats(), galois::loopname("TRANSPOSE_EDGEINTDATA_SET"));
+    // prefix sum of the counts is the new tranposed edge index data
+    galois::ParallelSTL::partial_sum(edgeIndData_temp.begin(),
+                                     edgeIndData_temp.begin() + numNodes,
+                                     edgeIndData.begin());
 
     // edgeIndData_temp[i] will now hold number of edges that all nodes
     // before the ith node have
@@ -0,0 +1,727 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPHS_LC_COMPRESSED_GRAPH_H
+#define GALOIS_GRAPHS_LC_COMPRESSED_GRAPH_H
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "galois/config.h"
+#include "galois/Galois.h"
+#include "galois/gstl.h"
+#include "galois/graphs/Details.h"
+#include "galois/graphs/FileGraph.h"
+#include "galois/graphs/GraphHelpers.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Reduction.h"
+#include "galois/VarintCodec.h"
+
+namespace galois::graphs {
+
+namespace internal {
+
+/**
+ * Edge iterator of {@link LC_Compressed_Graph}. Dereferences to the edge
+ * index, like the edge iterator of {@link LC_CSR_Graph}, and carries the
+ * destination of the current edge, which is decoded on increment.
+ *
+ * Decoding always reads one varint past the current edge. This stays in
+ * bounds because the encoded stream is a sequence of complete varints
+ * followed by a zero pad byte.
+ */
+class CompressedEdgeIterator
+    : public boost::iterator_facade<CompressedEdgeIterator, uint64_t,
+                                    boost::forward_traversal_tag, uint64_t> {
+  friend class boost::iterator_core_access;
+
+  const uint8_t* pos;
+  uint64_t idx;
+  uint32_t dst;
+
+  uint64_t dereference() const { return idx; }
+
+  bool equal(const CompressedEdgeIterator& other) const {
+    return idx == other.idx;
+  }
+
+  void increment() {
+    uint64_t gap;
+    pos = VarintCodec::decode(pos, gap);
+    dst += static_cast<uint32_t>(gap);
+    ++idx;
+  }
+
+public:
+  CompressedEdgeIterator() : pos(nullptr), idx(0), dst(0) {}
+
+  //! End iterator of a node whose last edge has index idx - 1
+  explicit CompressedEdgeIterator(uint64_t idx)
+      : pos(nullptr), idx(idx), dst(0) {}
+
+  /**
+   * Begin iterator of node src whose first edge has index idx and whose
+   * encoded adjacency list starts at pos.
+   */
+  CompressedEdgeIterator(const uint8_t* pos, uint64_t idx, uint32_t src)
+      : idx(idx) {
+    uint64_t first;
+    this->pos = VarintCodec::decode(pos, first);
+    dst       = src + static_cast<uint32_t>(VarintCodec::unzigzag(first));
+  }
+
+  uint32_t getDst() const { return dst; }
+};
+
+} // namespace internal
+
+/**
+ * Read-only local computation graph whose adjacency lists are compressed.
+ *
+ * Each node's out-neighbors are sorted by destination and stored as gaps in
+ * byte-aligned varints: the first neighbor relative to the node itself (zigzag
+ * encoded, since it may be smaller), and each subsequent one relative to the
+ * previous neighbor. Graphs with locality in their node numbering typically
+ * need 1-2 bytes per edge instead of 4. Edge data, if any, is stored
+ * uncompressed in the sorted edge order.
+ *
+ * The interface matches {@link LC_CSR_Graph} for traversal: edges(n),
+ * edge_begin/edge_end, getEdgeDst and getEdgeData. Edge iterators are forward
+ * iterators that decode as they advance, so getEdgeDst on an arbitrary edge
+ * index is not supported, and edges cannot be sorted or changed.
+ *
+ * Graphs can be read from a regular .gr file, which is compressed while
+ * loading, or from the compressed .vgr variant written by writeToVGRFile
+ * (or graph-convert -gr2vgr), which loads without re-encoding.
+ *
+ * @tparam NodeTy data on nodes
+ * @tparam EdgeTy data on out edges
+ */
+template <typename NodeTy, typename EdgeTy, bool HasNoLockable = false,
+          bool UseNumaAlloc = false, typename FileEdgeTy = EdgeTy>
+class LC_Compressed_Graph : private boost::noncopyable,
+                            private internal::LocalIteratorFeature<UseNumaAlloc> {
+public:
+  template <bool _has_id>
+  struct with_id {
+    typedef LC_Compressed_Graph type;
+  };
+
+  template <typename _node_data>
+  struct with_node_data {
+    typedef LC_Compressed_Graph<_node_data, EdgeTy, HasNoLockable,
+                                UseNumaAlloc, FileEdgeTy>
+        type;
+  };
+
+  template <typename _edge_data>
+  struct with_edge_data {
+    typedef LC_Compressed_Graph<NodeTy, _edge_data, HasNoLockable,
+                                UseNumaAlloc, FileEdgeTy>
+        type;
+  };
+
+  template <typename _file_edge_data>
+  struct with_file_edge_data {
+    typedef LC_Compressed_Graph<NodeTy, EdgeTy, HasNoLockable, UseNumaAlloc,
+                                _file_edge_data>
+        type;
+  };
+
+  //! If true, do not use abstract locks in graph
+  template <bool _has_no_lockable>
+  struct with_no_lockable {
+    typedef LC_Compressed_Graph<NodeTy, EdgeTy, _has_no_lockable,
+                                UseNumaAlloc, FileEdgeTy>
+        type;
+  };
+  template <bool _has_no_lockable>
+  using _with_no_lockable =
+      LC_Compressed_Graph<NodeTy, EdgeTy, _has_no_lockable, UseNumaAlloc,
+                          FileEdgeTy>;
+
+  //! If true, use NUMA-aware graph allocation; otherwise, use NUMA interleaved
+  //! allocation.
+  template <bool _use_numa_alloc>
+  struct with_numa_alloc {
+    typedef LC_Compressed_Graph<NodeTy, EdgeTy, HasNoLockable,
+                                _use_numa_alloc, FileEdgeTy>
+        type;
+  };
+  template <bool _use_numa_alloc>
+  using _with_numa_alloc =
+      LC_Compressed_Graph<NodeTy, EdgeTy, HasNoLockable, _use_numa_alloc,
+                          FileEdgeTy>;
+
+  typedef read_compressed_graph_tag read_tag;
+
+  //! Version number in the header of .vgr files; .gr files use 1 and 2
+  static constexpr uint64_t VGR_VERSION = 3;
+
+protected:
+  typedef LargeArray<EdgeTy> EdgeData;
+  typedef LargeArray<uint8_t> EdgeBytes;
+  typedef internal::NodeInfoBaseTypes<NodeTy, !HasNoLockable> NodeInfoTypes;
+  typedef internal::NodeInfoBase<NodeTy, !HasNoLockable> NodeInfo;
+  typedef LargeArray<uint64_t> EdgeIndData;
+  typedef LargeArray<uint32_t> EdgePosData;
+  typedef LargeArray<NodeInfo> NodeData;
+  typedef galois::VarintCodec Codec;
+
+  //! Whether edge data has to follow the destinations into sorted order
+  static constexpr bool HasFileEdgeData =
+      EdgeData::has_value && LargeArray<FileEdgeTy>::has_value;
+  //! (destination, position within its node) of a file edge
+  typedef std::pair<uint32_t, uint32_t> DstPos;
+  //! What allocateFrom sorts per node: positions are only needed to move
+  //! edge data
+  typedef typename std::conditional<HasFileEdgeData, DstPos, uint32_t>::type
+      SortedEdge;
+
+public:
+  typedef uint32_t GraphNode;
+  typedef EdgeTy edge_data_type;
+  typedef FileEdgeTy file_edge_data_type;
+  typedef NodeTy node_data_type;
+  typedef typename EdgeData::reference edge_data_reference;
+  typedef typename NodeInfoTypes::reference node_data_reference;
+  typedef internal::CompressedEdgeIterator edge_iterator;
+  using iterator = boost::counting_iterator<GraphNode>;
+  typedef iterator const_iterator;
+  typedef iterator local_iterator;
+  typedef iterator const_local_iterator;
+
+protected:
+  NodeData nodeData;
+  //! edgeIndData[n] is the index one past the last edge of n
+  EdgeIndData edgeIndData;
+  //! byteIndData[n] is the offset one past the encoded edges of n
+  EdgeIndData byteIndData;
+  EdgeBytes edgeBytes;
+  EdgeData edgeData;
+  //! Position within its node of the file edge of each edge in destination
+  //! order; only kept between allocateFrom and releaseFileEdges, and only
+  //! with edge data
+  EdgePosData filePositions;
+
+  uint64_t numNodes;
+  uint64_t numEdges;
+  //! size of edgeBytes, including the trailing pad byte
+  uint64_t numBytes;
+
+  //! Thread ranges of the last getEdgeBalancedRanges
+  mutable EdgeBalancedRanges balancedRanges;
+
+  uint64_t edgeStart(GraphNode N) const {
+    return (N == 0) ? 0 : edgeIndData[N - 1];
+  }
+
+  uint64_t byteStart(GraphNode N) const {
+    return (N == 0) ? 0 : byteIndData[N - 1];
+  }
+
+  edge_iterator raw_begin(GraphNode N) const {
+    return edge_iterator(edgeBytes.data() + byteStart(N), edgeStart(N), N);
+  }
+
+  edge_iterator raw_end(GraphNode N) const {
+    return edge_iterator(edgeIndData[N]);
+  }
+
+  template <bool _A1 = HasNoLockable>
+  void acquireNode(GraphNode N, MethodFlag mflag,
+                   typename std::enable_if<!_A1>::type* = 0) {
+    galois::runtime::acquire(&nodeData[N], mflag);
+  }
+
+  template <bool _A1 = HasNoLockable>
+  void acquireNode(GraphNode, MethodFlag,
+                   typename std::enable_if<_A1>::type* = 0) {}
+
+  template <bool _A1 = EdgeData::has_value,
+            bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void constructEdgeValue(FileGraph& graph, uint64_t e,
+                          typename FileGraph::edge_iterator nn,
+                          typename std::enable_if<!_A1 || _A2>::type* = 0) {
+    typedef LargeArray<FileEdgeTy> FED;
+    if (EdgeData::has_value)
+      edgeData.set(e, graph.getEdgeData<typename FED::value_type>(nn));
+  }
+
+  template <bool _A1 = EdgeData::has_value,
+            bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void constructEdgeValue(FileGraph&, uint64_t e, typename FileGraph::edge_iterator,
+                          typename std::enable_if<_A1 && !_A2>::type* = 0) {
+    edgeData.constructAt(e);
+  }
+
+  static uint32_t dstOf(uint32_t dst) { return dst; }
+  static uint32_t dstOf(const DstPos& e) { return e.first; }
+
+  static void addEdge(gstl::Vector<uint32_t>& sorted, uint32_t dst, uint32_t) {
+    sorted.push_back(dst);
+  }
+  static void addEdge(gstl::Vector<DstPos>& sorted, uint32_t dst,
+                      uint32_t pos) {
+    sorted.emplace_back(dst, pos);
+  }
+
+  //! Fills sorted with the edges of N in destination order
+  template <typename T>
+  static void sortedEdges(FileGraph& graph, GraphNode N,
+                          gstl::Vector<T>& sorted) {
+    sorted.clear();
+    uint32_t pos = 0;
+    for (FileGraph::edge_iterator nn = graph.edge_begin(N),
+                                  en = graph.edge_end(N);
+         nn != en; ++nn) {
+      addEdge(sorted, graph.getEdgeDst(nn), pos++);
+    }
+    std::sort(sorted.begin(), sorted.end());
+  }
+
+  //! Number of bytes needed to encode the sorted edges of N
+  template <typename T>
+  static uint64_t encodedSize(GraphNode N, const gstl::Vector<T>& sorted) {
+    uint64_t bytes = 0;
+    uint32_t prev  = N;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+      uint32_t dst = dstOf(sorted[i]);
+      bytes += (i == 0) ? Codec::size(Codec::zigzag(int64_t(dst) - prev))
+                        : Codec::size(dst - prev);
+      prev = dst;
+    }
+    return bytes;
+  }
+
+  //! Records the sorted order of the edges of a node starting at edge e
+  void keepPositions(uint64_t, const gstl::Vector<uint32_t>&) {}
+  void keepPositions(uint64_t e, const gstl::Vector<DstPos>& sorted) {
+    for (auto& s : sorted) {
+      filePositions[e++] = s.second;
+    }
+  }
+
+  void allocateArrays() {
+    balancedRanges.clear();
+    if (UseNumaAlloc) {
+      nodeData.allocateBlocked(numNodes);
+      edgeIndData.allocateBlocked(numNodes);
+      byteIndData.allocateBlocked(numNodes);
+      edgeData.allocateBlocked(numEdges);
+    } else {
+      nodeData.allocateInterleaved(numNodes);
+      edgeIndData.allocateInterleaved(numNodes);
+      byteIndData.allocateInterleaved(numNodes);
+      edgeData.allocateInterleaved(numEdges);
+    }
+  }
+
+  void allocateBytes() {
+    if (UseNumaAlloc) {
+      edgeBytes.allocateBlocked(numBytes);
+    } else {
+      edgeBytes.allocateInterleaved(numBytes);
+    }
+    // the stream always ends with the pad byte
+    assert(numBytes > 0);
+    edgeBytes[numBytes - 1] = 0;
+  }
+
+public:
+  LC_Compressed_Graph() : numNodes(0), numEdges(0), numBytes(0) {}
+
+  LC_Compressed_Graph(LC_Compressed_Graph&& rhs) = default;
+
+  LC_Compressed_Graph& operator=(LC_Compressed_Graph&&) = default;
+
+  node_data_reference getData(GraphNode N,
+                              MethodFlag mflag = MethodFlag::WRITE) {
+    NodeInfo& NI = nodeData[N];
+    acquireNode(N, mflag);
+    return NI.getData();
+  }
+
+  edge_data_reference
+  getEdgeData(const edge_iterator& ni,
+              MethodFlag GALOIS_UNUSED(mflag) = MethodFlag::UNPROTECTED) {
+    return edgeData[*ni];
+  }
+
+  GraphNode getEdgeDst(const edge_iterator& ni) const { return ni.getDst(); }
+
+  size_t size() const { return numNodes; }
+  size_t sizeEdges() const { return numEdges; }
+  //! Bytes used by the encoded adjacency lists
+  size_t sizeEdgeBytes() const { return numBytes; }
+
+  iterator begin() const { return iterator(0); }
+  iterator end() const { return iterator(numNodes); }
+
+  const_local_iterator local_begin() const {
+    return const_local_iterator(this->localBegin(numNodes));
+  }
+
+  const_local_iterator local_end() const {
+    return const_local_iterator(this->localEnd(numNodes));
+  }
+
+  local_iterator local_begin() {
+    return local_iterator(this->localBegin(numNodes));
+  }
+
+  local_iterator local_end() {
+    return local_iterator(this->localEnd(numNodes));
+  }
+
+  edge_iterator edge_begin(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    acquireNode(N, mflag);
+    if (!HasNoLockable && galois::runtime::shouldLock(mflag)) {
+      for (edge_iterator ii = raw_begin(N), ee = raw_end(N); ii != ee; ++ii) {
+        acquireNode(ii.getDst(), mflag);
+      }
+    }
+    return raw_begin(N);
+  }
+
+  edge_iterator edge_end(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    acquireNode(N, mflag);
+    return raw_end(N);
+  }
+
+  uint64_t getDegree(GraphNode N) const {
+    return edgeIndData[N] - edgeStart(N);
+  }
+
+  //! Neighbors are sorted, so the search stops at the first larger one
+  edge_iterator findEdge(GraphNode N1, GraphNode N2) {
+    edge_iterator ee = edge_end(N1);
+    for (edge_iterator ii = edge_begin(N1); ii != ee; ++ii) {
+      if (ii.getDst() >= N2) {
+        return (ii.getDst() == N2) ? ii : ee;
+      }
+    }
+    return ee;
+  }
+
+  edge_iterator findEdgeSortedByDst(GraphNode N1, GraphNode N2) {
+    return findEdge(N1, N2);
+  }
+
+  runtime::iterable<NoDerefIterator<edge_iterator>>
+  edges(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    return internal::make_no_deref_range(edge_begin(N, mflag),
+                                         edge_end(N, mflag));
+  }
+
+  runtime::iterable<NoDerefIterator<edge_iterator>>
+  out_edges(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    return edges(N, mflag);
+  }
+
+  /**
+   * Allocates the graph for a file graph. Unlike {@link LC_CSR_Graph}, this
+   * reads and sorts the adjacency lists to size the encoded edge array. With
+   * edge data, it keeps the sorted order as 4-byte positions within each node
+   * for constructFrom until releaseFileEdges; without, constructFrom sorts
+   * the destinations again.
+   */
+  void allocateFrom(FileGraph& graph) {
+    numNodes = graph.size();
+    numEdges = graph.sizeEdges();
+    allocateArrays();
+    if (HasFileEdgeData) {
+      if (UseNumaAlloc) {
+        filePositions.allocateBlocked(numEdges);
+      } else {
+        filePositions.allocateInterleaved(numEdges);
+      }
+    }
+
+    galois::substrate::PerThreadStorage<gstl::Vector<SortedEdge>> buffers;
+    galois::do_all(
+        galois::iterate(UINT64_C(0), numNodes),
+        [&](uint64_t n) {
+          auto& sorted = *buffers.getLocal();
+          sortedEdges(graph, n, sorted);
+          byteIndData[n] = encodedSize(n, sorted);
+          keepPositions(*graph.edge_begin(n), sorted);
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("COMPRESSED_EDGE_BYTES"));
+    galois::ParallelSTL::partial_sum(byteIndData.begin(),
+                                     byteIndData.begin() + numNodes,
+                                     byteIndData.begin());
+
+    numBytes = (numNodes ? byteIndData[numNodes - 1] : 0) + 1;
+    allocateBytes();
+  }
+
+  void constructFrom(FileGraph& graph, unsigned tid, unsigned total,
+                     const bool readUnweighted = false) {
+    // at this point memory should already be allocated
+    auto r = graph
+                 .divideByNode(NodeData::size_of::value +
+                                   2 * EdgeIndData::size_of::value,
+                               EdgeData::size_of::value + 2, tid, total)
+                 .first;
+
+    this->setLocalRange(*r.first, *r.second);
+
+    gstl::Vector<uint32_t> sorted;
+    for (FileGraph::iterator ii = r.first, ei = r.second; ii != ei; ++ii) {
+      GraphNode n = *ii;
+      nodeData.constructAt(n);
+      edgeIndData[n] = *graph.edge_end(n);
+
+      uint64_t begin = *graph.edge_begin(n);
+      if (!HasFileEdgeData) {
+        sortedEdges(graph, n, sorted);
+      }
+      uint8_t* out  = edgeBytes.data() + byteStart(n);
+      uint32_t prev = n;
+      for (uint64_t e = begin; e != edgeIndData[n]; ++e) {
+        uint32_t dst;
+        if (HasFileEdgeData) {
+          FileGraph::edge_iterator nn(begin + filePositions[e]);
+          dst = graph.getEdgeDst(nn);
+          if (readUnweighted) {
+            edgeData.constructAt(e);
+          } else {
+            constructEdgeValue(graph, e, nn);
+          }
+        } else {
+          dst = sorted[e - begin];
+          edgeData.constructAt(e);
+        }
+        out = (e == begin)
+                  ? Codec::encode(Codec::zigzag(int64_t(dst) - prev), out)
+                  : Codec::encode(dst - prev, out);
+        prev = dst;
+      }
+      assert(out == edgeBytes.data() + byteIndData[n]);
+    }
+  }
+
+  //! Frees the sorted edge order once every thread has run constructFrom
+  void releaseFileEdges() { filePositions.deallocate(); }
+
+  auto divideByNode(size_t nodeSize, size_t edgeSize, size_t id, size_t total) {
+    return galois::graphs::divideNodesBinarySearch(
+        numNodes, numEdges, nodeSize, edgeSize, id, total, edgeIndData);
+  }
+
+  /**
+   * Returns the node each active thread begins at when the nodes are divided
+   * so that every thread gets about the same weight of nodes and edges; see
+   * LC_CSR_Graph::getEdgeBalancedRanges. The division is cached until the
+   * graph is read again.
+   *
+   * @param nodeWeight weight to give to a node in division
+   * @param edgeWeight weight to give to an edge in division
+   * @returns array of getActiveThreads() + 1 node ids
+   */
+  const uint32_t* getEdgeBalancedRanges(size_t nodeWeight = 1,
+                                        size_t edgeWeight = 1) const {
+    return balancedRanges.get(numNodes, numEdges, edgeIndData,
+                              galois::getActiveThreads(), nodeWeight,
+                              edgeWeight);
+  }
+
+  void initializeLocalRanges() {
+    galois::on_each([&](unsigned tid, unsigned total) {
+      auto r = divideByNode(0, 1, tid, total).first;
+      this->setLocalRange(*r.first, *r.second);
+    });
+  }
+
+  //! Returns true if filename starts with a .vgr header
+  static bool isVGRFile(const std::string& filename) {
+    std::ifstream graphFile(filename.c_str());
+    uint64_t version = 0;
+    graphFile.read(reinterpret_cast<char*>(&version), sizeof(uint64_t));
+    return graphFile && version == VGR_VERSION;
+  }
+
+  /**
+   * Reads a .vgr file. The layout is the .gr header (version, size of edge
+   * data, number of nodes, number of edges) followed by the number of encoded
+   * bytes, the edge index array, the byte index array, the encoded bytes
+   * padded to 8 bytes, and the edge data.
+   *
+   * The sizes in the header are checked against the size of the file before
+   * anything is allocated, and the index arrays and encoded edges are checked
+   * after reading, so that a corrupt file cannot make edge iteration read
+   * outside the graph.
+   */
+  void readGraphFromVGRFile(const std::string& filename) {
+    std::ifstream graphFile(filename.c_str());
+    if (!graphFile.is_open()) {
+      GALOIS_DIE("failed to open file");
+    }
+    uint64_t header[5];
+    graphFile.read(reinterpret_cast<char*>(header), sizeof(uint64_t) * 5);
+    if (!graphFile) {
+      GALOIS_DIE(filename, " is not a .vgr graph");
+    }
+    if (header[0] != VGR_VERSION) {
+      GALOIS_DIE("unknown file version: ", header[0]);
+    }
+    const uint64_t sizeofEdge = EdgeData::size_of::value;
+    if (EdgeData::has_value && header[1] != sizeofEdge) {
+      GALOIS_DIE("edge data size mismatch: file has ", header[1], ", need ",
+                 sizeofEdge);
+    }
+    numNodes = header[2];
+    numEdges = header[3];
+    numBytes = header[4];
+
+    // the file must hold exactly the arrays the header describes; sizes are
+    // compared by division so that edited counts cannot overflow, and every
+    // edge takes at least one byte besides the pad byte
+    struct stat buf;
+    if (stat(filename.c_str(), &buf) != 0) {
+      GALOIS_SYS_DIE("failed reading ", filename);
+    }
+    uint64_t rest    = static_cast<uint64_t>(buf.st_size) - sizeof(header);
+    uint64_t padding = (numBytes + 7) / 8 * 8 - numBytes;
+    bool sizesMatch  = numNodes <= std::numeric_limits<GraphNode>::max() &&
+                       rest / (2 * sizeof(uint64_t)) >= numNodes;
+    if (sizesMatch) {
+      rest -= 2 * sizeof(uint64_t) * numNodes;
+      sizesMatch = numBytes != 0 && numBytes <= rest && numEdges < numBytes;
+    }
+    if (sizesMatch) {
+      rest -= numBytes;
+      if (header[1] == 0 || numEdges == 0) {
+        sizesMatch = rest == 0 || rest == padding;
+      } else {
+        sizesMatch = rest >= padding && (rest - padding) % header[1] == 0 &&
+                     (rest - padding) / header[1] == numEdges;
+      }
+    }
+    if (!sizesMatch) {
+      GALOIS_DIE(filename, " is not a .vgr graph");
+    }
+
+    allocateArrays();
+    galois::do_all(
+        galois::iterate(UINT64_C(0), numNodes),
+        [&](uint64_t n) { nodeData.constructAt(n); }, galois::no_stats());
+    allocateBytes();
+
+    graphFile.read(reinterpret_cast<char*>(edgeIndData.data()),
+                   sizeof(uint64_t) * numNodes);
+    graphFile.read(reinterpret_cast<char*>(byteIndData.data()),
+                   sizeof(uint64_t) * numNodes);
+    graphFile.read(reinterpret_cast<char*>(edgeBytes.data()), numBytes);
+    if (EdgeData::has_value) {
+      graphFile.seekg(padding, std::ios_base::cur);
+      graphFile.read(reinterpret_cast<char*>(edgeData.data()),
+                     header[1] * numEdges);
+    }
+    if (!graphFile) {
+      GALOIS_DIE("failed reading ", filename);
+    }
+
+    // both indices must be monotone and end at the edge count and at the pad
+    // byte, which must end any varint read past the last edge
+    galois::GReduceLogicalOr badIndex;
+    galois::do_all(
+        galois::iterate(UINT64_C(0), numNodes),
+        [&](uint64_t n) {
+          if (edgeIndData[n] < edgeStart(n) || byteIndData[n] < byteStart(n))
+            badIndex.update(true);
+        },
+        galois::no_stats(), galois::loopname("VGRIndexCheck"));
+    uint64_t lastEdge = numNodes ? edgeIndData[numNodes - 1] : 0;
+    uint64_t lastByte = numNodes ? byteIndData[numNodes - 1] : 0;
+    if (badIndex.reduce() || lastEdge != numEdges || lastByte != numBytes - 1 ||
+        edgeBytes[numBytes - 1] != 0) {
+      GALOIS_DIE(filename, " is not a .vgr graph");
+    }
+
+    // the bytes of each node must hold exactly one complete varint per edge,
+    // so decoding never crosses into another node, and decode to local nodes
+    galois::GReduceLogicalOr badEdges;
+    galois::do_all(
+        galois::iterate(UINT64_C(0), numNodes),
+        [&](uint64_t n) {
+          const uint8_t* first = edgeBytes.data() + byteStart(n);
+          const uint8_t* last  = edgeBytes.data() + byteIndData[n];
+          uint64_t ends        = 0;
+          for (const uint8_t* b = first; b != last; ++b)
+            ends += !(*b & 0x80);
+          if (ends != getDegree(n) || (first != last && (last[-1] & 0x80))) {
+            badEdges.update(true);
+            return;
+          }
+          for (edge_iterator ii = raw_begin(n), ee = raw_end(n); ii != ee;
+               ++ii) {
+            if (ii.getDst() >= numNodes)
+              badEdges.update(true);
+          }
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("VGREdgeCheck"));
+    if (badEdges.reduce()) {
+      GALOIS_DIE(filename, " is not a .vgr graph");
+    }
+
+    initializeLocalRanges();
+  }
+
+  //! Writes the graph as a .vgr file; see readGraphFromVGRFile
+  void writeToVGRFile(const std::string& filename) const {
+    std::ofstream graphFile(filename.c_str(), std::ios_base::binary);
+    if (!graphFile.is_open()) {
+      GALOIS_DIE("failed to open file");
+    }
+    uint64_t header[5] = {VGR_VERSION, EdgeData::size_of::value, numNodes,
+                          numEdges, numBytes};
+    graphFile.write(reinterpret_cast<const char*>(header),
+                    sizeof(uint64_t) * 5);
+    graphFile.write(reinterpret_cast<const char*>(edgeIndData.data()),
+                    sizeof(uint64_t) * numNodes);
+    graphFile.write(reinterpret_cast<const char*>(byteIndData.data()),
+                    sizeof(uint64_t) * numNodes);
+    graphFile.write(reinterpret_cast<const char*>(edgeBytes.data()), numBytes);
+    if (EdgeData::has_value) {
+      const char padding[8] = {};
+      graphFile.write(padding, (numBytes + 7) / 8 * 8 - numBytes);
+      graphFile.write(reinterpret_cast<const char*>(edgeData.data()),
+                      EdgeData::size_of::value * numEdges);
+    }
+    if (!graphFile) {
+      GALOIS_DIE("failed writing ", filename);
+    }
+  }
+};
+
+} // namespace galois::graphs
+
+#endif
@@ -0,0 +1,474 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file MultiSourceSearch.h
+ *
+ * Shortest path searches from many sources at once: a bit-parallel BFS that
+ * traverses up to 512 sources together and a delta-stepping SSSP whose
+ * sources share one worklist.
+ */
+
+#ifndef GALOIS_GRAPHS_MULTISOURCESEARCH_H
+#define GALOIS_GRAPHS_MULTISOURCESEARCH_H
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "galois/AtomicHelpers.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/config.h"
+#include "galois/graphs/Frontier.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+namespace galois {
+namespace graphs {
+
+/**
+ * Set of sources of a multi-source search, one bit per source.
+ *
+ * @tparam Width number of sources; a multiple of 64
+ */
+template <unsigned Width>
+struct SourceMask {
+  static_assert(Width > 0 && Width % 64 == 0,
+                "width must be a positive multiple of 64");
+  constexpr static unsigned WORDS = Width / 64;
+
+  uint64_t words[WORDS];
+
+  void clear() {
+    for (unsigned w = 0; w < WORDS; ++w)
+      words[w] = 0;
+  }
+
+  bool any() const {
+    uint64_t all = 0;
+    for (unsigned w = 0; w < WORDS; ++w)
+      all |= words[w];
+    return all != 0;
+  }
+
+  bool test(unsigned i) const { return (words[i / 64] >> (i % 64)) & 1; }
+
+  void set(unsigned i) { words[i / 64] |= uint64_t(1) << (i % 64); }
+
+  unsigned count() const {
+    unsigned c = 0;
+    for (unsigned w = 0; w < WORDS; ++w)
+      c += __builtin_popcountll(words[w]);
+    return c;
+  }
+
+  SourceMask& operator|=(const SourceMask& o) {
+    for (unsigned w = 0; w < WORDS; ++w)
+      words[w] |= o.words[w];
+    return *this;
+  }
+
+  SourceMask operator&(const SourceMask& o) const {
+    SourceMask r;
+    for (unsigned w = 0; w < WORDS; ++w)
+      r.words[w] = words[w] & o.words[w];
+    return r;
+  }
+
+  //! Sources in this set but not in o
+  SourceMask andNot(const SourceMask& o) const {
+    SourceMask r;
+    for (unsigned w = 0; w < WORDS; ++w)
+      r.words[w] = words[w] & ~o.words[w];
+    return r;
+  }
+
+  //! Adds the sources of o; may be called concurrently
+  void atomicOr(const SourceMask& o) {
+    for (unsigned w = 0; w < WORDS; ++w)
+      // skip the atomic when the bits are set already, which is common when
+      // several nodes of the frontier share a neighbor
+      if ((__atomic_load_n(&words[w], __ATOMIC_RELAXED) & o.words[w]) !=
+          o.words[w])
+        __atomic_fetch_or(&words[w], o.words[w], __ATOMIC_RELAXED);
+  }
+
+  //! Calls fn(i) on every source i in the set, in increasing order
+  template <typename FnTy>
+  void forEach(const FnTy& fn) const {
+    for (unsigned w = 0; w < WORDS; ++w)
+      for (uint64_t bits = words[w]; bits; bits &= bits - 1)
+        fn(w * 64 + __builtin_ctzll(bits));
+  }
+};
+
+/**
+ * Breadth-first search from up to Width sources at once, in the style of
+ * MS-BFS (Then et al., "The More the Merrier", VLDB 2014).
+ *
+ * Every node keeps three masks of sources: those that have reached it so far
+ * (seen), those that reached it in the last level (visit), and those reaching
+ * it in the level being built. A level scans the out-edges of the frontier
+ * once and ORs the visit mask of each node into its neighbors, so sources
+ * that are in the same frontier share the traversal of their edges. Sources
+ * diverge only in the bits, which costs Width / 8 bytes per node and mask.
+ *
+ * The search is driven one level at a time, like edgeMap:
+ *
+ *     bfs.reset(sources);
+ *     do {
+ *       bfs.forEachVisited([&](node, mask) { ... });
+ *     } while (bfs.advance());
+ *
+ * or with run, which does the same with a visitor of the form
+ * fn(node, mask, level).
+ *
+ * @tparam GraphTy graph with out-edges; edge directions are followed
+ * @tparam Width maximum number of sources per search; a multiple of 64
+ */
+template <typename GraphTy, unsigned Width = 64>
+class MultiSourceBFS {
+public:
+  using GNode = typename GraphTy::GraphNode;
+  using Mask  = SourceMask<Width>;
+
+  constexpr static unsigned WIDTH = Width;
+
+private:
+  constexpr static galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+
+  struct NoEdgeFn {
+    void operator()(GNode, GNode, const Mask&) const {}
+  };
+
+  GraphTy& graph;
+  LargeArray<Mask> seen;
+  LargeArray<Mask> visit;
+  LargeArray<Mask> visitNext;
+  Frontier frontiers[2];
+  unsigned current = 0;
+  unsigned depth   = 0;
+
+public:
+  explicit MultiSourceBFS(GraphTy& g) : graph(g) {
+    seen.allocateInterleaved(graph.size());
+    visit.allocateInterleaved(graph.size());
+    visitNext.allocateInterleaved(graph.size());
+    frontiers[0].resize(graph.size());
+    frontiers[1].resize(graph.size());
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          seen[n].clear();
+          visit[n].clear();
+          visitNext[n].clear();
+        },
+        galois::no_stats(), galois::loopname("MultiSourceBFSInit"));
+  }
+
+  MultiSourceBFS(const MultiSourceBFS&) = delete;
+  MultiSourceBFS& operator=(const MultiSourceBFS&) = delete;
+
+  /**
+   * Starts a new search; the frontier becomes the sources, at level 0.
+   *
+   * @param sources at most Width nodes; source i is bit i of the masks.
+   * Repeated nodes are allowed.
+   */
+  void reset(const std::vector<GNode>& sources) {
+    assert(sources.size() <= Width);
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          seen[n].clear();
+          visit[n].clear();
+        },
+        galois::no_stats(), galois::loopname("MultiSourceBFSReset"));
+    frontiers[0].clear();
+    frontiers[1].clear();
+    current = 0;
+    depth   = 0;
+    for (unsigned i = 0; i < sources.size(); ++i) {
+      seen[sources[i]].set(i);
+      visit[sources[i]].set(i);
+      frontiers[current].push(sources[i]);
+    }
+  }
+
+  /**
+   * Expands the frontier by one level.
+   *
+   * @param edgeFn called as edgeFn(src, dst, mask) for every edge from the
+   * frontier on which dst is first reached, where mask holds the sources that
+   * reach dst through src in this level; called concurrently, also for the
+   * same dst
+   * @returns false once no new node was reached; the frontier is empty then
+   */
+  template <typename EdgeFnTy = NoEdgeFn>
+  bool advance(const EdgeFnTy& edgeFn = EdgeFnTy()) {
+    Frontier& in  = frontiers[current];
+    Frontier& out = frontiers[current ^ 1];
+    out.clear();
+
+    in.forEach(
+        [&](GNode src) {
+          const Mask& mask = visit[src];
+          for (auto e : graph.edges(src, flag)) {
+            GNode dst = graph.getEdgeDst(e);
+            // seen only changes between levels, so the bits left are sources
+            // for which dst is exactly one level further
+            Mask fresh = mask.andNot(seen[dst]);
+            if (!fresh.any())
+              continue;
+            visitNext[dst].atomicOr(fresh);
+            edgeFn(src, dst, fresh);
+            out.push(dst);
+          }
+        },
+        "MultiSourceBFS");
+
+    in.forEach([&](GNode n) { visit[n].clear(); }, "MultiSourceBFSClear");
+    out.forEach(
+        [&](GNode n) {
+          visit[n] = visitNext[n];
+          seen[n] |= visit[n];
+          visitNext[n].clear();
+        },
+        "MultiSourceBFSUpdate");
+
+    in.clear();
+    current ^= 1;
+    depth += 1;
+    return !out.empty();
+  }
+
+  //! Level of the frontier, i.e., its distance from the sources reaching it
+  unsigned level() const { return depth; }
+
+  //! Nodes reached in the last level
+  Frontier& frontier() { return frontiers[current]; }
+
+  //! Calls fn(node, mask) in parallel on every node of the frontier, with the
+  //! sources that reached it in the last level
+  template <typename FnTy>
+  void forEachVisited(const FnTy& fn) {
+    frontiers[current].forEach([&](GNode n) { fn(n, visit[n]); },
+                               "MultiSourceBFSVisit");
+  }
+
+  //! Sources that reached n in the last level
+  const Mask& visited(GNode n) const { return visit[n]; }
+
+  //! Sources that have reached n so far
+  const Mask& reached(GNode n) const { return seen[n]; }
+
+  /**
+   * Runs a whole search.
+   *
+   * @param fn called as fn(node, mask, level) in parallel on every node and
+   * level, with the sources for which the node is at that distance
+   * @returns number of levels, i.e., one more than the largest distance
+   */
+  template <typename FnTy>
+  unsigned run(const std::vector<GNode>& sources, const FnTy& fn) {
+    reset(sources);
+    do {
+      unsigned l = depth;
+      forEachVisited([&](GNode n, const Mask& mask) { fn(n, mask, l); });
+    } while (advance());
+    return depth;
+  }
+};
+
+/**
+ * Delta-stepping SSSP from several sources that share one worklist.
+ *
+ * Distances are stored node major, dist[n * numSources + i], and a node
+ * keeps a pending flag per source whose distance dropped since the node last
+ * relaxed its edges for it. Work items are nodes in a single OBIM keyed by
+ * distance >> stepShift; an item relaxes the edges of its node once for all
+ * of its pending sources in its bucket or an earlier one, so sources whose
+ * searches reach a node in the same bucket share the scan of its edges and
+ * update the distances of a neighbor in the same cache lines. Each node also
+ * records the earliest bucket it is queued in, so that it is pushed once per
+ * bucket rather than once per source.
+ *
+ * Batching trades memory for shared work: a run keeps the distances of all
+ * sources, numSources * 5 bytes per node.
+ *
+ * @tparam GraphTy graph whose edge data are the non-negative edge weights
+ * @tparam DistTy integral distance type
+ */
+template <typename GraphTy, typename DistTy = uint32_t>
+class BatchedSSSP {
+public:
+  using GNode = typename GraphTy::GraphNode;
+
+  //! Distance of unreachable nodes; leaves room to add a weight without
+  //! overflowing
+  constexpr static DistTy infinity = std::numeric_limits<DistTy>::max() / 4;
+
+private:
+  constexpr static galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+  constexpr static unsigned CHUNK_SIZE     = 64U;
+  constexpr static DistTy none = std::numeric_limits<DistTy>::max();
+
+  struct Request {
+    GNode node;
+    DistTy dist;
+  };
+
+  struct Indexer {
+    unsigned shift;
+    unsigned operator()(const Request& r) const { return r.dist >> shift; }
+  };
+
+  using OBIM = galois::worklists::OrderedByIntegerMetric<
+      Indexer, galois::worklists::PerSocketChunkFIFO<CHUNK_SIZE>>;
+
+  GraphTy& graph;
+  LargeArray<std::atomic<DistTy>> dist;
+  LargeArray<std::atomic<uint8_t>> pending;
+  // per node, bucket of its earliest item in the worklist, or none
+  LargeArray<std::atomic<DistTy>> queued;
+  size_t numSources = 0;
+  //! (source, distance) pairs an item relaxes
+  substrate::PerThreadStorage<std::vector<std::pair<uint32_t, DistTy>>>
+      scratch;
+
+  //! Records that n has work at distance d; true if n must be pushed. Not
+  //! relaxed: it pairs with the reset of queued before the pending flags are
+  //! read.
+  bool push(GNode n, DistTy d) {
+    DistTy bucket = d >> stepShift;
+    DistTy old    = queued[n].load();
+    while (bucket < old)
+      if (queued[n].compare_exchange_weak(old, bucket))
+        return true;
+    return false;
+  }
+
+  unsigned stepShift = 0;
+
+public:
+  explicit BatchedSSSP(GraphTy& g) : graph(g) {}
+
+  BatchedSSSP(const BatchedSSSP&) = delete;
+  BatchedSSSP& operator=(const BatchedSSSP&) = delete;
+
+  /**
+   * Computes the distances from every source.
+   *
+   * @param sources source i has index i in distance
+   * @param shift log2 of the delta of delta-stepping
+   */
+  void run(const std::vector<GNode>& sources, unsigned shift) {
+    stepShift = shift;
+    if (dist.size() != graph.size() * sources.size()) {
+      dist.deallocate();
+      pending.deallocate();
+      dist.allocateInterleaved(graph.size() * sources.size());
+      pending.allocateInterleaved(graph.size() * sources.size());
+    }
+    if (queued.size() != graph.size())
+      queued.allocateInterleaved(graph.size());
+    numSources = sources.size();
+    galois::do_all(
+        galois::iterate(size_t{0}, dist.size()),
+        [&](size_t i) {
+          dist[i].store(infinity, std::memory_order_relaxed);
+          pending[i].store(0, std::memory_order_relaxed);
+        },
+        galois::no_stats(), galois::loopname("BatchedSSSPReset"));
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) { queued[n].store(none, std::memory_order_relaxed); },
+        galois::no_stats(), galois::loopname("BatchedSSSPResetQueued"));
+
+    galois::InsertBag<Request> init;
+    for (uint32_t i = 0; i < sources.size(); ++i) {
+      dist[sources[i] * numSources + i] = 0;
+      pending[sources[i] * numSources + i] = 1;
+      if (queued[sources[i]].exchange(0) != 0)
+        init.push(Request{sources[i], 0});
+    }
+
+    galois::for_each(
+        galois::iterate(init),
+        [&](const Request& req, auto& ctx) {
+          auto& todo    = *scratch.getLocal();
+          DistTy bucket = req.dist >> stepShift;
+          size_t row    = req.node * numSources;
+          // from here on, sources becoming pending push the node again
+          queued[req.node].store(none);
+
+          todo.clear();
+          DistTy later = none;
+          for (uint32_t i = 0; i < numSources; ++i) {
+            if (!pending[row + i].load())
+              continue;
+            DistTy d = dist[row + i].load();
+            if ((d >> stepShift) > bucket) {
+              later = std::min(later, d);
+              continue;
+            }
+            // clear before reading the distance again, so that a later
+            // decrease finds the flag unset and pushes the node
+            if (pending[row + i].exchange(0))
+              todo.emplace_back(i, dist[row + i].load());
+          }
+          // sources left for a later bucket
+          if (later != none && push(req.node, later))
+            ctx.push(Request{req.node, later});
+
+          for (auto e : graph.edges(req.node, flag)) {
+            GNode dst     = graph.getEdgeDst(e);
+            size_t dstRow = dst * numSources;
+            DistTy weight = graph.getEdgeData(e, flag);
+            for (auto& [i, d] : todo) {
+              DistTy newDist = d + weight;
+              if (newDist >= galois::atomicMin(dist[dstRow + i], newDist))
+                continue;
+              pending[dstRow + i].store(1);
+              if (push(dst, newDist))
+                ctx.push(Request{dst, newDist});
+            }
+          }
+        },
+        galois::wl<OBIM>(Indexer{stepShift}),
+        galois::disable_conflict_detection(),
+        galois::loopname("BatchedSSSP"));
+  }
+
+  //! Number of sources of the last run
+  size_t sources() const { return numSources; }
+
+  //! Distance from source i of the last run to n; infinity if unreachable
+  DistTy distance(GNode n, size_t i) const {
+    return dist[n * numSources + i].load(std::memory_order_relaxed);
+  }
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
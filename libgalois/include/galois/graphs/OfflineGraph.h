@@ -20,18 +20,26 @@
 #ifndef _GALOIS_DIST_OFFLINE_GRAPH_
 #define _GALOIS_DIST_OFFLINE_GRAPH_
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdint>
+#include <cstring>
+#include <deque>
 #include <fstream>
 #include <iostream>
 #include <mutex>
 #include <numeric>
+#include <vector>
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <boost/iterator/counting_iterator.hpp>
 
 #include "galois/config.h"
+#include "galois/gIO.h"
 #include "galois/graphs/Details.h"
 #include "galois/graphs/GraphHelpers.h"
 #include "galois/substrate/SimpleLock.h"
@@ -60,132 +68,146 @@ namespace graphs {
 // outedges[numEdges] {uint64_t LE}
 // EdgeType[numEdges] {EdgeType size}
 
+/**
+ * Read-only access to a graph file on disk without loading it.
+ *
+ * The file is mapped into memory, so accesses only fault in the pages they
+ * touch and the kernel reads ahead of sequential scans. If the file cannot be
+ * mapped, it is read with pread through one buffer per section of the file
+ * (prefix sum, destinations, edge data); each miss refills the buffer with a
+ * large aligned block starting at the requested position. Bulk range reads
+ * (readIndexRange, readEdgeRange, readEdgeDataRange) should be preferred over
+ * per-node and per-edge accessors for scans.
+ *
+ * num_seeks counts the discontiguous accesses and num_bytes_read the bytes
+ * returned, for both backends.
+ */
 class OfflineGraph {
-  std::ifstream fileEdgeDst, fileIndex, fileEdgeData;
-  std::streamoff locEdgeDst, locIndex, locEdgeData;
+  //! Bytes read at a time by the pread backend; a multiple of BLOCK_SIZE
+  static const size_t WINDOW_SIZE = 4 << 20;
+  //! Alignment of the reads of the pread backend
+  static const size_t BLOCK_SIZE = 4096;
+
+  //! A section of the file and the reading state of it
+  struct Section {
+    std::vector<char> buffer;
+    //! file range held by buffer
+    uint64_t bufferBegin = 0, bufferEnd = 0;
+    //! end of the last access
+    uint64_t loc          = 0;
+    uint64_t numSeeks     = 0;
+    uint64_t numBytesRead = 0;
+  };
+
+  int fd              = -1;
+  const char* mapping = nullptr;
+  Section sectionIndex, sectionEdgeDst, sectionEdgeData;
 
   uint64_t numNodes;
   uint64_t numEdges;
   uint64_t sizeEdgeData;
   size_t length;
   bool v2;
-  uint64_t numSeeksEdgeDst, numSeeksIndex, numSeeksEdgeData;
-  uint64_t numBytesReadEdgeDst, numBytesReadIndex, numBytesReadEdgeData;
 
   galois::substrate::SimpleLock lock;
 
-  uint64_t outIndexs(uint64_t node) {
-    std::lock_guard<decltype(lock)> lg(lock);
-    std::streamoff pos = (4 + node) * sizeof(uint64_t);
+  size_t sizeEdgeDst() const {
+    return v2 ? sizeof(uint64_t) : sizeof(uint32_t);
+  }
+
+  uint64_t offsetOfIndex(uint64_t node) const {
+    return (4 + node) * sizeof(uint64_t);
+  }
+
+  uint64_t offsetOfEdgeDst(uint64_t edge) const {
+    return offsetOfIndex(numNodes) + edge * sizeEdgeDst();
+  }
 
-    // move to correct position in file
-    if (locEdgeDst != pos) {
-      numSeeksEdgeDst++;
-      fileEdgeDst.seekg(pos, fileEdgeDst.beg);
-      locEdgeDst = pos;
+  uint64_t offsetOfEdgeData(uint64_t edge) const {
+    // edge data is aligned to 64 bits
+    return ((offsetOfEdgeDst(numEdges) + 7) & ~uint64_t(7)) +
+           edge * sizeEdgeData;
+  }
+
+  //! Reads size bytes at offset with pread, retrying short reads
+  void readFully(uint64_t offset, size_t size, char* out) {
+    while (size) {
+      ssize_t n = pread(fd, out, size, offset);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        GALOIS_SYS_DIE("failed reading graph at offset ", offset);
+      offset += n;
+      out += n;
+      size -= n;
     }
+  }
 
-    // read the value
-    uint64_t retval;
-    try {
-      fileEdgeDst.read(reinterpret_cast<char*>(&retval), sizeof(uint64_t));
-    } catch (const std::ifstream::failure& e) {
-      std::cerr << "Exception while reading edge destinations:" << e.what()
-                << "\n";
-      std::cerr << "IO error flags: EOF " << fileEdgeDst.eof() << " FAIL "
-                << fileEdgeDst.fail() << " BAD " << fileEdgeDst.bad() << "\n";
+  //! Copies size bytes at offset of the file, which lie in section s, to out
+  void read(Section& s, uint64_t offset, size_t size, char* out) {
+    assert(offset + size <= length);
+    std::lock_guard<decltype(lock)> lg(lock);
+    if (s.loc != offset)
+      s.numSeeks++;
+    s.loc = offset + size;
+    s.numBytesRead += size;
+
+    if (mapping) {
+      std::memcpy(out, mapping + offset, size);
+      return;
     }
+    if (offset < s.bufferBegin || offset + size > s.bufferEnd) {
+      // large requests bypass the buffer
+      if (size > WINDOW_SIZE - BLOCK_SIZE) {
+        readFully(offset, size, out);
+        return;
+      }
+      s.bufferBegin = offset & ~uint64_t(BLOCK_SIZE - 1);
+      s.bufferEnd   = std::min<uint64_t>(s.bufferBegin + WINDOW_SIZE, length);
+      s.buffer.resize(WINDOW_SIZE);
+      readFully(s.bufferBegin, s.bufferEnd - s.bufferBegin, s.buffer.data());
+    }
+    std::memcpy(out, s.buffer.data() + (offset - s.bufferBegin), size);
+  }
 
-    // metadata update
-    auto numBytesRead = fileEdgeDst.gcount();
-    assert(numBytesRead == sizeof(uint64_t));
-    locEdgeDst += numBytesRead;
-    numBytesReadEdgeDst += numBytesRead;
+  //! Asks the kernel to read [offset, offset + size) of the mapping ahead, up
+  //! to 16 windows
+  void willNeed(uint64_t offset, size_t size) {
+    if (!mapping || !size)
+      return;
+    size           = std::min<size_t>(size, 16 * WINDOW_SIZE);
+    uint64_t begin = offset & ~uint64_t(BLOCK_SIZE - 1);
+    madvise(const_cast<char*>(mapping) + begin, offset + size - begin,
+            MADV_WILLNEED);
+  }
 
+  uint64_t outIndexs(uint64_t node) {
+    uint64_t retval;
+    read(sectionIndex, offsetOfIndex(node), sizeof(uint64_t),
+         reinterpret_cast<char*>(&retval));
     return retval;
   }
 
   uint64_t outEdges(uint64_t edge) {
-    std::lock_guard<decltype(lock)> lg(lock);
-    std::streamoff pos = (4 + numNodes) * sizeof(uint64_t) +
-                         edge * (v2 ? sizeof(uint64_t) : sizeof(uint32_t));
-
-    // move to correct position
-    if (locIndex != pos) {
-      numSeeksIndex++;
-      fileIndex.seekg(pos, fileEdgeDst.beg);
-      locIndex = pos;
-    }
-
     // v2 reads 64 bits, v1 reads 32 bits
     if (v2) {
       uint64_t retval;
-      try {
-        fileIndex.read(reinterpret_cast<char*>(&retval), sizeof(uint64_t));
-      } catch (const std::ifstream::failure& e) {
-        std::cerr << "Exception while reading index:" << e.what() << "\n";
-        std::cerr << "IO error flags: EOF " << fileIndex.eof() << " FAIL "
-                  << fileIndex.fail() << " BAD " << fileIndex.bad() << "\n";
-      }
-
-      auto numBytesRead = fileIndex.gcount();
-      assert(numBytesRead == sizeof(uint64_t));
-      locIndex += numBytesRead;
-      numBytesReadIndex += numBytesRead;
-      return retval;
-    } else {
-      uint32_t retval;
-      try {
-        fileIndex.read(reinterpret_cast<char*>(&retval), sizeof(uint32_t));
-      } catch (const std::ifstream::failure& e) {
-        std::cerr << "Exception while reading index:" << e.what() << "\n";
-        std::cerr << "IO error flags: EOF " << fileIndex.eof() << " FAIL "
-                  << fileIndex.fail() << " BAD " << fileIndex.bad() << "\n";
-      }
-
-      auto numBytesRead = fileIndex.gcount();
-      assert(numBytesRead == sizeof(uint32_t));
-      locIndex += numBytesRead;
-      numBytesReadIndex += numBytesRead;
+      read(sectionEdgeDst, offsetOfEdgeDst(edge), sizeof(uint64_t),
+           reinterpret_cast<char*>(&retval));
       return retval;
     }
+    uint32_t retval;
+    read(sectionEdgeDst, offsetOfEdgeDst(edge), sizeof(uint32_t),
+         reinterpret_cast<char*>(&retval));
+    return retval;
   }
 
   template <typename T>
   T edgeData(uint64_t edge) {
     assert(sizeof(T) <= sizeEdgeData);
-    std::lock_guard<decltype(lock)> lg(lock);
-    std::streamoff pos = (4 + numNodes) * sizeof(uint64_t) +
-                         numEdges * (v2 ? sizeof(uint64_t) : sizeof(uint32_t));
-
-    // align + move to correct position
-    pos = (pos + 7) & ~7;
-    pos += edge * sizeEdgeData;
-
-    if (locEdgeData != pos) {
-      numSeeksEdgeData++;
-      fileEdgeData.seekg(pos, fileEdgeDst.beg);
-      locEdgeData = pos;
-    }
-
     T retval;
-    try {
-      fileEdgeData.read(reinterpret_cast<char*>(&retval), sizeof(T));
-    } catch (const std::ifstream::failure& e) {
-      std::cerr << "Exception while reading edge data:" << e.what() << "\n";
-      std::cerr << "IO error flags: EOF " << fileEdgeData.eof() << " FAIL "
-                << fileEdgeData.fail() << " BAD " << fileEdgeData.bad() << "\n";
-    }
-
-    auto numBytesRead = fileEdgeData.gcount();
-    assert(numBytesRead == sizeof(T));
-    locEdgeData += numBytesRead;
-    numBytesReadEdgeData += numBytesRead;
-    /*fprintf(stderr, "READ:: %ld[", edge);
-    for(int i=0; i<sizeof(T); ++i){
-       fprintf(stderr, "%c", reinterpret_cast<char*>(&retval)[i]);
-    }
-    fprintf(stderr, "]");*/
+    read(sectionEdgeData, offsetOfEdgeData(edge), sizeof(T),
+         reinterpret_cast<char*>(&retval));
     return retval;
   }
 
@@ -194,79 +216,153 @@ public:
   typedef boost::counting_iterator<uint64_t> edge_iterator;
   typedef uint64_t GraphNode;
 
-  OfflineGraph(const std::string& name)
-      : fileEdgeDst(name, std::ios_base::binary),
-        fileIndex(name, std::ios_base::binary),
-        fileEdgeData(name, std::ios_base::binary), locEdgeDst(0), locIndex(0),
-        locEdgeData(0), numSeeksEdgeDst(0), numSeeksIndex(0),
-        numSeeksEdgeData(0), numBytesReadEdgeDst(0), numBytesReadIndex(0),
-        numBytesReadEdgeData(0) {
-    if (!fileEdgeDst.is_open() || !fileEdgeDst.good())
-      throw "Bad filename";
-    if (!fileIndex.is_open() || !fileIndex.good())
+  /**
+   * @param name graph file to read
+   * @param useMmap map the file; if false or if mapping fails, read it with
+   * pread instead
+   */
+  OfflineGraph(const std::string& name, bool useMmap = true) {
+    fd = open(name.c_str(), O_RDONLY);
+    if (fd < 0)
       throw "Bad filename";
-    if (!fileEdgeData.is_open() || !fileEdgeData.good())
+
+    struct stat buf;
+    if (fstat(fd, &buf) != 0) {
+      close(fd);
       throw "Bad filename";
+    }
+    length = buf.st_size;
 
-    fileEdgeDst.exceptions(std::ifstream::eofbit | std::ifstream::failbit |
-                           std::ifstream::badbit);
-    fileIndex.exceptions(std::ifstream::eofbit | std::ifstream::failbit |
-                         std::ifstream::badbit);
-    fileEdgeData.exceptions(std::ifstream::eofbit | std::ifstream::failbit |
-                            std::ifstream::badbit);
-
-    uint64_t ver = 0;
-
-    try {
-      fileEdgeDst.read(reinterpret_cast<char*>(&ver), sizeof(uint64_t));
-      fileEdgeDst.read(reinterpret_cast<char*>(&sizeEdgeData),
-                       sizeof(uint64_t));
-      fileEdgeDst.read(reinterpret_cast<char*>(&numNodes), sizeof(uint64_t));
-      fileEdgeDst.read(reinterpret_cast<char*>(&numEdges), sizeof(uint64_t));
-    } catch (const std::ifstream::failure& e) {
-      std::cerr << "Exception while reading graph header:" << e.what() << "\n";
-      std::cerr << "IO error flags: EOF " << fileEdgeDst.eof() << " FAIL "
-                << fileEdgeDst.fail() << " BAD " << fileEdgeDst.bad() << "\n";
+    uint64_t header[4];
+    if (length < sizeof(header) ||
+        pread(fd, header, sizeof(header), 0) != sizeof(header)) {
+      close(fd);
+      throw "Out of data";
     }
+    uint64_t ver = header[0];
+    sizeEdgeData = header[1];
+    numNodes     = header[2];
+    numEdges     = header[3];
 
-    if (ver == 0 || ver > 2)
+    if (ver == 0 || ver > 2) {
+      close(fd);
       throw "Bad Version";
+    }
 
     v2 = ver == 2;
 
-    if (!fileEdgeDst)
-      throw "Out of data";
-
-    // File length
-    fileEdgeDst.seekg(0, fileEdgeDst.end);
-    length = fileEdgeDst.tellg();
-    if (length < sizeof(uint64_t) * (4 + numNodes) +
-                     (v2 ? sizeof(uint64_t) : sizeof(uint32_t)) * numEdges)
+    if (length < offsetOfEdgeDst(numEdges) ||
+        (sizeEdgeData && length < offsetOfEdgeData(numEdges))) {
+      close(fd);
       throw "File too small";
+    }
 
-    fileEdgeDst.seekg(0, std::ios_base::beg);
-    fileEdgeData.seekg(0, std::ios_base::beg);
-    fileIndex.seekg(0, std::ios_base::beg);
+    if (useMmap) {
+      void* m = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+      if (m != MAP_FAILED)
+        mapping = static_cast<const char*>(m);
+    }
+  }
+
+  OfflineGraph(OfflineGraph&& other)
+      : fd(other.fd), mapping(other.mapping),
+        sectionIndex(std::move(other.sectionIndex)),
+        sectionEdgeDst(std::move(other.sectionEdgeDst)),
+        sectionEdgeData(std::move(other.sectionEdgeData)),
+        numNodes(other.numNodes), numEdges(other.numEdges),
+        sizeEdgeData(other.sizeEdgeData), length(other.length), v2(other.v2) {
+    other.fd      = -1;
+    other.mapping = nullptr;
   }
 
+  OfflineGraph(const OfflineGraph&) = delete;
+  OfflineGraph& operator=(const OfflineGraph&) = delete;
+
+  ~OfflineGraph() {
+    if (mapping)
+      munmap(const_cast<char*>(mapping), length);
+    if (fd >= 0)
+      close(fd);
+  }
+
+  //! True if the file is mapped rather than read with pread
+  bool isMapped() const { return mapping != nullptr; }
+
   uint64_t num_seeks() {
-    // std::cout << "Seeks :: " << numSeeksEdgeDst << " , " << numSeeksEdgeData
-    //          << " , " << numSeeksIndex << " \n";
-    return numSeeksEdgeDst + numSeeksEdgeData + numSeeksIndex;
+    return sectionIndex.numSeeks + sectionEdgeDst.numSeeks +
+           sectionEdgeData.numSeeks;
   }
 
   uint64_t num_bytes_read() {
-    // std::cout << "Bytes read :: " << numBytesReadEdgeDst << " , " <<
-    // numBytesReadEdgeData << " , " << numBytesReadIndex << " \n";
-    return numBytesReadEdgeDst + numBytesReadEdgeData + numBytesReadIndex;
+    return sectionIndex.numBytesRead + sectionEdgeDst.numBytesRead +
+           sectionEdgeData.numBytesRead;
   }
 
   void reset_seek_counters() {
-    numSeeksEdgeDst = numSeeksEdgeData = numSeeksIndex = 0;
-    numBytesReadEdgeDst = numBytesReadEdgeData = numBytesReadIndex = 0;
+    for (Section* s : {&sectionIndex, &sectionEdgeDst, &sectionEdgeData}) {
+      s->numSeeks     = 0;
+      s->numBytesRead = 0;
+    }
+  }
+
+  /**
+   * Reads entries [begin, end) of the edge prefix sum, i.e., the end edge of
+   * nodes [begin, end).
+   *
+   * @param out array of at least end - begin elements
+   */
+  void readIndexRange(uint64_t begin, uint64_t end, uint64_t* out) {
+    assert(begin <= end && end <= numNodes);
+    size_t size = (end - begin) * sizeof(uint64_t);
+    willNeed(offsetOfIndex(begin), size);
+    read(sectionIndex, offsetOfIndex(begin), size,
+         reinterpret_cast<char*>(out));
   }
 
-  OfflineGraph(OfflineGraph&&) = default;
+  /**
+   * Reads the destinations of edges [begin, end).
+   *
+   * @param out array of at least end - begin elements
+   */
+  void readEdgeRange(uint64_t begin, uint64_t end, uint64_t* out) {
+    assert(begin <= end && end <= numEdges);
+    willNeed(offsetOfEdgeDst(begin), (end - begin) * sizeEdgeDst());
+    if (v2) {
+      read(sectionEdgeDst, offsetOfEdgeDst(begin),
+           (end - begin) * sizeof(uint64_t), reinterpret_cast<char*>(out));
+      return;
+    }
+    // widen v1 destinations in chunks
+    uint32_t chunk[1024];
+    while (begin < end) {
+      size_t n = std::min<uint64_t>(end - begin, 1024);
+      read(sectionEdgeDst, offsetOfEdgeDst(begin), n * sizeof(uint32_t),
+           reinterpret_cast<char*>(chunk));
+      std::copy(chunk, chunk + n, out);
+      begin += n;
+      out += n;
+    }
+  }
+
+  /**
+   * Reads the data of edges [begin, end). T may be smaller than the edge data
+   * of the file, in which case the prefix of each edge data is read.
+   *
+   * @param out array of at least end - begin elements
+   */
+  template <typename T>
+  void readEdgeDataRange(uint64_t begin, uint64_t end, T* out) {
+    assert(sizeof(T) <= sizeEdgeData);
+    assert(begin <= end && end <= numEdges);
+    willNeed(offsetOfEdgeData(begin), (end - begin) * sizeEdgeData);
+    if (sizeof(T) == sizeEdgeData) {
+      read(sectionEdgeData, offsetOfEdgeData(begin), (end - begin) * sizeof(T),
+           reinterpret_cast<char*>(out));
+      return;
+    }
+    for (uint64_t e = begin; e < end; ++e)
+      *out++ = edgeData<T>(e);
+  }
 
   size_t size() const { return numNodes; }
   size_t sizeEdges() const { return numEdges; }
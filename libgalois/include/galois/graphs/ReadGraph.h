@@ -229,6 +229,31 @@ void readGraphDispatch(GraphTy& graph, read_lc_inout_graph_tag,
   readGraphDispatch(graph, tag1, f1);
 }
 
+template <typename GraphTy>
+void readGraphDispatch(GraphTy& graph, read_compressed_graph_tag, FileGraph& f,
+                       const bool readUnweighted = false) {
+  readGraphDispatch(graph, read_default_graph_tag(), f, readUnweighted);
+  graph.releaseFileEdges();
+}
+
+//! Compressed graphs load .vgr files directly and compress .gr files
+template <typename GraphTy>
+void readGraphDispatch(GraphTy& graph, read_compressed_graph_tag,
+                       const std::string& filename,
+                       const bool readUnweighted = false) {
+  if (GraphTy::isVGRFile(filename)) {
+    graph.readGraphFromVGRFile(filename);
+    return;
+  }
+  FileGraph f;
+  if (readUnweighted) {
+    f.fromFileInterleaved<void>(filename);
+  } else {
+    f.fromFileInterleaved<typename GraphTy::file_edge_data_type>(filename);
+  }
+  readGraphDispatch(graph, read_compressed_graph_tag(), f, readUnweighted);
+}
+
 } // namespace graphs
 } // namespace galois
 
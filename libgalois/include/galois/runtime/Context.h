@@ -136,9 +136,12 @@ class SimpleRuntimeContext : public LockManagerBase {
   //! The locks we hold
   Lockable* locks;
   bool customAcquire;
+  //! Record conflicts in conflicted instead of signaling them
+  bool deferConflicts;
+  bool conflicted;
 
 protected:
-  friend void doAcquire(Lockable*, galois::MethodFlag);
+  friend bool doAcquire(Lockable*, galois::MethodFlag);
 
   static SimpleRuntimeContext* getOwner(Lockable* lockable) {
     LockManagerBase* owner = LockManagerBase::getOwner(lockable);
@@ -153,7 +156,7 @@ protected:
     locks          = lockable;
   }
 
-  void acquire(Lockable* lockable, galois::MethodFlag m) {
+  bool acquire(Lockable* lockable, galois::MethodFlag m) {
     AcquireStatus i;
     if (customAcquire) {
       subAcquire(lockable, m);
@@ -161,18 +164,39 @@ protected:
       if (i == AcquireStatus::NEW_OWNER) {
         addToNhood(lockable);
       }
+    } else if (deferConflicts) {
+      conflicted = true;
+      return false;
     } else {
       signalConflict(lockable);
     }
+    return true;
   }
 
   void release(Lockable* lockable);
 
 public:
-  SimpleRuntimeContext(bool child = false) : locks(0), customAcquire(child) {}
+  SimpleRuntimeContext(bool child = false)
+      : locks(0), customAcquire(child), deferConflicts(false),
+        conflicted(false) {}
   virtual ~SimpleRuntimeContext() {}
 
-  void startIteration() { assert(!locks); }
+  void startIteration() {
+    assert(!locks);
+    conflicted = false;
+  }
+
+  /**
+   * If defer is true, a failed acquire marks the iteration conflicted and
+   * returns false instead of unwinding the operator. Used by loops with the
+   * galois::no_exceptions trait.
+   */
+  void setDeferConflicts(bool defer) { deferConflicts = defer; }
+  bool defersConflicts() const { return deferConflicts; }
+
+  //! Marks the current iteration conflicted; only for deferred conflicts
+  void markConflicted() { conflicted = true; }
+  bool isConflicted() const { return conflicted; }
 
   unsigned cancelIteration();
   unsigned commitIteration();
@@ -207,17 +231,37 @@ inline bool shouldLock(const galois::MethodFlag g) {
 }
 
 //! actual locking function.  Will always lock.
-inline void doAcquire(Lockable* lockable, galois::MethodFlag m) {
+//! @returns false if the lock was not acquired and the conflict was deferred
+inline bool doAcquire(Lockable* lockable, galois::MethodFlag m) {
   SimpleRuntimeContext* ctx = getThreadContext();
   if (ctx)
-    ctx->acquire(lockable, m);
+    return ctx->acquire(lockable, m);
+  return true;
 }
 
 //! Master function which handles conflict detection
 //! used to acquire a lockable thing
-inline void acquire(Lockable* lockable, galois::MethodFlag m) {
+//! @returns false if the lock was not acquired and the conflict was deferred
+inline bool acquire(Lockable* lockable, galois::MethodFlag m) {
   if (shouldLock(m))
-    doAcquire(lockable, m);
+    return doAcquire(lockable, m);
+  return true;
+}
+
+//! Aborts the current iteration, by signaling a conflict or, if conflicts
+//! are deferred, by marking the iteration conflicted
+inline void abortIteration() {
+  SimpleRuntimeContext* ctx = getThreadContext();
+  if (ctx && ctx->defersConflicts())
+    ctx->markConflicted();
+  else
+    signalConflict();
+}
+
+//! True if the current iteration has a deferred conflict
+inline bool isConflicted() {
+  SimpleRuntimeContext* ctx = getThreadContext();
+  return ctx && ctx->isConflicted();
 }
 
 struct AlwaysLockObj {
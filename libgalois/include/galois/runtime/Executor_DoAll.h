@@ -20,6 +20,10 @@
 #ifndef GALOIS_RUNTIME_EXECUTOR_DOALL_H
 #define GALOIS_RUNTIME_EXECUTOR_DOALL_H
 
+#include <atomic>
+#include <iterator>
+#include <type_traits>
+
 #include "galois/config.h"
 #include "galois/gIO.h"
 #include "galois/runtime/Executor_OnEach.h"
@@ -457,7 +461,268 @@ public:
   }
 };
 
-template <bool _STEAL>
+/**
+ * Work-stealing do_all executor without per-thread locks.
+ *
+ * The iteration space is cut into chunks of chunk_size iterations, and each
+ * thread's remaining work is a [begin, end) interval of chunk indices packed
+ * into a single 64-bit word. The owner claims chunks from the front with one
+ * atomic add; thieves take the back half of a victim's interval with a CAS.
+ * A claimed chunk index never returns to any interval, so a stale CAS cannot
+ * succeed (no ABA).
+ *
+ * Requires random access local iterators that index into [range.begin(),
+ * range.end()) and fewer than 2^32 chunks; see ChooseDoAllImpl.
+ */
+template <typename R, typename F, typename ArgsTuple>
+class DoAllLockFreeStealingExec {
+
+  typedef typename R::iterator Iter;
+  typedef typename std::iterator_traits<Iter>::difference_type Diff_ty;
+
+  constexpr static const bool NEED_STATS =
+      galois::internal::NeedStats<ArgsTuple>::value;
+  constexpr static const bool MORE_STATS =
+      NEED_STATS && has_trait<more_stats_tag, ArgsTuple>();
+
+  static uint64_t pack(uint64_t beg, uint64_t end) { return (beg << 32) | end; }
+  static uint64_t begOf(uint64_t w) { return w >> 32; }
+  static uint64_t endOf(uint64_t w) { return w & 0xFFFFFFFF; }
+  //! The owner's atomic add may push begin past end; both mean empty
+  static bool isEmpty(uint64_t w) { return begOf(w) >= endOf(w); }
+
+  struct ThreadContext {
+    //! packed [begin, end) of chunk indices this thread still owns
+    alignas(substrate::GALOIS_CACHE_LINE_SIZE) std::atomic<uint64_t> work;
+    unsigned id;
+    size_t num_iter;
+
+    ThreadContext()
+        : work(0), id(substrate::getThreadPool().getMaxThreads()),
+          num_iter(0) {}
+
+    bool hasWorkWeak() const {
+      return !isEmpty(work.load(std::memory_order_relaxed));
+    }
+
+    //! Claims the first chunk; only called by the owner
+    bool getWork(uint64_t& chunk) {
+      uint64_t w = work.fetch_add(uint64_t(1) << 32);
+      chunk      = begOf(w);
+      return !isEmpty(w);
+    }
+
+    //! Takes the back half of this thread's chunks; called by thieves
+    bool stealWork(uint64_t& steal_beg, uint64_t& steal_end) {
+      uint64_t w = work.load();
+      if (isEmpty(w)) {
+        return false;
+      }
+      uint64_t beg  = begOf(w);
+      uint64_t end  = endOf(w);
+      uint64_t size = end - beg;
+      steal_beg     = (size > 1) ? end - size / 2 : beg;
+      steal_end     = end;
+      return work.compare_exchange_strong(w, pack(beg, steal_beg));
+    }
+
+    //! Publishes stolen chunks; only called by the owner when empty
+    void assignWork(uint64_t beg, uint64_t end) {
+      assert(!hasWorkWeak());
+      assert(beg < end);
+      work.store(pack(beg, end));
+    }
+  };
+
+  R range;
+  F func;
+  const char* loopname;
+  Iter global_beg;
+  Diff_ty global_size;
+  Diff_ty chunk_size;
+  uint64_t num_chunks;
+  substrate::PerThreadStorage<ThreadContext> workers;
+
+  // for stats
+  PerThreadTimer<MORE_STATS> totalTime;
+  PerThreadTimer<MORE_STATS> initTime;
+  PerThreadTimer<MORE_STATS> execTime;
+  PerThreadTimer<MORE_STATS> stealTime;
+
+  //! Maps an iterator of a local range boundary to a chunk boundary; threads
+  //! sharing a boundary round it the same way, so chunks are not duplicated
+  uint64_t toChunk(const Iter& it) const {
+    Diff_ty off = std::distance(global_beg, it);
+    if (off >= global_size) {
+      return num_chunks;
+    }
+    return std::min<uint64_t>((off + chunk_size / 2) / chunk_size, num_chunks);
+  }
+
+  bool doWork(ThreadContext& ctx) {
+    bool didwork = false;
+    uint64_t chunk;
+
+    while (ctx.getWork(chunk)) {
+      didwork = true;
+
+      Iter beg = global_beg + chunk * chunk_size;
+      Iter end = global_beg + std::min<Diff_ty>((chunk + 1) * chunk_size,
+                                                global_size);
+      for (; beg != end; ++beg) {
+        if (NEED_STATS) {
+          ++ctx.num_iter;
+        }
+        func(*beg);
+      }
+    }
+
+    return didwork;
+  }
+
+  bool transferWork(ThreadContext& rich, ThreadContext& poor) {
+    assert(rich.id != poor.id);
+
+    uint64_t steal_beg;
+    uint64_t steal_end;
+
+    if (rich.stealWork(steal_beg, steal_end)) {
+      poor.assignWork(steal_beg, steal_end);
+      return true;
+    }
+    return false;
+  }
+
+  GALOIS_ATTRIBUTE_NOINLINE bool stealWithinSocket(ThreadContext& poor) {
+    bool sawWork = false;
+
+    auto& tp = substrate::getThreadPool();
+
+    const unsigned maxT     = galois::getActiveThreads();
+    const unsigned my_pack  = substrate::ThreadPool::getSocket();
+    const unsigned per_pack = tp.getMaxThreads() / tp.getMaxSockets();
+
+    const unsigned pack_beg = my_pack * per_pack;
+
+    for (unsigned i = 1; i < per_pack; ++i) {
+      // go around the socket in circle starting from the next thread
+      unsigned t = (poor.id + i) % per_pack + pack_beg;
+
+      if (t < maxT && workers.getRemote(t)->hasWorkWeak()) {
+        sawWork = true;
+        if (transferWork(*workers.getRemote(t), poor)) {
+          return true;
+        }
+      }
+    }
+
+    return sawWork;
+  }
+
+  GALOIS_ATTRIBUTE_NOINLINE bool stealOutsideSocket(ThreadContext& poor) {
+    bool sawWork = false;
+
+    auto& tp            = substrate::getThreadPool();
+    const unsigned myPkg = substrate::ThreadPool::getSocket();
+    const unsigned maxT  = galois::getActiveThreads();
+
+    for (unsigned i = 1; i < maxT; ++i) {
+      ThreadContext& rich = *(workers.getRemote((poor.id + i) % maxT));
+
+      if (tp.getSocket(rich.id) != myPkg && rich.hasWorkWeak()) {
+        sawWork = true;
+        if (transferWork(rich, poor)) {
+          return true;
+        }
+      }
+    }
+
+    return sawWork;
+  }
+
+  GALOIS_ATTRIBUTE_NOINLINE bool trySteal(ThreadContext& poor) {
+    if (stealWithinSocket(poor)) {
+      return true;
+    }
+    substrate::asmPause();
+
+    // only socket leaders go off socket first, so that a whole socket does
+    // not stampede a remote one
+    if (substrate::getThreadPool().isLeader(poor.id) &&
+        stealOutsideSocket(poor)) {
+      return true;
+    }
+    substrate::asmPause();
+
+    return stealOutsideSocket(poor);
+  }
+
+public:
+  //! Whether the chunk indices of range fit in the packed representation
+  static bool fits(const R& range, const ArgsTuple& argsTuple) {
+    Diff_ty cs = get_trait_value<chunk_size_tag>(argsTuple).value;
+    uint64_t size = std::distance(range.begin(), range.end());
+    // leave room for the owner's add past end on an empty interval
+    return (size + cs - 1) / cs < (uint64_t(1) << 32) - 1;
+  }
+
+  DoAllLockFreeStealingExec(const R& _range, F _func,
+                            const ArgsTuple& argsTuple)
+      : range(_range), func(_func),
+        loopname(galois::internal::getLoopName(argsTuple)),
+        global_beg(range.begin()),
+        global_size(std::distance(range.begin(), range.end())),
+        chunk_size(get_trait_value<chunk_size_tag>(argsTuple).value),
+        num_chunks((global_size + chunk_size - 1) / chunk_size),
+        totalTime(loopname, "Total"), initTime(loopname, "Init"),
+        execTime(loopname, "Execute"), stealTime(loopname, "Steal") {
+    assert(chunk_size > 0);
+    assert(num_chunks < (uint64_t(1) << 32) - 1);
+  }
+
+  // parallel call
+  void initThread(void) {
+    initTime.start();
+
+    unsigned id        = substrate::ThreadPool::getTID();
+    ThreadContext& ctx = *workers.getLocal(id);
+    ctx.id             = id;
+    ctx.num_iter       = 0;
+    ctx.work.store(
+        pack(toChunk(range.local_begin()), toChunk(range.local_end())));
+
+    initTime.stop();
+  }
+
+  void operator()(void) {
+    ThreadContext& ctx = *workers.getLocal();
+    totalTime.start();
+
+    while (true) {
+      execTime.start();
+      doWork(ctx);
+      execTime.stop();
+
+      stealTime.start();
+      bool stole = trySteal(ctx);
+      stealTime.stop();
+
+      // trySteal also returns true if it saw work it lost a race for
+      if (!stole) {
+        break;
+      }
+    }
+
+    totalTime.stop();
+    assert(!ctx.hasWorkWeak());
+
+    if (NEED_STATS) {
+      galois::runtime::reportStat_Tsum(loopname, "Iterations", ctx.num_iter);
+    }
+  }
+};
+
+template <bool _STEAL, bool _LOCKFREE = false>
 struct ChooseDoAllImpl {
 
   template <typename R, typename F, typename ArgsT>
@@ -476,7 +741,53 @@ struct ChooseDoAllImpl {
 };
 
 template <>
-struct ChooseDoAllImpl<false> {
+struct ChooseDoAllImpl<true, true> {
+
+  template <typename R>
+  using CanUseLockFree = std::integral_constant<
+      bool, std::is_same<typename R::local_iterator,
+                         typename R::iterator>::value &&
+                std::is_base_of<std::random_access_iterator_tag,
+                                typename std::iterator_traits<
+                                    typename R::iterator>::iterator_category>::
+                    value>;
+
+  template <typename R, typename F, typename ArgsT>
+  static void call(const R& range, F&& func, const ArgsT& argsTuple) {
+    callImpl(range, std::forward<F>(func), argsTuple, CanUseLockFree<R>());
+  }
+
+private:
+  template <typename R, typename F, typename ArgsT>
+  static void callImpl(const R& range, F&& func, const ArgsT& argsTuple,
+                       std::true_type) {
+    typedef internal::DoAllLockFreeStealingExec<
+        R, OperatorReferenceType<decltype(std::forward<F>(func))>, ArgsT>
+        Exec;
+
+    if (!Exec::fits(range, argsTuple)) {
+      ChooseDoAllImpl<true>::call(range, std::forward<F>(func), argsTuple);
+      return;
+    }
+
+    Exec exec(range, std::forward<F>(func), argsTuple);
+
+    substrate::Barrier& barrier = getBarrier(activeThreads);
+
+    substrate::getThreadPool().run(
+        activeThreads, [&exec](void) { exec.initThread(); }, std::ref(barrier),
+        std::ref(exec));
+  }
+
+  template <typename R, typename F, typename ArgsT>
+  static void callImpl(const R& range, F&& func, const ArgsT& argsTuple,
+                       std::false_type) {
+    ChooseDoAllImpl<true>::call(range, std::forward<F>(func), argsTuple);
+  }
+};
+
+template <>
+struct ChooseDoAllImpl<false, false> {
 
   template <typename R, typename F, typename ArgsT>
   static void call(const R& range, F func, const ArgsT& argsTuple) {
@@ -545,10 +856,11 @@ void do_all_gen(const R& range, F&& func, const ArgsTuple& argsTuple) {
 
   timer.start();
 
-  constexpr bool STEAL = has_trait<steal_tag, ArgsT>();
+  constexpr bool LOCKFREE = has_trait<lockfree_steal_tag, ArgsT>();
+  constexpr bool STEAL    = has_trait<steal_tag, ArgsT>() || LOCKFREE;
 
   OperatorReferenceType<decltype(std::forward<F>(func))> func_ref = func;
-  internal::ChooseDoAllImpl<STEAL>::call(range, func_ref, argsT);
+  internal::ChooseDoAllImpl<STEAL, LOCKFREE>::call(range, func_ref, argsT);
 
   timer.stop();
 }
@@ -155,6 +155,7 @@ public:
       !has_trait<disable_conflict_detection_tag, ArgsTy>();
   static constexpr bool needsPia   = has_trait<per_iter_alloc_tag, ArgsTy>();
   static constexpr bool needsBreak = has_trait<parallel_break_tag, ArgsTy>();
+  static constexpr bool noExceptions = has_trait<no_exceptions_tag, ArgsTy>();
   static constexpr bool MORE_STATS =
       needStats && has_trait<more_stats_tag, ArgsTy>();
 
@@ -253,8 +254,9 @@ protected:
     return didWork;
   }
 
+  //! Runs items until one aborts, which unwinds to here
   template <unsigned int limit, typename WL>
-  void runQueueDispatch(ThreadLocalData& tld, WL& lwl, RunQueueState<WL>& s) {
+  void runQueueUnwind(ThreadLocalData& tld, WL& lwl, RunQueueState<WL>& s) {
 #ifdef GALOIS_USE_LONGJMP_ABORT
     if (setjmp(execFrame) == 0) {
       while ((!limit || s.num < limit) && (s.item = lwl.pop())) {
@@ -278,6 +280,29 @@ protected:
 #endif
   }
 
+  //! Runs items whose operators return on conflict, checking each one
+  template <unsigned int limit, typename WL>
+  void runQueueStatus(ThreadLocalData& tld, WL& lwl, RunQueueState<WL>& s) {
+    while ((!limit || s.num < limit) && (s.item = lwl.pop())) {
+      ++s.num;
+      tld.ctx.startIteration();
+      tld.inc_iterations();
+      tld.function(aborted.value(*s.item), tld.facing.data());
+      if (tld.ctx.isConflicted())
+        abortIteration(*s.item, tld);
+      else
+        commitIteration(tld);
+    }
+  }
+
+  template <unsigned int limit, typename WL>
+  void runQueueDispatch(ThreadLocalData& tld, WL& lwl, RunQueueState<WL>& s) {
+    if (noExceptions)
+      runQueueStatus<limit>(tld, lwl, s);
+    else
+      runQueueUnwind<limit>(tld, lwl, s);
+  }
+
   template <unsigned int limit, typename WL>
   bool runQueue(ThreadLocalData& tld, WL& lwl) {
     RunQueueState<WL> s;
@@ -312,8 +337,10 @@ protected:
     ThreadLocalData tld(origFunction, loopname);
     if (needsBreak)
       tld.facing.setBreakFlag(&broke);
-    if (couldAbort)
+    if (couldAbort) {
+      tld.ctx.setDeferConflicts(noExceptions);
       setThreadContext(&tld.ctx);
+    }
     if (needsPush && !couldAbort)
       tld.facing.setFastPushBack(std::bind(&ForEachExecutor::fastPushBack, this,
                                            std::placeholders::_1));
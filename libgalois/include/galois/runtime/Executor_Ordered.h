@@ -20,31 +20,413 @@
 #ifndef GALOIS_RUNTIME_EXECUTOR_ORDERED_H
 #define GALOIS_RUNTIME_EXECUTOR_ORDERED_H
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <iterator>
+#include <vector>
+
 #include "galois/config.h"
+#include "galois/gIO.h"
+#include "galois/runtime/Context.h"
+#include "galois/runtime/LoopStatistics.h"
+#include "galois/runtime/Statistics.h"
+#include "galois/runtime/Substrate.h"
+#include "galois/runtime/UserContextAccess.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/ThreadPool.h"
+#include "galois/Threads.h"
 
 namespace galois {
 namespace runtime {
 
-// TODO(ddn): Pull in and integrate in executors from exp
+namespace internal {
+
+//! Stability test of stable source algorithms: every source is stable
+struct AlwaysStable {
+  template <typename T>
+  bool operator()(const T&) const {
+    return true;
+  }
+};
+
+/**
+ * Windowed executor for ordered loops, in the style of the kinetic dependence
+ * graph (KDG) executors.
+ *
+ * Every round takes the earliest pending items as a window and ranks them in
+ * priority order. The neighborhood function of every window item is run in
+ * parallel, and each lock goes to the earliest item that wants it, so an item
+ * that owns its whole neighborhood conflicts with no earlier item of the
+ * window. Those items (that also pass the stability test) then execute in
+ * parallel; the others, and items that abort because the operator touches
+ * data outside of the declared neighborhood, go back to the pending set.
+ * The earliest pending item always executes, so every round makes progress.
+ *
+ * The window grows while most of it commits and shrinks when conflicts
+ * dominate.
+ *
+ * Pending items live in per-thread heaps; new and retried items go to the
+ * heap of the thread that executed them. To form a window, every thread pops
+ * its share of the window from its own heap in parallel, and the leader
+ * merges these sorted runs up to the earliest last item of a thread that
+ * still has items left, which keeps the window a prefix of the pending items.
+ * Unused items of the runs go back to their heaps.
+ */
+template <typename T, typename Cmp, typename NhFunc, typename OpFunc,
+          typename StableTest>
+class OrderedExecutor {
+  class Context : public SimpleRuntimeContext {
+  public:
+    T item;
+    size_t rank;
+    bool expanding;
+    //! Set by whichever thread steals a lock from this item during the
+    //! neighborhood phase, concurrently with the thread expanding it
+    std::atomic<bool> notReady;
+
+    Context(const T& _item, size_t _rank)
+        : SimpleRuntimeContext(true), item(_item), rank(_rank),
+          expanding(true), notReady(false) {}
+
+  protected:
+    virtual void subAcquire(Lockable* lockable, galois::MethodFlag) {
+      if (!expanding) {
+        // Only data outside of the neighborhood can be acquired here
+        AcquireStatus s = tryAcquire(lockable);
+        if (s == NEW_OWNER)
+          addToNhood(lockable);
+        else if (s == FAIL)
+          signalConflict(lockable);
+        return;
+      }
+
+      if (this->tryLock(lockable))
+        this->addToNhood(lockable);
+
+      Context* other;
+      do {
+        other = static_cast<Context*>(this->getOwner(lockable));
+        if (other == this)
+          return;
+        if (other && other->rank < rank) {
+          notReady.store(true, std::memory_order_relaxed);
+          return;
+        }
+      } while (!this->stealByCAS(lockable, other));
+
+      // Disable loser
+      if (other)
+        other->notReady.store(true, std::memory_order_relaxed);
+    }
+  };
+
+  struct ThreadLocalData : public LoopStatistics<true> {
+    UserContextAccess<T> facing;
+    ThreadLocalData(const char* ln) : LoopStatistics<true>(ln) {}
+  };
+
+  static const size_t maxWindow = 1 << 20;
+
+  const Cmp& cmp;
+  const NhFunc& nhFunc;
+  const OpFunc& opFunc;
+  const StableTest& stabilityTest;
+  const char* loopname;
+  substrate::Barrier& barrier;
+
+  struct PerThread {
+    //! Min-heap of items waiting for a round
+    std::vector<T> heap;
+    //! Earliest items of the heap, in order, offered to the next window
+    std::vector<T> run;
+    //! Number of items of run that went into the window
+    size_t taken = 0;
+  };
+
+  substrate::PerThreadStorage<PerThread> queues;
+  std::deque<Context> window;
+  std::atomic<size_t> nextNhood;
+  std::atomic<size_t> nextExec;
+  std::atomic<size_t> committed;
+  //! Set if the earliest item of the window aborted
+  std::atomic<bool> firstAborted;
+  bool broke;
+
+  size_t windowSize;
+  size_t minWindow;
+  size_t rounds;
+  size_t totalCommitted;
+  size_t totalAttempted;
+
+  //! True if a comes strictly before b
+  bool before(const T& a, const T& b) const { return !cmp(b, a); }
+
+  //! Heap order that puts the earliest item on top
+  auto later() const {
+    return [this](const T& a, const T& b) { return before(b, a); };
+  }
+
+  void pushLocal(PerThread& p, const T& item) {
+    p.heap.push_back(item);
+    std::push_heap(p.heap.begin(), p.heap.end(), later());
+  }
+
+  //! Window size for the next round, from the outcome of the current one
+  size_t nextWindowSize() const {
+    size_t c = committed;
+    if (c * 10 > window.size() * 9)
+      return std::min(windowSize * 2, maxWindow);
+    if (c * 2 < window.size())
+      return std::max(windowSize / 2, minWindow);
+    return windowSize;
+  }
 
+  //! Pops this thread's share of the next window off its heap
+  void fillRun(PerThread& p) {
+    if (broke)
+      p.heap.clear();
+    size_t size  = firstAborted ? 1 : nextWindowSize();
+    size_t quota = (size + activeThreads - 1) / activeThreads;
+    p.run.clear();
+    while (p.run.size() < quota && !p.heap.empty()) {
+      std::pop_heap(p.heap.begin(), p.heap.end(), later());
+      p.run.push_back(p.heap.back());
+      p.heap.pop_back();
+    }
+  }
+
+  //! Merges the runs of all threads into the next window
+  void beginRound() {
+    size_t next = nextWindowSize();
+    if (!window.empty()) {
+      ++rounds;
+      totalCommitted += committed;
+      totalAttempted += window.size();
+    }
+    windowSize  = next;
+    size_t size = firstAborted ? 1 : windowSize;
+    window.clear();
+
+    // Items after the earliest last item of a thread with items left in its
+    // heap may come after items that are not in any run
+    const T* bound = nullptr;
+    std::vector<PerThread*> runs;
+    for (unsigned i = 0; i < activeThreads; ++i) {
+      PerThread& p = *queues.getRemote(i);
+      p.taken      = 0;
+      if (p.run.empty())
+        continue;
+      runs.push_back(&p);
+      if (!p.heap.empty() && (!bound || before(p.run.back(), *bound)))
+        bound = &p.run.back();
+    }
+
+    auto head = [this](const PerThread* a, const PerThread* b) {
+      return before(b->run[b->taken], a->run[a->taken]);
+    };
+    std::make_heap(runs.begin(), runs.end(), head);
+    while (!runs.empty() && window.size() < size) {
+      std::pop_heap(runs.begin(), runs.end(), head);
+      PerThread& p  = *runs.back();
+      const T& item = p.run[p.taken];
+      if (bound && before(*bound, item))
+        break;
+      size_t rank = window.size();
+      window.emplace_back(item, rank);
+      if (++p.taken < p.run.size())
+        std::push_heap(runs.begin(), runs.end(), head);
+      else
+        runs.pop_back();
+    }
+
+    nextNhood    = 0;
+    nextExec     = 0;
+    committed    = 0;
+    firstAborted = false;
+  }
+
+  void returnLeftovers(PerThread& p) {
+    for (size_t i = p.taken; i < p.run.size(); ++i)
+      pushLocal(p, p.run[i]);
+  }
+
+  void expandNhoods() {
+    size_t i;
+    while ((i = nextNhood++) < window.size()) {
+      Context& ctx = window[i];
+      ctx.startIteration();
+      setThreadContext(&ctx);
+      nhFunc(ctx.item);
+      ctx.expanding = false;
+    }
+    setThreadContext(0);
+  }
+
+  //! Runs the operator on ctx; returns false if it aborted
+  bool runFunction(ThreadLocalData& tld, Context& ctx) {
+    int result = 0;
+    setThreadContext(&ctx);
+#ifdef GALOIS_USE_LONGJMP_ABORT
+    if ((result = setjmp(execFrame)) == 0) {
+#elif defined(GALOIS_USE_EXCEPTION_ABORT)
+    try {
+#endif
+      opFunc(ctx.item, tld.facing.data());
+#ifdef GALOIS_USE_LONGJMP_ABORT
+    } else {
+      clearConflictLock();
+    }
+#elif defined(GALOIS_USE_EXCEPTION_ABORT)
+    } catch (const ConflictFlag& flag) {
+      clearConflictLock();
+      result = flag;
+    }
+#endif
+    setThreadContext(0);
+
+    switch (result) {
+    case 0:
+      return true;
+    case CONFLICT:
+      return false;
+    default:
+      GALOIS_DIE("unknown conflict flag");
+    }
+    return false;
+  }
+
+  void executeWindow(ThreadLocalData& tld, PerThread& p) {
+    size_t i;
+    while ((i = nextExec++) < window.size()) {
+      Context& ctx = window[i];
+      tld.inc_iterations();
+      // Nothing can come before the earliest item, so it is always stable
+      if (ctx.notReady.load(std::memory_order_relaxed) ||
+          (ctx.rank != 0 && !stabilityTest(ctx.item))) {
+        ctx.notReady.store(true, std::memory_order_relaxed);
+        tld.inc_conflicts();
+        pushLocal(p, ctx.item);
+        continue;
+      }
+
+      if (runFunction(tld, ctx)) {
+        auto& buffer = tld.facing.getPushBuffer();
+        tld.inc_pushes(std::distance(buffer.begin(), buffer.end()));
+        for (auto& item : buffer)
+          pushLocal(p, item);
+        ++committed;
+      } else {
+        ctx.notReady.store(true, std::memory_order_relaxed);
+        tld.inc_conflicts();
+        pushLocal(p, ctx.item);
+        if (ctx.rank == 0)
+          firstAborted = true;
+      }
+      tld.facing.resetPushBuffer();
+      tld.facing.resetAlloc();
+    }
+  }
+
+  //! Releases this thread's block of the neighborhoods of the previous
+  //! window
+  void commitWindow(unsigned tid) {
+    size_t n = window.size();
+    for (size_t i = n * tid / activeThreads, e = n * (tid + 1) / activeThreads;
+         i < e; ++i)
+      window[i].commitIteration();
+  }
+
+  void go(const std::vector<T>& initial) {
+    ThreadLocalData tld(loopname);
+    tld.facing.setBreakFlag(&broke);
+    unsigned tid = substrate::ThreadPool::getTID();
+    bool leader  = tid == 0;
+
+    PerThread& p = *queues.getLocal();
+    size_t n     = initial.size();
+    p.heap.assign(initial.begin() + n * tid / activeThreads,
+                  initial.begin() + n * (tid + 1) / activeThreads);
+    std::make_heap(p.heap.begin(), p.heap.end(), later());
+
+    while (true) {
+      commitWindow(tid);
+      fillRun(p);
+      barrier.wait();
+      if (leader)
+        beginRound();
+      barrier.wait();
+      if (window.empty())
+        break;
+      returnLeftovers(p);
+      expandNhoods();
+      barrier.wait();
+      executeWindow(tld, p);
+      barrier.wait();
+    }
+
+    if (leader) {
+      reportStat_Single(loopname, "Rounds", rounds);
+      reportStat_Single(loopname, "CommitRate",
+                        totalAttempted ? double(totalCommitted) /
+                                             double(totalAttempted)
+                                       : 1.0);
+    }
+  }
+
+public:
+  OrderedExecutor(const Cmp& _cmp, const NhFunc& _nhFunc,
+                  const OpFunc& _opFunc, const StableTest& _stabilityTest,
+                  const char* ln)
+      : cmp(_cmp), nhFunc(_nhFunc), opFunc(_opFunc),
+        stabilityTest(_stabilityTest), loopname(ln ? ln : "for_each_ordered"),
+        barrier(getBarrier(activeThreads)), nextNhood(0), nextExec(0),
+        committed(0), firstAborted(false), broke(false),
+        windowSize(4 * activeThreads), minWindow(activeThreads), rounds(0),
+        totalCommitted(0), totalAttempted(0) {}
+
+  template <typename Iter>
+  void run(Iter beg, Iter end) {
+    std::vector<T> initial(beg, end);
+    substrate::getThreadPool().run(activeThreads,
+                                   [&, this]() { go(initial); });
+  }
+};
+
+} // namespace internal
+
+/**
+ * Ordered loop for stable source algorithms. A source is stable if no item
+ * pushed later can come before it and share its neighborhood, so any item
+ * that comes before every conflicting item of the current window is safe to
+ * execute.
+ */
 template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc>
-void for_each_ordered_impl(Iter GALOIS_UNUSED(beg), Iter GALOIS_UNUSED(end),
-                           const Cmp& GALOIS_UNUSED(cmp),
-                           const NhFunc& GALOIS_UNUSED(nhFunc),
-                           const OpFunc& GALOIS_UNUSED(opFunc),
-                           const char* GALOIS_UNUSED(loopname)) {
-  GALOIS_DIE("not yet implemented");
+void for_each_ordered_impl(Iter beg, Iter end, const Cmp& cmp,
+                           const NhFunc& nhFunc, const OpFunc& opFunc,
+                           const char* loopname) {
+  typedef typename std::iterator_traits<Iter>::value_type T;
+  internal::AlwaysStable stable;
+  internal::OrderedExecutor<T, Cmp, NhFunc, OpFunc, internal::AlwaysStable> e(
+      cmp, nhFunc, opFunc, stable, loopname);
+  e.run(beg, end);
 }
 
+/**
+ * Ordered loop for unstable source algorithms. Items that do not conflict with
+ * earlier items of the window execute only if stabilityTest also holds for
+ * them; the others wait for a later round.
+ */
 template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc,
           typename StableTest>
-void for_each_ordered_impl(Iter GALOIS_UNUSED(beg), Iter GALOIS_UNUSED(end),
-                           const Cmp& GALOIS_UNUSED(cmp),
-                           const NhFunc& GALOIS_UNUSED(nhFunc),
-                           const OpFunc& GALOIS_UNUSED(opFunc),
-                           const StableTest& GALOIS_UNUSED(stabilityTest),
-                           const char* GALOIS_UNUSED(loopname)) {
-  GALOIS_DIE("not yet implemented");
+void for_each_ordered_impl(Iter beg, Iter end, const Cmp& cmp,
+                           const NhFunc& nhFunc, const OpFunc& opFunc,
+                           const StableTest& stabilityTest,
+                           const char* loopname) {
+  typedef typename std::iterator_traits<Iter>::value_type T;
+  internal::OrderedExecutor<T, Cmp, NhFunc, OpFunc, StableTest> e(
+      cmp, nhFunc, opFunc, stabilityTest, loopname);
+  e.run(beg, end);
 }
 
 } // end namespace runtime
@@ -61,7 +61,8 @@ void pageInReadOnly(void* buf, size_t len, size_t stride);
 int numNumaAllocForNode(unsigned nodeid);
 
 //! Print lines from /proc/pid/numa_maps that contain at least n (non-huge)
-//! pages
+//! pages, as well as every line backed by huge pages; each line has the pages
+//! of the mapping on each NUMA node
 void printInterleavedStats(int minPages = 16 * 1024);
 
 //! [Example Third Party Allocator]
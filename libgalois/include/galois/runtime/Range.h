@@ -299,6 +299,24 @@ public:
   }
 };
 
+template <typename G>
+class EdgeBalancedRangeMaker {
+  G& m_graph;
+  size_t m_nodeWeight;
+  size_t m_edgeWeight;
+
+public:
+  EdgeBalancedRangeMaker(G& graph, size_t nodeWeight, size_t edgeWeight)
+      : m_graph(graph), m_nodeWeight(nodeWeight), m_edgeWeight(edgeWeight) {}
+
+  template <typename Arg>
+  auto operator()(const Arg&) const {
+    return runtime::makeSpecificRange(
+        m_graph.begin(), m_graph.end(),
+        m_graph.getEdgeBalancedRanges(m_nodeWeight, m_edgeWeight));
+  }
+};
+
 template <typename C>
 class HasLocalIter {
 
@@ -335,5 +353,24 @@ auto iterate(const I& beg, const I& end) {
   return internal::IteratorRangeMaker<I, std::is_integral<I>::value>(beg, end);
 }
 
+/**
+ * Iterates over the nodes of a graph, giving each thread a contiguous block of
+ * nodes with about the same weight of nodes and edges. Unlike iterate(graph),
+ * which divides nodes evenly by count, this balances loops whose work grows
+ * with the degree of a node on skewed graphs without needing steal().
+ *
+ * The graph must provide getEdgeBalancedRanges (see LC_CSR_Graph), which
+ * caches the division for later loops.
+ *
+ * @param graph graph whose nodes to iterate over
+ * @param nodeWeight weight to give to a node in division
+ * @param edgeWeight weight to give to an edge in division
+ */
+template <typename G>
+auto iterate_edge_balanced(G& graph, size_t nodeWeight = 1,
+                           size_t edgeWeight = 1) {
+  return internal::EdgeBalancedRangeMaker<G>(graph, nodeWeight, edgeWeight);
+}
+
 } // end namespace galois
 #endif
@@ -52,6 +52,15 @@ struct HWTopoInfo {
 /**
  * getHWTopo determines the machine topology from the process information
  * exposed in /proc and /dev filesystems.
+ *
+ * Only CPUs in the affinity mask and the cgroup cpuset of the process are
+ * used, and with a cgroup CPU quota only as many CPUs as the quota allows.
+ * The GALOIS_THREAD_PLACEMENT environment variable orders the CPUs that
+ * threads are bound to: "compact" (the default) fills the cores of one socket
+ * before the next, "scatter" assigns consecutive threads to different
+ * sockets, and a CPU list such as "0-3,8-11" binds threads to exactly those
+ * CPUs in that order. In compact and scatter order, hyperthreads come after
+ * all physical cores.
  */
 HWTopoInfo getHWTopo();
 
@@ -61,6 +70,14 @@ HWTopoInfo getHWTopo();
  */
 std::vector<int> parseCPUList(const std::string& in);
 
+/**
+ * parseCPUQuota returns the number of CPUs that a cgroup CPU bandwidth limit
+ * of quota per period allows, rounded up, or 0 if there is no limit. quota
+ * and period are as in cgroup v2 cpu.max (where quota may be "max") or cgroup
+ * v1 cpu.cfs_quota_us (where quota may be -1) and cpu.cfs_period_us.
+ */
+unsigned parseCPUQuota(const std::string& quota, const std::string& period);
+
 /**
  * bindThreadSelf binds a thread to an osContext as returned by getHWTopo.
  */
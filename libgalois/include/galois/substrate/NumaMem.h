@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "galois/config.h"
+#include "galois/substrate/PageAlloc.h"
 
 namespace galois {
 namespace substrate {
@@ -38,12 +39,18 @@ struct largeFreer {
 
 typedef std::unique_ptr<void, internal::largeFreer> LAptr;
 
-LAptr largeMallocLocal(size_t bytes);    // fault in locally
-LAptr largeMallocFloating(size_t bytes); // leave numa mapping undefined
+// kind selects the OS pages backing the allocation (see PageKind)
+
+// fault in locally
+LAptr largeMallocLocal(size_t bytes, PageKind kind = PageKind::Default);
+// leave numa mapping undefined
+LAptr largeMallocFloating(size_t bytes, PageKind kind = PageKind::Default);
 // fault in interleaved mapping
-LAptr largeMallocInterleaved(size_t bytes, unsigned numThreads);
+LAptr largeMallocInterleaved(size_t bytes, unsigned numThreads,
+                             PageKind kind = PageKind::Default);
 // fault in block interleaved mapping
-LAptr largeMallocBlocked(size_t bytes, unsigned numThreads);
+LAptr largeMallocBlocked(size_t bytes, unsigned numThreads,
+                         PageKind kind = PageKind::Default);
 
 // fault in specified regions for each thread (threadRanges)
 template <typename RangeArrayTy>
@@ -65,8 +65,27 @@ namespace substrate {
 // size of pages
 size_t allocSize();
 
+//! Kind of OS pages backing an allocation of pages
+enum class PageKind {
+  Default,     //!< huge pages of allocSize() if available, else small pages
+  Small,       //!< small pages only
+  Transparent, //!< small pages with transparent huge pages requested
+  Huge1G       //!< 1GB huge pages if available, else as Default
+};
+
+//! Granularity of an allocation with the given kind of pages
+size_t allocSize(PageKind kind);
+
 // allocate contiguous pages, optionally faulting them in
-void* allocPages(unsigned num, bool preFault);
+void* allocPages(unsigned num, bool preFault,
+                 PageKind kind = PageKind::Default);
+
+// allocate pages for at least bytes, optionally faulting them in; bytes is
+// rounded up to the size actually mapped, which 1GB pages are only used for
+// if the request is at least that large and the mapping succeeds. kind is
+// set to Default if 1GB pages were asked for but not used, so that
+// allocSize(kind) is the granularity of the mapping
+void* allocRegion(size_t& bytes, bool preFault, PageKind& kind);
 
 // free page range
 void freePages(void* ptr, unsigned num);
@@ -0,0 +1,299 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_WORKLIST_BATCHEDBULKSYNCHRONOUS_H
+#define GALOIS_WORKLIST_BATCHEDBULKSYNCHRONOUS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "galois/config.h"
+#include "galois/Timer.h"
+#include "galois/runtime/Statistics.h"
+#include "galois/runtime/Substrate.h"
+#include "galois/worklists/Chunk.h"
+#include "galois/worklists/WLCompileCheck.h"
+
+namespace galois {
+namespace worklists {
+
+//! Indexer of BatchedBulkSynchronous that disables deduplication
+struct NoDedupe {};
+
+namespace internal {
+
+/**
+ * Bitset of the items queued for a round. Bits are set when an item is
+ * queued and reset when it is popped, so the bitset is clear again by the
+ * time the round ends and never needs a separate clearing pass.
+ */
+template <typename Indexer>
+class DedupeSet {
+  Indexer indexer;
+  size_t numWords;
+  std::unique_ptr<std::atomic<uint64_t>[]> bits[2];
+
+public:
+  DedupeSet(const Indexer& x, size_t numKeys)
+      : indexer(x), numWords((numKeys + 63) / 64) {
+    for (auto& b : bits) {
+      b.reset(new std::atomic<uint64_t>[numWords]);
+      for (size_t i = 0; i < numWords; ++i)
+        b[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  //! Returns true if val was not yet queued for the given round
+  template <typename T>
+  bool insert(unsigned round, const T& val) {
+    size_t key = indexer(val);
+    assert(key / 64 < numWords);
+    uint64_t mask = uint64_t(1) << (key % 64);
+    if (bits[round][key / 64].load(std::memory_order_relaxed) & mask)
+      return false;
+    return !(bits[round][key / 64].fetch_or(mask, std::memory_order_relaxed) &
+             mask);
+  }
+
+  template <typename T>
+  void erase(unsigned round, const T& val) {
+    size_t key = indexer(val);
+    bits[round][key / 64].fetch_and(~(uint64_t(1) << (key % 64)),
+                                    std::memory_order_relaxed);
+  }
+};
+
+template <>
+class DedupeSet<NoDedupe> {
+public:
+  DedupeSet(const NoDedupe&, size_t) {}
+
+  template <typename T>
+  bool insert(unsigned, const T&) {
+    return true;
+  }
+
+  template <typename T>
+  void erase(unsigned, const T&) {}
+};
+
+} // namespace internal
+
+/**
+ * Bulk-synchronous scheduling with batched pushes. Like BulkSynchronous, work
+ * is processed in rounds separated by barriers. Rather than pushing every new
+ * item into the shared container, each thread buffers the items for the next
+ * round in a bounded local array and hands them to the (per-socket by
+ * default) container a batch at a time, which cuts contention on the chunk
+ * lists when rounds are large.
+ *
+ * With an Indexer mapping items to keys in [0, numKeys), an item is queued at
+ * most once per round; later pushes of an item with the same key in the same
+ * round are dropped. This suits algorithms whose items are nodes, e.g.,
+ * level-synchronous BFS, k-core or label propagation.
+ *
+ * If constructed with a loop name, the number of rounds, the largest size
+ * (items popped) and time in microseconds of a round, and a histogram of round
+ * sizes are reported as statistics of that loop. The histogram is a list of
+ * counts separated by ';' whose entry i counts the rounds of fewer than 2^i
+ * items but at least 2^(i-1), so high-diameter runs with many rounds still
+ * report a handful of statistics.
+ *
+ * @tparam Container container the items of a round are kept in
+ * @tparam BatchSize number of items a thread buffers before flushing them
+ * @tparam Indexer functor from an item to its key, or NoDedupe
+ */
+template <class Container = PerSocketChunkFIFO<>, unsigned BatchSize = 64,
+          typename Indexer = NoDedupe, class T = int, bool Concurrent = true>
+class BatchedBulkSynchronous : private boost::noncopyable {
+public:
+  template <bool _concurrent>
+  using rethread =
+      BatchedBulkSynchronous<Container, BatchSize, Indexer, T, _concurrent>;
+
+  template <typename _T>
+  using retype =
+      BatchedBulkSynchronous<typename Container::template retype<_T>,
+                             BatchSize, Indexer, _T, Concurrent>;
+
+  template <typename _container>
+  using with_container =
+      BatchedBulkSynchronous<_container, BatchSize, Indexer, T, Concurrent>;
+
+  template <unsigned _batch_size>
+  using with_batch_size =
+      BatchedBulkSynchronous<Container, _batch_size, Indexer, T, Concurrent>;
+
+  template <typename _indexer>
+  using with_indexer =
+      BatchedBulkSynchronous<Container, BatchSize, _indexer, T, Concurrent>;
+
+  static_assert(BatchSize > 0, "batches must hold at least one item");
+
+private:
+  typedef typename Container::template rethread<Concurrent> CTy;
+
+  struct TLD {
+    unsigned round;
+    unsigned size;
+    size_t popped;
+    std::array<T, BatchSize> batch;
+    TLD() : round(0), size(0), popped(0) {}
+  };
+
+  CTy wls[2];
+  internal::DedupeSet<Indexer> queued;
+  substrate::PerThreadStorage<TLD> tlds;
+  substrate::Barrier& barrier;
+  substrate::CacheLineStorage<std::atomic<bool>> some;
+  std::atomic<bool> isEmpty;
+
+  const char* loopname;
+  galois::Timer roundTimer;
+  // round statistics; only kept with a loop name
+  size_t numRounds      = 0;
+  size_t maxRoundSize   = 0;
+  uint64_t maxRoundTime = 0;
+  std::vector<size_t> roundSizes;
+
+  void flush(TLD& tld) {
+    if (!tld.size)
+      return;
+    wls[(tld.round + 1) & 1].push(tld.batch.begin(),
+                                  tld.batch.begin() + tld.size);
+    tld.size = 0;
+    if (!some.get().load(std::memory_order_relaxed))
+      some.get() = true;
+  }
+
+  //! Called by thread 0 while every thread waits between rounds
+  void endRound() {
+    if (loopname) {
+      roundTimer.stop();
+      size_t popped = 0;
+      for (unsigned i = 0; i < runtime::activeThreads; ++i) {
+        popped += tlds.getRemote(i)->popped;
+        tlds.getRemote(i)->popped = 0;
+      }
+      size_t sizeClass = 0;
+      while (popped >> sizeClass)
+        ++sizeClass;
+      if (roundSizes.size() <= sizeClass)
+        roundSizes.resize(sizeClass + 1);
+      roundSizes[sizeClass] += 1;
+      numRounds += 1;
+      maxRoundSize = std::max(maxRoundSize, popped);
+      maxRoundTime = std::max(maxRoundTime, roundTimer.get_usec());
+      roundTimer.start();
+    }
+    if (!some.get())
+      isEmpty = true;
+    some.get() = false;
+  }
+
+public:
+  typedef T value_type;
+
+  /**
+   * @param ln loop name to report round statistics under; none if null
+   * @param indexer maps items to keys when deduplicating
+   * @param numKeys number of keys of the indexer
+   */
+  explicit BatchedBulkSynchronous(const char* ln = nullptr,
+                                  const Indexer& indexer = Indexer(),
+                                  size_t numKeys         = 0)
+      : queued(indexer, numKeys),
+        barrier(runtime::getBarrier(runtime::activeThreads)), some(false),
+        isEmpty(false), loopname(ln) {}
+
+  ~BatchedBulkSynchronous() {
+    if (!loopname)
+      return;
+    runtime::reportStat_Single(loopname, "Rounds", numRounds);
+    runtime::reportStat_Single(loopname, "MaxRoundSize", maxRoundSize);
+    runtime::reportStat_Single(loopname, "MaxRoundTime", maxRoundTime);
+    std::string histogram;
+    for (size_t i = 0; i < roundSizes.size(); ++i)
+      histogram += (i ? ";" : "") + std::to_string(roundSizes[i]);
+    runtime::reportParam(loopname, "RoundSizeHistogram", histogram);
+  }
+
+  void push(const value_type& val) {
+    TLD& tld = *tlds.getLocal();
+    if (!queued.insert((tld.round + 1) & 1, val))
+      return;
+    tld.batch[tld.size++] = val;
+    if (tld.size == BatchSize)
+      flush(tld);
+  }
+
+  template <typename ItTy>
+  void push(ItTy b, ItTy e) {
+    while (b != e)
+      push(*b++);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    auto rp  = range.local_pair();
+    TLD& tld = *tlds.getLocal();
+    push(rp.first, rp.second);
+    flush(tld);
+    tld.round  = 1;
+    some.get() = true;
+    if (loopname && substrate::ThreadPool::getTID() == 0)
+      roundTimer.start();
+  }
+
+  galois::optional<value_type> pop() {
+    TLD& tld = *tlds.getLocal();
+    galois::optional<value_type> r;
+
+    while (true) {
+      if (isEmpty)
+        return r; // empty
+
+      r = wls[tld.round].pop();
+      if (r) {
+        queued.erase(tld.round, *r);
+        ++tld.popped;
+        return r;
+      }
+
+      // the current round is drained; publish this thread's next round
+      flush(tld);
+      barrier.wait();
+      if (substrate::ThreadPool::getTID() == 0)
+        endRound();
+      tld.round = (tld.round + 1) & 1;
+      barrier.wait();
+    }
+  }
+};
+GALOIS_WLCOMPILECHECK(BatchedBulkSynchronous)
+
+} // end namespace worklists
+} // end namespace galois
+
+#endif
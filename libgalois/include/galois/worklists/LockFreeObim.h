@@ -0,0 +1,544 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_WORKLIST_LOCKFREEOBIM_H
+#define GALOIS_WORKLIST_LOCKFREEOBIM_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include "galois/config.h"
+#include "galois/runtime/Substrate.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/worklists/Chunk.h"
+#include "galois/worklists/Obim.h"
+#include "galois/worklists/WorkListHelpers.h"
+
+namespace galois {
+namespace worklists {
+
+/**
+ * Approximate priority scheduling without a global bucket lock.
+ *
+ * Same interface and scheduling policy as {@link OrderedByIntegerMetric},
+ * but buckets are kept in a single shared radix tree keyed by the index
+ * instead of a master log replayed into per-thread maps. Creating a bucket is
+ * a CAS into the tree, and searching for work walks per-node occupancy
+ * bitmasks from the back-scan start, so neither push nor pop serializes on
+ * bucket creation.
+ *
+ * Buckets are reclaimed once they drain. Each bucket counts the threads that
+ * may hold items of it in thread-local chunks; a thread releases a bucket
+ * when its pop from the bucket fails, and the last thread to release it
+ * unlinks the bucket from the tree. Unlinked buckets are recycled with
+ * epoch-based reclamation, so threads still scanning them are safe. Recycled
+ * buckets go to a per-thread free list and are reused for new indices, which
+ * keeps bucket creation off the per-thread storage allocator.
+ *
+ * The index type must be integral. Barrier mode (see
+ * OrderedByIntegerMetric::with_barrier) is not supported.
+ *
+ * @tparam Indexer        Indexer class
+ * @tparam Container      Scheduler for each bucket
+ * @tparam BlockPeriod    Check for higher priority work every 2^BlockPeriod
+ *                        iterations
+ * @tparam BSP            Use back-scan prevention
+ * @tparam T              Work item type
+ * @tparam Index          Indexer return type
+ * @tparam UseMonotonic   Assume that an activity at priority p will not
+ * schedule work at priority p or any priority p1 where p1 < p.
+ * @tparam UseDescending  Use descending order instead
+ * @tparam Concurrent     Whether or not to allow concurrent execution
+ */
+template <class Indexer      = DummyIndexer<int>,
+          typename Container = PerSocketChunkFIFO<>, unsigned BlockPeriod = 0,
+          bool BSP = true, typename T = int, typename Index = int,
+          bool UseMonotonic = false, bool UseDescending = false,
+          bool Concurrent = true>
+struct LockFreeOrderedByIntegerMetric
+    : private boost::noncopyable,
+      public internal::OrderedByIntegerMetricComparator<Index, UseDescending> {
+  static_assert(std::is_integral<Index>::value,
+                "only integral index types supported");
+
+  template <typename _T>
+  using retype = LockFreeOrderedByIntegerMetric<
+      Indexer, typename Container::template retype<_T>, BlockPeriod, BSP, _T,
+      typename std::result_of<Indexer(_T)>::type, UseMonotonic, UseDescending,
+      Concurrent>;
+
+  template <bool _b>
+  using rethread =
+      LockFreeOrderedByIntegerMetric<Indexer, Container, BlockPeriod, BSP, T,
+                                     Index, UseMonotonic, UseDescending, _b>;
+
+  template <unsigned _period>
+  struct with_block_period {
+    typedef LockFreeOrderedByIntegerMetric<Indexer, Container, _period, BSP, T,
+                                           Index, UseMonotonic, UseDescending,
+                                           Concurrent>
+        type;
+  };
+
+  template <typename _container>
+  struct with_container {
+    typedef LockFreeOrderedByIntegerMetric<Indexer, _container, BlockPeriod,
+                                           BSP, T, Index, UseMonotonic,
+                                           UseDescending, Concurrent>
+        type;
+  };
+
+  template <typename _indexer>
+  struct with_indexer {
+    typedef LockFreeOrderedByIntegerMetric<_indexer, Container, BlockPeriod,
+                                           BSP, T, Index, UseMonotonic,
+                                           UseDescending, Concurrent>
+        type;
+  };
+
+  template <bool _bsp>
+  struct with_back_scan_prevention {
+    typedef LockFreeOrderedByIntegerMetric<Indexer, Container, BlockPeriod,
+                                           _bsp, T, Index, UseMonotonic,
+                                           UseDescending, Concurrent>
+        type;
+  };
+
+  template <bool _use_monotonic>
+  struct with_monotonic {
+    typedef LockFreeOrderedByIntegerMetric<Indexer, Container, BlockPeriod,
+                                           BSP, T, Index, _use_monotonic,
+                                           UseDescending, Concurrent>
+        type;
+  };
+
+  template <bool _use_descending>
+  struct with_descending {
+    typedef LockFreeOrderedByIntegerMetric<Indexer, Container, BlockPeriod,
+                                           BSP, T, Index, UseMonotonic,
+                                           _use_descending, Concurrent>
+        type;
+  };
+
+  typedef T value_type;
+  typedef Index index_type;
+
+private:
+  typedef typename Container::template rethread<Concurrent> CTy;
+  typedef typename std::make_unsigned<Index>::type Key;
+
+  static constexpr unsigned KEY_BITS   = sizeof(Key) * 8;
+  static constexpr unsigned RADIX_BITS = 6;
+  static constexpr unsigned RADIX      = 1U << RADIX_BITS;
+  static constexpr unsigned LEVELS = (KEY_BITS + RADIX_BITS - 1) / RADIX_BITS;
+  static constexpr unsigned DEAD   = 1U << 31;
+  static constexpr uint64_t QUIESCENT   = ~uint64_t(0);
+  static constexpr size_t RETIRE_PERIOD = 64;
+  static constexpr size_t FREE_LIMIT    = 4 * RETIRE_PERIOD;
+
+  struct Bucket {
+    CTy wl;
+    Index index;
+    //! number of threads that may hold items of this bucket locally
+    std::atomic<unsigned> holders;
+
+    Bucket() : index(), holders(0) {}
+  };
+
+  //! Radix tree node; children of the last level are buckets
+  struct Node {
+    //! bit d is set if child d may lead to a bucket
+    std::atomic<uint64_t> occupied;
+    std::atomic<void*> child[RADIX];
+
+    Node() : occupied(0) {
+      for (unsigned i = 0; i < RADIX; ++i)
+        child[i].store(nullptr, std::memory_order_relaxed);
+    }
+  };
+
+  struct ThreadData {
+    Index curIndex;
+    Index scanStart;
+    Bucket* current;
+    unsigned int numPops;
+    std::atomic<uint64_t> epoch;
+    std::deque<std::pair<uint64_t, Bucket*>> retired;
+    //! buckets this thread is counted as a holder of
+    std::unordered_set<Bucket*> held;
+    //! drained buckets that no thread can reach anymore
+    std::vector<Bucket*> freeBuckets;
+
+    ThreadData(Index initial)
+        : curIndex(initial), scanStart(initial), current(0), numPops(0),
+          epoch(QUIESCENT) {}
+  };
+
+  substrate::PerThreadStorage<ThreadData> data;
+  Node root;
+  std::atomic<uint64_t> globalEpoch;
+  Indexer indexer;
+
+  //! Maps an index to a key whose unsigned order is the priority order
+  static Key toKey(Index i) {
+    Key k = static_cast<Key>(i);
+    if (std::is_signed<Index>::value)
+      k ^= Key(1) << (KEY_BITS - 1);
+    if (UseDescending)
+      k = ~k;
+    return k;
+  }
+
+  static unsigned digit(Key k, unsigned level) {
+    unsigned shift = (LEVELS - 1 - level) * RADIX_BITS;
+    return static_cast<unsigned>(k >> shift) & (RADIX - 1);
+  }
+
+  static void deleteNode(Node* n, unsigned level) {
+    for (unsigned i = 0; i < RADIX; ++i) {
+      void* c = n->child[i].load(std::memory_order_relaxed);
+      if (!c)
+        continue;
+      if (level + 1 == LEVELS)
+        delete static_cast<Bucket*>(c);
+      else {
+        deleteNode(static_cast<Node*>(c), level + 1);
+        delete static_cast<Node*>(c);
+      }
+    }
+  }
+
+  //! Walks to the leaf for k, creating interior nodes as needed
+  Node* findLeaf(Key k, Node** path) {
+    Node* n = &root;
+    for (unsigned level = 0; level + 1 < LEVELS; ++level) {
+      path[level]              = n;
+      std::atomic<void*>& slot = n->child[digit(k, level)];
+      void* c                  = slot.load(std::memory_order_acquire);
+      if (!c) {
+        Node* fresh = new Node();
+        if (slot.compare_exchange_strong(c, fresh))
+          c = fresh;
+        else
+          delete fresh;
+      }
+      n = static_cast<Node*>(c);
+    }
+    path[LEVELS - 1] = n;
+    return n;
+  }
+
+  //! Publishes a new bucket bottom-up; pairs with unmarkDead
+  void markLive(Node** path, Key k) {
+    for (unsigned level = LEVELS; level-- > 0;) {
+      uint64_t bit = uint64_t(1) << digit(k, level);
+      if (path[level]->occupied.load() & bit)
+        return;
+      path[level]->occupied.fetch_or(bit);
+    }
+  }
+
+  static bool childEmpty(Node* n, unsigned level, unsigned d) {
+    void* c = n->child[d].load();
+    if (level + 1 == LEVELS)
+      return !c;
+    return !c || !static_cast<Node*>(c)->occupied.load();
+  }
+
+  //! Clears occupancy bits bottom-up after a bucket was unlinked. A bit is
+  //! restored if the child was concurrently populated after clearing.
+  void unmarkDead(Node** path, Key k) {
+    for (unsigned level = LEVELS; level-- > 0;) {
+      Node* n      = path[level];
+      unsigned d   = digit(k, level);
+      uint64_t bit = uint64_t(1) << d;
+      if (!childEmpty(n, level, d))
+        return;
+      n->occupied.fetch_and(~bit);
+      if (!childEmpty(n, level, d)) {
+        n->occupied.fetch_or(bit);
+        return;
+      }
+    }
+  }
+
+  void enterEpoch(ThreadData& p) { p.epoch.store(globalEpoch.load()); }
+
+  void leaveEpoch(ThreadData& p) {
+    p.epoch.store(QUIESCENT, std::memory_order_release);
+  }
+
+  void reclaim(ThreadData& p) {
+    uint64_t e = globalEpoch.load();
+    bool quiet = true;
+    for (unsigned i = 0; i < runtime::activeThreads && quiet; ++i) {
+      uint64_t o = data.getRemote(i)->epoch.load();
+      quiet      = o == QUIESCENT || o == e;
+    }
+    if (quiet)
+      globalEpoch.compare_exchange_strong(e, e + 1);
+
+    e = globalEpoch.load();
+    while (!p.retired.empty() && p.retired.front().first + 2 <= e) {
+      recycle(p, p.retired.front().second);
+      p.retired.pop_front();
+    }
+  }
+
+  //! Returns a bucket for index i that the calling thread holds
+  Bucket* allocBucket(ThreadData& p, Index i) {
+    Bucket* b;
+    if (p.freeBuckets.empty()) {
+      b = new Bucket();
+    } else {
+      b = p.freeBuckets.back();
+      p.freeBuckets.pop_back();
+    }
+    b->index = i;
+    b->holders.store(1, std::memory_order_relaxed);
+    return b;
+  }
+
+  //! Takes back a bucket that is empty and unreachable from the tree
+  void recycle(ThreadData& p, Bucket* b) {
+    if (p.freeBuckets.size() < FREE_LIMIT)
+      p.freeBuckets.push_back(b);
+    else
+      delete b;
+  }
+
+  //! Unlinks a dead bucket and queues it for reclamation
+  void retire(ThreadData& p, Bucket* b) {
+    Key k = toKey(b->index);
+    Node* path[LEVELS];
+    Node* leaf     = findLeaf(k, path);
+    void* expected = b;
+    leaf->child[digit(k, LEVELS - 1)].compare_exchange_strong(expected,
+                                                              nullptr);
+    unmarkDead(path, k);
+
+    p.retired.emplace_back(globalEpoch.load(), b);
+    if (p.retired.size() >= RETIRE_PERIOD)
+      reclaim(p);
+  }
+
+  //! Registers this thread as a holder; fails if the bucket has drained
+  bool acquire(ThreadData& p, Bucket* b) {
+    if (p.held.count(b))
+      return true;
+    unsigned n = b->holders.load();
+    do {
+      if (n & DEAD)
+        return false;
+    } while (!b->holders.compare_exchange_weak(n, n + 1));
+    p.held.insert(b);
+    return true;
+  }
+
+  //! Called after a failed pop; the last holder kills the bucket
+  void release(ThreadData& p, Bucket* b) {
+    p.held.erase(b);
+    if (p.current == b)
+      p.current = nullptr;
+    unsigned n = b->holders.load();
+    unsigned next;
+    do {
+      next = (n == 1) ? DEAD : n - 1;
+    } while (!b->holders.compare_exchange_weak(n, next));
+    if (next == DEAD)
+      retire(p, b);
+  }
+
+  //! Visits buckets with key >= k in priority order until f returns true
+  template <typename F>
+  bool scan(Node* n, unsigned level, Key k, bool bounded, F& f) {
+    unsigned start = bounded ? digit(k, level) : 0;
+    uint64_t mask  = n->occupied.load() & (~uint64_t(0) << start);
+    while (mask) {
+      unsigned d = __builtin_ctzll(mask);
+      mask &= mask - 1;
+      void* c = n->child[d].load(std::memory_order_acquire);
+      if (!c)
+        continue;
+      if (level + 1 == LEVELS) {
+        if (f(static_cast<Bucket*>(c)))
+          return true;
+      } else if (scan(static_cast<Node*>(c), level + 1, k,
+                      bounded && d == start, f)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  GALOIS_ATTRIBUTE_NOINLINE
+  galois::optional<T> slowPop(ThreadData& p, bool currentDrained) {
+    bool localLeader = substrate::ThreadPool::isLeader();
+    Index msS        = this->earliest;
+
+    enterEpoch(p);
+    if (currentDrained && p.current)
+      release(p, p.current);
+
+    if (BSP && !UseMonotonic) {
+      msS = p.scanStart;
+      if (localLeader) {
+        for (unsigned i = 0; i < runtime::activeThreads; ++i) {
+          Index o = data.getRemote(i)->scanStart;
+          if (this->compare(o, msS))
+            msS = o;
+        }
+      } else {
+        Index o = data.getRemote(substrate::ThreadPool::getLeader())->scanStart;
+        if (this->compare(o, msS))
+          msS = o;
+      }
+    }
+
+    galois::optional<T> item;
+    auto tryPop = [&](Bucket* b) {
+      if (!acquire(p, b))
+        return false;
+      if ((item = b->wl.pop())) {
+        p.current   = b;
+        p.curIndex  = b->index;
+        p.scanStart = b->index;
+        return true;
+      }
+      release(p, b);
+      return false;
+    };
+    scan(&root, 0, toKey(msS), true, tryPop);
+
+    leaveEpoch(p);
+    return item;
+  }
+
+  GALOIS_ATTRIBUTE_NOINLINE
+  Bucket* getOrCreate(ThreadData& p, Index i) {
+    Key k = toKey(i);
+    Node* path[LEVELS];
+
+    enterEpoch(p);
+    Node* leaf               = findLeaf(k, path);
+    std::atomic<void*>& slot = leaf->child[digit(k, LEVELS - 1)];
+    Bucket* b                = nullptr;
+    while (!b) {
+      void* c = slot.load(std::memory_order_acquire);
+      if (c) {
+        if (acquire(p, static_cast<Bucket*>(c))) {
+          b = static_cast<Bucket*>(c);
+        } else {
+          // help unlink a drained bucket so that it can be replaced
+          slot.compare_exchange_strong(c, nullptr);
+        }
+        continue;
+      }
+      Bucket* fresh = allocBucket(p, i);
+      if (slot.compare_exchange_strong(c, fresh)) {
+        markLive(path, k);
+        p.held.insert(fresh);
+        b = fresh;
+      } else {
+        recycle(p, fresh);
+      }
+    }
+    leaveEpoch(p);
+    return b;
+  }
+
+public:
+  LockFreeOrderedByIntegerMetric(const Indexer& x = Indexer())
+      : data(this->earliest), globalEpoch(0), indexer(x) {}
+
+  ~LockFreeOrderedByIntegerMetric() {
+    for (unsigned i = 0; i < runtime::activeThreads; ++i) {
+      ThreadData& p = *data.getRemote(i);
+      for (auto& r : p.retired)
+        delete r.second;
+      for (Bucket* b : p.freeBuckets)
+        delete b;
+    }
+    deleteNode(&root, 0);
+  }
+
+  void push(const value_type& val) {
+    Index index   = indexer(val);
+    ThreadData& p = *data.getLocal();
+
+    assert(!UseMonotonic || this->compare(p.curIndex, index));
+
+    // Fast path
+    if (index == p.curIndex && p.current) {
+      p.current->wl.push(val);
+      return;
+    }
+
+    // Slow path
+    Bucket* C = getOrCreate(p, index);
+    if (BSP && this->compare(index, p.scanStart))
+      p.scanStart = index;
+    // Opportunistically move to higher priority work
+    if (this->compare(index, p.curIndex) ||
+        (!p.current && index == p.curIndex)) {
+      p.curIndex = index;
+      p.current  = C;
+    }
+    C->wl.push(val);
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e)
+      push(*b++);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    auto rp = range.local_pair();
+    push(rp.first, rp.second);
+  }
+
+  galois::optional<value_type> pop() {
+    // Find a successful pop
+    ThreadData& p = *data.getLocal();
+    Bucket* C     = p.current;
+
+    if (BlockPeriod && ((p.numPops++ & ((1 << BlockPeriod) - 1)) == 0))
+      return slowPop(p, false);
+
+    galois::optional<value_type> item;
+    if (C && (item = C->wl.pop()))
+      return item;
+
+    // Slow path
+    return slowPop(p, true);
+  }
+};
+GALOIS_WLCOMPILECHECK(LockFreeOrderedByIntegerMetric)
+
+} // end namespace worklists
+} // end namespace galois
+
+#endif
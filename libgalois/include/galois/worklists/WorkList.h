@@ -24,10 +24,12 @@
 #include "galois/optional.h"
 #include "galois/worklists/AdaptiveObim.h"
 #include "galois/worklists/PerThreadChunk.h"
+#include "galois/worklists/BatchedBulkSynchronous.h"
 #include "galois/worklists/BulkSynchronous.h"
 #include "galois/worklists/Chunk.h"
 #include "galois/worklists/Simple.h"
 #include "galois/worklists/LocalQueue.h"
+#include "galois/worklists/LockFreeObim.h"
 #include "galois/worklists/Obim.h"
 #include "galois/worklists/OrderedList.h"
 #include "galois/worklists/OwnerComputes.h"
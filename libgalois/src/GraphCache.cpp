@@ -0,0 +1,419 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file GraphCache.cpp
+ *
+ * Parallel graph transforms and the on-disk cache of their results.
+ */
+
+#include "galois/graphs/GraphCache.h"
+#include "galois/Galois.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Timer.h"
+#include "galois/gIO.h"
+#include "galois/runtime/Statistics.h"
+#include "galois/substrate/EnvCheck.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+using galois::graphs::FileGraph;
+
+/**
+ * Builds a graph from the edges of another graph in parallel. Every edge
+ * (src, dst) of the input for which keep(src, dst) is true is added as
+ * (p[src], p[dst]) if forward and as (p[dst], p[src]) if backward; self loops
+ * are added once.
+ */
+class TransformWriter : public galois::graphs::FileGraphWriter {
+  //! Sorts the edges of node n by destination; edge data moves along
+  template <typename DstTy>
+  void sortEdges(uint64_t n, std::vector<uint64_t>& order,
+                 std::vector<char>& scratch) {
+    uint64_t begin = n ? outIdx[n - 1] : 0;
+    uint64_t end   = outIdx[n];
+    DstTy* dsts    = reinterpret_cast<DstTy*>(outs);
+
+    if (!sizeofEdge) {
+      std::sort(dsts + begin, dsts + end);
+      return;
+    }
+
+    order.resize(end - begin);
+    for (uint64_t i = 0; i < order.size(); ++i)
+      order[i] = begin + i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](uint64_t a, uint64_t b) { return dsts[a] < dsts[b]; });
+
+    scratch.resize(order.size() * (sizeof(DstTy) + sizeofEdge));
+    DstTy* sortedDsts = reinterpret_cast<DstTy*>(scratch.data());
+    char* sortedData  = scratch.data() + order.size() * sizeof(DstTy);
+    for (uint64_t i = 0; i < order.size(); ++i) {
+      sortedDsts[i] = dsts[order[i]];
+      std::memcpy(sortedData + i * sizeofEdge,
+                  edgeData + order[i] * sizeofEdge, sizeofEdge);
+    }
+    std::memcpy(dsts + begin, sortedDsts, order.size() * sizeof(DstTy));
+    std::memcpy(edgeData + begin * sizeofEdge, sortedData,
+                order.size() * sizeofEdge);
+  }
+
+  void setEdgeDst(uint64_t idx, uint64_t dst) {
+    if (graphVersion == 1)
+      reinterpret_cast<uint32_t*>(outs)[idx] = dst;
+    else
+      reinterpret_cast<uint64_t*>(outs)[idx] = dst;
+  }
+
+public:
+  template <typename KeepFn>
+  void build(FileGraph& in, const std::vector<uint64_t>& p, bool forward,
+             bool backward, size_t sizeofData, bool sorted, KeepFn keep) {
+    auto map = [&](uint64_t n) { return p.empty() ? n : p[n]; };
+
+    std::vector<std::atomic<uint64_t>> cursor(in.size());
+    galois::GAccumulator<uint64_t> edges;
+    galois::do_all(
+        galois::iterate(in),
+        [&](uint64_t src) {
+          for (auto jj : in.edges(src)) {
+            uint64_t dst = in.getEdgeDst(jj);
+            if (!keep(src, dst))
+              continue;
+            if (forward)
+              cursor[map(src)] += 1;
+            if (backward && !(forward && src == dst))
+              cursor[map(dst)] += 1;
+            edges += 1 + (forward && backward && src != dst);
+          }
+        },
+        galois::steal(), galois::no_stats());
+
+    numNodes   = in.size();
+    numEdges   = edges.reduce();
+    sizeofEdge = sizeofData;
+    phase1();
+
+    galois::do_all(
+        galois::iterate(uint64_t{0}, numNodes),
+        [&](uint64_t n) { outIdx[n] = cursor[n]; }, galois::no_stats());
+    galois::ParallelSTL::partial_sum(outIdx, outIdx + numNodes, outIdx);
+    galois::do_all(
+        galois::iterate(uint64_t{0}, numNodes),
+        [&](uint64_t n) { cursor[n] = n ? outIdx[n - 1] : 0; },
+        galois::no_stats());
+
+    const char* inData = sizeofData ? in.edge_data_begin<char>() : nullptr;
+    auto add           = [&](uint64_t src, uint64_t dst, uint64_t edge) {
+      uint64_t idx = cursor[src]++;
+      setEdgeDst(idx, dst);
+      if (sizeofData)
+        std::memcpy(edgeData + idx * sizeofData, inData + edge * sizeofData,
+                    sizeofData);
+    };
+    galois::do_all(
+        galois::iterate(in),
+        [&](uint64_t src) {
+          for (auto jj : in.edges(src)) {
+            uint64_t dst = in.getEdgeDst(jj);
+            if (!keep(src, dst))
+              continue;
+            if (forward)
+              add(map(src), map(dst), *jj);
+            if (backward && !(forward && src == dst))
+              add(map(dst), map(src), *jj);
+          }
+        },
+        galois::steal(), galois::no_stats());
+
+    if (sorted) {
+      galois::substrate::PerThreadStorage<
+          std::pair<std::vector<uint64_t>, std::vector<char>>>
+          scratch;
+      galois::do_all(
+          galois::iterate(uint64_t{0}, numNodes),
+          [&](uint64_t n) {
+            auto& s = *scratch.getLocal();
+            if (graphVersion == 1)
+              sortEdges<uint32_t>(n, s.first, s.second);
+            else
+              sortEdges<uint64_t>(n, s.first, s.second);
+          },
+          galois::steal(), galois::no_stats());
+    }
+
+    finish();
+  }
+
+  //! Writes the graph to path, replacing it atomically; returns success
+  bool save(const std::string& path) {
+    std::string tmp = path + ".tmp." + std::to_string(getpid());
+    int fd          = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1)
+      return false;
+
+    const char* ptr = static_cast<const char*>(mappings.front().ptr);
+    size_t total    = mappings.front().len;
+    while (total) {
+      ssize_t written = write(fd, ptr, total);
+      if (written <= 0) {
+        close(fd);
+        unlink(tmp.c_str());
+        return false;
+      }
+      total -= written;
+      ptr += written;
+    }
+
+    if (close(fd) != 0 || rename(tmp.c_str(), path.c_str()) != 0) {
+      unlink(tmp.c_str());
+      return false;
+    }
+    return true;
+  }
+};
+
+//! Position of every node when sorted by degree and id with comp
+template <typename Compare>
+std::vector<uint64_t> rankByDegree(FileGraph& g, Compare comp) {
+  using DegreeNodePair = std::pair<uint64_t, uint64_t>;
+  std::vector<DegreeNodePair> dnPairs(g.size());
+  galois::do_all(
+      galois::iterate(g),
+      [&](uint64_t n) {
+        dnPairs[n] = DegreeNodePair(
+            std::distance(g.edge_begin(n), g.edge_end(n)), n);
+      },
+      galois::no_stats());
+  galois::ParallelSTL::sort(dnPairs.begin(), dnPairs.end(), comp);
+
+  std::vector<uint64_t> p(g.size());
+  galois::do_all(
+      galois::iterate(uint64_t{0}, g.size()),
+      [&](uint64_t i) { p[dnPairs[i].second] = i; }, galois::no_stats());
+  return p;
+}
+
+//! Node ids ordered by decreasing degree; p[old id] = new id
+std::vector<uint64_t> relabelByDegree(FileGraph& g) {
+  return rankByDegree(g, std::greater<std::pair<uint64_t, uint64_t>>());
+}
+
+/**
+ * Position of every node in a degeneracy order, computed with the linear
+ * bucket algorithm of Batagelj and Zaversnik. The peeling is inherently
+ * sequential; only the degrees are computed in parallel.
+ */
+std::vector<uint64_t> degeneracyOrder(FileGraph& g) {
+  size_t numNodes = g.size();
+  std::vector<uint64_t> degree(numNodes);
+  galois::do_all(
+      galois::iterate(g),
+      [&](uint64_t n) {
+        degree[n] = std::distance(g.edge_begin(n), g.edge_end(n));
+      },
+      galois::no_stats());
+  uint64_t maxDegree =
+      numNodes ? *std::max_element(degree.begin(), degree.end()) : 0;
+
+  // nodes sorted by degree; bin[d] is the first position of degree d
+  std::vector<uint64_t> bin(maxDegree + 2);
+  for (uint64_t d : degree)
+    bin[d + 1] += 1;
+  for (size_t d = 1; d < bin.size(); ++d)
+    bin[d] += bin[d - 1];
+  std::vector<uint64_t> pos(numNodes), order(numNodes);
+  {
+    std::vector<uint64_t> next(bin.begin(), bin.end() - 1);
+    for (uint64_t n = 0; n < numNodes; ++n) {
+      pos[n]        = next[degree[n]]++;
+      order[pos[n]] = n;
+    }
+  }
+
+  // removing a node moves each neighbor of higher degree one bin down
+  for (uint64_t i = 0; i < numNodes; ++i) {
+    uint64_t n = order[i];
+    for (auto jj : g.edges(n)) {
+      uint64_t m = g.getEdgeDst(jj);
+      if (degree[m] <= degree[n])
+        continue;
+      uint64_t first = bin[degree[m]];
+      uint64_t other = order[first];
+      std::swap(order[first], order[pos[m]]);
+      std::swap(pos[other], pos[m]);
+      bin[degree[m]] += 1;
+      degree[m] -= 1;
+    }
+  }
+  return pos;
+}
+
+//! Applies transforms to in, leaving the result in out
+void transform(FileGraph& in, unsigned transforms, size_t sizeofData,
+               TransformWriter& out) {
+  using namespace galois::graphs;
+
+  unsigned orient = transforms & (OrientByDegree | OrientById | OrientByCore);
+  if (orient & (orient - 1))
+    GALOIS_DIE("at most one orientation can be applied to a graph");
+
+  struct Step {
+    bool relabel, forward, backward;
+    unsigned orient;
+  };
+  std::vector<Step> steps;
+  if (transforms & Symmetrize)
+    steps.push_back({false, true, true, 0});
+  if (transforms & Transpose)
+    steps.push_back({false, false, true, 0});
+  if (transforms & RelabelByDegree)
+    steps.push_back({true, true, false, 0});
+  if (orient)
+    steps.push_back({false, true, false, orient});
+  if (steps.empty())
+    steps.push_back({false, true, false, 0});
+
+  FileGraph cur;
+  FileGraph* src = &in;
+  for (size_t i = 0; i < steps.size(); ++i) {
+    std::vector<uint64_t> p;
+    if (steps[i].relabel)
+      p = relabelByDegree(*src);
+
+    std::vector<uint64_t> rank;
+    if (steps[i].orient == OrientByDegree)
+      rank = rankByDegree(*src, std::less<std::pair<uint64_t, uint64_t>>());
+    else if (steps[i].orient == OrientByCore)
+      rank = degeneracyOrder(*src);
+
+    TransformWriter w;
+    bool sorted = i + 1 == steps.size() && (transforms & SortByDst);
+    if (steps[i].orient == OrientById) {
+      w.build(*src, p, steps[i].forward, steps[i].backward, sizeofData, sorted,
+              [](uint64_t a, uint64_t b) { return a < b; });
+    } else if (steps[i].orient) {
+      w.build(*src, p, steps[i].forward, steps[i].backward, sizeofData, sorted,
+              [&](uint64_t a, uint64_t b) { return rank[a] < rank[b]; });
+    } else {
+      w.build(*src, p, steps[i].forward, steps[i].backward, sizeofData, sorted,
+              [](uint64_t, uint64_t) { return true; });
+    }
+    if (i + 1 == steps.size()) {
+      out = std::move(w);
+    } else {
+      cur = std::move(w);
+      src = &cur;
+    }
+  }
+}
+
+//! 64-bit FNV-1a hash of a string
+uint64_t hashKey(const std::string& key) {
+  uint64_t h = 14695981039346656037ULL;
+  for (unsigned char c : key) {
+    h ^= c;
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+} // namespace
+
+void galois::graphs::fromFileCached(FileGraph& out, const std::string& filename,
+                                    unsigned transforms, bool keepEdgeData) {
+  struct stat buf;
+  if (stat(filename.c_str(), &buf) == -1)
+    GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+
+  // version, size of edge data, nodes, edges
+  uint64_t header[4];
+  std::ifstream headerFile(filename, std::ios::binary);
+  if (!headerFile.read(reinterpret_cast<char*>(header), sizeof(header)))
+    GALOIS_DIE("failed reading header of ", "'", filename, "'");
+  size_t sizeofData = keepEdgeData ? header[1] : 0;
+
+  if (!transforms && keepEdgeData) {
+    out.fromFile(filename);
+    return;
+  }
+
+  std::string cacheDir = filename + ".cache";
+  std::string setting;
+  bool enabled = true;
+  if (galois::substrate::EnvCheck("GALOIS_GRAPH_CACHE", setting)) {
+    if (setting == "0")
+      enabled = false;
+    else
+      cacheDir = setting;
+  }
+
+  std::string key = filename + ":" + std::to_string(buf.st_size) + ":" +
+                    std::to_string(buf.st_mtime) + ":" +
+                    std::to_string(buf.st_ino);
+  for (uint64_t h : header)
+    key += ":" + std::to_string(h);
+  key += ":" + std::to_string(transforms) + ":" + std::to_string(sizeofData);
+
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.gr",
+                static_cast<unsigned long long>(hashKey(key)));
+  std::string cachePath = cacheDir + "/" + name;
+
+  if (enabled && access(cachePath.c_str(), R_OK) == 0) {
+    galois::runtime::reportStat_Single("GraphCache", "Hits", 1);
+    out.fromFile(cachePath);
+    return;
+  }
+  galois::runtime::reportStat_Single("GraphCache", "Misses", 1);
+
+  galois::StatTimer buildTimer("TimerBuild", "GraphCache");
+  buildTimer.start();
+  FileGraph in;
+  in.fromFile(filename);
+  TransformWriter result;
+  transform(in, transforms, sizeofData, result);
+  buildTimer.stop();
+
+  if (enabled) {
+    if (mkdir(cacheDir.c_str(), 0755) != 0 && errno != EEXIST) {
+      galois::gWarn("cannot create graph cache directory ", cacheDir, ": ",
+                    std::strerror(errno));
+    } else if (!result.save(cachePath)) {
+      galois::gWarn("cannot write cached graph ", cachePath, ": ",
+                    std::strerror(errno));
+    }
+  }
+
+  out = std::move(result);
+}
@@ -1,5 +1,6 @@
 #include "galois/substrate/HWTopo.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 std::vector<int> galois::substrate::parseCPUList(const std::string& line) {
@@ -35,3 +36,19 @@ std::vector<int> galois::substrate::parseCPUList(const std::string& line) {
 
   return vals;
 }
+
+unsigned galois::substrate::parseCPUQuota(const std::string& quota,
+                                          const std::string& period) {
+  try {
+    long q = std::stol(quota);
+    long p = std::stol(period);
+    if (q <= 0 || p <= 0)
+      return 0;
+    return std::max(1L, (q + p - 1) / p);
+  } catch (const std::invalid_argument&) {
+    // "max" is no limit
+    return 0;
+  } catch (const std::out_of_range&) {
+    return 0;
+  }
+}
@@ -29,6 +29,8 @@
 #include <cstring>
 #include <fstream>
 #include <functional>
+#include <iterator>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -200,18 +202,178 @@ std::vector<int> parseCPUSet() {
   return galois::substrate::parseCPUList(line);
 }
 
+//! CPUs in the affinity mask of this process
+std::vector<int> parseAffinity() {
+#ifdef GALOIS_USE_SCHED_SETAFFINITY
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+    std::vector<int> vals;
+    for (int i = 0; i < CPU_SETSIZE; ++i)
+      if (CPU_ISSET(i, &mask))
+        vals.push_back(i);
+    return vals;
+  }
+#endif
+  return parseCPUSet();
+}
+
+//! First line of the first file in paths that can be read
+std::string readFirst(const std::vector<std::string>& paths) {
+  for (auto& path : paths) {
+    std::ifstream data(path);
+    std::string line;
+    if (data && std::getline(data, line))
+      return line;
+  }
+  return "";
+}
+
+/**
+ * Candidate paths of file in the cgroup of this process, for the cgroup v1
+ * controller or, if controller is empty, for the cgroup v2 hierarchy. Paths
+ * at the root of the hierarchy come last because in a cgroup namespace the
+ * cgroup of the process is mounted there.
+ */
+std::vector<std::string> cgroupFiles(const std::string& controller,
+                                     const std::string& file) {
+  std::vector<std::string> roots;
+  if (controller.empty()) {
+    roots = {"/sys/fs/cgroup", "/sys/fs/cgroup/unified"};
+  }
+
+  std::vector<std::string> paths;
+  std::ifstream data("/proc/self/cgroup");
+  std::string line;
+  // hierarchy-ID:controller-list:cgroup-path
+  while (std::getline(data, line)) {
+    size_t first  = line.find(':');
+    size_t second = line.find(':', first + 1);
+    if (first == std::string::npos || second == std::string::npos)
+      continue;
+    std::string controllers = line.substr(first + 1, second - first - 1);
+    std::string path        = line.substr(second + 1);
+
+    if (controller.empty()) {
+      if (controllers.empty())
+        for (auto& root : roots)
+          paths.push_back(root + path + "/" + file);
+      continue;
+    }
+
+    std::string list = "," + controllers + ",";
+    if (list.find("," + controller + ",") == std::string::npos)
+      continue;
+    roots.push_back("/sys/fs/cgroup/" + controllers);
+    paths.push_back(roots.back() + path + "/" + file);
+  }
+
+  if (!controller.empty() && roots.empty())
+    roots.push_back("/sys/fs/cgroup/" + controller);
+  for (auto& root : roots)
+    paths.push_back(root + "/" + file);
+  return paths;
+}
+
+//! CPUs in the cgroup cpuset of this process; empty if unknown
+std::vector<int> parseCgroupCPUSet() {
+  std::string line = readFirst(cgroupFiles("", "cpuset.cpus.effective"));
+  if (line.empty())
+    line = readFirst(cgroupFiles("cpuset", "cpuset.effective_cpus"));
+  if (line.empty())
+    line = readFirst(cgroupFiles("cpuset", "cpuset.cpus"));
+  return galois::substrate::parseCPUList(line);
+}
+
+//! Number of CPUs the cgroup CPU quota of this process allows; 0 if none
+unsigned parseCgroupQuota() {
+  std::string line = readFirst(cgroupFiles("", "cpu.max"));
+  if (!line.empty()) {
+    size_t space = line.find(' ');
+    if (space == std::string::npos)
+      return 0;
+    return galois::substrate::parseCPUQuota(line.substr(0, space),
+                                            line.substr(space + 1));
+  }
+
+  std::string quota = readFirst(cgroupFiles("cpu", "cpu.cfs_quota_us"));
+  std::string period = readFirst(cgroupFiles("cpu", "cpu.cfs_period_us"));
+  if (quota.empty() || period.empty())
+    return 0;
+  return galois::substrate::parseCPUQuota(quota, period);
+}
+
 void markValid(std::vector<cpuinfo>& info) {
-  auto v = parseCPUSet();
+  auto v = parseAffinity();
+  auto c = parseCgroupCPUSet();
+  std::sort(v.begin(), v.end());
+  std::sort(c.begin(), c.end());
+  if (!v.empty() && !c.empty()) {
+    std::vector<int> both;
+    std::set_intersection(v.begin(), v.end(), c.begin(), c.end(),
+                          std::back_inserter(both));
+    // A cpuset from another cgroup namespace may not match at all
+    if (!both.empty())
+      v = both;
+  } else if (v.empty()) {
+    v = c;
+  }
+
   if (v.empty()) {
     for (auto& c : info)
       c.valid = true;
   } else {
-    std::sort(v.begin(), v.end());
     for (auto& c : info)
       c.valid = std::binary_search(v.begin(), v.end(), c.proc);
   }
 }
 
+/**
+ * Orders info, which is in compact order, by the placement in
+ * GALOIS_THREAD_PLACEMENT. Returns false if the placement names no CPU in
+ * info.
+ */
+bool orderByPlacement(std::vector<cpuinfo>& info) {
+  std::string placement;
+  if (!galois::substrate::EnvCheck("GALOIS_THREAD_PLACEMENT", placement) ||
+      placement == "compact")
+    return true;
+
+  if (placement == "scatter") {
+    // Round robin over sockets by the index of a CPU within its socket
+    std::vector<unsigned> keys;
+    std::map<unsigned, unsigned> seen;
+    for (auto& c : info)
+      keys.push_back(seen[c.physid]++);
+    std::vector<size_t> order(info.size());
+    for (size_t i = 0; i < order.size(); ++i)
+      order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+    std::vector<cpuinfo> sorted;
+    for (auto i : order)
+      sorted.push_back(info[i]);
+    info = sorted;
+    return true;
+  }
+
+  auto cpus = galois::substrate::parseCPUList(placement);
+  std::vector<cpuinfo> listed;
+  for (int cpu : cpus) {
+    auto ii = std::find_if(info.begin(), info.end(), [&](const cpuinfo& c) {
+      return c.proc == static_cast<unsigned>(cpu);
+    });
+    if (ii != info.end() &&
+        std::none_of(listed.begin(), listed.end(),
+                     [&](const cpuinfo& c) { return c.proc == ii->proc; }))
+      listed.push_back(*ii);
+  }
+  if (listed.empty())
+    return false;
+  info = listed;
+  return true;
+}
+
 galois::substrate::HWTopoInfo makeHWTopo() {
   galois::substrate::MachineTopoInfo retMTI;
 
@@ -226,6 +388,15 @@ galois::substrate::HWTopoInfo makeHWTopo() {
 
   std::sort(info.begin(), info.end());
   markSMT(info);
+  if (!orderByPlacement(info))
+    galois::gWarn("GALOIS_THREAD_PLACEMENT names no usable CPU; using compact "
+                  "placement");
+
+  // Threads beyond the CPU quota would only be descheduled
+  unsigned quota = parseCgroupQuota();
+  if (quota && quota < info.size())
+    info.resize(quota);
+
   retMTI.maxSockets   = countSockets(info);
   retMTI.maxThreads   = info.size();
   retMTI.maxCores     = countCores(info);
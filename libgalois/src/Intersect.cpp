@@ -0,0 +1,196 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file Intersect.cpp
+ *
+ * Sorted set intersection kernels. The vector kernels are compiled for their
+ * instruction sets with target attributes so that the rest of the library
+ * does not require them.
+ */
+
+#include "galois/graphs/Intersect.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define GALOIS_INTERSECT_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using galois::graphs::IntersectKernel;
+
+//! Galloping is used when one range is this many times longer than the other
+constexpr size_t GallopRatio = 32;
+
+size_t mergeScalar(const uint32_t* a, size_t na, const uint32_t* b,
+                   size_t nb) {
+  size_t i = 0, j = 0, count = 0;
+  while (i < na && j < nb) {
+    uint32_t x = a[i], y = b[j];
+    count += x == y;
+    i += x <= y;
+    j += y <= x;
+  }
+  return count;
+}
+
+#ifdef GALOIS_INTERSECT_X86
+/**
+ * Compares a block of 8 values of a with all rotations of a block of 8 values
+ * of b, then advances the block with the smaller last value (or both).
+ */
+__attribute__((target("avx2"))) size_t
+mergeAVX2(const uint32_t* a, size_t na, const uint32_t* b, size_t nb) {
+  size_t i = 0, j = 0, count = 0;
+  const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+  while (i + 8 <= na && j + 8 <= nb) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+    __m256i match = _mm256_cmpeq_epi32(va, vb);
+    for (int k = 1; k < 8; ++k) {
+      vb    = _mm256_permutevar8x32_epi32(vb, rotate);
+      match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+    }
+    count +=
+        __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(match)));
+
+    uint32_t lastA = a[i + 7], lastB = b[j + 7];
+    i += lastA <= lastB ? 8 : 0;
+    j += lastB <= lastA ? 8 : 0;
+  }
+  return count + mergeScalar(a + i, na - i, b + j, nb - j);
+}
+
+//! mergeAVX2 with blocks of 16 values
+__attribute__((target("avx512f"))) size_t
+mergeAVX512(const uint32_t* a, size_t na, const uint32_t* b, size_t nb) {
+  size_t i = 0, j = 0, count = 0;
+  const __m512i rotate =
+      _mm512_set_epi32(0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+  while (i + 16 <= na && j + 16 <= nb) {
+    __m512i va      = _mm512_loadu_si512(a + i);
+    __m512i vb      = _mm512_loadu_si512(b + j);
+    __mmask16 match = _mm512_cmpeq_epi32_mask(va, vb);
+    for (int k = 1; k < 16; ++k) {
+      vb = _mm512_maskz_permutexvar_epi32(0xFFFF, rotate, vb);
+      match |= _mm512_cmpeq_epi32_mask(va, vb);
+    }
+    count += __builtin_popcount(match);
+
+    uint32_t lastA = a[i + 15], lastB = b[j + 15];
+    i += lastA <= lastB ? 16 : 0;
+    j += lastB <= lastA ? 16 : 0;
+  }
+  return count + mergeAVX2(a + i, na - i, b + j, nb - j);
+}
+#endif
+
+/**
+ * Searches for each value of the short range in the long one, doubling the
+ * step from the previous match before binary searching.
+ */
+size_t gallop(const uint32_t* s, size_t ns, const uint32_t* l, size_t nl) {
+  size_t count = 0, lo = 0;
+  for (size_t i = 0; i < ns && lo < nl; ++i) {
+    uint32_t key = s[i];
+    size_t hi    = lo;
+    for (size_t step = 1; hi < nl && l[hi] < key; step <<= 1) {
+      lo = hi + 1;
+      hi += step;
+    }
+    lo = std::lower_bound(l + lo, l + std::min(hi, nl), key) - l;
+    count += lo < nl && l[lo] == key;
+  }
+  return count;
+}
+
+typedef size_t (*MergeFn)(const uint32_t*, size_t, const uint32_t*, size_t);
+
+MergeFn mergeFor(IntersectKernel kernel) {
+  switch (kernel) {
+#ifdef GALOIS_INTERSECT_X86
+  case IntersectKernel::AVX2:
+    return mergeAVX2;
+  case IntersectKernel::AVX512:
+    return mergeAVX512;
+#endif
+  default:
+    return mergeScalar;
+  }
+}
+
+} // namespace
+
+bool galois::graphs::isSupported(IntersectKernel kernel) {
+#ifdef GALOIS_INTERSECT_X86
+  __builtin_cpu_init();
+  switch (kernel) {
+  case IntersectKernel::AVX2:
+    return __builtin_cpu_supports("avx2");
+  case IntersectKernel::AVX512:
+    return __builtin_cpu_supports("avx512f");
+  default:
+    return true;
+  }
+#else
+  return kernel == IntersectKernel::Scalar;
+#endif
+}
+
+galois::graphs::IntersectKernel galois::graphs::bestIntersectKernel() {
+  for (IntersectKernel k : {IntersectKernel::AVX512, IntersectKernel::AVX2})
+    if (isSupported(k))
+      return k;
+  return IntersectKernel::Scalar;
+}
+
+size_t galois::graphs::intersectCount(IntersectKernel kernel, const uint32_t* a,
+                                      size_t na, const uint32_t* b,
+                                      size_t nb) {
+  assert(isSupported(kernel));
+  return mergeFor(kernel)(a, na, b, nb);
+}
+
+size_t galois::graphs::intersectCount(const uint32_t* a, size_t na,
+                                      const uint32_t* b, size_t nb) {
+  static const MergeFn merge = mergeFor(bestIntersectKernel());
+
+  if (na > nb) {
+    std::swap(a, b);
+    std::swap(na, nb);
+  }
+  if (!na || a[na - 1] < b[0] || b[nb - 1] < a[0])
+    return 0;
+  if (na * GallopRatio < nb)
+    return gallop(a, na, b, nb);
+  return merge(a, na, b, nb);
+}
+
+size_t galois::graphs::intersectCount(const uint64_t* bits, const uint32_t* b,
+                                      size_t nb) {
+  size_t count = 0;
+  for (size_t i = 0; i < nb; ++i)
+    count += (bits[b[i] / 64] >> (b[i] % 64)) & 1;
+  return count;
+}
@@ -19,11 +19,78 @@
 
 #include "galois/runtime/Mem.h"
 
+#include <fstream>
 #include <map>
 #include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
 
 using namespace galois::runtime;
 
+namespace {
+
+//! Per node page counts of a line of /proc/self/numa_maps
+struct NumaMapsLine {
+  std::string text;
+  std::vector<size_t> pagesOnNode;
+  size_t pageKB = 4;
+};
+
+//! Parses /proc/self/numa_maps; returns no lines if it is unavailable
+std::vector<NumaMapsLine> readNumaMaps() {
+  std::vector<NumaMapsLine> lines;
+  std::ifstream f("/proc/self/numa_maps");
+  std::string text;
+  while (std::getline(f, text)) {
+    NumaMapsLine line;
+    std::istringstream ss(text);
+    std::string field;
+    while (ss >> field) {
+      // node counts look like N<node>=<pages>
+      size_t eq = field.find('=');
+      if (eq == std::string::npos)
+        continue;
+      if (field[0] == 'N' && eq > 1) {
+        size_t node = std::stoul(field.substr(1, eq - 1));
+        if (line.pagesOnNode.size() <= node)
+          line.pagesOnNode.resize(node + 1, 0);
+        line.pagesOnNode[node] = std::stoul(field.substr(eq + 1));
+      } else if (field.compare(0, eq, "kernelpagesize_kB") == 0) {
+        line.pageKB = std::stoul(field.substr(eq + 1));
+      }
+    }
+    line.text = std::move(text);
+    lines.emplace_back(std::move(line));
+  }
+  return lines;
+}
+
+} // namespace
+
+int galois::runtime::numNumaAllocForNode(unsigned nodeid) {
+  const size_t smallKB = sysconf(_SC_PAGESIZE) / 1024;
+  size_t pages         = 0;
+  for (auto& line : readNumaMaps())
+    if (nodeid < line.pagesOnNode.size())
+      pages += line.pagesOnNode[nodeid] * (line.pageKB / smallKB);
+  return pages;
+}
+
+void galois::runtime::printInterleavedStats(int minPages) {
+  const size_t smallKB = sysconf(_SC_PAGESIZE) / 1024;
+  for (auto& line : readNumaMaps()) {
+    size_t pages = 0;
+    for (auto p : line.pagesOnNode)
+      pages += p;
+    // huge page mappings are always of interest
+    if (line.pageKB > smallKB ? pages > 0 : pages >= (size_t)minPages)
+      galois::gPrint(line.text, "\n");
+  }
+}
+
 // Anchor the class
 SystemHeap::SystemHeap() { assert(AllocSize == runtime::pagePoolSize()); }
 
@@ -48,10 +48,12 @@ static void pageIn(void* _ptr, size_t len, size_t pageSize, unsigned numThreads,
           ptr[x] = 0;
       } else {
         // sectioned page distribution (e.g. thread 0 gets first chunk, thread
-        // 1 gets next chunk, ... last thread gets last chunk)
-        for (size_t x = myID * len / numThreads;
-             x < len && x < (myID + 1) * len / numThreads; x += pageSize)
-          ptr[x] = 0;
+        // 1 gets next chunk, ... last thread gets last chunk); chunks are
+        // whole pages so that no page is touched by two threads
+        size_t numPages = (len + pageSize - 1) / pageSize;
+        for (size_t p = myID * numPages / numThreads;
+             p < (myID + 1) * numPages / numThreads; ++p)
+          ptr[p * pageSize] = 0;
       }
     });
   }
@@ -148,51 +150,44 @@ static size_t roundup(size_t data, size_t mult) {
 }
 
 LAptr galois::substrate::largeMallocInterleaved(size_t bytes,
-                                                unsigned numThreads) {
-  // round up to hugePageSize
-  bytes = roundup(bytes, allocSize());
-
+                                                unsigned numThreads,
+                                                PageKind kind) {
 #ifdef GALOIS_USE_NUMA
   // We don't use numa_alloc_interleaved_subset because we really want huge
   // pages
   // yes this is a comment in a ifdef, but if libnuma improves, this is where
   // the alloc would go
 #endif
-  // Get a non-prefaulted allocation
-  void* data = allocPages(bytes / allocSize(), false);
+  // Get a non-prefaulted allocation; rounds bytes up to what is mapped
+  void* data = allocRegion(bytes, false, kind);
 
-  // Then page in based on thread number
+  // Then page in based on thread number, one touch per page actually mapped
   if (data)
     // true = round robin paging
-    pageIn(data, bytes, allocSize(), numThreads, true);
+    pageIn(data, bytes, allocSize(kind), numThreads, true);
 
   return LAptr{data, internal::largeFreer{bytes}};
 }
 
-LAptr galois::substrate::largeMallocLocal(size_t bytes) {
-  // round up to hugePageSize
-  bytes = roundup(bytes, allocSize());
-  // Get a prefaulted allocation
-  return LAptr{allocPages(bytes / allocSize(), true),
-               internal::largeFreer{bytes}};
+LAptr galois::substrate::largeMallocLocal(size_t bytes, PageKind kind) {
+  // Get a prefaulted allocation; rounds bytes up to what is mapped
+  void* data = allocRegion(bytes, true, kind);
+  return LAptr{data, internal::largeFreer{bytes}};
 }
 
-LAptr galois::substrate::largeMallocFloating(size_t bytes) {
-  // round up to hugePageSize
-  bytes = roundup(bytes, allocSize());
-  // Get a non-prefaulted allocation
-  return LAptr{allocPages(bytes / allocSize(), false),
-               internal::largeFreer{bytes}};
+LAptr galois::substrate::largeMallocFloating(size_t bytes, PageKind kind) {
+  // Get a non-prefaulted allocation; rounds bytes up to what is mapped
+  void* data = allocRegion(bytes, false, kind);
+  return LAptr{data, internal::largeFreer{bytes}};
 }
 
-LAptr galois::substrate::largeMallocBlocked(size_t bytes, unsigned numThreads) {
-  // round up to hugePageSize
-  bytes = roundup(bytes, allocSize());
-  // Get a non-prefaulted allocation
-  void* data = allocPages(bytes / allocSize(), false);
+LAptr galois::substrate::largeMallocBlocked(size_t bytes, unsigned numThreads,
+                                            PageKind kind) {
+  // Get a non-prefaulted allocation; rounds bytes up to what is mapped
+  void* data = allocRegion(bytes, false, kind);
   if (data)
     // false = blocked paging
-    pageIn(data, bytes, allocSize(), numThreads, false);
+    pageIn(data, bytes, allocSize(kind), numThreads, false);
   return LAptr{data, internal::largeFreer{bytes}};
 }
 
@@ -55,20 +55,57 @@ static const int _MAP_HUGE     = _MAP;
 
 size_t galois::substrate::allocSize() { return hugePageSize; }
 
-void* galois::substrate::allocPages(unsigned num, bool preFault) {
+size_t galois::substrate::allocSize(PageKind kind) {
+  // 1GB pages can only back whole 1GB regions
+  return kind == PageKind::Huge1G ? 512 * hugePageSize : hugePageSize;
+}
+
+void* galois::substrate::allocPages(unsigned num, bool preFault,
+                                    PageKind kind) {
   if (num > 0) {
-    void* ptr =
-        trymmap(num * hugePageSize, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
-    if (!ptr) {
-      gDebug("Huge page alloc failed, falling back");
-      ptr = trymmap(num * hugePageSize, preFault ? _MAP_POP : _MAP);
+    void* ptr         = nullptr;
+    const size_t size = num * hugePageSize;
+
+    switch (kind) {
+    case PageKind::Huge1G:
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_1GB)
+      if (size % allocSize(kind) == 0)
+        ptr = trymmap(size, (preFault ? _MAP_HUGE_POP : _MAP_HUGE) |
+                                MAP_HUGE_1GB);
+#endif
+      if (!ptr)
+        gDebug("1GB page alloc failed, falling back");
+      // fall through
+    case PageKind::Default:
+      if (!ptr)
+        ptr = trymmap(size, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+      if (!ptr) {
+        gDebug("Huge page alloc failed, falling back");
+        ptr = trymmap(size, preFault ? _MAP_POP : _MAP);
+      }
+      break;
+    case PageKind::Small:
+      ptr = trymmap(size, preFault ? _MAP_POP : _MAP);
+      break;
+    case PageKind::Transparent:
+      // populate only after the advice so the faults get huge pages
+      ptr = trymmap(size, _MAP);
+#ifdef MADV_HUGEPAGE
+      if (ptr && madvise(ptr, size, MADV_HUGEPAGE) != 0)
+        gDebug("Transparent huge page advice failed");
+#endif
+      if (ptr && preFault)
+        for (size_t x = 0; x < size; x += 4096)
+          static_cast<char*>(ptr)[x] = 0;
+      preFault = false;
+      break;
     }
 
     if (!ptr)
       GALOIS_SYS_DIE("Out of Memory");
 
     if (preFault && doHandMap)
-      for (size_t x = 0; x < num * hugePageSize; x += 4096)
+      for (size_t x = 0; x < size; x += 4096)
         static_cast<char*>(ptr)[x] = 0;
 
     return ptr;
@@ -77,6 +114,33 @@ void* galois::substrate::allocPages(unsigned num, bool preFault) {
   }
 }
 
+void* galois::substrate::allocRegion(size_t& bytes, bool preFault,
+                                     PageKind& kind) {
+  if (kind == PageKind::Huge1G) {
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_1GB)
+    // smaller arrays would be mostly padding
+    const size_t gigaPageSize = allocSize(kind);
+    if (bytes >= gigaPageSize) {
+      size_t size = (bytes + gigaPageSize - 1) / gigaPageSize * gigaPageSize;
+      void* ptr   = trymmap(size, (preFault ? _MAP_HUGE_POP : _MAP_HUGE) |
+                                    MAP_HUGE_1GB);
+      if (ptr) {
+        if (preFault && doHandMap)
+          for (size_t x = 0; x < size; x += 4096)
+            static_cast<char*>(ptr)[x] = 0;
+        bytes = size;
+        return ptr;
+      }
+      gDebug("1GB page alloc failed, falling back");
+    }
+#endif
+    kind = PageKind::Default;
+  }
+
+  bytes = (bytes + hugePageSize - 1) / hugePageSize * hugePageSize;
+  return allocPages(bytes / hugePageSize, preFault, kind);
+}
+
 void galois::substrate::freePages(void* ptr, unsigned num) {
   std::lock_guard<SimpleLock> lg(allocLock);
   if (munmap(ptr, num * hugePageSize) != 0)
@@ -0,0 +1,134 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/PlacementPolicy.h"
+#include "galois/substrate/EnvCheck.h"
+#include "galois/substrate/SimpleLock.h"
+#include "galois/gIO.h"
+
+#include <map>
+#include <mutex>
+
+namespace {
+
+const char* const placementNames[] = {"blocked", "local", "interleaved",
+                                      "floating"};
+const char* const pageNames[]      = {"default", "small", "thp", "1g"};
+
+using PolicyMap = std::map<std::string, galois::PlacementPolicy>;
+
+struct Overrides {
+  galois::substrate::SimpleLock lock;
+  PolicyMap fromEnv;
+  PolicyMap fromCode;
+
+  Overrides() {
+    std::string spec;
+    if (!galois::substrate::EnvCheck("GALOIS_PLACEMENT", spec))
+      return;
+    size_t begin = 0;
+    while (begin < spec.size()) {
+      size_t end = spec.find(',', begin);
+      if (end == std::string::npos)
+        end = spec.size();
+      std::string entry = spec.substr(begin, end - begin);
+      size_t eq         = entry.find('=');
+      if (eq == std::string::npos || eq == 0)
+        GALOIS_DIE("GALOIS_PLACEMENT entry '", entry,
+                   "' is not role=placement[:pages]");
+      fromEnv[entry.substr(0, eq)] =
+          galois::PlacementPolicy::parse(entry.substr(eq + 1));
+      begin = end + 1;
+    }
+  }
+
+  //! Returns the override of role in m, if any
+  static const galois::PlacementPolicy* find(const PolicyMap& m,
+                                             const std::string& role) {
+    auto ii = m.find(role);
+    if (ii == m.end())
+      ii = m.find("*");
+    return ii == m.end() ? nullptr : &ii->second;
+  }
+};
+
+Overrides& getOverrides() {
+  static Overrides overrides;
+  return overrides;
+}
+
+} // namespace
+
+galois::PlacementPolicy
+galois::PlacementPolicy::forRole(const std::string& role,
+                                 const PlacementPolicy& dflt) {
+  auto& o = getOverrides();
+  std::lock_guard<substrate::SimpleLock> lg(o.lock);
+  const PlacementPolicy* p = Overrides::find(o.fromCode, role);
+  if (!p)
+    p = Overrides::find(o.fromEnv, role);
+  if (!p)
+    return dflt;
+  galois::gDebug("Placement of ", role, " overridden to ", p->str());
+  return *p;
+}
+
+void galois::PlacementPolicy::setOverride(const std::string& role,
+                                          const PlacementPolicy& policy) {
+  auto& o = getOverrides();
+  std::lock_guard<substrate::SimpleLock> lg(o.lock);
+  o.fromCode[role] = policy;
+}
+
+galois::PlacementPolicy
+galois::PlacementPolicy::parse(const std::string& spec) {
+  size_t colon          = spec.find(':');
+  std::string placement = spec.substr(0, colon);
+  std::string pages =
+      colon == std::string::npos ? "default" : spec.substr(colon + 1);
+
+  PlacementPolicy p;
+  bool found = false;
+  for (unsigned i = 0; i < 4; ++i) {
+    if (placement == placementNames[i]) {
+      p.placement = static_cast<Placement>(i);
+      found       = true;
+    }
+  }
+  if (!found)
+    GALOIS_DIE("unknown placement '", placement,
+               "'; use blocked, local, interleaved or floating");
+
+  found = false;
+  for (unsigned i = 0; i < 4; ++i) {
+    if (pages == pageNames[i]) {
+      p.pages = static_cast<substrate::PageKind>(i);
+      found   = true;
+    }
+  }
+  if (!found)
+    GALOIS_DIE("unknown page kind '", pages,
+               "'; use default, small, thp or 1g");
+  return p;
+}
+
+std::string galois::PlacementPolicy::str() const {
+  return std::string(placementNames[placement]) + ":" +
+         pageNames[static_cast<unsigned>(pages)];
+}
@@ -0,0 +1,130 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+#include "galois/Timer.h"
+#include "galois/runtime/Context.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+/**
+ * Checks that galois::no_exceptions conflicts retry every item and, given a
+ * number of items, compares the throughput of aborts when conflicts unwind the
+ * operator with when the operator returns on conflict. Every item updates two
+ * of a few counters, so most attempts conflict.
+ */
+
+struct Counter : public galois::runtime::Lockable {
+  unsigned value = 0;
+};
+
+const unsigned numCounters = 8;
+
+struct Op {
+  std::vector<Counter>& counters;
+  galois::GAccumulator<size_t>& attempts;
+
+  template <typename Context>
+  void operator()(unsigned item, Context&) const {
+    attempts += 1;
+    Counter& a = counters[item % numCounters];
+    Counter& b = counters[(item / numCounters) % numCounters];
+    if (!galois::runtime::acquire(&a, galois::MethodFlag::WRITE))
+      return;
+    // widen the window for conflicts
+    for (volatile int i = 0; i < 64; ++i)
+      ;
+    if (!galois::runtime::acquire(&b, galois::MethodFlag::WRITE))
+      return;
+    a.value += 1;
+    b.value += 1;
+  }
+};
+
+//! Runs Op over numItems items, timing the loop in t, and returns the number
+//! of aborts
+template <typename... Args>
+size_t run(const char* name, unsigned numItems, galois::Timer& t,
+           Args&&... args) {
+  std::vector<Counter> counters(numCounters);
+  galois::GAccumulator<size_t> attempts;
+
+  t.start();
+  galois::for_each(galois::iterate(0u, numItems), Op{counters, attempts},
+                   galois::no_pushes(), galois::loopname(name),
+                   std::forward<Args>(args)...);
+  t.stop();
+
+  size_t total = 0;
+  for (auto& c : counters)
+    total += c.value;
+  GALOIS_ASSERT(total == 2 * size_t(numItems), name, ": ", total,
+                " updates instead of ", 2 * size_t(numItems));
+  return attempts.reduce() - numItems;
+}
+
+template <typename... Args>
+void report(const char* name, unsigned numItems, Args&&... args) {
+  galois::Timer t;
+  size_t aborts = run(name, numItems, t, std::forward<Args>(args)...);
+  std::cout << name << ": " << aborts << " aborts in " << t.get() << " ms, "
+            << aborts / (t.get() ? t.get() : 1) << " aborts/ms\n";
+}
+
+//! A deferred conflict marks the context instead of unwinding
+void checkDeferred() {
+  galois::runtime::SimpleRuntimeContext owner, ctx;
+  Counter c;
+  galois::runtime::setThreadContext(&owner);
+  galois::runtime::acquire(&c, galois::MethodFlag::WRITE);
+
+  ctx.setDeferConflicts(true);
+  ctx.startIteration();
+  galois::runtime::setThreadContext(&ctx);
+  bool acquired = galois::runtime::acquire(&c, galois::MethodFlag::WRITE);
+  GALOIS_ASSERT(!acquired && ctx.isConflicted(), "conflict not deferred");
+  galois::runtime::setThreadContext(0);
+  ctx.cancelIteration();
+  owner.commitIteration();
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(2);
+
+  checkDeferred();
+
+  galois::Timer t;
+  run("Unwind", 1024, t);
+  run("Status", 1024, t, galois::no_exceptions());
+
+  // abort-throughput <items> [threads] times both paths
+  if (argc > 1) {
+    unsigned numItems = atoi(argv[1]);
+    if (argc > 2)
+      galois::setActiveThreads(atoi(argv[2]));
+    report("Unwind", numItems);
+    report("Status", numItems, galois::no_exceptions());
+  }
+
+  return 0;
+}
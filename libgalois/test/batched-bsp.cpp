@@ -0,0 +1,115 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <vector>
+
+// Node n has edges to 3n+1, 3n+2 and n/2 (mod the number of nodes), so most
+// nodes are reached from several nodes of the previous level.
+static const unsigned numNodes = 5000;
+static const unsigned INF      = std::numeric_limits<unsigned>::max();
+
+template <typename F>
+void neighbors(unsigned n, F&& f) {
+  f((3 * n + 1) % numNodes);
+  f((3 * n + 2) % numNodes);
+  f(n / 2);
+}
+
+struct Identity {
+  size_t operator()(unsigned n) const { return n; }
+};
+
+// Every node reached at level d + 1 is pushed once per edge from level d;
+// this only computes levels correctly if rounds are level synchronous.
+template <typename WL, typename... Args>
+void check(bool dedupe, Args&&... args) {
+  std::vector<std::atomic<unsigned>> dist(numNodes);
+  for (auto& d : dist)
+    d = INF;
+  dist[0] = 0;
+
+  std::vector<unsigned> initial{0};
+  galois::GAccumulator<size_t> processed;
+  galois::for_each(
+      galois::iterate(initial),
+      [&](unsigned n, auto& ctx) {
+        processed += 1;
+        unsigned d = dist[n] + 1;
+        neighbors(n, [&](unsigned m) {
+          unsigned old = INF;
+          dist[m].compare_exchange_strong(old, d);
+          if (old == INF || old == d)
+            ctx.push(m);
+        });
+      },
+      galois::wl<WL>(std::forward<Args>(args)...),
+      galois::disable_conflict_detection(), galois::loopname("batched-bsp"));
+
+  // without deduplication every copy of a node pushes its neighbors again,
+  // so a node is processed once per shortest path to it
+  std::vector<unsigned> expected(numNodes, INF);
+  std::vector<size_t> paths(numNodes, 0);
+  std::deque<unsigned> queue{0};
+  expected[0]    = 0;
+  paths[0]       = 1;
+  size_t reached = 0;
+  size_t copies  = 0;
+  while (!queue.empty()) {
+    unsigned n = queue.front();
+    queue.pop_front();
+    ++reached;
+    copies += paths[n];
+    neighbors(n, [&](unsigned m) {
+      if (expected[m] == INF) {
+        expected[m] = expected[n] + 1;
+        queue.push_back(m);
+      }
+      if (expected[m] == expected[n] + 1)
+        paths[m] += paths[n];
+    });
+  }
+
+  for (unsigned n = 0; n < numNodes; ++n) {
+    GALOIS_ASSERT(dist[n] == expected[n], "node ", n, " has level ", dist[n],
+                  " instead of ", expected[n]);
+  }
+  size_t want = dedupe ? reached : copies;
+  GALOIS_ASSERT(processed.reduce() == want, "expected ", want,
+                " items but processed ", processed.reduce());
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(argc > 1 ? atoi(argv[1]) : 2);
+
+  namespace gwl = galois::worklists;
+  using WL = gwl::BatchedBulkSynchronous<gwl::PerSocketChunkFIFO<16>, 8>;
+  check<WL>(false);
+  check<WL::with_batch_size<1>>(false);
+  check<WL>(false, "batched-bsp");
+  check<WL::with_indexer<Identity>>(true, nullptr, Identity(), numNodes);
+
+  return 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <unistd.h>
+
+typedef std::tuple<uint32_t, uint32_t, int> Edge;
+
+std::string makeTempFile() {
+  char name[] = "/tmp/compressed-graph-XXXXXX";
+  int fd      = mkstemp(name);
+  if (fd < 0)
+    GALOIS_SYS_DIE("failed creating temporary file");
+  close(fd);
+  return name;
+}
+
+//! Random graph with self loops, multi-edges, a hub and far-away neighbors
+std::vector<std::vector<std::pair<uint32_t, int>>> makeAdjacency(size_t n) {
+  std::mt19937 gen(0);
+  std::vector<std::vector<std::pair<uint32_t, int>>> adj(n);
+  for (size_t src = 0; src < n; ++src) {
+    size_t degree = (src == 7) ? n : gen() % 8;
+    for (size_t i = 0; i < degree; ++i) {
+      uint32_t dst = (gen() % 4) ? (src + gen() % 64) % n : gen() % n;
+      adj[src].emplace_back(dst, static_cast<int>(gen() % 1000));
+    }
+  }
+  adj[3].emplace_back(3, 1);
+  adj[3].emplace_back(3, 2);
+  return adj;
+}
+
+void writeGr(const std::vector<std::vector<std::pair<uint32_t, int>>>& adj,
+             const std::string& filename) {
+  galois::graphs::FileGraphWriter w;
+  size_t numEdges = 0;
+  for (auto& a : adj)
+    numEdges += a.size();
+  w.setNumNodes(adj.size());
+  w.setNumEdges<int>(numEdges);
+  w.phase1();
+  for (size_t src = 0; src < adj.size(); ++src)
+    w.incrementDegree(src, adj[src].size());
+  w.phase2();
+  for (size_t src = 0; src < adj.size(); ++src)
+    for (auto& e : adj[src])
+      w.addNeighbor<int>(src, e.first, e.second);
+  w.finish<int>();
+  w.toFile(filename);
+}
+
+template <typename Graph>
+std::vector<Edge> sortedEdges(Graph& g) {
+  std::vector<Edge> edges;
+  for (auto src : g) {
+    for (auto e : g.edges(src)) {
+      edges.emplace_back(src, g.getEdgeDst(e), g.getEdgeData(e));
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+//! Destinations of every node in the order the graph iterates them
+template <typename Graph>
+std::vector<uint32_t> neighbors(Graph& g) {
+  std::vector<uint32_t> dsts;
+  for (auto src : g)
+    for (auto e : g.edges(src))
+      dsts.push_back(g.getEdgeDst(e));
+  return dsts;
+}
+
+//! Breadth-first levels written against the common graph interface
+template <typename Graph>
+std::vector<uint32_t> bfs(Graph& g) {
+  std::vector<uint32_t> level(g.size(), ~0U);
+  galois::InsertBag<uint32_t> cur, next;
+  level[0] = 0;
+  cur.push(0);
+  for (uint32_t depth = 1; !cur.empty(); ++depth) {
+    galois::do_all(galois::iterate(cur), [&](uint32_t src) {
+      for (auto e : g.edges(src, galois::MethodFlag::UNPROTECTED)) {
+        uint32_t dst = g.getEdgeDst(e);
+        if (__sync_bool_compare_and_swap(&level[dst], ~0U, depth))
+          next.push(dst);
+      }
+    });
+    cur.clear();
+    std::swap(cur, next);
+  }
+  return level;
+}
+
+template <typename Compressed, typename CSR>
+void check(Compressed& c, CSR& g, const char* what) {
+  GALOIS_ASSERT(c.size() == g.size() && c.sizeEdges() == g.sizeEdges(), what,
+                ": size mismatch");
+  for (auto src : c) {
+    uint32_t prev = 0;
+    for (auto e : c.edges(src)) {
+      GALOIS_ASSERT(c.getEdgeDst(e) >= prev, what, ": neighbors of ", src,
+                    " not sorted");
+      prev = c.getEdgeDst(e);
+    }
+    GALOIS_ASSERT(c.getDegree(src) == g.getDegree(src), what,
+                  ": degree mismatch at ", src);
+  }
+  const uint32_t* ranges = c.getEdgeBalancedRanges();
+  GALOIS_ASSERT(std::equal(ranges, ranges + galois::getActiveThreads() + 1,
+                           g.getEdgeBalancedRanges()),
+                what, ": edge balanced ranges differ");
+  GALOIS_ASSERT(sortedEdges(c) == sortedEdges(g) && bfs(c) == bfs(g), what,
+                ": graphs differ");
+  GALOIS_ASSERT(c.findEdge(3, 3) != c.edge_end(3) &&
+                    c.getEdgeDst(c.findEdge(3, 3)) == 3,
+                what, ": findEdge failed");
+  std::cout << what << ": " << c.sizeEdges() << " edges in "
+            << c.sizeEdgeBytes() << " bytes\n";
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  galois::setActiveThreads(argc > 1 ? atoi(argv[1]) : 2);
+
+  std::string gr  = makeTempFile();
+  std::string vgr = makeTempFile();
+  writeGr(makeAdjacency(5000), gr);
+
+  typedef galois::graphs::LC_CSR_Graph<int, int> CSR;
+  typedef galois::graphs::LC_Compressed_Graph<int, int> Compressed;
+
+  CSR g;
+  galois::graphs::readGraph(g, gr);
+
+  Compressed fromGr;
+  galois::graphs::readGraph(fromGr, gr);
+  check(fromGr, g, "gr");
+
+  fromGr.writeToVGRFile(vgr);
+  Compressed fromVgr;
+  galois::graphs::readGraph(fromVgr, vgr);
+  check(fromVgr, g, "vgr");
+
+  // without edge data, loading sorts destinations alone
+  galois::graphs::LC_Compressed_Graph<int, void> noData;
+  galois::graphs::readGraph(noData, gr);
+  GALOIS_ASSERT(neighbors(noData) == neighbors(fromGr) &&
+                    noData.sizeEdgeBytes() == fromGr.sizeEdgeBytes(),
+                "graphs without edge data differ");
+
+  std::remove(gr.c_str());
+  std::remove(vgr.c_str());
+  return 0;
+}
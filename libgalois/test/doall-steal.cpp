@@ -0,0 +1,112 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+// Checks that the locking and lock-free work-stealing do_all executors visit
+// every item once on a skewed, power-law-like workload where a few hub items
+// dominate the work and, given a number of items, compares their times.
+
+#include "galois/Galois.h"
+#include "galois/Bag.h"
+#include "galois/Reduction.h"
+#include "galois/Timer.h"
+#include "galois/substrate/ThreadPool.h"
+
+#include <atomic>
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+unsigned numItems = 1 << 12;
+unsigned iter     = 2;
+
+// item i costs about numItems / (i + 1) units, clustered at the front so
+// that the first thread's range holds most of the work
+unsigned cost(unsigned i) { return std::min(numItems / (i + 1), 1U << 14); }
+
+std::vector<std::atomic<unsigned>> visits;
+std::vector<unsigned> results;
+
+template <typename Steal>
+unsigned run(unsigned th, Steal steal) {
+  galois::setActiveThreads(th);
+
+  galois::Timer t;
+  t.start();
+  for (unsigned x = 0; x < iter; ++x) {
+    galois::do_all(
+        galois::iterate(0U, numItems),
+        [&](unsigned i) {
+          unsigned v = i;
+          for (unsigned k = cost(i); k; --k) {
+            v = v * 1103515245U + 12345U;
+          }
+          results[i] = v;
+          visits[i] += 1;
+        },
+        steal, galois::chunk_size<16>(), galois::no_stats());
+  }
+  t.stop();
+  return t.get();
+}
+
+void check() {
+  for (unsigned i = 0; i < numItems; ++i) {
+    GALOIS_ASSERT(visits[i] == iter, "item ", i, " visited ", visits[i],
+                  " times");
+    visits[i] = 0;
+  }
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys Galois_runtime;
+  // doall-steal <items> [iterations] prints times for each thread count
+  bool timing = argc > 1;
+  if (argc > 1)
+    numItems = atoi(argv[1]);
+  if (argc > 2)
+    iter = atoi(argv[2]);
+
+  visits = std::vector<std::atomic<unsigned>>(numItems);
+  results.resize(numItems);
+
+  if (timing)
+    std::cout << "threads,\tlocked,\tlockfree\n";
+  for (unsigned M = galois::substrate::getThreadPool().getMaxThreads(); M;
+       M >>= 1) {
+    unsigned locked = run(M, galois::steal());
+    check();
+    unsigned lockfree = run(M, galois::lockfree_steal());
+    check();
+    if (timing)
+      std::cout << M << ",\t" << locked << ",\t" << lockfree << "\n";
+  }
+
+  // per-thread containers fall back to the locking executor
+  galois::InsertBag<unsigned> bag;
+  galois::do_all(galois::iterate(0U, numItems),
+                 [&](unsigned i) { bag.push(i); });
+  galois::GAccumulator<size_t> sum;
+  galois::do_all(
+      galois::iterate(bag), [&](unsigned i) { sum += i; },
+      galois::lockfree_steal());
+  GALOIS_ASSERT(sum.reduce() == (size_t)numItems * (numItems - 1) / 2,
+                "bag sum mismatch");
+
+  return 0;
+}
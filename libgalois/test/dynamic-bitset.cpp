@@ -0,0 +1,128 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+
+#include "galois/Galois.h"
+#include "galois/DynamicBitset.h"
+#include "galois/PODResizeableArray.h"
+#include "galois/substrate/SimpleLock.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+std::mt19937 gen(0);
+
+//! Random bits, mostly clear, with runs of set words
+std::vector<bool> makeBits(size_t n) {
+  std::vector<bool> v(n);
+  for (size_t i = 0; i < n; ++i)
+    v[i] = (i / 64) % 97 == 3 || gen() % 17 == 0;
+  return v;
+}
+
+void load(galois::DynamicBitSet& b, const std::vector<bool>& v) {
+  b.resize(v.size());
+  for (size_t i = 0; i < v.size(); ++i)
+    if (v[i])
+      b.set(i);
+}
+
+std::vector<bool> unload(const galois::DynamicBitSet& b) {
+  std::vector<bool> v(b.size());
+  for (size_t i = 0; i < b.size(); ++i)
+    v[i] = b.test(i);
+  return v;
+}
+
+void test(size_t n) {
+  galois::DynamicBitSet a, b, c;
+  auto va = makeBits(n);
+  auto vb = makeBits(n);
+  load(a, va);
+  load(b, vb);
+
+  std::vector<uint32_t> want;
+  for (size_t i = 0; i < n; ++i)
+    if (va[i])
+      want.push_back(i);
+  GALOIS_ASSERT(a.count() == want.size(), n, " bits");
+  GALOIS_ASSERT(a.getOffsets() == want, n, " bits");
+  galois::PODResizeableArray<unsigned int> offsets;
+  a.getOffsets(offsets);
+  GALOIS_ASSERT(std::equal(offsets.begin(), offsets.end(), want.begin(),
+                           want.end()),
+                n, " bits");
+
+  std::vector<uint32_t> seen;
+  galois::substrate::SimpleLock lock;
+  a.for_each_set_bit([&](size_t i) {
+    lock.lock();
+    seen.push_back(i);
+    lock.unlock();
+  });
+  std::sort(seen.begin(), seen.end());
+  GALOIS_ASSERT(seen == want, n, " bits");
+
+  auto apply = [&](auto op) {
+    std::vector<bool> v(n);
+    for (size_t i = 0; i < n; ++i)
+      v[i] = op(bool(va[i]), bool(vb[i]));
+    return v;
+  };
+  auto both   = [](bool x, bool y) { return x && y; };
+  auto differ = [](bool x, bool y) { return x != y; };
+  auto either = [](bool x, bool y) { return x || y; };
+  c.resize(n);
+  c.bitwise_and(a, b);
+  GALOIS_ASSERT(unload(c) == apply(both), n, " bits");
+  c.bitwise_xor(a, b);
+  GALOIS_ASSERT(unload(c) == apply(differ), n, " bits");
+  load(c, va);
+  c.bitwise_or(b);
+  GALOIS_ASSERT(unload(c) == apply(either), n, " bits");
+  load(c, va);
+  c.bitwise_and(b);
+  GALOIS_ASSERT(unload(c) == apply(both), n, " bits");
+  load(c, va);
+  c.bitwise_xor(b);
+  GALOIS_ASSERT(unload(c) == apply(differ), n, " bits");
+
+  if (n == 0)
+    return;
+  for (int i = 0; i < 20; ++i) {
+    size_t begin = gen() % n;
+    size_t end   = begin + gen() % (n - begin);
+    auto v       = va;
+    std::fill(v.begin() + begin, v.begin() + end + 1, false);
+    load(c, va);
+    c.reset(begin, end);
+    GALOIS_ASSERT(unload(c) == v, n, " bits");
+  }
+  c.reset();
+  GALOIS_ASSERT(c.count() == 0, n, " bits");
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(4);
+  for (size_t n : {0, 1, 63, 64, 65, 1000, 65536, 65537, 300000})
+    test(n);
+  return 0;
+}
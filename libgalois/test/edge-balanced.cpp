@@ -0,0 +1,99 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+
+#include <atomic>
+#include <vector>
+
+typedef galois::graphs::LC_CSR_Graph<int, void>::with_no_lockable<true>::type
+    Graph;
+
+//! Degree of node n: the first nodes are hubs holding most of the edges
+uint64_t degree(uint32_t n) { return n < 16 ? 4096 : n % 4; }
+
+void build(Graph& g, uint32_t numNodes) {
+  uint64_t numEdges = 0;
+  for (uint32_t n = 0; n < numNodes; ++n)
+    numEdges += degree(n);
+
+  g.allocateFrom(numNodes, numEdges);
+  g.constructNodes();
+  uint64_t e = 0;
+  for (uint32_t n = 0; n < numNodes; ++n) {
+    for (uint64_t i = 0; i < degree(n); ++i)
+      g.constructEdge(e++, (n + i) % numNodes);
+    g.fixEndEdge(n, e);
+  }
+}
+
+void check(Graph& g, size_t nodeWeight, size_t edgeWeight) {
+  unsigned total = galois::getActiveThreads();
+  std::vector<std::atomic<unsigned>> visits(g.size());
+  std::vector<uint64_t> weights(total);
+
+  galois::do_all(
+      galois::iterate_edge_balanced(g, nodeWeight, edgeWeight),
+      [&](uint32_t n) {
+        visits[n] += 1;
+        weights[galois::substrate::ThreadPool::getTID()] +=
+            nodeWeight + edgeWeight * std::distance(g.edge_begin(n),
+                                                    g.edge_end(n));
+      },
+      galois::no_stats());
+
+  for (size_t n = 0; n < g.size(); ++n)
+    GALOIS_ASSERT(visits[n] == 1, "node ", n, " visited ", visits[n].load(),
+                  " times");
+
+  // no thread is more than a node's worth of weight past an even share
+  uint64_t sum = 0;
+  for (auto w : weights)
+    sum += w;
+  for (unsigned tid = 0; tid < total; ++tid)
+    GALOIS_ASSERT(weights[tid] <= sum / total + nodeWeight + edgeWeight * 4096,
+                  "thread ", tid, " got weight ", weights[tid], " of ", sum);
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(4);
+
+  Graph g;
+  build(g, 10000);
+
+  check(g, 1, 1);
+  check(g, 0, 1);
+  check(g, 1, 0);
+
+  // the division is cached until the weights or threads change
+  const uint32_t* ranges = g.getEdgeBalancedRanges();
+  GALOIS_ASSERT(ranges == g.getEdgeBalancedRanges());
+  GALOIS_ASSERT(ranges[0] == 0 && ranges[galois::getActiveThreads()] == g.size());
+
+  galois::setActiveThreads(3);
+  check(g, 1, 1);
+
+  // and is recomputed when the graph is rebuilt
+  build(g, 100);
+  check(g, 1, 1);
+
+  return 0;
+}
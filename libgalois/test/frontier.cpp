@@ -0,0 +1,162 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+
+#include "galois/Galois.h"
+#include "galois/graphs/Frontier.h"
+#include "galois/graphs/LCGraph.h"
+
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace galois::graphs;
+
+typedef LC_CSR_Graph<int, void>::with_no_lockable<true>::type Graph;
+
+constexpr uint32_t Inf = std::numeric_limits<uint32_t>::max();
+
+std::set<uint32_t> members(Frontier& f) {
+  std::set<uint32_t> s;
+  galois::substrate::SimpleLock lock;
+  f.forEach([&](uint32_t n) {
+    lock.lock();
+    s.insert(n);
+    lock.unlock();
+  });
+  return s;
+}
+
+void testFrontier() {
+  Frontier f(1000);
+  std::set<uint32_t> want;
+  galois::do_all(galois::iterate(0u, 3000u),
+                 [&](uint32_t i) { f.push((i * 7) % 1000 / 3 * 3); });
+  for (uint32_t i = 0; i < 1000; i += 3)
+    want.insert(i);
+
+  GALOIS_ASSERT(f.size() == want.size(), "duplicate pushes counted");
+  GALOIS_ASSERT(members(f) == want, "wrong sparse members");
+  f.toDense();
+  GALOIS_ASSERT(f.isDense() && members(f) == want, "wrong dense members");
+  GALOIS_ASSERT(f.contains(999) && !f.contains(998), "wrong membership");
+  f.toSparse();
+  GALOIS_ASSERT(!f.isDense() && members(f) == want,
+                "wrong members after toSparse");
+
+  f.clear();
+  GALOIS_ASSERT(f.empty() && members(f).empty(), "clear left members");
+  f.push(5);
+  GALOIS_ASSERT(f.size() == 1 && f.contains(5), "push after clear");
+  f.fill();
+  GALOIS_ASSERT(f.size() == 1000 && members(f).size() == 1000, "fill");
+  f.clear();
+  GALOIS_ASSERT(f.empty() && !f.contains(999), "clear dense");
+}
+
+struct Levels {
+  std::vector<std::atomic<uint32_t>>& level;
+  uint32_t round;
+
+  bool cond(uint32_t dst) { return level[dst] == Inf; }
+  bool update(uint32_t, uint32_t dst) {
+    level[dst] = round;
+    return true;
+  }
+  bool updateAtomic(uint32_t, uint32_t dst) {
+    uint32_t old = Inf;
+    return level[dst].compare_exchange_strong(old, round);
+  }
+};
+
+void testBFS(bool symmetric) {
+  std::mt19937 gen(0);
+  size_t numNodes = 5000;
+  std::vector<std::set<uint32_t>> adj(numNodes);
+  for (uint32_t n = 0; n < numNodes; ++n) {
+    size_t degree = n == 0 ? numNodes / 4 : gen() % 4;
+    for (size_t i = 0; i < degree; ++i) {
+      uint32_t dst = gen() % numNodes;
+      adj[n].insert(dst);
+      if (symmetric)
+        adj[dst].insert(n);
+    }
+  }
+
+  size_t numEdges = 0;
+  for (auto& a : adj)
+    numEdges += a.size();
+  Graph g;
+  g.allocateFrom(numNodes, numEdges);
+  g.constructNodes();
+  uint64_t e = 0;
+  for (size_t n = 0; n < numNodes; ++n) {
+    for (auto dst : adj[n])
+      g.constructEdge(e++, dst);
+    g.fixEndEdge(n, e);
+  }
+
+  std::vector<uint32_t> want(numNodes, Inf);
+  std::deque<uint32_t> queue = {1};
+  want[1]                    = 0;
+  while (!queue.empty()) {
+    uint32_t n = queue.front();
+    queue.pop_front();
+    for (auto dst : adj[n])
+      if (want[dst] == Inf) {
+        want[dst] = want[n] + 1;
+        queue.push_back(dst);
+      }
+  }
+
+  std::vector<EdgeMapOptions> configs(3);
+  // always pull
+  configs[1].alpha = configs[1].beta = std::numeric_limits<unsigned>::max();
+  // never pull
+  configs[2].alpha = configs[2].beta = 1;
+  for (auto options : configs) {
+    options.symmetric = symmetric;
+    std::vector<std::atomic<uint32_t>> level(numNodes);
+    for (auto& l : level)
+      l = Inf;
+    level[1] = 0;
+
+    Frontier a(numNodes), b(numNodes);
+    Frontier *in = &a, *out = &b;
+    in->push(1);
+    for (Levels fn{level, 1}; !in->empty(); ++fn.round) {
+      edgeMap(g, *in, *out, fn, options);
+      std::swap(in, out);
+    }
+    for (size_t n = 0; n < numNodes; ++n)
+      GALOIS_ASSERT(level[n] == want[n], "wrong BFS level");
+  }
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(4);
+  testFrontier();
+  testBFS(false);
+  testBFS(true);
+  return 0;
+}
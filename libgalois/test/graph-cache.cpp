@@ -0,0 +1,260 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/GraphCache.h"
+#include "galois/graphs/LCGraph.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+using namespace galois::graphs;
+
+typedef std::tuple<uint64_t, uint64_t, int> Edge;
+
+std::string makeTempFile() {
+  char name[] = "/tmp/graph-cache-XXXXXX";
+  int fd      = mkstemp(name);
+  if (fd < 0)
+    GALOIS_SYS_DIE("failed creating temporary file");
+  close(fd);
+  return name;
+}
+
+//! Random graph with a hub, self loops and unsorted edges
+std::vector<Edge> makeEdges(size_t n) {
+  std::mt19937 gen(0);
+  std::vector<Edge> edges;
+  for (size_t src = 0; src < n; ++src) {
+    size_t degree = (src == 5) ? n / 2 : gen() % 6;
+    for (size_t i = 0; i < degree; ++i)
+      edges.emplace_back(src, gen() % n, static_cast<int>(gen() % 1000));
+  }
+  edges.emplace_back(2, 2, 7);
+  return edges;
+}
+
+void writeGr(size_t n, const std::vector<Edge>& edges,
+             const std::string& filename) {
+  FileGraphWriter w;
+  w.setNumNodes(n);
+  w.setNumEdges<int>(edges.size());
+  w.phase1();
+  for (auto& e : edges)
+    w.incrementDegree(std::get<0>(e));
+  w.phase2();
+  for (auto& e : edges)
+    w.addNeighbor<int>(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+  w.finish<int>();
+  w.toFile(filename);
+}
+
+//! Edges of g in the order of their sources, and in sorted order if sorted
+std::vector<Edge> edgesOf(FileGraph& g, bool sorted, bool hasData) {
+  std::vector<Edge> edges;
+  for (auto src : g) {
+    size_t begin = edges.size();
+    for (auto jj : g.edges(src))
+      edges.emplace_back(src, g.getEdgeDst(jj),
+                         hasData ? g.getEdgeData<int>(jj) : 0);
+    auto first = edges.begin() + begin;
+    if (!sorted)
+      std::sort(first, edges.end());
+    else
+      GALOIS_ASSERT(std::is_sorted(first, edges.end(),
+                                   [](const Edge& a, const Edge& b) {
+                                     return std::get<1>(a) < std::get<1>(b);
+                                   }),
+                    "edges of ", src, " are not sorted");
+  }
+  if (sorted)
+    for (size_t i = 0; i < edges.size();) {
+      size_t j = i;
+      while (j < edges.size() && std::get<0>(edges[j]) == std::get<0>(edges[i]))
+        ++j;
+      std::sort(edges.begin() + i, edges.begin() + j);
+      i = j;
+    }
+  return edges;
+}
+
+//! Applies transforms to edges the slow way
+std::vector<Edge> expected(size_t n, std::vector<Edge> edges,
+                           unsigned transforms, bool hasData) {
+  if (transforms & Symmetrize) {
+    size_t num = edges.size();
+    for (size_t i = 0; i < num; ++i)
+      if (std::get<0>(edges[i]) != std::get<1>(edges[i]))
+        edges.emplace_back(std::get<1>(edges[i]), std::get<0>(edges[i]),
+                           std::get<2>(edges[i]));
+  }
+  if (transforms & Transpose)
+    for (auto& e : edges)
+      std::swap(std::get<0>(e), std::get<1>(e));
+  if (transforms & RelabelByDegree) {
+    std::vector<std::pair<uint64_t, uint64_t>> degrees(n);
+    for (size_t i = 0; i < n; ++i)
+      degrees[i].second = i;
+    for (auto& e : edges)
+      degrees[std::get<0>(e)].first += 1;
+    std::sort(degrees.rbegin(), degrees.rend());
+    std::vector<uint64_t> p(n);
+    for (size_t i = 0; i < n; ++i)
+      p[degrees[i].second] = i;
+    for (auto& e : edges)
+      e = Edge(p[std::get<0>(e)], p[std::get<1>(e)], std::get<2>(e));
+  }
+  if (transforms & (OrientByDegree | OrientById)) {
+    std::vector<uint64_t> degrees(n);
+    for (auto& e : edges)
+      degrees[std::get<0>(e)] += 1;
+    auto key = [&](uint64_t v) {
+      return std::make_pair((transforms & OrientById) ? 0 : degrees[v], v);
+    };
+    edges.erase(std::remove_if(edges.begin(), edges.end(),
+                               [&](const Edge& e) {
+                                 return !(key(std::get<0>(e)) <
+                                          key(std::get<1>(e)));
+                               }),
+                edges.end());
+  }
+  if (!hasData)
+    for (auto& e : edges)
+      std::get<2>(e) = 0;
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+//! Checks that g keeps one direction of every edge of the symmetric graph
+//! sym and that no node has more out-edges than the degeneracy of sym
+void checkCoreOrder(FileGraph& g, const std::vector<Edge>& sym, size_t n) {
+  std::vector<std::pair<uint64_t, uint64_t>> both, want;
+  for (auto src : g) {
+    for (auto jj : g.edges(src)) {
+      both.emplace_back(src, g.getEdgeDst(jj));
+      both.emplace_back(g.getEdgeDst(jj), src);
+    }
+  }
+  for (auto& e : sym)
+    if (std::get<0>(e) != std::get<1>(e))
+      want.emplace_back(std::get<0>(e), std::get<1>(e));
+  std::sort(both.begin(), both.end());
+  std::sort(want.begin(), want.end());
+  GALOIS_ASSERT(both == want, "orientation lost or duplicated edges");
+
+  // degeneracy: the largest minimum degree seen while removing nodes
+  std::vector<uint64_t> degrees(n);
+  std::vector<std::vector<uint64_t>> adj(n);
+  for (auto& e : sym) {
+    if (std::get<0>(e) != std::get<1>(e)) {
+      degrees[std::get<0>(e)] += 1;
+      adj[std::get<0>(e)].push_back(std::get<1>(e));
+    }
+  }
+  std::vector<bool> removed(n);
+  uint64_t degeneracy = 0;
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t m = n;
+    for (uint64_t v = 0; v < n; ++v)
+      if (!removed[v] && (m == n || degrees[v] < degrees[m]))
+        m = v;
+    degeneracy = std::max(degeneracy, degrees[m]);
+    removed[m] = true;
+    for (auto v : adj[m])
+      degrees[v] -= 1;
+  }
+  for (auto src : g)
+    GALOIS_ASSERT(uint64_t(std::distance(g.edge_begin(src), g.edge_end(src))) <=
+                      degeneracy,
+                  "node ", src, " has more than ", degeneracy, " out-edges");
+}
+
+size_t countCached(const std::string& dir) {
+  size_t count = 0;
+  if (DIR* d = opendir(dir.c_str())) {
+    while (dirent* e = readdir(d))
+      count += e->d_name[0] != '.';
+    closedir(d);
+  }
+  return count;
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(4);
+  unsetenv("GALOIS_GRAPH_CACHE");
+
+  size_t n           = 1000;
+  std::string file   = makeTempFile();
+  std::vector<Edge> e = makeEdges(n);
+  writeGr(n, e, file);
+
+  std::vector<unsigned> variants = {
+      SortByDst,
+      Transpose,
+      Symmetrize | SortByDst,
+      RelabelByDegree,
+      Transpose | RelabelByDegree | SortByDst,
+      Symmetrize | OrientByDegree | SortByDst,
+      Symmetrize | RelabelByDegree | OrientById | SortByDst};
+
+  for (int pass = 0; pass < 2; ++pass) {
+    for (unsigned t : variants) {
+      for (bool keep : {true, false}) {
+        FileGraph g;
+        fromFileCached(g, file, t, keep);
+        GALOIS_ASSERT(edgesOf(g, t & SortByDst, keep) ==
+                          expected(n, e, t, keep),
+                      "wrong graph for transforms ", t, " on pass ", pass);
+      }
+    }
+    // the second pass only hits cached files written by the first
+    GALOIS_ASSERT(countCached(file + ".cache") == 2 * variants.size(),
+                  "expected ", 2 * variants.size(), " cached graphs");
+  }
+
+  typedef LC_CSR_Graph<int, int>::with_no_lockable<true>::type Graph;
+  Graph graph;
+  readGraphCached(graph, file, Symmetrize | SortByDst);
+  GALOIS_ASSERT(graph.sizeEdges() == expected(n, e, Symmetrize, true).size(),
+                "read ", graph.sizeEdges(), " edges");
+
+  // disabled cache builds the same graph without writing
+  setenv("GALOIS_GRAPH_CACHE", "0", 1);
+  FileGraph g;
+  fromFileCached(g, file, Transpose | Symmetrize, true);
+  GALOIS_ASSERT(edgesOf(g, false, true) ==
+                    expected(n, e, Transpose | Symmetrize, true),
+                "wrong graph with the cache disabled");
+  GALOIS_ASSERT(countCached(file + ".cache") == 2 * variants.size(),
+                "cache written while disabled");
+
+  FileGraph dag;
+  fromFileCached(dag, file, Symmetrize | OrientByCore | SortByDst, false);
+  checkCoreOrder(dag, expected(n, e, Symmetrize, false), n);
+
+  std::string cmd = "rm -rf " + file + " " + file + ".cache";
+  return system(cmd.c_str());
+}
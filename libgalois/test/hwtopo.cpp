@@ -22,6 +22,10 @@
 
 #include <iostream>
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 void printMyTopo() {
   auto t = galois::substrate::getHWTopo();
   std::cout << "T,C,P,N: " << t.machineTopoInfo.maxThreads << " "
@@ -57,6 +61,38 @@ void test(const std::string& name, const std::vector<int>& found,
   }
 }
 
+void testQuota(const std::string& quota, const std::string& period,
+               unsigned expected) {
+  unsigned found = galois::substrate::parseCPUQuota(quota, period);
+  if (found != expected) {
+    std::cerr << "quota " << quota << " " << period << ": found " << found
+              << " expected " << expected << "\n";
+    std::abort();
+  }
+}
+
+//! Threads are only bound to CPUs the process may run on
+void testAffinity() {
+#ifdef __linux__
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (sched_getaffinity(0, sizeof(mask), &mask) != 0)
+    return;
+  auto t = galois::substrate::getHWTopo();
+  if (t.machineTopoInfo.maxThreads > (unsigned)CPU_COUNT(&mask)) {
+    std::cerr << "more threads than CPUs in the affinity mask\n";
+    std::abort();
+  }
+  for (auto& c : t.threadTopoInfo) {
+    if (!CPU_ISSET(c.osContext, &mask)) {
+      std::cerr << "thread " << c.tid << " on CPU " << c.osContext
+                << " outside of the affinity mask\n";
+      std::abort();
+    }
+  }
+#endif
+}
+
 int main() {
   printMyTopo();
 
@@ -73,5 +109,13 @@ int main() {
   test("parse range", parseCPUList("     0-4   \n"),
        std::vector<int>{0, 1, 2, 3, 4});
 
+  testQuota("max", "100000", 0);
+  testQuota("-1", "100000", 0);
+  testQuota("50000", "100000", 1);
+  testQuota("200000", "100000", 2);
+  testQuota("250000", "100000", 3);
+
+  testAffinity();
+
   return 0;
 }
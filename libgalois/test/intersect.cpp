@@ -0,0 +1,119 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/Intersect.h"
+#include "galois/graphs/LCGraph.h"
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+using namespace galois::graphs;
+
+std::mt19937 gen(0);
+
+//! n distinct sorted values below range
+std::vector<uint32_t> makeSet(size_t n, uint32_t range) {
+  std::vector<uint32_t> v;
+  while (v.size() < n) {
+    for (size_t i = v.size(); i < n; ++i)
+      v.push_back(gen() % range);
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+  }
+  return v;
+}
+
+size_t expected(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+  std::vector<uint32_t> out;
+  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                        std::back_inserter(out));
+  return out.size();
+}
+
+void check(size_t got, size_t want, const char* what, size_t na, size_t nb) {
+  GALOIS_ASSERT(got == want, what, " counted ", got, " instead of ", want,
+                " for sizes ", na, " and ", nb);
+}
+
+void testSets() {
+  std::vector<IntersectKernel> kernels;
+  for (auto k : {IntersectKernel::Scalar, IntersectKernel::AVX2,
+                 IntersectKernel::AVX512})
+    if (isSupported(k))
+      kernels.push_back(k);
+
+  std::vector<size_t> sizes = {0, 1, 7, 8, 9, 15, 16, 17, 31, 100, 1000, 5000};
+  for (size_t na : sizes) {
+    for (size_t nb : sizes) {
+      // dense ranges have many common values, sparse ones few
+      for (uint32_t range : {uint32_t(2 * (na + nb) + 1), uint32_t(1) << 20}) {
+        auto a = makeSet(na, range);
+        auto b = makeSet(nb, range);
+        size_t want = expected(a, b);
+
+        for (auto k : kernels)
+          check(intersectCount(k, a.data(), na, b.data(), nb), want, "kernel",
+                na, nb);
+        check(intersectCount(a.data(), na, b.data(), nb), want, "dispatch", na,
+              nb);
+
+        std::vector<uint64_t> bits(range / 64 + 1);
+        for (auto x : a)
+          bits[x / 64] |= uint64_t(1) << (x % 64);
+        check(intersectCount(bits.data(), b.data(), nb), want, "bitmap", na,
+              nb);
+      }
+    }
+  }
+}
+
+void testGraph() {
+  typedef LC_CSR_Graph<int, void>::with_no_lockable<true>::type Graph;
+  size_t numNodes = 2000;
+  std::vector<std::vector<uint32_t>> adj(numNodes);
+  size_t numEdges = 0;
+  for (size_t n = 0; n < numNodes; ++n) {
+    adj[n] = makeSet(n == 0 ? numNodes / 2 : gen() % 64, numNodes);
+    numEdges += adj[n].size();
+  }
+
+  Graph g;
+  g.allocateFrom(numNodes, numEdges);
+  g.constructNodes();
+  uint64_t e = 0;
+  for (size_t n = 0; n < numNodes; ++n) {
+    for (auto dst : adj[n])
+      g.constructEdge(e++, dst);
+    g.fixEndEdge(n, e);
+  }
+
+  for (size_t n = 0; n < numNodes; ++n)
+    check(countCommonNeighbors(g, 0, n), expected(adj[0], adj[n]), "graph",
+          adj[0].size(), adj[n].size());
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  testSets();
+  testGraph();
+  return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+
+#include <vector>
+
+// Items encode (x << 1) | branched; the priority is x / 4.
+struct Indexer {
+  int operator()(int item) const { return (item >> 1) / 4; }
+};
+
+template <typename F>
+void expand(int item, int depth, F&& push) {
+  int x = item >> 1;
+  if (x >= depth)
+    return;
+  push(((x + 1) << 1) | (item & 1));
+  // send some work back to a lower priority to churn buckets
+  if (!(item & 1) && x % 16 == 8)
+    push(((x - 8) << 1) | 1);
+}
+
+template <typename WL>
+void check(int numItems, int depth) {
+  std::vector<int> initial(numItems);
+  for (int i = 0; i < numItems; ++i)
+    initial[i] = ((i * 7) % 64) << 1;
+
+  galois::GAccumulator<size_t> processed;
+  galois::for_each(
+      galois::iterate(initial),
+      [&](int item, auto& ctx) {
+        processed += 1;
+        expand(item, depth, [&](int next) { ctx.push(next); });
+      },
+      galois::wl<WL>(), galois::disable_conflict_detection(),
+      galois::loopname("lockfree-obim"));
+
+  size_t expected = 0;
+  std::vector<int> stack(initial);
+  while (!stack.empty()) {
+    int item = stack.back();
+    stack.pop_back();
+    ++expected;
+    expand(item, depth, [&](int next) { stack.push_back(next); });
+  }
+
+  GALOIS_ASSERT(processed.reduce() == expected, "expected ", expected,
+                " items but processed ", processed.reduce());
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(argc > 1 ? atoi(argv[1]) : 2);
+
+  namespace gwl = galois::worklists;
+  using WL =
+      gwl::LockFreeOrderedByIntegerMetric<Indexer, gwl::PerSocketChunkFIFO<8>>;
+  check<WL>(100, 256);
+  check<WL::with_descending<true>::type>(100, 256);
+  check<WL::with_block_period<2>::type>(100, 256);
+
+  return 0;
+}
@@ -0,0 +1,187 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/graphs/MultiSourceSearch.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace galois::graphs;
+
+typedef LC_CSR_Graph<int, uint32_t>::with_no_lockable<true>::type Graph;
+typedef std::vector<std::vector<std::pair<uint32_t, uint32_t>>> Adjacency;
+
+constexpr uint32_t Inf = std::numeric_limits<uint32_t>::max();
+
+//! Random directed graph with a hub and some unreachable nodes
+void makeGraph(Graph& g, Adjacency& adj, size_t numNodes) {
+  std::mt19937 gen(0);
+  adj.resize(numNodes);
+  size_t numEdges = 0;
+  for (uint32_t n = 0; n < numNodes; ++n) {
+    size_t degree = n == 0 ? numNodes / 4 : gen() % 4;
+    for (size_t i = 0; i < degree; ++i)
+      adj[n].emplace_back(gen() % numNodes, 1 + gen() % 100);
+    numEdges += adj[n].size();
+  }
+
+  g.allocateFrom(numNodes, numEdges);
+  g.constructNodes();
+  uint64_t e = 0;
+  for (size_t n = 0; n < numNodes; ++n) {
+    for (auto& [dst, w] : adj[n])
+      g.constructEdge(e++, dst, w);
+    g.fixEndEdge(n, e);
+  }
+}
+
+std::vector<uint32_t> bfs(const Adjacency& adj, uint32_t source) {
+  std::vector<uint32_t> dist(adj.size(), Inf);
+  std::deque<uint32_t> queue = {source};
+  dist[source]               = 0;
+  while (!queue.empty()) {
+    uint32_t n = queue.front();
+    queue.pop_front();
+    for (auto& edge : adj[n])
+      if (dist[edge.first] == Inf) {
+        dist[edge.first] = dist[n] + 1;
+        queue.push_back(edge.first);
+      }
+  }
+  return dist;
+}
+
+std::vector<uint32_t> dijkstra(const Adjacency& adj, uint32_t source) {
+  using Item = std::pair<uint32_t, uint32_t>;
+  std::vector<uint32_t> dist(adj.size(), Inf);
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  dist[source] = 0;
+  queue.emplace(0, source);
+  while (!queue.empty()) {
+    auto [d, n] = queue.top();
+    queue.pop();
+    if (d > dist[n])
+      continue;
+    for (auto& [dst, w] : adj[n])
+      if (d + w < dist[dst]) {
+        dist[dst] = d + w;
+        queue.emplace(d + w, dst);
+      }
+  }
+  return dist;
+}
+
+template <unsigned Width>
+void testBFS(Graph& g, const Adjacency& adj, size_t numSources) {
+  std::vector<uint32_t> sources;
+  for (size_t i = 0; i < numSources; ++i)
+    sources.push_back((i * 37) % g.size());
+  // the same node twice
+  sources.back() = sources.front();
+
+  std::vector<std::atomic<uint32_t>> level(g.size() * numSources);
+  for (auto& l : level)
+    l = Inf;
+  std::atomic<size_t> edgeCalls(0);
+
+  MultiSourceBFS<Graph, Width> msbfs(g);
+  // twice, so that reset clears the first search
+  for (int run = 0; run < 2; ++run) {
+    msbfs.run(sources, [&](uint32_t n, const auto& mask, unsigned l) {
+      mask.forEach([&](unsigned i) {
+        uint32_t old = Inf;
+        bool first = level[n * numSources + i].compare_exchange_strong(old, l);
+        GALOIS_ASSERT(first || run == 1, "node visited twice by one source");
+      });
+    });
+  }
+
+  for (size_t i = 0; i < numSources; ++i) {
+    std::vector<uint32_t> want = bfs(adj, sources[i]);
+    for (size_t n = 0; n < g.size(); ++n) {
+      GALOIS_ASSERT(level[n * numSources + i] == want[n], "wrong MS-BFS level");
+      GALOIS_ASSERT(msbfs.reached(n).test(i) == (want[n] != Inf),
+                    "wrong reached");
+    }
+  }
+
+  // stepping by hand; every edge call reaches its destination one level on
+  msbfs.reset(sources);
+  while (msbfs.advance([&](uint32_t src, uint32_t dst, const auto& mask) {
+    mask.forEach([&](unsigned i) {
+      GALOIS_ASSERT(level[dst * numSources + i] ==
+                        level[src * numSources + i] + 1,
+                    "edge outside the BFS DAG");
+    });
+    edgeCalls += 1;
+  })) {
+    msbfs.forEachVisited([&](uint32_t n, const auto& mask) {
+      GALOIS_ASSERT(mask.any() &&
+                        (msbfs.reached(n) & mask).count() == mask.count(),
+                    "visited but not reached");
+      mask.forEach([&](unsigned i) {
+        GALOIS_ASSERT(level[n * numSources + i] == msbfs.level(),
+                      "wrong level");
+      });
+    });
+  }
+  GALOIS_ASSERT(edgeCalls > 0 && msbfs.frontier().empty(),
+                "search did not finish");
+}
+
+void testSSSP(Graph& g, const Adjacency& adj) {
+  BatchedSSSP<Graph> sssp(g);
+  for (size_t numSources : {1, 13, 40}) {
+    std::vector<uint32_t> sources;
+    for (size_t i = 0; i < numSources; ++i)
+      sources.push_back((i * 101 + 1) % g.size());
+    sssp.run(sources, 4);
+    GALOIS_ASSERT(sssp.sources() == numSources, "wrong number of sources");
+    for (size_t i = 0; i < numSources; ++i) {
+      std::vector<uint32_t> want = dijkstra(adj, sources[i]);
+      for (size_t n = 0; n < g.size(); ++n) {
+        uint32_t got = sssp.distance(n, i);
+        GALOIS_ASSERT(got == (want[n] == Inf ? sssp.infinity : want[n]),
+                      "wrong batched SSSP distance");
+      }
+    }
+  }
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(4);
+
+  Graph g;
+  Adjacency adj;
+  makeGraph(g, adj, 5000);
+  testBFS<64>(g, adj, 64);
+  testBFS<128>(g, adj, 100);
+  testBFS<512>(g, adj, 3);
+  testSSSP(g, adj);
+  return 0;
+}
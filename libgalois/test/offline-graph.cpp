@@ -0,0 +1,151 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/FileGraph.h"
+#include "galois/graphs/OfflineGraph.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace galois::graphs;
+
+//! Random graph large enough to span several pread buffers
+std::string writeGraph(std::vector<uint64_t>& index, std::vector<uint32_t>& dst,
+                       std::vector<int>& data) {
+  char name[] = "/tmp/offline-graph-XXXXXX";
+  int fd      = mkstemp(name);
+  if (fd < 0)
+    GALOIS_SYS_DIE("failed creating temporary file");
+  close(fd);
+
+  size_t n = 200000;
+  std::mt19937 gen(0);
+  std::vector<size_t> degrees(n);
+  for (size_t i = 0; i < n; ++i)
+    degrees[i] = (i == 7) ? 5000 : gen() % 12;
+
+  FileGraphWriter w;
+  w.setNumNodes(n);
+  w.setNumEdges<int>(std::accumulate(degrees.begin(), degrees.end(), 0ul));
+  w.phase1();
+  for (size_t i = 0; i < n; ++i)
+    w.incrementDegree(i, degrees[i]);
+  w.phase2();
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < degrees[i]; ++j) {
+      dst.push_back(gen() % n);
+      data.push_back(gen() % 1000);
+      w.addNeighbor<int>(i, dst.back(), data.back());
+    }
+    index.push_back(dst.size());
+  }
+  w.finish<int>();
+  w.toFile(name);
+  return name;
+}
+
+void checkGraph(OfflineGraph& g, const std::vector<uint64_t>& index,
+                const std::vector<uint32_t>& dst,
+                const std::vector<int>& data) {
+  GALOIS_ASSERT(g.size() == index.size() && g.sizeEdges() == dst.size(),
+                "wrong sizes");
+
+  // per-node and per-edge accessors
+  g.reset_seek_counters();
+  for (uint64_t n = 0; n < g.size(); n += 97) {
+    GALOIS_ASSERT(*g.edge_end(n) == index[n], "wrong edge end");
+    for (auto e : g.edges(n)) {
+      GALOIS_ASSERT(g.getEdgeDst(e) == dst[*e], "wrong edge destination");
+      GALOIS_ASSERT(g.getEdgeData<int>(e) == data[*e], "wrong edge data");
+    }
+  }
+  GALOIS_ASSERT(g.num_bytes_read() > 0 && g.num_seeks() > 0,
+                "reads not counted");
+
+  // bulk reads, including ranges that are not chunk or buffer aligned
+  g.reset_seek_counters();
+  std::vector<uint64_t> out(g.sizeEdges());
+  std::vector<int> outData(g.sizeEdges());
+  g.readIndexRange(0, g.size(), out.data());
+  GALOIS_ASSERT(std::equal(index.begin(), index.end(), out.begin()),
+                "wrong index");
+  g.readEdgeRange(0, g.sizeEdges(), out.data());
+  GALOIS_ASSERT(std::equal(dst.begin(), dst.end(), out.begin()), "wrong edges");
+  g.readEdgeDataRange<int>(0, g.sizeEdges(), outData.data());
+  GALOIS_ASSERT(outData == data, "wrong edge data range");
+  size_t bytes = g.size() * sizeof(uint64_t) + g.sizeEdges() * 2 * sizeof(int);
+  GALOIS_ASSERT(g.num_bytes_read() == bytes, "wrong number of bytes read");
+  GALOIS_ASSERT(g.num_seeks() == 3, "sequential range reads seek");
+
+  uint64_t begin = 12345, end = 1012345;
+  g.readEdgeRange(begin, end, out.data());
+  GALOIS_ASSERT(std::equal(dst.begin() + begin, dst.begin() + end, out.begin()),
+                "wrong partial edges");
+  g.readIndexRange(3, 4, out.data());
+  GALOIS_ASSERT(out[0] == index[3], "wrong single index");
+
+  // the binary search used to partition
+  auto r = g.divideByNode(0, 1, 1, 4);
+  GALOIS_ASSERT(*r.second.first == index[*r.first.first - 1] &&
+                    *r.second.second == index[*r.first.second - 1],
+                "wrong division");
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+
+  std::vector<uint64_t> index;
+  std::vector<uint32_t> dst;
+  std::vector<int> data;
+  std::string file = writeGraph(index, dst, data);
+
+  OfflineGraph mapped(file);
+  GALOIS_ASSERT(mapped.isMapped(), "graph not mapped");
+  checkGraph(mapped, index, dst, data);
+
+  OfflineGraph read(file, false);
+  GALOIS_ASSERT(!read.isMapped(), "graph mapped");
+  checkGraph(read, index, dst, data);
+
+  OfflineGraph moved(std::move(read));
+  GALOIS_ASSERT(moved.getEdgeDst(*moved.edge_begin(7)) == dst[index[6]],
+                "moved graph unreadable");
+
+  // a file cut short inside the edge data is rejected rather than mapped
+  struct stat st;
+  GALOIS_ASSERT(stat(file.c_str(), &st) == 0 &&
+                truncate(file.c_str(), st.st_size - sizeof(int)) == 0);
+  bool rejected = false;
+  try {
+    OfflineGraph cut(file);
+  } catch (const char*) {
+    rejected = true;
+  }
+  GALOIS_ASSERT(rejected, "truncated edge data accepted");
+
+  unlink(file.c_str());
+  return 0;
+}
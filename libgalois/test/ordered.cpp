@@ -0,0 +1,170 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/runtime/Context.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <vector>
+
+struct Node : public galois::runtime::Lockable {
+  uint64_t value = 0;
+};
+
+struct Item {
+  uint32_t prio;
+  uint32_t a;
+  uint32_t b;
+  uint32_t steps;
+};
+
+struct Cmp {
+  bool operator()(const Item& x, const Item& y) const {
+    return x.prio <= y.prio;
+  }
+};
+
+void update(Node& n, uint32_t prio) { n.value = n.value * 31 + prio + 1; }
+
+std::vector<Item> makeItems(size_t numItems, size_t numNodes) {
+  std::mt19937 gen(0);
+  std::vector<uint32_t> prios(numItems);
+  std::iota(prios.begin(), prios.end(), 0);
+  std::shuffle(prios.begin(), prios.end(), gen);
+  std::vector<Item> items;
+  for (auto p : prios)
+    items.push_back(Item{p, static_cast<uint32_t>(gen() % numNodes),
+                         static_cast<uint32_t>(gen() % numNodes), 0});
+  return items;
+}
+
+//! Node values after running items one at a time in priority order
+std::vector<uint64_t> serial(std::vector<Item> items, size_t numNodes) {
+  std::vector<Node> nodes(numNodes);
+  std::sort(items.begin(), items.end(),
+            [](const Item& x, const Item& y) { return x.prio < y.prio; });
+  for (auto& item : items) {
+    update(nodes[item.a], item.prio);
+    if (item.b != item.a)
+      update(nodes[item.b], item.prio);
+  }
+  std::vector<uint64_t> values;
+  for (auto& n : nodes)
+    values.push_back(n.value);
+  return values;
+}
+
+void check(std::vector<Node>& nodes, const std::vector<uint64_t>& expected,
+           const char* name) {
+  for (size_t i = 0; i < nodes.size(); ++i)
+    GALOIS_ASSERT(nodes[i].value == expected[i], name, ": node ", i,
+                  " updated out of order");
+}
+
+//! Items on overlapping neighborhoods commit in priority order
+void testOrder(bool unstable, const char* name) {
+  size_t numNodes         = 500;
+  std::vector<Item> items = makeItems(20000, numNodes);
+  std::vector<Node> nodes(numNodes);
+
+  auto nhFunc = [&](const Item& item) {
+    galois::runtime::acquire(&nodes[item.a], galois::MethodFlag::WRITE);
+    galois::runtime::acquire(&nodes[item.b], galois::MethodFlag::WRITE);
+  };
+  auto fn = [&](const Item& item, galois::UserContext<Item>&) {
+    update(nodes[item.a], item.prio);
+    if (item.b != item.a)
+      update(nodes[item.b], item.prio);
+  };
+
+  if (unstable) {
+    // deferring items never reorders them
+    galois::for_each_ordered(
+        items.begin(), items.end(), Cmp(), nhFunc, fn,
+        [](const Item& item) { return item.prio % 3 != 0; }, name);
+  } else {
+    galois::for_each_ordered(items.begin(), items.end(), Cmp(), nhFunc, fn,
+                             name);
+  }
+
+  check(nodes, serial(items, numNodes), name);
+}
+
+//! Pushed items run, and touching data outside of the neighborhood aborts
+//! and retries instead of racing
+void testPushes() {
+  size_t numNodes = 256;
+  uint32_t steps  = 10;
+  std::vector<Node> nodes(numNodes);
+  std::vector<Item> items;
+  for (uint32_t i = 0; i < numNodes; ++i)
+    items.push_back(Item{i, i, i, steps});
+
+  galois::for_each_ordered(
+      items.begin(), items.end(), Cmp(),
+      [&](const Item& item) {
+        galois::runtime::acquire(&nodes[item.a], galois::MethodFlag::WRITE);
+      },
+      [&](const Item& item, galois::UserContext<Item>& ctx) {
+        galois::runtime::acquire(&nodes[(item.a + 1) % numNodes],
+                                 galois::MethodFlag::WRITE);
+        update(nodes[item.a], item.prio);
+        if (item.steps)
+          ctx.push(Item{static_cast<uint32_t>(item.prio + numNodes), item.a,
+                        item.a, item.steps - 1});
+      },
+      "pushes");
+
+  std::vector<Item> expected;
+  for (uint32_t s = 0; s <= steps; ++s)
+    for (uint32_t i = 0; i < numNodes; ++i)
+      expected.push_back(Item{static_cast<uint32_t>(s * numNodes + i), i, i, 0});
+  check(nodes, serial(expected, numNodes), "pushes");
+}
+
+void testBreak() {
+  std::vector<Item> items = makeItems(20000, 500);
+  std::atomic<size_t> executed(0);
+  galois::for_each_ordered(
+      items.begin(), items.end(), Cmp(), [](const Item&) {},
+      [&](const Item& item, galois::UserContext<Item>& ctx) {
+        ++executed;
+        if (item.prio == 100)
+          ctx.breakLoop();
+      });
+  GALOIS_ASSERT(executed < items.size(), "break did not stop the loop");
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(4);
+
+  testOrder(false, "stable");
+  testOrder(true, "unstable");
+  testPushes();
+  testBreak();
+
+  galois::setActiveThreads(1);
+  testOrder(false, "serial");
+
+  return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/PlacementPolicy.h"
+#include "galois/runtime/Mem.h"
+#include "galois/substrate/NumaMem.h"
+
+#include <cstdlib>
+
+using galois::PlacementPolicy;
+using galois::substrate::PageKind;
+
+void expect(const PlacementPolicy& p, const char* spec) {
+  GALOIS_ASSERT(p.str() == spec, "expected ", spec, " but got ", p.str());
+}
+
+// the * entry of GALOIS_PLACEMENT covers this role, so override it in code
+void fill(const PlacementPolicy& p) {
+  PlacementPolicy::setOverride("test", p);
+  galois::LargeArray<size_t> a;
+  a.allocateForRole(100000, "test", PlacementPolicy());
+  for (size_t i = 0; i < a.size(); ++i)
+    a[i] = i;
+  for (size_t i = 0; i < a.size(); ++i)
+    GALOIS_ASSERT(a[i] == i);
+}
+
+int main() {
+  // read on first use of a policy
+  setenv("GALOIS_PLACEMENT", "edgeDst=local:thp,*=floating", 1);
+
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(2);
+
+  expect(PlacementPolicy::parse("blocked"), "blocked:default");
+  expect(PlacementPolicy::parse("interleaved:1g"), "interleaved:1g");
+
+  PlacementPolicy dflt(PlacementPolicy::Blocked);
+  expect(PlacementPolicy::forRole("edgeDst", dflt), "local:thp");
+  expect(PlacementPolicy::forRole("nodeData", dflt), "floating:default");
+
+  PlacementPolicy::setOverride("nodeData",
+                               PlacementPolicy::parse("interleaved:small"));
+  expect(PlacementPolicy::forRole("nodeData", dflt), "interleaved:small");
+  expect(PlacementPolicy::forRole("edgeData", dflt), "floating:default");
+
+  for (auto placement :
+       {PlacementPolicy::Blocked, PlacementPolicy::Local,
+        PlacementPolicy::Interleaved, PlacementPolicy::Floating}) {
+    for (auto pages : {PageKind::Default, PageKind::Small,
+                       PageKind::Transparent, PageKind::Huge1G}) {
+      fill(PlacementPolicy(placement, pages));
+    }
+  }
+
+  // without 1GB pages worth of data, Huge1G maps what Default would
+  galois::substrate::LAptr small[] = {
+      galois::substrate::largeMallocInterleaved(3 << 20, 2, PageKind::Huge1G),
+      galois::substrate::largeMallocBlocked(3 << 20, 2, PageKind::Huge1G),
+      galois::substrate::largeMallocLocal(3 << 20, PageKind::Huge1G),
+      galois::substrate::largeMallocFloating(3 << 20, PageKind::Huge1G)};
+  for (auto& alloc : small)
+    GALOIS_ASSERT(alloc.get_deleter().bytes ==
+                      2 * galois::substrate::allocSize(),
+                  "small Huge1G allocation mapped ", alloc.get_deleter().bytes,
+                  " bytes");
+
+  galois::runtime::printInterleavedStats();
+  GALOIS_ASSERT(galois::runtime::numNumaAllocForNode(0) >= 0);
+
+  return 0;
+}
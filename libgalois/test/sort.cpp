@@ -160,6 +160,51 @@ int do_accumulate() {
   return 0;
 }
 
+int do_partial_sum() {
+
+  unsigned M = galois::substrate::getThreadPool().getMaxThreads();
+  std::cout << "partial_sum:\n";
+
+  while (M) {
+    galois::setActiveThreads(M);
+    std::cout << "Using " << M << " threads\n";
+
+    std::vector<uint64_t> V(vectorSize);
+    std::generate(V.begin(), V.end(), RandomNumber);
+
+    std::vector<uint64_t> C(vectorSize);
+    std::vector<uint64_t> G(vectorSize);
+
+    galois::Timer t;
+    t.start();
+    galois::ParallelSTL::partial_sum(V.begin(), V.end(), G.begin());
+    t.stop();
+
+    galois::Timer t2;
+    t2.start();
+    std::partial_sum(V.begin(), V.end(), C.begin());
+    t2.stop();
+
+    bool eq = std::equal(C.begin(), C.end(), G.begin());
+
+    // exclusive scan in place should be the inclusive scan shifted by one
+    galois::ParallelSTL::exclusive_scan(V.begin(), V.end(), V.begin(),
+                                        uint64_t{1});
+    eq = eq && V[0] == 1;
+    for (size_t x = 1; eq && x < V.size(); ++x) {
+      eq = V[x] == C[x - 1] + 1;
+    }
+
+    std::cout << "Galois: " << t.get() << " STL: " << t2.get()
+              << " Equal: " << eq << "\n";
+    if (!eq)
+      return 1;
+    M >>= 1;
+  }
+
+  return 0;
+}
+
 int main(int argc, char** argv) {
   galois::SharedMemSys Galois_runtime;
   if (argc > 1)
@@ -171,5 +216,6 @@ int main(int argc, char** argv) {
   //  ret |= do_sort();
   //  ret |= do_count_if();
   ret |= do_accumulate();
+  ret |= do_partial_sum();
   return ret;
 }
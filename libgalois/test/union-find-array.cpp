@@ -0,0 +1,106 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/UnionFindArray.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+using Edge = std::pair<uint32_t, uint32_t>;
+
+//! Components of the first m edges the slow way, labeled by smallest member
+std::vector<uint32_t> expected(size_t n, const std::vector<Edge>& edges,
+                               size_t m) {
+  std::vector<uint32_t> label(n);
+  for (size_t i = 0; i < n; ++i)
+    label[i] = i;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t i = 0; i < m; ++i) {
+      uint32_t a = label[edges[i].first], b = label[edges[i].second];
+      if (a != b) {
+        label[edges[i].first] = label[edges[i].second] = std::min(a, b);
+        changed                                        = true;
+      }
+    }
+  }
+  return label;
+}
+
+template <galois::PathCompression C>
+void test(size_t n, const std::vector<Edge>& edges, size_t numBatches) {
+  galois::UnionFindArray<C> uf(n);
+  size_t components = n;
+  size_t batchSize  = (edges.size() + numBatches - 1) / numBatches;
+
+  for (size_t begin = 0; begin < edges.size(); begin += batchSize) {
+    size_t end = std::min(begin + batchSize, edges.size());
+    std::vector<Edge> batch(edges.begin() + begin, edges.begin() + end);
+    components -= uf.unite(batch);
+
+    // find is safe between batches without compress
+    std::vector<uint32_t> want = expected(n, edges, end);
+    size_t reps                = 0;
+    for (size_t i = 0; i < n; ++i) {
+      reps += uf.isRep(i);
+      // roots are the smallest members of their sets
+      GALOIS_ASSERT(uf.find(i) == want[i], "wrong root of ", i, " after ", end,
+                    " edges");
+    }
+    GALOIS_ASSERT(reps == components, "counted ", components,
+                  " components but found ", reps);
+  }
+
+  uf.compress();
+  for (size_t i = 0; i < n; ++i)
+    GALOIS_ASSERT(uf.component(i) == uf.findNoCompress(i) &&
+                      uf.same(i, uf.find(i)),
+                  "not compressed: ", i);
+
+  bool wasSame = uf.same(0, 1);
+  bool united  = uf.unite(0, 1);
+  GALOIS_ASSERT(united != wasSame && uf.same(0, 1), "unite of one pair failed");
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(4);
+
+  // sparse random graph, so that there are many components
+  size_t n = 5000;
+  std::mt19937 gen(0);
+  std::vector<Edge> edges;
+  for (size_t i = 0; i < n * 3 / 4; ++i)
+    edges.emplace_back(gen() % n, gen() % n);
+  edges.emplace_back(7, 7);
+  // a long chain to exercise compression
+  for (size_t i = n - 1; i > n - 500; --i)
+    edges.emplace_back(i, i - 1);
+
+  test<galois::PathCompression::None>(n, edges, 4);
+  test<galois::PathCompression::Splitting>(n, edges, 4);
+  test<galois::PathCompression::Halving>(n, edges, 1);
+  test<galois::PathCompression::Full>(n, edges, 7);
+
+  return 0;
+}
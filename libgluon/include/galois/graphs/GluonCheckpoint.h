@@ -0,0 +1,279 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file GluonCheckpoint.h
+ *
+ * Asynchronous checkpointing of the node data of a partitioned graph.
+ */
+
+#ifndef _GALOIS_GLUONCHECKPOINT_H_
+#define _GALOIS_GLUONCHECKPOINT_H_
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "galois/DReducible.h"
+#include "galois/Galois.h"
+#include "galois/graphs/DistributedGraph.h"
+#include "galois/runtime/Network.h"
+
+namespace galois {
+namespace graphs {
+
+/**
+ * Periodically snapshots the node data of every local proxy of a DistGraph
+ * and writes it to disk in the background, so that a run can be restarted
+ * from the last round all hosts saved.
+ *
+ * Each host keeps two snapshot files, dir/ckpt-<host>-{0,1}, and alternates
+ * between them. Saving copies the node data into the buffer of the next file
+ * and returns; the copy is written by a background thread while computation
+ * continues. Before the next save, hosts wait for their writes and agree on
+ * completion with a barrier; only then is the round recorded in
+ * dir/ckpt-<host>.committed. Snapshots and records are synced to disk,
+ * along with the directory entry of their rename, before the barrier and
+ * before the round counts as committed. A committed round therefore has a
+ * durable snapshot on every host, and the other file is the only one ever
+ * being written, so a crash at any point, of a process or of a machine,
+ * leaves the last committed round intact.
+ *
+ * Snapshots must be taken at the end of a round, after the last sync, when
+ * masters and mirrors agree and the sync bitsets are empty; restoring then
+ * needs no communication beyond agreeing on the round. The partition itself
+ * is not part of the snapshot, only its identity, which restoring checks:
+ * restart with the same input, policy and number of hosts, and read the
+ * partition back with readFromFile to skip repartitioning.
+ *
+ * Node data is copied bytewise, so it must not hold pointers.
+ *
+ * @tparam NodeTy node data of the graph
+ * @tparam EdgeTy edge data of the graph
+ */
+template <typename NodeTy, typename EdgeTy>
+class GluonCheckpoint {
+  struct Header {
+    uint64_t round;
+    uint64_t numNodes;
+    uint64_t nodeSize;
+    uint64_t host;
+    //! DistGraph::partitionHash of the partition the snapshot was taken on
+    uint64_t partition;
+  };
+
+  DistGraph<NodeTy, EdgeTy>& graph;
+  std::string dir;
+  unsigned id;
+  uint64_t partition;
+  std::vector<char> buffers[2];
+  unsigned slot = 0;
+  std::thread writer;
+  //! round being written by writer, if any
+  bool pending          = false;
+  uint64_t pendingRound = 0;
+
+  std::string fileName(unsigned s) const {
+    return dir + "/ckpt-" + std::to_string(id) + "-" + std::to_string(s);
+  }
+
+  std::string committedName() const {
+    return dir + "/ckpt-" + std::to_string(id) + ".committed";
+  }
+
+  Header header(uint64_t round) const {
+    return Header{round, graph.size(), sizeof(NodeTy), id, partition};
+  }
+
+  //! Writes data to name through a temporary file so that name is either
+  //! absent, the previous version or complete, and returns once both the data
+  //! and the rename are on disk
+  static void writeFile(const std::string& name, const void* header,
+                        size_t headerSize, const char* data, size_t size) {
+    std::string tmp = name + ".tmp";
+    FILE* f         = fopen(tmp.c_str(), "wb");
+    if (!f)
+      GALOIS_SYS_DIE("unable to open checkpoint file ", tmp);
+    if (fwrite(header, 1, headerSize, f) != headerSize ||
+        (size && fwrite(data, 1, size, f) != size) || fflush(f) != 0 ||
+        fsync(fileno(f)) != 0)
+      GALOIS_SYS_DIE("unable to write checkpoint file ", tmp);
+    if (fclose(f) != 0)
+      GALOIS_SYS_DIE("unable to close checkpoint file ", tmp);
+    if (rename(tmp.c_str(), name.c_str()) != 0)
+      GALOIS_SYS_DIE("unable to rename checkpoint file ", tmp);
+
+    // the rename is only durable once the directory holding it is synced
+    std::string parent = name.substr(0, name.rfind('/'));
+    if (parent.empty())
+      parent = "/";
+    int fd = open(parent.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0 || fsync(fd) != 0)
+      GALOIS_SYS_DIE("unable to sync checkpoint directory ", parent);
+    close(fd);
+  }
+
+  //! Waits for the background write, which syncs the snapshot, then records
+  //! its round as committed once every host has finished its own
+  void commit() {
+    if (writer.joinable())
+      writer.join();
+    galois::runtime::getHostBarrier().wait();
+    if (pending) {
+      writeFile(committedName(), &pendingRound, sizeof(pendingRound), nullptr,
+                0);
+      pending = false;
+    }
+  }
+
+  //! Reads the snapshot of round from file s into the graph
+  bool load(unsigned s, uint64_t round) {
+    FILE* f = fopen(fileName(s).c_str(), "rb");
+    if (!f)
+      return false;
+    Header h, expected = header(round);
+    bool ok = fread(&h, sizeof(h), 1, f) == 1 && h.round == expected.round &&
+              h.nodeSize == expected.nodeSize && h.host == expected.host;
+    if (ok && (h.numNodes != expected.numNodes ||
+               h.partition != expected.partition))
+      GALOIS_DIE("checkpoint ", fileName(s), " of round ", round,
+                 " was taken on another partition; restart with the same "
+                 "input, partitioning policy and number of hosts");
+    if (ok) {
+      std::vector<char>& buffer = buffers[s];
+      buffer.resize(h.numNodes * sizeof(NodeTy));
+      ok = fread(buffer.data(), 1, buffer.size(), f) == buffer.size();
+      if (ok)
+        galois::do_all(
+            galois::iterate(graph.allNodesRange()),
+            [&](uint32_t n) {
+              memcpy(static_cast<void*>(&graph.getData(n)),
+                     &buffer[n * sizeof(NodeTy)], sizeof(NodeTy));
+            },
+            galois::no_stats(), galois::loopname("CheckpointRestore"));
+    }
+    fclose(f);
+    return ok;
+  }
+
+public:
+  /**
+   * @param _graph graph whose node data is checkpointed
+   * @param _dir existing directory to keep the snapshots in, shared by all
+   * hosts or local to each
+   */
+  GluonCheckpoint(DistGraph<NodeTy, EdgeTy>& _graph, std::string _dir)
+      : graph(_graph), dir(std::move(_dir)),
+        id(galois::runtime::getSystemNetworkInterface().ID),
+        partition(graph.partitionHash()) {}
+
+  GluonCheckpoint(const GluonCheckpoint&) = delete;
+  GluonCheckpoint& operator=(const GluonCheckpoint&) = delete;
+
+  ~GluonCheckpoint() {
+    if (writer.joinable())
+      writer.join();
+  }
+
+  /**
+   * Snapshots the node data as of the end of round and starts writing it.
+   * Commits the previous snapshot first, which waits for its write. All
+   * hosts must call this collectively.
+   */
+  void save(uint64_t round) {
+    galois::StatTimer timer("CheckpointSaveTime", "Gluon");
+    timer.start();
+    commit();
+
+    std::vector<char>& buffer = buffers[slot];
+    buffer.resize(graph.size() * sizeof(NodeTy));
+    galois::do_all(
+        galois::iterate(graph.allNodesRange()),
+        [&](uint32_t n) {
+          memcpy(&buffer[n * sizeof(NodeTy)],
+                 static_cast<const void*>(&graph.getData(n)), sizeof(NodeTy));
+        },
+        galois::no_stats(), galois::loopname("CheckpointSnapshot"));
+
+    Header h     = header(round);
+    pending      = true;
+    pendingRound = round;
+    writer = std::thread([this, h, s = slot] {
+      writeFile(fileName(s), &h, sizeof(h), buffers[s].data(),
+                buffers[s].size());
+    });
+    slot ^= 1;
+    timer.stop();
+  }
+
+  /**
+   * Waits for the last snapshot and commits it. All hosts must call this
+   * collectively.
+   */
+  void finish() { commit(); }
+
+  /**
+   * Loads the last round committed by any host into the node data. All hosts
+   * must call this collectively, after initializing the node data.
+   *
+   * @param round set to the restored round
+   * @returns false, leaving the node data alone, if nothing was committed
+   */
+  bool restore(uint64_t& round) {
+    galois::StatTimer timer("CheckpointRestoreTime", "Gluon");
+    timer.start();
+    // a host may have died between the barrier and recording the last round,
+    // but all hosts finished writing it, so the latest record is valid
+    uint64_t committed = 0;
+    if (FILE* f = fopen(committedName().c_str(), "rb")) {
+      if (fread(&committed, sizeof(committed), 1, f) == 1)
+        committed += 1;
+      fclose(f);
+    }
+    galois::DGReduceMax<uint64_t> latest;
+    latest.update(committed);
+    committed = latest.reduce();
+
+    bool found = committed != 0;
+    if (found) {
+      round = committed - 1;
+      if (load(0, round)) {
+        slot = 1;
+      } else if (load(1, round)) {
+        slot = 0;
+      } else {
+        GALOIS_DIE("no checkpoint of round ", round, " for host ", id, " in ",
+                   dir);
+      }
+    }
+    galois::runtime::getHostBarrier().wait();
+    timer.stop();
+    return found;
+  }
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
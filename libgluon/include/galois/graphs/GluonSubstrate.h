@@ -33,7 +33,9 @@
 #include "galois/runtime/DistStats.h"
 #include "galois/runtime/SyncStructures.h"
 #include "galois/runtime/DataCommMode.h"
+#include "galois/runtime/CompactOffsets.h"
 #include "galois/DynamicBitset.h"
+#include "galois/VarintCodec.h"
 
 #ifdef GALOIS_ENABLE_GPU
 #include "galois/cuda/HostDecls.h"
@@ -99,6 +101,8 @@ private:
   std::pair<unsigned, unsigned> cartesianGrid; //!< cartesian grid (if any)
   bool partitionAgnostic; //!< true if communication should ignore partitioning
   DataCommMode substrateDataMode; //!< datamode to enforce
+  //! True if integer values may be varint-encoded in compact data modes
+  bool compressValues;
   const uint32_t
       numHosts;     //!< Copy of net.Num, which is the total number of machines
   uint32_t num_run; //!< Keep track of number of runs.
@@ -129,6 +133,8 @@ private:
   // Used for efficient comms
   galois::DynamicBitSet syncBitset;
   galois::PODResizeableArray<unsigned int> syncOffsets;
+  //! Encoded metadata (or values) of rleBitsetData and deltaOffsetsData
+  galois::PODResizeableArray<uint8_t> syncCompact;
 
   /**
    * Reset a provided bitset given the type of synchronization performed
@@ -419,16 +425,20 @@ public:
    * @param _partitionAgnostic determines if sync should be partition agnostic
    * or not
    * @param _enforcedDataMode Forced data comm mode for sync
+   * @param _compressValues True if integer values sent with compact metadata
+   * should be varint-encoded whenever that makes the message smaller
    */
   GluonSubstrate(
       GraphTy& _userGraph, unsigned host, unsigned numHosts, bool _transposed,
       std::pair<unsigned, unsigned> _cartesianGrid = std::make_pair(0u, 0u),
       bool _partitionAgnostic                      = false,
-      DataCommMode _enforcedDataMode               = DataCommMode::noData)
+      DataCommMode _enforcedDataMode               = DataCommMode::noData,
+      bool _compressValues                         = false)
       : galois::runtime::GlobalObject(this), userGraph(_userGraph), id(host),
         transposed(_transposed), isVertexCut(userGraph.is_vertex_cut()),
         cartesianGrid(_cartesianGrid), partitionAgnostic(_partitionAgnostic),
-        substrateDataMode(_enforcedDataMode), numHosts(numHosts), num_run(0),
+        substrateDataMode(_enforcedDataMode), compressValues(_compressValues),
+        numHosts(numHosts), num_run(0),
         num_round(0), currentBVFlag(nullptr),
         mirrorNodes(userGraph.getMirrorNodes()) {
     if (cartesianGrid.first != 0 && cartesianGrid.second != 0) {
@@ -490,72 +500,9 @@ private:
 
     Toffsets.start();
 
-    auto activeThreads = galois::getActiveThreads();
-    std::vector<unsigned int> t_prefix_bit_counts(activeThreads);
-
-    // count how many bits are set on each thread
-    galois::on_each([&](unsigned tid, unsigned nthreads) {
-      // TODO use block_range instead
-      unsigned int block_size = bitset_comm.size() / nthreads;
-      if ((bitset_comm.size() % nthreads) > 0)
-        ++block_size;
-      assert((block_size * nthreads) >= bitset_comm.size());
-
-      unsigned int start = tid * block_size;
-      unsigned int end   = (tid + 1) * block_size;
-      if (end > bitset_comm.size())
-        end = bitset_comm.size();
-
-      unsigned int count = 0;
-      for (unsigned int i = start; i < end; ++i) {
-        if (bitset_comm.test(i))
-          ++count;
-      }
-
-      t_prefix_bit_counts[tid] = count;
-    });
+    bitset_comm.getOffsets(offsets);
+    bit_set_count = offsets.size();
 
-    // calculate prefix sum of bits per thread
-    for (unsigned int i = 1; i < activeThreads; ++i) {
-      t_prefix_bit_counts[i] += t_prefix_bit_counts[i - 1];
-    }
-    // total num of set bits
-    bit_set_count = t_prefix_bit_counts[activeThreads - 1];
-
-    // calculate the indices of the set bits and save them to the offset
-    // vector
-    if (bit_set_count > 0) {
-      offsets.resize(bit_set_count);
-      galois::on_each([&](unsigned tid, unsigned nthreads) {
-        // TODO use block_range instead
-        // TODO this is same calculation as above; maybe refactor it
-        // into function?
-        unsigned int block_size = bitset_comm.size() / nthreads;
-        if ((bitset_comm.size() % nthreads) > 0)
-          ++block_size;
-        assert((block_size * nthreads) >= bitset_comm.size());
-
-        unsigned int start = tid * block_size;
-        unsigned int end   = (tid + 1) * block_size;
-        if (end > bitset_comm.size())
-          end = bitset_comm.size();
-
-        unsigned int count = 0;
-        unsigned int t_prefix_bit_count;
-        if (tid == 0) {
-          t_prefix_bit_count = 0;
-        } else {
-          t_prefix_bit_count = t_prefix_bit_counts[tid - 1];
-        }
-
-        for (unsigned int i = start; i < end; ++i) {
-          if (bitset_comm.test(i)) {
-            offsets[t_prefix_bit_count + count] = i;
-            ++count;
-          }
-        }
-      });
-    }
     Toffsets.stop();
   }
 
@@ -760,6 +707,215 @@ private:
     galois::runtime::reportStat_Tsum(RNAME, statSendBytes_str, b.size());
   }
 
+  //! True if values of VecType can be varint-encoded
+  template <typename VecType>
+  static constexpr bool isCompressible() {
+    typedef typename VecType::value_type ValTy;
+    return std::is_integral<ValTy>::value && sizeof(ValTy) > 1;
+  }
+
+  //! Maps an integer value to the unsigned value that is varint-encoded
+  template <typename ValTy>
+  static uint64_t valueToVarint(ValTy v) {
+    if (std::is_signed<ValTy>::value) {
+      return galois::VarintCodec::zigzag(static_cast<int64_t>(v));
+    }
+    return static_cast<uint64_t>(v);
+  }
+
+  //! Inverse of valueToVarint
+  template <typename ValTy>
+  static ValTy varintToValue(uint64_t v) {
+    if (std::is_signed<ValTy>::value) {
+      return static_cast<ValTy>(galois::VarintCodec::unzigzag(v));
+    }
+    return static_cast<ValTy>(v);
+  }
+
+  /**
+   * Returns the number of bytes val_vec takes if varint-encoded, or the
+   * number of bytes it takes as is if it cannot be encoded.
+   */
+  template <typename VecType>
+  size_t encodedValuesSize(const VecType& val_vec) const {
+    typedef typename VecType::value_type ValTy;
+    size_t rawSize = val_vec.size() * sizeof(ValTy);
+    if constexpr (isCompressible<VecType>()) {
+      if (compressValues) {
+        galois::GAccumulator<size_t> encodedSize;
+        galois::do_all(
+            galois::iterate(size_t{0}, val_vec.size()),
+            [&](size_t n) {
+              encodedSize +=
+                  galois::VarintCodec::size(valueToVarint(val_vec[n]));
+            },
+            galois::no_stats());
+        return encodedSize.reduce();
+      }
+    }
+    return rawSize;
+  }
+
+  /**
+   * Picks the data mode of a message get_data_mode assigned bitsetData or
+   * offsetsData, from the actual sizes of every encoding of its metadata and
+   * values. Frontiers are often clustered in the local id space, which makes
+   * run lengths and gaps between offsets much smaller than the bitset or the
+   * offsets themselves.
+   *
+   * @param data_mode INPUT/OUTPUT: bitsetData or offsetsData; set to the mode
+   * to send the message in
+   * @param num number of elements the bitset covers
+   * @param offsets sorted offsets of the elements to send
+   * @param val_vec values to send
+   * @param encodeValues OUTPUT: true if values should be varint-encoded; only
+   * meaningful for the compact modes
+   *
+   * @returns number of bytes the chosen mode saves over data_mode
+   */
+  template <typename VecType>
+  size_t
+  selectCompactMode(DataCommMode& data_mode, size_t num,
+                    const galois::PODResizeableArray<unsigned int>& offsets,
+                    const VecType& val_vec, bool& encodeValues) const {
+#ifdef GALOIS_ENABLE_GPU
+    // GPU hosts only decode the original modes
+    (void)num;
+    (void)offsets;
+    (void)val_vec;
+    (void)encodeValues;
+    return 0;
+#else
+    typedef typename VecType::value_type ValTy;
+    if (enforcedDataMode != noData) {
+      return 0;
+    }
+
+    size_t rleSize, deltaSize;
+    galois::runtime::compact_offsets_size(offsets, rleSize, deltaSize);
+
+    // compact modes carry their metadata as a byte vector and a flag byte
+    // for the encoding of the values
+    auto metadataSize = [&](DataCommMode mode) -> size_t {
+      switch (mode) {
+      case bitsetData:
+        return ((num + 63) / 64) * sizeof(uint64_t) + 2 * sizeof(size_t);
+      case offsetsData:
+        return offsets.size() * sizeof(unsigned int) + sizeof(size_t);
+      case rleBitsetData:
+        return rleSize + sizeof(size_t) + sizeof(bool);
+      default:
+        return deltaSize + sizeof(size_t) + sizeof(bool);
+      }
+    };
+
+    DataCommMode original = data_mode;
+    size_t rawValues      = val_vec.size() * sizeof(ValTy);
+    size_t encodedValues  = encodedValuesSize(val_vec);
+    size_t originalSize   = metadataSize(original) + rawValues;
+
+    data_mode = get_compact_data_mode(data_mode, offsets.size(), num,
+                                      metadataSize(rleBitsetData),
+                                      metadataSize(deltaOffsetsData));
+    if (data_mode != rleBitsetData && data_mode != deltaOffsetsData &&
+        encodedValues < rawValues) {
+      // metadata alone does not pay off, but it may with encoded values
+      data_mode = (rleSize <= deltaSize) ? rleBitsetData : deltaOffsetsData;
+    }
+    if (data_mode != rleBitsetData && data_mode != deltaOffsetsData) {
+      return 0;
+    }
+
+    encodeValues = encodedValues < rawValues;
+    size_t compactSize =
+        metadataSize(data_mode) + (encodeValues ? encodedValues : rawValues);
+    if (compactSize >= originalSize) {
+      data_mode = original;
+      return 0;
+    }
+    return originalSize - compactSize;
+#endif
+  }
+
+  /**
+   * Serializes a message in rleBitsetData or deltaOffsetsData mode: the
+   * varint-encoded metadata followed by either the values as is or the
+   * values varint-encoded.
+   *
+   * @param data_mode rleBitsetData or deltaOffsetsData
+   * @param offsets sorted offsets of the elements to send
+   * @param encodeValues true if values should be varint-encoded
+   * @param val_vec values to send
+   * @param b buffer to serialize into
+   */
+  template <typename VecType>
+  void serializeCompact(DataCommMode data_mode,
+                        const galois::PODResizeableArray<unsigned int>& offsets,
+                        bool encodeValues, const VecType& val_vec,
+                        galois::runtime::SendBuffer& b) {
+    size_t count = offsets.size();
+    // a varint of an unsigned int takes at most 5 bytes; rle has at most 2
+    // varints per offset
+    syncCompact.resize(2 * 5 * count);
+    uint8_t* out = galois::runtime::encode_compact_offsets(data_mode, offsets,
+                                                           syncCompact.data());
+    syncCompact.resize(out - syncCompact.data());
+    gSerialize(b, data_mode, count, syncCompact, encodeValues);
+
+    if constexpr (isCompressible<VecType>()) {
+      if (encodeValues) {
+        syncCompact.resize(10 * count);
+        out = syncCompact.data();
+        for (size_t i = 0; i < count; ++i) {
+          out = galois::VarintCodec::encode(valueToVarint(val_vec[i]), out);
+        }
+        syncCompact.resize(out - syncCompact.data());
+        gSerialize(b, syncCompact);
+        return;
+      }
+    }
+    gSerialize(b, val_vec);
+  }
+
+  /**
+   * Deserializes the rest of a message sent by serializeCompact: the offsets
+   * of the received elements and their values.
+   *
+   * @param data_mode rleBitsetData or deltaOffsetsData
+   * @param bit_set_count number of elements in the message
+   * @param buf buffer to deserialize from
+   * @param offsets OUTPUT: offsets of the received elements
+   * @param val_vec OUTPUT: values of the received elements
+   */
+  template <typename VecType>
+  void deserializeCompact(DataCommMode data_mode, size_t bit_set_count,
+                          galois::runtime::RecvBuffer& buf,
+                          galois::PODResizeableArray<unsigned int>& offsets,
+                          VecType& val_vec) {
+    bool encodedValues;
+    galois::runtime::gDeserialize(buf, syncCompact, encodedValues);
+
+    offsets.resize(bit_set_count);
+    galois::runtime::decode_compact_offsets(data_mode, syncCompact.data(),
+                                            bit_set_count, offsets);
+
+    if constexpr (isCompressible<VecType>()) {
+      if (encodedValues) {
+        typedef typename VecType::value_type ValTy;
+        galois::runtime::gDeserialize(buf, syncCompact);
+        val_vec.resize(bit_set_count);
+        const uint8_t* in = syncCompact.data();
+        uint64_t v;
+        for (size_t i = 0; i < bit_set_count; ++i) {
+          in         = galois::VarintCodec::decode(in, v);
+          val_vec[i] = varintToValue<ValTy>(v);
+        }
+        return;
+      }
+    }
+    galois::runtime::gDeserialize(buf, val_vec);
+  }
+
   /**
    * Given data to serialize in val_vec, serialize it into the send buffer
    * depending on the mode of data communication selected for the data.
@@ -778,7 +934,7 @@ private:
    * to
    */
   template <bool async, SyncType syncType, typename VecType>
-  void serializeMessage(std::string loopName, DataCommMode data_mode,
+  void serializeMessage(std::string loopName, DataCommMode& data_mode,
                         size_t bit_set_count, std::vector<size_t>& indices,
                         galois::PODResizeableArray<unsigned int>& offsets,
                         galois::DynamicBitSet& bit_set_comm, VecType& val_vec,
@@ -801,17 +957,29 @@ private:
       Tserialize.start();
       gSerialize(b, data_mode, bit_set_count, offsets, val_vec);
       Tserialize.stop();
-    } else if (data_mode == offsetsData) {
+    } else if (data_mode == offsetsData || data_mode == bitsetData) {
       offsets.resize(bit_set_count);
       val_vec.resize(bit_set_count);
       Tserialize.start();
-      gSerialize(b, data_mode, bit_set_count, offsets, val_vec);
-      Tserialize.stop();
-    } else if (data_mode == bitsetData) {
-      val_vec.resize(bit_set_count);
-      Tserialize.start();
-      gSerialize(b, data_mode, bit_set_count, bit_set_comm, val_vec);
+      bool encodeValues = false;
+      size_t savedBytes =
+          selectCompactMode(data_mode, indices.size(), offsets, val_vec,
+                            encodeValues);
+      if (data_mode == offsetsData) {
+        gSerialize(b, data_mode, bit_set_count, offsets, val_vec);
+      } else if (data_mode == bitsetData) {
+        gSerialize(b, data_mode, bit_set_count, bit_set_comm, val_vec);
+      } else { // rleBitsetData or deltaOffsetsData
+        serializeCompact(data_mode, offsets, encodeValues, val_vec, b);
+      }
       Tserialize.stop();
+
+      if (savedBytes > 0) {
+        std::string statSavedBytes_str(syncTypeStr + "CompactSavedBytes_" +
+                                       get_run_identifier(loopName));
+        galois::runtime::reportStat_Tsum(RNAME, statSavedBytes_str,
+                                         savedBytes);
+      }
     } else { // onlyData
       Tserialize.start();
       gSerialize(b, data_mode, val_vec);
@@ -873,6 +1041,12 @@ private:
         galois::runtime::gDeserialize(buf, buf_start);
       } else if (data_mode == dataSplitFirst) {
         galois::runtime::gDeserialize(buf, retval);
+      } else if (data_mode == rleBitsetData ||
+                 data_mode == deltaOffsetsData) {
+        // metadata and data are both encoded
+        deserializeCompact(data_mode, bit_set_count, buf, offsets, val_vec);
+        Tdeserialize.stop();
+        return;
       }
     }
 
@@ -2283,7 +2457,7 @@ private:
             setSubset<decltype(offsets), SyncFnTy, syncType, VecTy, async, true,
                       true>(loopName, offsets, bit_set_count, offsets, val_vec,
                             bit_set_compute);
-          } else { // bitsetData or offsetsData
+          } else { // bitsetData, offsetsData or the compact modes
             setSubset<decltype(sharedNodes[from_id]), SyncFnTy, syncType, VecTy,
                       async, false, true>(loopName, sharedNodes[from_id],
                                           bit_set_count, offsets, val_vec,
@@ -2383,7 +2557,7 @@ private:
             setSubset<decltype(offsets), SyncFnTy, syncType, VecTy, async, true,
                       true, true>(loopName, offsets, bit_set_count, offsets,
                                   val_vec, bit_set_compute, i);
-          } else { // bitsetData or offsetsData
+          } else { // bitsetData, offsetsData or the compact modes
             setSubset<decltype(sharedNodes[from_id]), SyncFnTy, syncType, VecTy,
                       async, false, true, true>(loopName, sharedNodes[from_id],
                                                 bit_set_count, offsets, val_vec,
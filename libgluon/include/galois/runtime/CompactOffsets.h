@@ -0,0 +1,160 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file CompactOffsets.h
+ *
+ * Encoding of the offsets of a message in the compact data comm modes,
+ * rleBitsetData and deltaOffsetsData.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+#include "galois/VarintCodec.h"
+#include "galois/runtime/DataCommMode.h"
+
+namespace galois {
+namespace runtime {
+
+/**
+ * Computes the bytes sorted offsets take in both compact modes, without the
+ * framing of the byte vector they are sent in.
+ *
+ * rleBitsetData sends the runs of the bitset, alternating clear and set
+ * runs and starting with a clear one; deltaOffsetsData sends the gap before
+ * every offset. The clear runs are exactly the non-zero gaps.
+ *
+ * Offsets are sized in parallel: the last offset of each set run finds the
+ * start of its run by binary search, since offsets[i] - offsets[j] == i - j
+ * exactly for the j in the same run as i.
+ *
+ * @param offsets sorted offsets of the elements to send
+ * @param rle_size OUTPUT: bytes of the offsets in rleBitsetData
+ * @param delta_size OUTPUT: bytes of the offsets in deltaOffsetsData
+ */
+template <typename OffsetVec>
+void compact_offsets_size(const OffsetVec& offsets, size_t& rle_size,
+                          size_t& delta_size) {
+  size_t count = offsets.size();
+  galois::GAccumulator<size_t> rle, delta;
+  galois::do_all(
+      galois::iterate(size_t{0}, count),
+      [&](size_t i) {
+        uint64_t gap = (i == 0) ? offsets[0] : offsets[i] - offsets[i - 1] - 1;
+        delta += galois::VarintCodec::size(gap);
+        if (i == 0 || gap != 0) {
+          rle += galois::VarintCodec::size(gap);
+        }
+        if (i + 1 == count || offsets[i + 1] != offsets[i] + 1) {
+          size_t first = 0, last = i;
+          while (first < last) {
+            size_t mid = first + (last - first) / 2;
+            if (uint64_t(offsets[i]) - offsets[mid] == i - mid) {
+              last = mid;
+            } else {
+              first = mid + 1;
+            }
+          }
+          rle += galois::VarintCodec::size(i + 1 - first);
+        }
+      },
+      galois::no_stats());
+  rle_size   = rle.reduce();
+  delta_size = delta.reduce();
+}
+
+/**
+ * Encodes sorted offsets in a compact mode.
+ *
+ * @param data_mode rleBitsetData or deltaOffsetsData
+ * @param offsets sorted offsets of the elements to send
+ * @param out buffer with room for 10 bytes per offset
+ * @returns end of the encoded offsets in out
+ */
+template <typename OffsetVec>
+uint8_t* encode_compact_offsets(DataCommMode data_mode,
+                                const OffsetVec& offsets, uint8_t* out) {
+  size_t count = offsets.size();
+  if (data_mode == deltaOffsetsData) {
+    for (size_t i = 0; i < count; ++i) {
+      uint64_t gap = (i == 0) ? offsets[0] : offsets[i] - offsets[i - 1] - 1;
+      out          = galois::VarintCodec::encode(gap, out);
+    }
+    return out;
+  }
+  uint64_t runStart = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t gap = (i == 0) ? offsets[0] : offsets[i] - offsets[i - 1] - 1;
+    if (i == 0 || gap != 0) {
+      if (i != 0) {
+        uint64_t last = offsets[i - 1];
+        out           = galois::VarintCodec::encode(last + 1 - runStart, out);
+      }
+      out      = galois::VarintCodec::encode(gap, out);
+      runStart = offsets[i];
+    }
+  }
+  if (count > 0) {
+    uint64_t last = offsets[count - 1];
+    out           = galois::VarintCodec::encode(last + 1 - runStart, out);
+  }
+  return out;
+}
+
+/**
+ * Decodes offsets encoded by encode_compact_offsets.
+ *
+ * @param data_mode mode the offsets were encoded in
+ * @param in encoded offsets
+ * @param count number of offsets
+ * @param offsets OUTPUT: the count offsets; must have room for them
+ * @returns end of the encoded offsets in in
+ */
+template <typename OffsetVec>
+const uint8_t* decode_compact_offsets(DataCommMode data_mode,
+                                      const uint8_t* in, size_t count,
+                                      OffsetVec& offsets) {
+  uint64_t v;
+  if (data_mode == deltaOffsetsData) {
+    uint64_t prev = 0;
+    for (size_t i = 0; i < count; ++i) {
+      in         = galois::VarintCodec::decode(in, v);
+      prev       = (i == 0) ? v : prev + 1 + v;
+      offsets[i] = prev;
+    }
+    return in;
+  }
+  uint64_t next = 0;
+  for (size_t i = 0; i < count;) {
+    in = galois::VarintCodec::decode(in, v);
+    next += v;
+    in = galois::VarintCodec::decode(in, v);
+    for (uint64_t j = 0; j < v; ++j) {
+      offsets[i++] = next++;
+    }
+  }
+  return in;
+}
+
+} // namespace runtime
+} // namespace galois
@@ -28,16 +28,25 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
 //! Enumeration of data communication modes that can be used in synchronization
-//! @todo document the enums in doxygen
 enum DataCommMode {
-  noData, //!< send no data
-  bitsetData,
-  offsetsData,
-  gidsData,
-  onlyData,
+  noData,         //!< send no data
+  bitsetData,     //!< send a bitset of the updated elements and their data
+  offsetsData,    //!< send offsets of the updated elements and their data
+  gidsData,       //!< send global ids of the updated elements and their data
+  onlyData,       //!< send data of all elements
   dataSplitFirst, // NOT USED
-  dataSplit       // NOT USED
+  dataSplit,      // NOT USED
+  //! send run lengths of the bitset as varints and the data; only chosen in
+  //! auto mode by GluonSubstrate
+  rleBitsetData,
+  //! send gaps between offsets as varints and the data; only chosen in auto
+  //! mode by GluonSubstrate
+  deltaOffsetsData
 };
 
 //! If some mode is to be enforced, set this variable
@@ -86,3 +95,42 @@ DataCommMode get_data_mode(size_t num_selected, size_t num_total) {
   }
   return data_mode;
 }
+
+/**
+ * Refines a bitsetData or offsetsData mode picked by get_data_mode using the
+ * actual encoded sizes of the metadata of a message. The size formula of
+ * get_data_mode only depends on the number of updates, so it cannot see that
+ * updates are clustered; this one can.
+ *
+ * @param data_mode mode picked by get_data_mode
+ * @param num_selected number of elements to send out (subset of num_total)
+ * @param num_total total number of elements that exist
+ * @param rle_size bytes of the metadata of rleBitsetData as sent, i.e., the
+ * run-length encoded bitset with its framing
+ * @param delta_size bytes of the metadata of deltaOffsetsData as sent
+ *
+ * @returns the mode with the smallest metadata
+ */
+inline DataCommMode get_compact_data_mode(DataCommMode data_mode,
+                                          size_t num_selected,
+                                          size_t num_total, size_t rle_size,
+                                          size_t delta_size) {
+  if (enforcedDataMode != noData ||
+      (data_mode != bitsetData && data_mode != offsetsData)) {
+    return data_mode;
+  }
+  size_t bitsetSize =
+      ((num_total + 63) / 64) * sizeof(uint64_t) + (2 * sizeof(size_t));
+  size_t offsetsSize = num_selected * sizeof(unsigned int) + sizeof(size_t);
+
+  size_t best = std::min(bitsetSize, offsetsSize);
+  data_mode   = (bitsetSize <= offsetsSize) ? bitsetData : offsetsData;
+  if (delta_size < best) {
+    best      = delta_size;
+    data_mode = deltaOffsetsData;
+  }
+  if (rle_size < best) {
+    data_mode = rleBitsetData;
+  }
+  return data_mode;
+}
@@ -0,0 +1,94 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/runtime/CompactOffsets.h"
+#include "galois/runtime/DataCommMode.h"
+#include "galois/gIO.h"
+
+#include <vector>
+
+// defined by the Gluon library, which only the header is tested from
+DataCommMode enforcedDataMode = noData;
+
+//! Encodes offsets in both compact modes and decodes them back
+void roundTrip(const std::vector<unsigned int>& offsets) {
+  size_t rleSize, deltaSize;
+  galois::runtime::compact_offsets_size(offsets, rleSize, deltaSize);
+
+  for (DataCommMode mode : {rleBitsetData, deltaOffsetsData}) {
+    std::vector<uint8_t> buffer(10 * offsets.size() + 1);
+    uint8_t* end =
+        galois::runtime::encode_compact_offsets(mode, offsets, buffer.data());
+    size_t size = end - buffer.data();
+    GALOIS_ASSERT(size == (mode == rleBitsetData ? rleSize : deltaSize),
+                  "encoded size matches compact_offsets_size");
+
+    std::vector<unsigned int> decoded(offsets.size());
+    const uint8_t* in = galois::runtime::decode_compact_offsets(
+        mode, buffer.data(), offsets.size(), decoded);
+    GALOIS_ASSERT(in == end, "decoding consumes the encoding");
+    GALOIS_ASSERT(decoded == offsets, "decoded offsets");
+  }
+}
+
+int main() {
+  galois::SharedMemSys G;
+  galois::setActiveThreads(4);
+
+  roundTrip({});
+  roundTrip({0});
+  roundTrip({7});
+  roundTrip({0, 1, 2, 3});
+  roundTrip({5, 6, 7, 100, 101, 4000, 1u << 20, (1u << 20) + 1});
+  roundTrip({~0u - 1, ~0u});
+
+  std::vector<unsigned int> clustered, scattered;
+  for (unsigned int i = 0; i < 100000; ++i) {
+    if (i % 1000 < 200)
+      clustered.push_back(i);
+    if (i % 37 == 0)
+      scattered.push_back(i);
+  }
+  roundTrip(clustered);
+  roundTrip(scattered);
+
+  // runs are cheaper than the gaps of every offset of a run
+  size_t rleSize, deltaSize;
+  galois::runtime::compact_offsets_size(clustered, rleSize, deltaSize);
+  GALOIS_ASSERT(rleSize < deltaSize, "rle is smaller on clustered offsets");
+  galois::runtime::compact_offsets_size(scattered, rleSize, deltaSize);
+  GALOIS_ASSERT(deltaSize < rleSize, "delta is smaller on scattered offsets");
+
+  // sizes are compared as given: 1000 offsets take 4008 bytes, bitsets of
+  // 10^6 elements 125016
+  GALOIS_ASSERT(get_compact_data_mode(offsetsData, 1000, 1000000, 4007, 5000) ==
+                    rleBitsetData,
+                "rle metadata one byte smaller than offsets");
+  GALOIS_ASSERT(get_compact_data_mode(offsetsData, 1000, 1000000, 5000, 4007) ==
+                    deltaOffsetsData,
+                "delta metadata one byte smaller than offsets");
+  GALOIS_ASSERT(get_compact_data_mode(offsetsData, 1000, 1000000, 4008, 4008) ==
+                    offsetsData,
+                "ties keep the original mode");
+  GALOIS_ASSERT(get_compact_data_mode(onlyData, 1000, 1000, 1, 1) == onlyData,
+                "only bitset and offsets modes are refined");
+
+  return 0;
+}
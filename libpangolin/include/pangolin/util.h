@@ -4,6 +4,7 @@
 #include "pangolin/scan.h"
 #include "pangolin/mgraph.h"
 #include "pangolin/res_man.h"
+#include "galois/graphs/GraphCache.h"
 
 namespace util {
 
@@ -76,68 +77,6 @@ void DegreeRanking(PangolinGraph& og, PangolinGraph& g) {
   g.sortAllEdgesByDst();
 }
 
-unsigned orientation(PangolinGraph& og, PangolinGraph& g) {
-  galois::StatTimer Tdag("DAG");
-  Tdag.start();
-  // std::cout << "Orientation enabled, using DAG\n";
-  // std::cout << "Assume the input graph is clean and symmetric (.csgr)\n";
-  // std::cout << "Before: num_vertices " << og.size() << " num_edges "
-  //          << og.sizeEdges() << "\n";
-  std::vector<IndexT> degrees(og.size(), 0);
-
-  galois::do_all(
-      galois::iterate(og.begin(), og.end()),
-      [&](const auto& src) {
-        degrees[src] = std::distance(og.edge_begin(src), og.edge_end(src));
-      },
-      galois::loopname("getOldDegrees"));
-
-  unsigned max_degree = *(std::max_element(degrees.begin(), degrees.end()));
-  std::vector<IndexT> new_degrees(og.size(), 0);
-
-  galois::do_all(
-      galois::iterate(og.begin(), og.end()),
-      [&](const auto& src) {
-        for (auto e : og.edges(src)) {
-          auto dst = og.getEdgeDst(e);
-          if (degrees[dst] > degrees[src] ||
-              (degrees[dst] == degrees[src] && dst > src)) {
-            new_degrees[src]++;
-          }
-        }
-      },
-      galois::loopname("getNewDegrees"));
-
-  std::vector<IndexT> offsets = PrefixSum(new_degrees);
-  assert(offsets[og.size()] == og.sizeEdges() / 2);
-
-  g.allocateFrom(og.size(), og.sizeEdges() / 2);
-  g.constructNodes();
-
-  galois::do_all(
-      galois::iterate(og.begin(), og.end()),
-      [&](const auto& src) {
-        g.getData(src) = 0;
-        auto row_begin = offsets[src];
-        g.fixEndEdge(src, row_begin + new_degrees[src]);
-        IndexT offset = 0;
-        for (auto e : og.edges(src)) {
-          auto dst = og.getEdgeDst(e);
-          if (degrees[dst] > degrees[src] ||
-              (degrees[dst] == degrees[src] && dst > src)) {
-            g.constructEdge(row_begin + offset, dst, 0);
-            offset++;
-          }
-        }
-        assert(offset == new_degrees[src]);
-      },
-      galois::loopname("ConstructNewGraph"));
-
-  g.sortAllEdgesByDst();
-  Tdag.stop();
-  return max_degree;
-}
-
 // relabel is needed when we use DAG as input graph, and it is disabled when we
 // use symmetrized graph
 unsigned read_graph(PangolinGraph& graph, std::string filetype,
@@ -159,9 +98,16 @@ unsigned read_graph(PangolinGraph& graph, std::string filetype,
   } else if (filetype == "gr") {
     // printf("Reading .gr file: %s\n", filename.c_str());
     if (need_dag) {
-      PangolinGraph g_temp;
-      galois::graphs::readGraph(g_temp, filename);
-      max_degree = orientation(g_temp, graph);
+      galois::StatTimer Tdag("DAG");
+      Tdag.start();
+      galois::graphs::readGraphCached(graph, filename,
+                                      galois::graphs::OrientByDegree |
+                                          galois::graphs::SortByDst);
+      galois::do_all(
+          galois::iterate(graph.begin(), graph.end()),
+          [&](const auto& vid) { graph.getData(vid) = 0; },
+          galois::loopname("assignVertexLabels"));
+      Tdag.stop();
     } else {
       galois::graphs::readGraph(graph, filename);
       galois::do_all(
@@ -171,16 +117,16 @@ unsigned read_graph(PangolinGraph& graph, std::string filetype,
             // for (auto e : graph.edges(n)) graph.getEdgeData(e) = 1;
           },
           galois::loopname("assignVertexLabels"));
-      std::vector<unsigned> degrees(graph.size());
-      galois::do_all(
-          galois::iterate(graph.begin(), graph.end()),
-          [&](const auto& vid) {
-            degrees[vid] =
-                std::distance(graph.edge_begin(vid), graph.edge_end(vid));
-          },
-          galois::loopname("computeMaxDegree"));
-      max_degree = *(std::max_element(degrees.begin(), degrees.end()));
     }
+    std::vector<unsigned> degrees(graph.size());
+    galois::do_all(
+        galois::iterate(graph.begin(), graph.end()),
+        [&](const auto& vid) {
+          degrees[vid] =
+              std::distance(graph.edge_begin(vid), graph.edge_end(vid));
+        },
+        galois::loopname("computeMaxDegree"));
+    max_degree = *(std::max_element(degrees.begin(), degrees.end()));
   } else {
     printf("Unkown file format\n");
     exit(1);
@@ -0,0 +1,284 @@
+#ifndef GALOIS_BC_BATCH
+#define GALOIS_BC_BATCH
+
+#include "galois/AtomicHelpers.h"
+#include "galois/gstl.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/graphs/MultiSourceSearch.h"
+
+#include <atomic>
+#include <fstream>
+#include <iterator>
+
+////////////////////////////////////////////////////////////////////////////////
+
+// number of sources traversed together; per node, the path counts and
+// dependencies of a batch take 12 bytes for each of them
+constexpr static const unsigned BATCH_WIDTH      = 64u;
+constexpr static const unsigned BATCH_CHUNK_SIZE = 64u;
+
+using BatchShortPathType = double;
+
+// node data is the BC value
+using BatchGraph = galois::graphs::LC_CSR_Graph<float, void>::with_no_lockable<
+    true>::type::with_numa_alloc<true>::type;
+using BatchGNode = BatchGraph::GraphNode;
+using BatchBFS   = galois::graphs::MultiSourceBFS<BatchGraph, BATCH_WIDTH>;
+using BatchMask  = BatchBFS::Mask;
+
+//! Node reached in some level by the sources of mask
+struct BatchRecord {
+  BatchGNode node;
+  BatchMask mask;
+};
+
+using BatchLevelType = galois::InsertBag<BatchRecord, 4096>;
+
+/**
+ * Brandes BC for BATCH_WIDTH sources at a time. The forward phase is a
+ * multi-source BFS that also counts shortest paths per source; it records
+ * the nodes of every level with the sources that reached them there. The
+ * backward phase walks the levels in reverse like the Level algorithm, but
+ * every node pulls the dependencies of all sources of its record at once.
+ */
+class BatchBC {
+  BatchGraph& graph;
+  BatchBFS bfs;
+  // [node * BATCH_WIDTH + source] for the sources of the current batch
+  galois::LargeArray<std::atomic<BatchShortPathType>> numShortestPaths;
+  galois::LargeArray<float> dependency;
+  // sources for which a node is on the level below the one being processed
+  galois::LargeArray<BatchMask> succMask;
+
+  //! Index of source i of node n in the per-source arrays; node ids are 32
+  //! bits, so widen before scaling
+  static size_t cell(BatchGNode n, unsigned i) {
+    return size_t(n) * BATCH_WIDTH + i;
+  }
+
+  /**
+   * Forward phase: BFS from all sources of the batch, counting shortest
+   * paths on the way.
+   */
+  galois::gstl::Vector<BatchLevelType>
+  forward(const std::vector<BatchGNode>& sources) {
+    galois::gstl::Vector<BatchLevelType> levels;
+
+    bfs.reset(sources);
+    for (unsigned i = 0; i < sources.size(); ++i)
+      numShortestPaths[cell(sources[i], i)] = 1;
+
+    do {
+      BatchLevelType& level = levels.emplace_back();
+      bfs.forEachVisited([&](BatchGNode n, const BatchMask& mask) {
+        level.push(BatchRecord{n, mask});
+      });
+    } while (bfs.advance(
+        [&](BatchGNode src, BatchGNode dest, const BatchMask& mask) {
+          // src is complete: all its paths came in the previous level
+          mask.forEach([&](unsigned i) {
+            galois::atomicAdd(numShortestPaths[cell(dest, i)],
+                              numShortestPaths[cell(src, i)].load(
+                                  std::memory_order_relaxed));
+          });
+        }));
+    return levels;
+  }
+
+  /**
+   * Backward phase: propagates dependencies level by level, from the deepest
+   * one up to the one after the sources, and adds them to BC.
+   */
+  void backward(galois::gstl::Vector<BatchLevelType>& levels) {
+    for (size_t currentLevel = levels.size() - 1; currentLevel > 0;
+         --currentLevel) {
+      bool leaves = currentLevel + 1 == levels.size();
+      if (!leaves)
+        galois::do_all(
+            galois::iterate(levels[currentLevel + 1]),
+            [&](const BatchRecord& r) { succMask[r.node] = r.mask; },
+            galois::no_stats(), galois::loopname("BatchScatter"));
+
+      galois::do_all(
+          galois::iterate(levels[currentLevel]),
+          [&](const BatchRecord& r) {
+            float contrib[BATCH_WIDTH];
+            r.mask.forEach([&](unsigned i) { contrib[i] = 0; });
+
+            if (!leaves) {
+              for (auto e : graph.edges(r.node)) {
+                BatchGNode dest = graph.getEdgeDst(e);
+                BatchMask succ  = r.mask & succMask[dest];
+                succ.forEach([&](unsigned i) {
+                  size_t d = cell(dest, i);
+                  contrib[i] += ((float)1 + dependency[d]) /
+                                numShortestPaths[d].load(
+                                    std::memory_order_relaxed);
+                });
+              }
+            }
+
+            float sum = 0;
+            r.mask.forEach([&](unsigned i) {
+              size_t n      = cell(r.node, i);
+              dependency[n] = contrib[i] * numShortestPaths[n].load(
+                                               std::memory_order_relaxed);
+              sum += dependency[n];
+            });
+            // records of a level have distinct nodes
+            graph.getData(r.node) += sum;
+          },
+          galois::steal(), galois::chunk_size<BATCH_CHUNK_SIZE>(),
+          galois::no_stats(), galois::loopname("BatchBrandes"));
+
+      if (!leaves)
+        galois::do_all(
+            galois::iterate(levels[currentLevel + 1]),
+            [&](const BatchRecord& r) { succMask[r.node].clear(); },
+            galois::no_stats(), galois::loopname("BatchScatterClear"));
+    }
+  }
+
+  //! Zeroes the path counts of the batch, visiting only the nodes reached
+  void clearPaths(galois::gstl::Vector<BatchLevelType>& levels) {
+    for (auto& level : levels)
+      galois::do_all(
+          galois::iterate(level),
+          [&](const BatchRecord& r) {
+            r.mask.forEach([&](unsigned i) {
+              numShortestPaths[cell(r.node, i)].store(
+                  0, std::memory_order_relaxed);
+            });
+          },
+          galois::no_stats(), galois::loopname("BatchClearPaths"));
+  }
+
+public:
+  explicit BatchBC(BatchGraph& g) : graph(g), bfs(g) {
+    numShortestPaths.allocateInterleaved(graph.size() * BATCH_WIDTH);
+    dependency.allocateInterleaved(graph.size() * BATCH_WIDTH);
+    succMask.allocateInterleaved(graph.size());
+    galois::do_all(
+        galois::iterate(graph),
+        [&](BatchGNode n) {
+          graph.getData(n) = 0;
+          succMask[n].clear();
+          for (unsigned i = 0; i < BATCH_WIDTH; ++i)
+            numShortestPaths[cell(n, i)].store(
+                0, std::memory_order_relaxed);
+        },
+        galois::no_stats(), galois::loopname("InitializeGraph"));
+  }
+
+  //! Adds the BC contributions of at most BATCH_WIDTH sources
+  void run(const std::vector<BatchGNode>& sources) {
+    galois::gstl::Vector<BatchLevelType> levels = forward(sources);
+    backward(levels);
+    clearPaths(levels);
+  }
+};
+
+/******************************************************************************/
+/* Sanity check */
+/******************************************************************************/
+
+/**
+ * Get some sanity numbers (max, min, sum of BC)
+ *
+ * @param graph BatchGraph to sanity check
+ */
+void BatchSanity(BatchGraph& graph) {
+  galois::GReduceMax<float> accumMax;
+  galois::GReduceMin<float> accumMin;
+  galois::GAccumulator<float> accumSum;
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](BatchGNode n) {
+        float bc = graph.getData(n);
+        accumMax.update(bc);
+        accumMin.update(bc);
+        accumSum += bc;
+      },
+      galois::no_stats(), galois::loopname("BatchSanity"));
+
+  galois::gPrint("Max BC is ", accumMax.reduce(), "\n");
+  galois::gPrint("Min BC is ", accumMin.reduce(), "\n");
+  galois::gPrint("BC sum is ", accumSum.reduce(), "\n");
+}
+
+/******************************************************************************/
+/* Running */
+/******************************************************************************/
+
+void doBatchBC() {
+  galois::gInfo("Batches of ", BATCH_WIDTH, " sources");
+  galois::runtime::reportStat_Single(REGION_NAME, "BatchWidth", BATCH_WIDTH);
+  galois::reportPageAlloc("MemAllocPre");
+
+  galois::StatTimer graphConstructTimer("TimerConstructGraph", "BFS");
+  graphConstructTimer.start();
+  BatchGraph graph;
+  galois::graphs::readGraph(graph, inputFile);
+  graphConstructTimer.stop();
+  galois::gInfo("Graph construction complete");
+
+  galois::StatTimer preallocTime("PreAllocTime", REGION_NAME);
+  preallocTime.start();
+  galois::preAlloc(
+      std::max(size_t{galois::getActiveThreads()} * (graph.size() / 2000000),
+               std::max(10U, galois::getActiveThreads()) * size_t{10}));
+  preallocTime.stop();
+  galois::reportPageAlloc("MemAllocMid");
+
+  // same choice of sources as Level
+  std::vector<BatchGNode> sources;
+  if (singleSourceBC) {
+    sources.push_back(startSource);
+  } else {
+    if (sourcesToUse != "") {
+      std::ifstream sourceFile(sourcesToUse);
+      // check the range before narrowing to node ids
+      for (auto it = std::istream_iterator<uint64_t>{sourceFile};
+           it != std::istream_iterator<uint64_t>{}; ++it) {
+        if (*it >= graph.size())
+          GALOIS_DIE("source ", *it, " is not a node of the graph");
+        sources.push_back(*it);
+      }
+    } else {
+      for (uint64_t i = 0; i < graph.size(); ++i)
+        sources.push_back(i);
+    }
+    if (numOfSources && numOfSources < sources.size())
+      sources.resize(numOfSources);
+  }
+
+  BatchBC bc(graph);
+
+  galois::gInfo("Beginning main computation");
+  galois::StatTimer execTime("Timer_0");
+  for (size_t begin = 0; begin < sources.size(); begin += BATCH_WIDTH) {
+    size_t end = std::min(begin + BATCH_WIDTH, sources.size());
+    std::vector<BatchGNode> batch(sources.begin() + begin,
+                                  sources.begin() + end);
+    execTime.start();
+    bc.run(batch);
+    execTime.stop();
+  }
+
+  galois::reportPageAlloc("MemAllocPost");
+
+  BatchSanity(graph);
+
+  if (output) {
+    char* v_out = (char*)malloc(40);
+    for (auto ii = graph.begin(); ii != graph.end(); ++ii) {
+      sprintf(v_out, "%u %.9f\n", (*ii), graph.getData(*ii));
+      galois::gPrint(v_out);
+    }
+    free(v_out);
+  }
+}
+#endif
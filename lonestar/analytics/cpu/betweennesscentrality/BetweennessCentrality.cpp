@@ -25,9 +25,9 @@
 
 constexpr static const char* const REGION_NAME = "BC";
 
-enum Algo { Level = 0, Async, Outer, AutoAlgo };
+enum Algo { Level = 0, Async, Outer, Batch, AutoAlgo };
 
-const char* const ALGO_NAMES[] = {"Level", "Async", "Outer", "Auto"};
+const char* const ALGO_NAMES[] = {"Level", "Async", "Outer", "Batch", "Auto"};
 
 const uint32_t infinity = std::numeric_limits<uint32_t>::max() / 4;
 
@@ -76,6 +76,7 @@ static cll::opt<Algo> algo(
     "algo", cll::desc("Choose an algorithm (default value AutoAlgo):"),
     cll::values(clEnumVal(Level, "Level"), clEnumVal(Async, "Async"),
                 clEnumVal(Outer, "Outer"),
+                clEnumVal(Batch, "Batch: Level on many sources at once"),
                 clEnumVal(AutoAlgo,
                           "Auto: choose among the algorithms automatically")),
     cll::init(AutoAlgo));
@@ -96,6 +97,7 @@ static const char* desc = "Computes betwenness centrality in an unweighted "
 #include "LevelStructs.h"
 #include "AsyncStructs.h"
 #include "OuterStructs.h"
+#include "BatchStructs.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -137,6 +139,11 @@ int main(int argc, char** argv) {
     galois::gInfo("Running outer BC");
     doOuterBC();
     break;
+  case Batch:
+    // see BatchStructs.h
+    galois::gInfo("Running batch BC");
+    doBatchBC();
+    break;
   default:
     GALOIS_DIE("Unknown BC algorithm type");
   }
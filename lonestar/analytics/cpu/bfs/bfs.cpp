@@ -75,10 +75,37 @@ static cll::opt<Algo> algo(
                 clEnumVal(SyncTile, "SyncTile"), clEnumVal(Sync, "Sync")),
     cll::init(SyncTile));
 
+enum Worklist { FifoWL, BulkSyncWL, BatchedBulkSyncWL };
+
+static cll::opt<Worklist> worklist(
+    "wl", cll::desc("Worklist of AsyncTile and Async (default value FIFO):"),
+    cll::values(clEnumValN(FifoWL, "FIFO", "per-socket chunked FIFO"),
+                clEnumValN(BulkSyncWL, "BulkSync",
+                           "bulk-synchronous rounds, one per level"),
+                clEnumValN(BatchedBulkSyncWL, "BatchedBulkSync",
+                           "bulk-synchronous rounds with batched pushes; "
+                           "Async queues a node at most once per round")),
+    cll::init(FifoWL));
+
+enum GraphType { CSR, Compressed };
+
+static cll::opt<GraphType> graphType(
+    "graphType", cll::desc("Graph representation (default value CSR):"),
+    cll::values(clEnumVal(CSR, "CSR"),
+                clEnumVal(Compressed,
+                          "Varint gap-compressed adjacency lists, read from "
+                          ".gr or .vgr; Async and Sync only")),
+    cll::init(CSR));
+
 using Graph =
     galois::graphs::LC_CSR_Graph<unsigned, void>::with_no_lockable<true>::type;
 //::with_numa_alloc<true>::type;
 
+//! Its edge iterators only move forward, so edges cannot be tiled
+using CompressedGraph =
+    galois::graphs::LC_Compressed_Graph<unsigned,
+                                        void>::with_no_lockable<true>::type;
+
 using GNode = Graph::GraphNode;
 
 constexpr static const bool TRACK_WORK          = false;
@@ -96,6 +123,9 @@ using ReqPushWrap         = BFS::ReqPushWrap;
 using OutEdgeRangeFn      = BFS::OutEdgeRangeFn;
 using TileRangeFn         = BFS::TileRangeFn;
 
+using CompressedBFS =
+    BFS_SSSP<CompressedGraph, unsigned int, false, EDGE_TILE_SIZE>;
+
 struct EdgeTile {
   Graph::edge_iterator beg;
   Graph::edge_iterator end;
@@ -152,22 +182,39 @@ struct OneTilePushWrap {
   }
 };
 
-template <bool CONCURRENT, typename T, typename P, typename R>
-void asyncAlgo(Graph& graph, GNode source, const P& pushWrap,
-               const R& edgeRange) {
+//! Worklists whose rounds are BFS levels, so that every update in a round
+//! writes the same distance and needs no CAS
+template <typename WL>
+struct IsBulkSynchronous : std::false_type {};
+
+template <class C, class T, bool B>
+struct IsBulkSynchronous<galois::worklists::BulkSynchronous<C, T, B>>
+    : std::true_type {};
+
+template <class C, unsigned S, typename I, class T, bool B>
+struct IsBulkSynchronous<
+    galois::worklists::BatchedBulkSynchronous<C, S, I, T, B>>
+    : std::true_type {};
+
+//! Node an Async item updates, so that BatchedBulkSync queues it once a round
+struct SrcIndexer {
+  template <typename T>
+  size_t operator()(const T& item) const {
+    return item.src;
+  }
+};
 
-  namespace gwl = galois::worklists;
-  // typedef PerSocketChunkFIFO<CHUNK_SIZE> dFIFO;
-  using FIFO = gwl::PerSocketChunkFIFO<CHUNK_SIZE>;
-  using BSWL = gwl::BulkSynchronous<gwl::PerSocketChunkLIFO<CHUNK_SIZE>>;
-  using WL   = FIFO;
+template <bool CONCURRENT, typename T, typename WL, typename GraphTy,
+          typename P, typename R, typename... WLArgs>
+void asyncAlgo(GraphTy& graph, GNode source, const P& pushWrap,
+               const R& edgeRange, WLArgs&&... wlArgs) {
 
   using Loop =
       typename std::conditional<CONCURRENT, galois::ForEach,
                                 galois::WhileQ<galois::SerFIFO<T>>>::type;
 
   GALOIS_GCC7_IGNORE_UNUSED_BUT_SET
-  constexpr bool useCAS = CONCURRENT && !std::is_same<WL, BSWL>::value;
+  constexpr bool useCAS = CONCURRENT && !IsBulkSynchronous<WL>::value;
   GALOIS_END_GCC7_IGNORE_UNUSED_BUT_SET
 
   Loop loop;
@@ -231,8 +278,8 @@ void asyncAlgo(Graph& graph, GNode source, const P& pushWrap,
           }
         }
       },
-      galois::wl<WL>(), galois::loopname("runBFS"),
-      galois::disable_conflict_detection());
+      galois::wl<WL>(std::forward<WLArgs>(wlArgs)...),
+      galois::loopname("runBFS"), galois::disable_conflict_detection());
 
   if (TRACK_WORK) {
     galois::runtime::reportStat_Single("BFS", "BadWork", BadWork.reduce());
@@ -241,8 +288,39 @@ void asyncAlgo(Graph& graph, GNode source, const P& pushWrap,
   }
 }
 
-template <bool CONCURRENT, typename T, typename P, typename R>
-void syncAlgo(Graph& graph, GNode source, const P& pushWrap,
+//! Runs asyncAlgo with the worklist chosen by -wl; BatchedBulkSync reports
+//! its round statistics under runBFS and queues items with the same Indexer
+//! key at most once per round
+template <bool CONCURRENT, typename T, typename Indexer, typename GraphTy,
+          typename P, typename R>
+void asyncAlgoWL(GraphTy& graph, GNode source, const P& pushWrap,
+                 const R& edgeRange) {
+  namespace gwl = galois::worklists;
+  using FIFO = gwl::PerSocketChunkFIFO<CHUNK_SIZE>;
+  using BSWL = gwl::BulkSynchronous<gwl::PerSocketChunkLIFO<CHUNK_SIZE>>;
+  using BBSWL =
+      gwl::BatchedBulkSynchronous<gwl::PerSocketChunkFIFO<CHUNK_SIZE>, 64,
+                                  Indexer>;
+
+  switch (worklist) {
+  case FifoWL:
+    asyncAlgo<CONCURRENT, T, FIFO>(graph, source, pushWrap, edgeRange);
+    break;
+  case BulkSyncWL:
+    asyncAlgo<CONCURRENT, T, BSWL>(graph, source, pushWrap, edgeRange);
+    break;
+  case BatchedBulkSyncWL:
+    asyncAlgo<CONCURRENT, T, BBSWL>(graph, source, pushWrap, edgeRange,
+                                    "runBFS", Indexer(), graph.size());
+    break;
+  default:
+    std::cerr << "ERROR: unknown worklist\n";
+  }
+}
+
+template <bool CONCURRENT, typename T, typename GraphTy, typename P,
+          typename R>
+void syncAlgo(GraphTy& graph, GNode source, const P& pushWrap,
               const R& edgeRange) {
 
   using Cont = typename std::conditional<CONCURRENT, galois::InsertBag<T>,
@@ -297,12 +375,13 @@ void runAlgo(Graph& graph, const GNode& source) {
 
   switch (algo) {
   case AsyncTile:
-    asyncAlgo<CONCURRENT, SrcEdgeTile>(
+    // the tiles of a node share its key, so they are not deduplicated
+    asyncAlgoWL<CONCURRENT, SrcEdgeTile, galois::worklists::NoDedupe>(
         graph, source, SrcEdgeTilePushWrap{graph}, TileRangeFn());
     break;
   case Async:
-    asyncAlgo<CONCURRENT, UpdateRequest>(graph, source, ReqPushWrap(),
-                                         OutEdgeRangeFn{graph});
+    asyncAlgoWL<CONCURRENT, UpdateRequest, SrcIndexer>(
+        graph, source, ReqPushWrap(), OutEdgeRangeFn{graph});
     break;
   case SyncTile:
     syncAlgo<CONCURRENT, EdgeTile>(graph, source, EdgeTilePushWrap{graph},
@@ -317,14 +396,29 @@ void runAlgo(Graph& graph, const GNode& source) {
   }
 }
 
-int main(int argc, char** argv) {
-  galois::SharedMemSys G;
-  LonestarStart(argc, argv, name, desc, url, &inputFile);
+template <bool CONCURRENT>
+void runAlgo(CompressedGraph& graph, const GNode& source) {
 
-  galois::StatTimer totalTime("TimerTotal");
-  totalTime.start();
+  switch (algo) {
+  case Async:
+    asyncAlgoWL<CONCURRENT, CompressedBFS::UpdateRequest, SrcIndexer>(
+        graph, source, CompressedBFS::ReqPushWrap(),
+        CompressedBFS::OutEdgeRangeFn{graph});
+    break;
+  case Sync:
+    syncAlgo<CONCURRENT, GNode>(graph, source, NodePushWrap(),
+                                CompressedBFS::OutEdgeRangeFn{graph});
+    break;
+  default:
+    std::cerr << "ERROR: unkown algo type\n";
+  }
+}
+
+template <typename GraphTy>
+void run() {
+  using GraphBFS = BFS_SSSP<GraphTy, unsigned int, false, EDGE_TILE_SIZE>;
 
-  Graph graph;
+  GraphTy graph;
   GNode source;
   GNode report;
 
@@ -352,8 +446,9 @@ int main(int argc, char** argv) {
 
   galois::reportPageAlloc("MeminfoPre");
 
-  galois::do_all(galois::iterate(graph),
-                 [&graph](GNode n) { graph.getData(n) = BFS::DIST_INFINITY; });
+  galois::do_all(galois::iterate(graph), [&graph](GNode n) {
+    graph.getData(n) = GraphBFS::DIST_INFINITY;
+  });
   graph.getData(source) = 0;
 
   std::cout << "Running " << ALGO_NAMES[algo] << " algorithm with "
@@ -390,7 +485,7 @@ int main(int argc, char** argv) {
       [&](uint64_t i) {
         uint32_t myDistance = graph.getData(i);
 
-        if (myDistance != BFS::DIST_INFINITY) {
+        if (myDistance != GraphBFS::DIST_INFINITY) {
           maxDistance.update(myDistance);
           distanceSum += myDistance;
           visitedNode += 1;
@@ -407,12 +502,30 @@ int main(int argc, char** argv) {
   galois::gInfo("Sum of visited distances is ", rDistanceSum);
 
   if (!skipVerify) {
-    if (BFS::verify(graph, source)) {
+    if (GraphBFS::verify(graph, source)) {
       std::cout << "Verification successful.\n";
     } else {
       GALOIS_DIE("verification failed");
     }
   }
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  galois::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (graphType == Compressed) {
+    if (algo != Async && algo != Sync) {
+      GALOIS_DIE("-graphType=Compressed is only supported by -algo=Async and "
+                 "-algo=Sync");
+    }
+    run<CompressedGraph>();
+  } else {
+    run<Graph>();
+  }
 
   totalTime.stop();
 
@@ -19,11 +19,11 @@
 
 #include "galois/Galois.h"
 #include "galois/AtomicHelpers.h"
-#include "galois/DynamicBitset.h"
 #include "galois/gstl.h"
 #include "galois/Reduction.h"
 #include "galois/Timer.h"
 #include "galois/graphs/LCGraph.h"
+#include "galois/graphs/Frontier.h"
 #include "galois/graphs/TypeTraits.h"
 #include "galois/graphs/LC_CSR_CSC_Graph.h"
 #include "galois/runtime/Profile.h"
@@ -178,167 +178,53 @@ struct OneTilePushWrap {
   }
 };
 
-template <typename WL>
-void WlToBitset(WL& wl, galois::DynamicBitSet& bitset) {
-  galois::do_all(
-      galois::iterate(wl), [&](const GNode& src) { bitset.set(src); },
-      galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
-      galois::loopname("WlToBitset"));
-}
-
-template <typename WL>
-void BitsetToWl(const Graph& graph, const galois::DynamicBitSet& bitset,
-                WL& wl) {
-  wl.clear();
-  galois::do_all(
-      galois::iterate(graph),
-      [&](const GNode& src) {
-        if (bitset.test(src))
-          // pushWrap(wl, src);
-          wl.push(src);
-      },
-      galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
-      galois::loopname("BitsetToWl"));
-}
-
-template <bool CONCURRENT, typename T, typename P, typename R>
-void syncDOAlgo(Graph& graph, GNode source, const P& pushWrap,
-                const R& GALOIS_UNUSED(edgeRange), const uint32_t runID) {
-
-  using Cont = typename std::conditional<CONCURRENT, galois::InsertBag<T>,
-                                         galois::SerStack<T>>::type;
-  using Loop = typename std::conditional<CONCURRENT, galois::DoAll,
-                                         galois::StdForEach>::type;
-
-  constexpr galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
-  galois::GAccumulator<uint32_t> work_items;
-
-  Loop loop;
-
-  galois::DynamicBitSet front_bitset, next_bitset;
-  front_bitset.resize(graph.size());
-  next_bitset.resize(graph.size());
-
-  front_bitset.reset();
-  next_bitset.reset();
+//! Assigns every node reached in a round the node it was reached from
+struct ParentFn {
+  Graph& graph;
 
-  Cont* curr = new Cont();
-  Cont* next = new Cont();
+  bool cond(GNode dst) {
+    return graph.getData(dst, galois::MethodFlag::UNPROTECTED) ==
+           BFS::DIST_INFINITY;
+  }
 
-  Dist nextLevel              = 0u;
-  graph.getData(source, flag) = 0u;
+  bool update(GNode src, GNode dst) {
+    graph.getData(dst, galois::MethodFlag::UNPROTECTED) = src;
+    return true;
+  }
 
-  if (CONCURRENT) {
-    pushWrap(*next, source, "parallel");
-  } else {
-    pushWrap(*next, source);
+  bool updateAtomic(GNode src, GNode dst) {
+    auto& ddata = graph.getData(dst, galois::MethodFlag::UNPROTECTED);
+    /*
+     * Currently assigning parents on the bfs path; a level could be assigned
+     * instead
+     */
+    return __sync_bool_compare_and_swap(&ddata, BFS::DIST_INFINITY, src);
   }
-  // adding source to the worklist
-  work_items += 1;
-  // next_bitset.set(source);
-
-  int64_t edges_to_check = graph.sizeEdges();
-  int64_t scout_count =
-      std::distance(graph.edge_begin(source), graph.edge_end(source));
-  galois::gPrint("source: ", source, " has OutDegree:", scout_count, "\n");
-  assert(!next->empty());
-
-  uint64_t old_workItemNum = 0;
-  uint64_t numNodes        = graph.size();
-  // uint32_t c_pull = 0, c_push = 0;
-  galois::GAccumulator<uint64_t> writes_pull, writes_push;
-  writes_push.reset();
-  writes_pull.reset();
-  // std::vector<uint32_t> pull_levels;
-  // pull_levels.reserve(10);
-
-  while (!next->empty()) {
+};
 
+void syncDOAlgo(Graph& graph, GNode source, const uint32_t runID) {
+  galois::graphs::Frontier a(graph.size()), b(graph.size());
+  galois::graphs::Frontier* curr = &a;
+  galois::graphs::Frontier* next = &b;
+
+  graph.getData(source, galois::MethodFlag::UNPROTECTED) = 0u;
+  curr->push(source);
+  galois::gPrint("source: ", source, " has OutDegree:",
+                 std::distance(graph.edge_begin(source),
+                               graph.edge_end(source)),
+                 "\n");
+
+  std::string loopname = std::string("Sync_") + std::to_string(runID);
+  galois::graphs::EdgeMapOptions options;
+  options.alpha    = alpha;
+  options.beta     = beta;
+  options.loopname = loopname.c_str();
+
+  ParentFn fn{graph};
+  while (!curr->empty()) {
+    galois::graphs::edgeMap(graph, *curr, *next, fn, options);
     std::swap(curr, next);
-    next->clear();
-    if (scout_count > edges_to_check / alpha) {
-
-      WlToBitset(*curr, front_bitset);
-      do {
-        // c_pull++;
-        // pull_levels.push_back(nextLevel);
-
-        ++nextLevel;
-        old_workItemNum = work_items.reduce();
-        work_items.reset();
-
-        // PULL from in-edges
-        loop(
-            galois::iterate(graph),
-            [&](const T& dst) {
-              auto& ddata = graph.getData(dst, flag);
-              if (ddata == BFS::DIST_INFINITY) {
-                for (auto e : graph.in_edges(dst)) {
-                  auto src = graph.getInEdgeDst(e);
-
-                  if (front_bitset.test(src)) {
-                    /*
-                     * Currently assigning parents on the bfs path.
-                     * Assign nextLevel (uncomment below)
-                     */
-                    // ddata = nextLevel;
-                    ddata = src;
-                    next_bitset.set(dst);
-                    work_items += 1;
-                    break;
-                  }
-                }
-              }
-            },
-            galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
-            galois::loopname(
-                (std::string("Sync-pull_") + std::to_string(runID)).c_str()));
-
-        std::swap(front_bitset, next_bitset);
-        next_bitset.reset();
-      } while (work_items.reduce() >= old_workItemNum ||
-               (work_items.reduce() > numNodes / beta));
-
-      BitsetToWl(graph, front_bitset, *next);
-      scout_count = 1;
-    } else {
-      // c_push++;
-      ++nextLevel;
-      edges_to_check -= scout_count;
-      work_items.reset();
-      // PUSH to out-edges
-      loop(
-          galois::iterate(*curr),
-          [&](const T& src) {
-            for (auto e : graph.edges(src)) {
-              auto dst    = graph.getEdgeDst(e);
-              auto& ddata = graph.getData(dst, flag);
-
-              if (ddata == BFS::DIST_INFINITY) {
-                Dist oldDist = ddata;
-                /*
-                 * Currently assigning parents on the bfs path.
-                 * Assign nextLevel (uncomment below)
-                 */
-                // if(__sync_bool_compare_and_swap(&ddata, oldDist, nextLevel))
-                // {
-                if (__sync_bool_compare_and_swap(&ddata, oldDist, src)) {
-                  next->push(dst);
-                  work_items += (graph.edge_end(dst) - graph.edge_begin(dst));
-                }
-              }
-            }
-          },
-          galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
-          galois::loopname(
-              (std::string("Sync-push_") + std::to_string(runID)).c_str()));
-
-      scout_count = work_items.reduce();
-    }
   }
-
-  delete curr;
-  delete next;
 }
 
 template <bool CONCURRENT, typename T, typename P, typename R>
@@ -393,8 +279,7 @@ template <bool CONCURRENT>
 void runAlgo(Graph& graph, const GNode& source, const uint32_t runID) {
   switch (algo) {
   case SyncDO:
-    syncDOAlgo<CONCURRENT, GNode>(graph, source, NodePushWrap(),
-                                  OutEdgeRangeFn{graph}, runID);
+    syncDOAlgo(graph, source, runID);
     break;
   case Async:
     asyncAlgo<CONCURRENT, GNode>(graph, source, NodePushWrap(),
@@ -19,6 +19,7 @@
 
 #include "bipart.h"
 #include "galois/Galois.h"
+#include "galois/ParallelSTL.h"
 #include "galois/AtomicHelpers.h"
 #include "galois/Reduction.h"
 #include "galois/runtime/Profile.h"
@@ -567,9 +568,9 @@ void parallelCreateEdges(MetisGraph* graph, GNodeBag& bag,
       galois::steal(), galois::loopname("BuildGrah: Prefix sum"));
 
   num_edges_next = num_edges_acc.reduce();
-  for (uint32_t c = 1; c < num_nodes_next; ++c) {
-    prefix_edges[c] += prefix_edges[c - 1];
-  }
+  galois::ParallelSTL::partial_sum(prefix_edges.begin(),
+                                   prefix_edges.begin() + num_nodes_next,
+                                   prefix_edges.begin());
 
   coarseGGraph->constructFrom(num_nodes_next, num_edges_next, prefix_edges,
                               edges_id, edges_data);
@@ -20,6 +20,7 @@
 #include "bipart.h"
 #include "galois/graphs/ReadGraph.h"
 #include "galois/Timer.h"
+#include "galois/ParallelSTL.h"
 #include "Lonestar/BoilerPlate.h"
 #include "galois/graphs/FileGraph.h"
 #include "galois/LargeArray.h"
@@ -264,9 +265,9 @@ int main(int argc, char** argv) {
   galois::do_all(galois::iterate(uint32_t{0}, sizes),
                  [&](uint32_t c) { prefix_edges[c] = edges_id[c].size(); });
 
-  for (uint64_t c = 1; c < nodes + hedges; ++c) {
-    prefix_edges[c] += prefix_edges[c - 1];
-  }
+  galois::ParallelSTL::partial_sum(prefix_edges.begin(),
+                                   prefix_edges.begin() + nodes + hedges,
+                                   prefix_edges.begin());
 
   graph.constructFrom(nodes + hedges, edges, prefix_edges, edges_id,
                       edges_data);
@@ -0,0 +1,320 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause
+ * BSD License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2019, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/graphs/MultiSourceSearch.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "Lonestar/BoilerPlate.h"
+
+#include "llvm/Support/CommandLine.h"
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+constexpr static const char* const REGION_NAME = "ClosenessCentrality";
+constexpr static const char* const name        = "Closeness Centrality";
+constexpr static const char* const desc =
+    "Computes the closeness centrality of many nodes of a graph by searching "
+    "from batches of them at once.";
+
+/*******************************************************************************
+ * Declaration of command line arguments
+ ******************************************************************************/
+namespace cll = llvm::cl;
+
+enum Algo { MSBFS = 0, BatchedSSSP };
+
+const char* const ALGO_NAMES[] = {"MSBFS", "BatchedSSSP"};
+
+static cll::opt<std::string>
+    inputFile(cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<Algo> algo(
+    "algo", cll::desc("Choose an algorithm (default value MSBFS):"),
+    cll::values(clEnumVal(MSBFS, "MSBFS: multi-source BFS on hops"),
+                clEnumVal(BatchedSSSP,
+                          "BatchedSSSP: batched delta-stepping on the "
+                          "edge weights")),
+    cll::init(MSBFS));
+
+static cll::opt<std::string> sourcesToUse("sourcesToUse",
+                                          cll::desc("Whitespace separated list "
+                                                    "of sources in a file to "
+                                                    "compute closeness of"),
+                                          cll::init(""));
+
+static cll::opt<unsigned int>
+    numOfSources("numOfSources",
+                 cll::desc("Number of sources to compute closeness of "
+                           "(default all)"),
+                 cll::init(0));
+
+static cll::opt<unsigned int>
+    batchSize("batchSize",
+              cll::desc("Sources searched together; 64, 128, 256 or 512 "
+                        "for MSBFS (default value 64)"),
+              cll::init(64));
+
+static cll::opt<unsigned int>
+    stepShift("delta",
+              cll::desc("BatchedSSSP: shift value for the deltastep "
+                        "(default value 7)"),
+              cll::init(7));
+
+static cll::opt<bool>
+    output("output", cll::desc("Output closeness (default: false)"),
+           cll::init(false));
+
+/*******************************************************************************
+ * Graph structure declarations + other inits
+ ******************************************************************************/
+
+using Graph = galois::graphs::LC_CSR_Graph<void, void>::with_no_lockable<
+    true>::type::with_numa_alloc<true>::type;
+using WeightedGraph =
+    galois::graphs::LC_CSR_Graph<void, uint32_t>::with_no_lockable<
+        true>::type::with_numa_alloc<true>::type;
+using GNode = Graph::GraphNode;
+
+/**
+ * Per-thread sums of the distances from, and the number of nodes reached by,
+ * each source of a batch.
+ */
+class BatchSums {
+  struct Sums {
+    std::vector<uint64_t> distance;
+    std::vector<uint64_t> reached;
+  };
+  galois::substrate::PerThreadStorage<Sums> sums;
+
+public:
+  explicit BatchSums(size_t numSources) {
+    for (unsigned t = 0; t < sums.size(); ++t) {
+      sums.getRemote(t)->distance.assign(numSources, 0);
+      sums.getRemote(t)->reached.assign(numSources, 0);
+    }
+  }
+
+  void add(size_t source, uint64_t distance) {
+    Sums& local = *sums.getLocal();
+    local.distance[source] += distance;
+    local.reached[source] += 1;
+  }
+
+  /**
+   * Wasserman and Faust's closeness, which stays comparable across nodes
+   * that reach different numbers of nodes: (r / (n - 1)) * (r / d), where r
+   * is the number of nodes the source reaches besides itself and d is the sum
+   * of their distances.
+   *
+   * Stores the closeness of the first count sources at begin[i] and zeroes
+   * the sums for the next batch.
+   */
+  template <typename Iter>
+  void closeness(size_t numNodes, size_t count, Iter begin) {
+    for (size_t i = 0; i < count; ++i) {
+      uint64_t distance = 0, reached = 0;
+      for (unsigned t = 0; t < sums.size(); ++t) {
+        distance += sums.getRemote(t)->distance[i];
+        reached += sums.getRemote(t)->reached[i];
+        sums.getRemote(t)->distance[i] = 0;
+        sums.getRemote(t)->reached[i]  = 0;
+      }
+      // the source itself is counted at distance 0
+      reached -= 1;
+      begin[i] = distance == 0 ? 0.0
+                                : (double)reached / (numNodes - 1) *
+                                      ((double)reached / distance);
+    }
+  }
+};
+
+/*******************************************************************************
+ * Algorithms
+ ******************************************************************************/
+
+//! Closeness by hops, Width sources per multi-source BFS
+template <unsigned Width>
+void msbfsCloseness(Graph& graph, const std::vector<GNode>& sources,
+                    std::vector<double>& closeness) {
+  galois::graphs::MultiSourceBFS<Graph, Width> bfs(graph);
+  BatchSums sums(Width);
+
+  for (size_t begin = 0; begin < sources.size(); begin += Width) {
+    size_t end = std::min(begin + Width, sources.size());
+    std::vector<GNode> batch(sources.begin() + begin, sources.begin() + end);
+    bfs.run(batch, [&](GNode, const auto& mask, unsigned level) {
+      mask.forEach([&](unsigned i) { sums.add(i, level); });
+    });
+    sums.closeness(graph.size(), batch.size(), closeness.begin() + begin);
+  }
+}
+
+//! Closeness by weighted distance, batchSize sources per SSSP
+void ssspCloseness(WeightedGraph& graph, const std::vector<GNode>& sources,
+                   std::vector<double>& closeness) {
+  galois::graphs::BatchedSSSP<WeightedGraph> sssp(graph);
+  BatchSums sums(batchSize);
+
+  for (size_t begin = 0; begin < sources.size(); begin += batchSize) {
+    size_t end = std::min(begin + batchSize, sources.size());
+    std::vector<GNode> batch(sources.begin() + begin, sources.begin() + end);
+    sssp.run(batch, stepShift);
+    // the distances of all sources to a node are contiguous
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          for (size_t i = 0; i < batch.size(); ++i) {
+            uint32_t d = sssp.distance(n, i);
+            if (d != sssp.infinity)
+              sums.add(i, d);
+          }
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("SumDistances"));
+    sums.closeness(graph.size(), batch.size(), closeness.begin() + begin);
+  }
+}
+
+/*******************************************************************************
+ * Sanity check and output
+ ******************************************************************************/
+
+void closenessSanity(const std::vector<double>& closeness) {
+  galois::GReduceMax<double> accumMax;
+  galois::GReduceMin<double> accumMin;
+  galois::GAccumulator<double> accumSum;
+
+  galois::do_all(
+      galois::iterate(closeness),
+      [&](double c) {
+        accumMax.update(c);
+        accumMin.update(c);
+        accumSum += c;
+      },
+      galois::no_stats(), galois::loopname("ClosenessSanity"));
+
+  galois::gPrint("Max closeness is ", accumMax.reduce(), "\n");
+  galois::gPrint("Min closeness is ", accumMin.reduce(), "\n");
+  galois::gPrint("Closeness sum is ", accumSum.reduce(), "\n");
+}
+
+template <typename GraphTy>
+std::vector<GNode> chooseSources(GraphTy& graph) {
+  std::vector<GNode> sources;
+  if (sourcesToUse != "") {
+    std::ifstream sourceFile(sourcesToUse);
+    // check the range before narrowing to node ids
+    for (auto it = std::istream_iterator<uint64_t>{sourceFile};
+         it != std::istream_iterator<uint64_t>{}; ++it) {
+      if (*it >= graph.size())
+        GALOIS_DIE("source ", *it, " is not a node of the graph");
+      sources.push_back(*it);
+    }
+  } else {
+    for (uint64_t i = 0; i < graph.size(); ++i)
+      sources.push_back(i);
+  }
+  if (numOfSources && numOfSources < sources.size())
+    sources.resize(numOfSources);
+  return sources;
+}
+
+template <typename GraphTy, typename AlgoTy>
+void run(const AlgoTy& compute) {
+  galois::StatTimer graphReadingTimer("GraphConstructTime", REGION_NAME);
+  graphReadingTimer.start();
+  GraphTy graph;
+  galois::graphs::readGraph(graph, inputFile);
+  graphReadingTimer.stop();
+  galois::gInfo("Read ", graph.size(), " nodes, ", graph.sizeEdges(),
+                " edges");
+
+  galois::preAlloc(
+      std::max(size_t{galois::getActiveThreads()} * (graph.size() / 1000000),
+               std::max(10U, galois::getActiveThreads()) * size_t{10}));
+  galois::reportPageAlloc("MemAllocMid");
+
+  std::vector<GNode> sources = chooseSources(graph);
+  std::vector<double> closeness(sources.size());
+
+  galois::StatTimer execTime("Timer_0");
+  execTime.start();
+  compute(graph, sources, closeness);
+  execTime.stop();
+
+  galois::reportPageAlloc("MemAllocPost");
+
+  if (!skipVerify)
+    closenessSanity(closeness);
+
+  if (output)
+    for (size_t i = 0; i < sources.size(); ++i)
+      galois::gPrint(sources[i], " ", closeness[i], "\n");
+}
+
+/*******************************************************************************
+ * Main method for running
+ ******************************************************************************/
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, nullptr, &inputFile);
+
+  galois::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  galois::gInfo("Running ", ALGO_NAMES[algo], " with batches of ", batchSize,
+                " sources");
+  galois::runtime::reportStat_Single(REGION_NAME, "BatchSize",
+                                     batchSize.getValue());
+  galois::reportPageAlloc("MemAllocPre");
+
+  if (algo == MSBFS) {
+    switch (batchSize) {
+    case 64:
+      run<Graph>(msbfsCloseness<64>);
+      break;
+    case 128:
+      run<Graph>(msbfsCloseness<128>);
+      break;
+    case 256:
+      run<Graph>(msbfsCloseness<256>);
+      break;
+    case 512:
+      run<Graph>(msbfsCloseness<512>);
+      break;
+    default:
+      GALOIS_DIE("MSBFS batch size must be 64, 128, 256 or 512");
+    }
+  } else if (algo == BatchedSSSP) {
+    if (batchSize == 0)
+      GALOIS_DIE("batch size must be positive");
+    run<WeightedGraph>(ssspCloseness);
+  } else {
+    GALOIS_DIE("unknown closeness algorithm");
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
@@ -21,13 +21,17 @@
 #define CLUSTERING_H
 
 #include "galois/Galois.h"
+#include "galois/ParallelSTL.h"
 #include "galois/AtomicHelpers.h"
 #include "galois/LargeArray.h"
+#include "galois/substrate/PerThreadStorage.h"
 
 #include "llvm/Support/CommandLine.h"
 
+#include <algorithm>
 #include <random>
 #include <fstream>
+#include <vector>
 
 namespace cll = llvm::cl;
 static cll::opt<bool>
@@ -88,6 +92,114 @@ typedef float EdgeTy;
 // typedef uint32_t EdgeTy;
 typedef galois::LargeArray<EdgeTy> largeArrayEdgeTy;
 
+/**
+ * Sums edge weights by cluster id for one node (or one cluster of nodes) at a
+ * time. Clusters are kept in the order they were first added, so index 0 is
+ * the first cluster added after clear.
+ *
+ * Lookups go through an open-addressing hash table sized to twice the number
+ * of clusters expected since the last clear, so memory follows the largest
+ * degree rather than the number of clusters. Only the entries added since the
+ * last clear are reset, so one accumulator per thread can be reused for every
+ * node of every iteration; see ClusterAccumulators.
+ */
+class ClusterAccumulator {
+  struct Entry {
+    uint64_t cluster;
+    uint64_t index;
+  };
+  std::vector<Entry> table;
+  std::vector<uint64_t> slots;
+  std::vector<uint64_t> ids;
+  std::vector<EdgeTy> weights;
+  unsigned shift = 64;
+
+  uint64_t slotOf(uint64_t cluster) const {
+    // Fibonacci hashing: the top bits of the product are well mixed
+    return (cluster * 0x9E3779B97F4A7C15ULL) >> shift;
+  }
+
+public:
+  //! Removes all clusters and makes room for at least expected of them
+  void clear(size_t expected) {
+    for (uint64_t slot : slots)
+      table[slot].cluster = UNASSIGNED;
+    slots.clear();
+    ids.clear();
+    weights.clear();
+
+    size_t capacity = 16;
+    unsigned bits   = 4;
+    while (capacity < 2 * expected) {
+      capacity *= 2;
+      ++bits;
+    }
+    if (capacity > table.size()) {
+      table.assign(capacity, Entry{UNASSIGNED, 0});
+      shift = 64 - bits;
+    }
+  }
+
+  /**
+   * Adds weight to cluster, which is added with a weight of 0 first if
+   * needed. At most the expected number passed to clear may be added.
+   *
+   * @returns index of cluster
+   */
+  uint64_t add(uint64_t cluster, EdgeTy weight) {
+    assert(cluster != UNASSIGNED);
+    assert(ids.size() < table.size() / 2);
+    uint64_t mask = table.size() - 1;
+    for (uint64_t slot = slotOf(cluster);; slot = (slot + 1) & mask) {
+      Entry& e = table[slot];
+      if (e.cluster == cluster) {
+        weights[e.index] += weight;
+        return e.index;
+      }
+      if (e.cluster == UNASSIGNED) {
+        e.cluster = cluster;
+        e.index   = ids.size();
+        slots.push_back(slot);
+        ids.push_back(cluster);
+        weights.push_back(weight);
+        return e.index;
+      }
+    }
+  }
+
+  //! Weight added to cluster, 0 if it was never added
+  EdgeTy weightOf(uint64_t cluster) const {
+    assert(cluster != UNASSIGNED);
+    uint64_t mask = table.size() - 1;
+    for (uint64_t slot = slotOf(cluster);; slot = (slot + 1) & mask) {
+      const Entry& e = table[slot];
+      if (e.cluster == cluster)
+        return weights[e.index];
+      if (e.cluster == UNASSIGNED)
+        return 0;
+    }
+  }
+
+  //! Number of clusters added since the last clear
+  size_t size() const { return ids.size(); }
+
+  //! Id of the cluster at index i
+  uint64_t cluster(size_t i) const { return ids[i]; }
+
+  //! Weight of the cluster at index i
+  EdgeTy weight(size_t i) const { return weights[i]; }
+
+  //! Ids of the clusters in the order they were added
+  const std::vector<uint64_t>& clusters() const { return ids; }
+
+  //! Weights of the clusters in the order they were added
+  const std::vector<EdgeTy>& clusterWeights() const { return weights; }
+};
+
+//! One ClusterAccumulator per thread
+using ClusterAccumulators =
+    galois::substrate::PerThreadStorage<ClusterAccumulator>;
+
 template <typename GraphTy>
 void printGraphCharateristics(GraphTy& graph) {
 
@@ -104,24 +216,23 @@ void printGraphCharateristics(GraphTy& graph) {
  */
 template <typename GraphTy>
 void findNeighboringClusters(GraphTy& graph, typename GraphTy::GraphNode& n,
-                             std::map<uint64_t, uint64_t>& cluster_local_map,
-                             std::vector<EdgeTy>& counter,
+                             ClusterAccumulator& clusters,
                              EdgeTy& self_loop_wt) {
   using GNode = typename GraphTy::GraphNode;
   for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
     graph.getData(graph.getEdgeDst(ii), flag_write_lock);
   }
 
-  uint64_t num_unique_clusters = 0;
+  // cluster ids are node ids, so there are no more clusters than nodes
+  clusters.clear(std::min<size_t>(
+      std::distance(graph.edge_begin(n, flag_no_lock),
+                    graph.edge_end(n, flag_no_lock)) + 1,
+      graph.size()));
   /**
    * Add the node's current cluster to be considered
-   * for movement as well
+   * for movement as well; it gets index 0
    */
-  cluster_local_map[graph.getData(n).curr_comm_ass] =
-      0;                // Add n's current cluster
-  counter.push_back(0); // Initialize the counter to zero (no edges incident
-                        // yet)
-  num_unique_clusters++;
+  clusters.add(graph.getData(n).curr_comm_ass, 0);
 
   // Assuming we have grabbed lock on all the neighbors
   for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
@@ -131,18 +242,11 @@ void findNeighboringClusters(GraphTy& graph, typename GraphTy::GraphNode& n,
     if (dst == n) {
       self_loop_wt += edge_wt; // Self loop weights is recorded
     }
-    auto stored_already = cluster_local_map.find(
-        graph.getData(dst).curr_comm_ass); // Check if it already exists
-    if (stored_already != cluster_local_map.end()) {
-      counter[stored_already->second] += edge_wt;
-    } else {
-      cluster_local_map[graph.getData(dst).curr_comm_ass] = num_unique_clusters;
-      counter.push_back(edge_wt);
-      num_unique_clusters++;
-    }
+    clusters.add(graph.getData(dst).curr_comm_ass, edge_wt);
   } // End edge loop
   return;
 }
+
 template <typename GraphTy>
 uint64_t vertexFollowing(GraphTy& graph) {
   using GNode = typename GraphTy::GraphNode;
@@ -246,36 +350,33 @@ double calConstantForSecondTerm(GraphTy& graph) {
 }
 
 template <typename GraphTy, typename CommArrayTy>
-uint64_t maxCPMQuality(std::map<uint64_t, uint64_t>& cluster_local_map,
-                       std::vector<EdgeTy>& counter, EdgeTy self_loop_wt,
+uint64_t maxCPMQuality(const ClusterAccumulator& clusters, EdgeTy self_loop_wt,
                        CommArrayTy& c_info, uint64_t node_wt, uint64_t sc) {
 
   uint64_t max_index = sc; // Assign the initial value as self community
   double cur_gain    = 0;
   double max_gain    = 0;
-  double eix         = counter[0] - self_loop_wt;
+  double eix         = clusters.weight(0) - self_loop_wt;
   double eiy         = 0;
   double size_x      = (double)(c_info[sc].node_wt - node_wt);
   double size_y      = 0;
 
-  auto stored_already = cluster_local_map.begin();
-  do {
-    if (sc != stored_already->first) {
+  for (size_t i = 0; i < clusters.size(); ++i) {
+    uint64_t y = clusters.cluster(i);
+    if (sc != y) {
 
-      eiy =
-          counter[stored_already->second]; // Total edges incident on cluster y
-      size_y = c_info[stored_already->first].node_wt;
+      eiy    = clusters.weight(i); // Total edges incident on cluster y
+      size_y = c_info[y].node_wt;
 
       cur_gain = 2.0f * (double)(eiy - eix) -
                  resolution * node_wt * (double)(size_y - size_x);
-      if ((cur_gain > max_gain) || ((cur_gain == max_gain) && (cur_gain != 0) &&
-                                    (stored_already->first < max_index))) {
+      if ((cur_gain > max_gain) ||
+          ((cur_gain == max_gain) && (cur_gain != 0) && (y < max_index))) {
         max_gain  = cur_gain;
-        max_index = stored_already->first;
+        max_index = y;
       }
     }
-    stored_already++; // Explore next cluster
-  } while (stored_already != cluster_local_map.end());
+  }
 
   if ((c_info[max_index].size == 1 && c_info[sc].size == 1 && max_index > sc)) {
     max_index = sc;
@@ -331,36 +432,33 @@ double calCPMQuality(GraphTy& graph, CommArrayTy& c_info, double& e_xx,
 }
 
 template <typename CommArrayTy>
-uint64_t maxModularity(std::map<uint64_t, uint64_t>& cluster_local_map,
-                       std::vector<EdgeTy>& counter, EdgeTy self_loop_wt,
+uint64_t maxModularity(const ClusterAccumulator& clusters, EdgeTy self_loop_wt,
                        CommArrayTy& c_info, EdgeTy degree_wt, uint64_t sc,
                        double constant) {
 
   uint64_t max_index = sc; // Assign the intial value as self community
   double cur_gain    = 0;
   double max_gain    = 0;
-  double eix         = counter[0] - self_loop_wt;
+  double eix         = clusters.weight(0) - self_loop_wt;
   double ax          = c_info[sc].degree_wt - degree_wt;
   double eiy         = 0;
   double ay          = 0;
 
-  auto stored_already = cluster_local_map.begin();
-  do {
-    if (sc != stored_already->first) {
-      ay = c_info[stored_already->first].degree_wt; // Degree wt of cluster y
-      eiy =
-          counter[stored_already->second]; // Total edges incident on cluster y
+  for (size_t i = 0; i < clusters.size(); ++i) {
+    uint64_t y = clusters.cluster(i);
+    if (sc != y) {
+      ay       = c_info[y].degree_wt;  // Degree wt of cluster y
+      eiy      = clusters.weight(i); // Total edges incident on cluster y
       cur_gain = 2 * constant * (eiy - eix) +
                  2 * degree_wt * ((ax - ay) * constant * constant);
 
-      if ((cur_gain > max_gain) || ((cur_gain == max_gain) && (cur_gain != 0) &&
-                                    (stored_already->first < max_index))) {
+      if ((cur_gain > max_gain) ||
+          ((cur_gain == max_gain) && (cur_gain != 0) && (y < max_index))) {
         max_gain  = cur_gain;
-        max_index = stored_already->first;
+        max_index = y;
       }
     }
-    stored_already++; // Explore next cluster
-  } while (stored_already != cluster_local_map.end());
+  }
 
   if ((c_info[max_index].size == 1 && c_info[sc].size == 1 && max_index > sc)) {
     max_index = sc;
@@ -372,45 +470,41 @@ uint64_t maxModularity(std::map<uint64_t, uint64_t>& cluster_local_map,
 
 template <typename CommArrayTy>
 uint64_t
-maxModularityWithoutSwaps(std::map<uint64_t, uint64_t>& cluster_local_map,
-                          std::vector<EdgeTy>& counter, uint64_t self_loop_wt,
+maxModularityWithoutSwaps(const ClusterAccumulator& clusters,
+                          uint64_t self_loop_wt,
                           CommArrayTy& c_info, EdgeTy degree_wt, uint64_t sc,
                           double constant) {
 
   uint64_t max_index = sc; // Assign the intial value as self community
   double cur_gain    = 0;
   double max_gain    = 0;
-  double eix         = counter[0] - self_loop_wt;
+  double eix         = clusters.weight(0) - self_loop_wt;
   double ax          = c_info[sc].degree_wt - degree_wt;
   double eiy         = 0;
   double ay          = 0;
 
-  auto stored_already = cluster_local_map.begin();
-  do {
-    if (sc != stored_already->first) {
-      ay = c_info[stored_already->first].degree_wt; // Degree wt of cluster y
+  for (size_t i = 0; i < clusters.size(); ++i) {
+    uint64_t y = clusters.cluster(i);
+    if (sc != y) {
+      ay = c_info[y].degree_wt; // Degree wt of cluster y
 
       if (ay < (ax + degree_wt)) {
-        stored_already++;
         continue;
-      } else if (ay == (ax + degree_wt) && stored_already->first > sc) {
-        stored_already++;
+      } else if (ay == (ax + degree_wt) && y > sc) {
         continue;
       }
 
-      eiy =
-          counter[stored_already->second]; // Total edges incident on cluster y
+      eiy      = clusters.weight(i); // Total edges incident on cluster y
       cur_gain = 2 * constant * (eiy - eix) +
                  2 * degree_wt * ((ax - ay) * constant * constant);
 
-      if ((cur_gain > max_gain) || ((cur_gain == max_gain) && (cur_gain != 0) &&
-                                    (stored_already->first < max_index))) {
+      if ((cur_gain > max_gain) ||
+          ((cur_gain == max_gain) && (cur_gain != 0) && (y < max_index))) {
         max_gain  = cur_gain;
-        max_index = stored_already->first;
+        max_index = y;
       }
     }
-    stored_already++; // Explore next cluster
-  } while (stored_already != cluster_local_map.end());
+  }
 
   if ((c_info[max_index].size == 1 && c_info[sc].size == 1 && max_index > sc)) {
     max_index = sc;
@@ -575,21 +669,18 @@ double calModularityFinal(GraphTy& graph) {
 template <typename GraphTy>
 uint64_t renumberClustersContiguously(GraphTy& graph) {
   using GNode = typename GraphTy::GraphNode;
-  std::map<uint64_t, uint64_t> cluster_local_map;
+  // Cluster ids are node ids, so a dense array maps them to new ids
+  std::vector<uint64_t> new_ids(graph.size(), UNASSIGNED);
   uint64_t num_unique_clusters = 0;
 
   for (GNode n = 0; n < graph.size(); ++n) {
     auto& n_data = graph.getData(n, flag_no_lock);
     if (n_data.curr_comm_ass != UNASSIGNED) {
       assert(n_data.curr_comm_ass < graph.size());
-      auto stored_already = cluster_local_map.find(n_data.curr_comm_ass);
-      if (stored_already != cluster_local_map.end()) {
-        n_data.curr_comm_ass = stored_already->second;
-      } else {
-        cluster_local_map[n_data.curr_comm_ass] = num_unique_clusters;
-        n_data.curr_comm_ass                    = num_unique_clusters;
-        num_unique_clusters++;
-      }
+      uint64_t& new_id = new_ids[n_data.curr_comm_ass];
+      if (new_id == UNASSIGNED)
+        new_id = num_unique_clusters++;
+      n_data.curr_comm_ass = new_id;
     }
   }
   return num_unique_clusters;
@@ -599,21 +690,17 @@ template <typename GraphTy>
 uint64_t renumberClustersContiguouslySubcomm(GraphTy& graph) {
 
   using GNode = typename GraphTy::GraphNode;
-  std::map<uint64_t, uint64_t> cluster_local_map;
+  std::vector<uint64_t> new_ids(graph.size(), UNASSIGNED);
   uint64_t num_unique_clusters = 0;
 
   for (GNode n = 0; n < graph.size(); ++n) {
     auto& n_data = graph.getData(n, flag_no_lock);
     assert(n_data.curr_subcomm_ass != UNASSIGNED);
     assert(n_data.curr_subcomm_ass < graph.size());
-    auto stored_already = cluster_local_map.find(n_data.curr_subcomm_ass);
-    if (stored_already != cluster_local_map.end()) {
-      n_data.curr_subcomm_ass = stored_already->second;
-    } else {
-      cluster_local_map[n_data.curr_subcomm_ass] = num_unique_clusters;
-      n_data.curr_subcomm_ass                    = num_unique_clusters;
-      num_unique_clusters++;
-    }
+    uint64_t& new_id = new_ids[n_data.curr_subcomm_ass];
+    if (new_id == UNASSIGNED)
+      new_id = num_unique_clusters++;
+    n_data.curr_subcomm_ass = new_id;
   }
 
   return num_unique_clusters;
@@ -622,20 +709,16 @@ uint64_t renumberClustersContiguouslySubcomm(GraphTy& graph) {
 template <typename GraphTy>
 uint64_t renumberClustersContiguouslyArray(largeArray& arr) {
   using GNode = typename GraphTy::GraphNode;
-  std::map<uint64_t, uint64_t> cluster_local_map;
+  std::vector<uint64_t> new_ids(arr.size(), UNASSIGNED);
   uint64_t num_unique_clusters = 0;
 
   for (GNode n = 0; n < arr.size(); ++n) {
     if (arr[n] != UNASSIGNED) {
       assert(arr[n] < arr.size());
-      auto stored_already = cluster_local_map.find(arr[n]);
-      if (stored_already != cluster_local_map.end()) {
-        arr[n] = stored_already->second;
-      } else {
-        cluster_local_map[arr[n]] = num_unique_clusters;
-        arr[n]                    = num_unique_clusters;
-        num_unique_clusters++;
-      }
+      uint64_t& new_id = new_ids[arr[n]];
+      if (new_id == UNASSIGNED)
+        new_id = num_unique_clusters++;
+      arr[n] = new_id;
     }
   }
   return num_unique_clusters;
@@ -700,16 +783,15 @@ uint64_t generateRandonNumberDouble(double min, double max) {
 
 template <typename CommArrayTy>
 double diffCPMQuality(uint64_t curr_subcomm, uint64_t candidate_subcomm,
-                      std::map<uint64_t, uint64_t>& cluster_local_map,
-                      std::vector<EdgeTy>& counter, CommArrayTy& subcomm_info,
-                      EdgeTy self_loop_wt) {
+                      const ClusterAccumulator& clusters,
+                      CommArrayTy& subcomm_info, EdgeTy self_loop_wt) {
 
   uint64_t size_x = subcomm_info[curr_subcomm].node_wt;
   uint64_t size_y = subcomm_info[candidate_subcomm].node_wt;
 
   double diff =
-      (double)(counter[cluster_local_map[candidate_subcomm]] -
-               counter[cluster_local_map[curr_subcomm]] + self_loop_wt) +
+      (double)(clusters.weightOf(candidate_subcomm) -
+               clusters.weightOf(curr_subcomm) + self_loop_wt) +
       resolution * 0.5f *
           (double)((size_x * (size_x - 1) + size_y * (size_y - 1)) -
                    ((size_x - 1) * (size_x - 2) + size_y * (size_y + 1)));
@@ -721,19 +803,18 @@ template <typename GraphTy, typename CommArrayTy>
 uint64_t getRandomSubcommunity(GraphTy& graph, uint64_t n,
                                CommArrayTy& subcomm_info,
                                uint64_t total_degree_wt,
-                               double constant_for_second_term) {
+                               double constant_for_second_term,
+                               ClusterAccumulator& clusters) {
   using GNode           = typename GraphTy::GraphNode;
   uint64_t curr_subcomm = graph.getData(n).curr_subcomm_ass;
 
-  std::map<uint64_t, uint64_t>
-      cluster_local_map; // Map each neighbor's subcommunity to local number:
-                         // Subcommunity --> Index
-  std::vector<EdgeTy> counter; // Number of edges to each unique subcommunity
-  uint64_t num_unique_clusters = 1;
-
-  cluster_local_map[curr_subcomm] = 0; // Add n's current subcommunity
-  counter.push_back(0); // Initialize the counter to zero (no edges incident
-                        // yet)
+  /*
+   * Number of edges to each unique subcommunity, starting with n's current
+   * subcommunity (no edges incident yet)
+   */
+  clusters.clear(std::min<size_t>(
+      std::distance(graph.edge_begin(n), graph.edge_end(n)) + 1, graph.size()));
+  clusters.add(curr_subcomm, 0);
 
   EdgeTy self_loop_wt = 0;
 
@@ -745,25 +826,14 @@ uint64_t getRandomSubcommunity(GraphTy& graph, uint64_t n,
     if (dst == n) {
       self_loop_wt += edge_wt; // Self loop weights is recorded
     }
-    auto stored_already = cluster_local_map.find(
-        graph.getData(dst).curr_subcomm_ass); // Check if it already exists
-    if (stored_already != cluster_local_map.end()) {
-      counter[stored_already->second] += edge_wt;
-    } else {
-      cluster_local_map[graph.getData(dst).curr_subcomm_ass] =
-          num_unique_clusters;
-      counter.push_back(edge_wt);
-      num_unique_clusters++;
-    }
+    clusters.add(graph.getData(dst).curr_subcomm_ass, edge_wt);
   } // End edge loop
 
-  std::map<uint64_t, uint64_t> new_cluster_local_map;
-  std::vector<EdgeTy> new_counter;
-  num_unique_clusters = 0;
-  EdgeTy total        = 0;
+  // Candidates are considered in the order of their ids
+  std::vector<std::pair<uint64_t, EdgeTy>> candidates;
 
-  for (auto pair : cluster_local_map) {
-    auto subcomm = pair.first;
+  for (size_t i = 0; i < clusters.size(); ++i) {
+    auto subcomm = clusters.cluster(i);
     if (curr_subcomm == subcomm)
       continue;
     uint64_t subcomm_degree_wt = subcomm_info[subcomm].degree_wt;
@@ -773,24 +843,20 @@ uint64_t getRandomSubcommunity(GraphTy& graph, uint64_t n,
         constant_for_second_term * (double)subcomm_degree_wt *
             ((double)total_degree_wt - (double)subcomm_degree_wt))
       continue;
-    if (diffCPMQuality(curr_subcomm, subcomm, cluster_local_map, counter,
-                       subcomm_info, self_loop_wt) > 0) {
-      new_cluster_local_map[subcomm] = num_unique_clusters;
-      EdgeTy count                   = counter[cluster_local_map[subcomm]];
-      new_counter.push_back(count);
-      total += count;
+    if (diffCPMQuality(curr_subcomm, subcomm, clusters, subcomm_info,
+                       self_loop_wt) > 0) {
+      candidates.emplace_back(subcomm, clusters.weight(i));
     }
   }
+  std::sort(candidates.begin(), candidates.end());
 
   // Pick max community size
   uint64_t rand_idx = 1; // getRandomInt(0,total-1);
 
-  uint64_t idx = 0;
-  for (auto pair : new_cluster_local_map) {
-    if (new_counter[idx] > rand_idx)
+  for (auto pair : candidates) {
+    if (pair.second > rand_idx)
       return pair.first;
-    rand_idx = rand_idx - new_counter[idx];
-    idx++;
+    rand_idx = rand_idx - pair.second;
   }
 
   return UNASSIGNED;
@@ -800,7 +866,8 @@ template <typename GraphTy, typename CommTy>
 uint64_t getRandomSubcommunity2(GraphTy& graph, typename GraphTy::GraphNode n,
                                 CommTy& subcomm_info, uint64_t total_degree_wt,
                                 uint64_t comm_id,
-                                double constant_for_second_term) {
+                                double constant_for_second_term,
+                                ClusterAccumulator& clusters) {
   using GNode  = typename GraphTy::GraphNode;
   auto& n_data = graph.getData(n);
   /*
@@ -810,17 +877,6 @@ uint64_t getRandomSubcommunity2(GraphTy& graph, typename GraphTy::GraphNode n,
   subcomm_info[n_data.curr_subcomm_ass].node_wt          = 0;
   subcomm_info[n_data.curr_subcomm_ass].internal_edge_wt = 0;
 
-  /*
-   * Map each neighbor's subcommunity to local number: Subcommunity --> Index
-   */
-  std::map<uint64_t, uint64_t> cluster_local_map;
-
-  /*
-   * Edges weight to each unique subcommunity
-   */
-  std::vector<EdgeTy> counter;
-  std::vector<uint64_t> neighboring_cluster_ids;
-
   /*
    * Identify the neighboring clusters of the currently selected
    * node, that is, the clusters with which the currently
@@ -828,14 +884,12 @@ uint64_t getRandomSubcommunity2(GraphTy& graph, typename GraphTy::GraphNode n,
    * selected node is also included in the set of neighboring
    * clusters. In this way, it is always possible that the
    * currently selected node will be moved back to its old
-   * cluster.
+   * cluster. Edge weights are summed per subcommunity, indexed in the
+   * order the subcommunities are found, starting with n's current one.
    */
-  cluster_local_map[n_data.curr_subcomm_ass] = 0; // Add n's current
-                                                  // subcommunity
-  counter.push_back(0); // Initialize the counter to zero (no edges incident
-                        // yet)
-  neighboring_cluster_ids.push_back(n_data.curr_subcomm_ass);
-  uint64_t num_unique_clusters = 1;
+  clusters.clear(std::min<size_t>(
+      std::distance(graph.edge_begin(n), graph.edge_end(n)) + 1, graph.size()));
+  clusters.add(n_data.curr_subcomm_ass, 0);
 
   EdgeTy self_loop_wt = 0;
 
@@ -847,28 +901,20 @@ uint64_t getRandomSubcommunity2(GraphTy& graph, typename GraphTy::GraphNode n,
       if (dst == n) {
         self_loop_wt += edge_wt; // Self loop weights is recorded
       }
-      auto stored_already = cluster_local_map.find(
-          graph.getData(dst).curr_subcomm_ass); // Check if it already exists
-      if (stored_already != cluster_local_map.end()) {
-        counter[stored_already->second] += edge_wt;
-      } else {
-        cluster_local_map[graph.getData(dst).curr_subcomm_ass] =
-            num_unique_clusters;
-        counter.push_back(edge_wt);
-        neighboring_cluster_ids.push_back(graph.getData(dst).curr_subcomm_ass);
-        num_unique_clusters++;
-      }
+      clusters.add(graph.getData(dst).curr_subcomm_ass, edge_wt);
     }
   } // End edge loop
 
+  uint64_t num_unique_clusters = clusters.size();
+
   uint64_t best_cluster                            = n_data.curr_subcomm_ass;
   double max_quality_value_increment               = 0;
   double total_transformed_quality_value_increment = 0;
   double quality_value_increment                   = 0;
   std::vector<double> cum_transformed_quality_value_increment_per_cluster(
       num_unique_clusters);
-  for (auto pair : cluster_local_map) {
-    auto subcomm = pair.first;
+  for (uint64_t i = 0; i < num_unique_clusters; ++i) {
+    auto subcomm = clusters.cluster(i);
     if (n_data.curr_subcomm_ass == subcomm)
       continue;
 
@@ -880,10 +926,14 @@ uint64_t getRandomSubcommunity2(GraphTy& graph, typename GraphTy::GraphNode n,
         constant_for_second_term * (double)subcomm_degree_wt *
             ((double)total_degree_wt - (double)subcomm_degree_wt)) {
 
-      quality_value_increment =
-          counter[pair.second] - n_data.node_wt * subcomm_node_wt * resolution;
+      quality_value_increment = clusters.weight(i) - n_data.node_wt *
+                                                         subcomm_node_wt *
+                                                         resolution;
 
-      if (quality_value_increment > max_quality_value_increment) {
+      // ties go to the smallest subcommunity id
+      if (quality_value_increment > max_quality_value_increment ||
+          (quality_value_increment == max_quality_value_increment &&
+           quality_value_increment > 0 && subcomm < best_cluster)) {
         best_cluster                = subcomm;
         max_quality_value_increment = quality_value_increment;
       }
@@ -892,9 +942,8 @@ uint64_t getRandomSubcommunity2(GraphTy& graph, typename GraphTy::GraphNode n,
         total_transformed_quality_value_increment +=
             std::exp(quality_value_increment / randomness);
     }
-    cum_transformed_quality_value_increment_per_cluster[pair.second] =
+    cum_transformed_quality_value_increment_per_cluster[i] =
         total_transformed_quality_value_increment;
-    counter[pair.second] = 0;
   }
 
   /*
@@ -916,7 +965,7 @@ uint64_t getRandomSubcommunity2(GraphTy& graph, typename GraphTy::GraphNode n,
       else
         min_idx = mid_idx;
     }
-    chosen_cluster = neighboring_cluster_ids[max_idx];
+    chosen_cluster = clusters.cluster(max_idx);
   } else {
     chosen_cluster = best_cluster;
   }
@@ -952,7 +1001,8 @@ template <typename GraphTy, typename CommTy>
 void mergeNodesSubset(GraphTy& graph,
                       std::vector<typename GraphTy::GraphNode>& cluster_nodes,
                       uint64_t comm_id, uint64_t total_degree_wt,
-                      CommTy& subcomm_info, double constant_for_second_term) {
+                      CommTy& subcomm_info, double constant_for_second_term,
+                      ClusterAccumulator& clusters) {
 
   using GNode = typename GraphTy::GraphNode;
 
@@ -1004,7 +1054,7 @@ void mergeNodesSubset(GraphTy& graph,
     if (subcomm_info[n_data.curr_subcomm_ass].size == 1) {
       uint64_t new_subcomm_ass =
           getRandomSubcommunity2(graph, n, subcomm_info, total_degree_wt,
-                                 comm_id, constant_for_second_term);
+                                 comm_id, constant_for_second_term, clusters);
 
       if ((int64_t)new_subcomm_ass != -1 &&
           new_subcomm_ass != graph.getData(n).curr_subcomm_ass) {
@@ -1080,6 +1130,7 @@ void refinePartition(GraphTy& graph, double constant_for_second_term) {
   CommArray subcomm_info;
 
   subcomm_info.allocateBlocked(graph.size() + 1);
+  ClusterAccumulators accumulators;
 
   // call mergeNodesSubset for each community in parallel
   galois::do_all(galois::iterate((uint64_t)0, (uint64_t)graph.size()),
@@ -1094,7 +1145,8 @@ void refinePartition(GraphTy& graph, double constant_for_second_term) {
                      // comm_info[c].num_subcomm =
                      mergeNodesSubset<GraphTy, CommArray>(
                          graph, cluster_bags[c], c, comm_info[c].degree_wt,
-                         subcomm_info, constant_for_second_term);
+                         subcomm_info, constant_for_second_term,
+                         *accumulators.getLocal());
                    } else {
                      comm_info[c].num_subcomm = 0;
                    }
@@ -1128,13 +1180,18 @@ void buildNextLevelGraph(GraphTy& graph, GraphTy& graph_next,
 
   std::vector<std::vector<uint32_t>> edges_id(num_unique_clusters);
   std::vector<std::vector<EdgeTy>> edges_data(num_unique_clusters);
+  ClusterAccumulators accumulators;
 
   /* First pass to find the number of edges */
   galois::do_all(
       galois::iterate((uint64_t)0, num_unique_clusters),
       [&](uint64_t c) {
-        std::map<uint64_t, uint64_t> cluster_local_map;
-        uint64_t num_unique_clusters = 0;
+        ClusterAccumulator& clusters = *accumulators.getLocal();
+        uint64_t num_bag_edges       = 0;
+        for (GNode n : cluster_bags[c])
+          num_bag_edges += std::distance(graph.edge_begin(n, flag_no_lock),
+                                         graph.edge_end(n, flag_no_lock));
+        clusters.clear(std::min(num_bag_edges, num_unique_clusters));
         for (auto cb_ii = cluster_bags[c].begin();
              cb_ii != cluster_bags[c].end(); ++cb_ii) {
 
@@ -1146,22 +1203,16 @@ void buildNextLevelGraph(GraphTy& graph, GraphTy& graph_next,
             GNode dst     = graph.getEdgeDst(ii);
             auto dst_data = graph.getData(dst, flag_no_lock);
             assert(dst_data.curr_comm_ass != UNASSIGNED);
-            auto stored_already = cluster_local_map.find(
-                dst_data.curr_comm_ass); // Check if it already exists
-            if (stored_already != cluster_local_map.end()) {
-              edges_data[c][stored_already->second] += graph.getEdgeData(ii);
-            } else {
-              cluster_local_map[dst_data.curr_comm_ass] = num_unique_clusters;
-              edges_id[c].push_back(dst_data.curr_comm_ass);
-              edges_data[c].push_back(graph.getEdgeData(ii));
-              num_unique_clusters++;
-            }
+            clusters.add(dst_data.curr_comm_ass, graph.getEdgeData(ii));
           } // End edge loop
         }
+        edges_id[c].assign(clusters.clusters().begin(),
+                           clusters.clusters().end());
+        edges_data[c] = clusters.clusterWeights();
       },
       galois::steal(), galois::loopname("BuildGrah: Find edges"));
 
-  /* Serial loop to reduce all the edge counts */
+  /* Reduce all the edge counts */
   std::vector<uint64_t> prefix_edges_count(num_unique_clusters);
   galois::GAccumulator<uint64_t> num_edges_acc;
   galois::do_all(galois::iterate((uint32_t)0, num_nodes_next), [&](uint32_t c) {
@@ -1170,9 +1221,9 @@ void buildNextLevelGraph(GraphTy& graph, GraphTy& graph_next,
   });
 
   num_edges_next = num_edges_acc.reduce();
-  for (uint32_t c = 1; c < num_nodes_next; ++c) {
-    prefix_edges_count[c] += prefix_edges_count[c - 1];
-  }
+  galois::ParallelSTL::partial_sum(prefix_edges_count.begin(),
+                                   prefix_edges_count.begin() + num_nodes_next,
+                                   prefix_edges_count.begin());
 
   assert(prefix_edges_count[num_unique_clusters - 1] == num_edges_next);
   galois::gPrint("#nodes : ", num_nodes_next, ", #edges : ", num_edges_next,
@@ -1214,13 +1265,18 @@ void buildNextLevelGraphSubComm(GraphTy& graph, GraphTy& graph_next,
 
   std::vector<std::vector<uint32_t>> edges_id(num_unique_clusters);
   std::vector<std::vector<EdgeTy>> edges_data(num_unique_clusters);
+  ClusterAccumulators accumulators;
 
   /* First pass to find the number of edges */
   galois::do_all(
       galois::iterate((uint64_t)0, num_unique_clusters),
       [&](uint64_t c) {
-        std::map<uint64_t, uint64_t> cluster_local_map;
-        uint64_t num_unique_clusters = 0;
+        ClusterAccumulator& clusters = *accumulators.getLocal();
+        uint64_t num_bag_edges       = 0;
+        for (GNode n : cluster_bags[c])
+          num_bag_edges += std::distance(graph.edge_begin(n, flag_no_lock),
+                                         graph.edge_end(n, flag_no_lock));
+        clusters.clear(std::min(num_bag_edges, num_unique_clusters));
         for (auto cb_ii = cluster_bags[c].begin();
              cb_ii != cluster_bags[c].end(); ++cb_ii) {
 
@@ -1232,23 +1288,16 @@ void buildNextLevelGraphSubComm(GraphTy& graph, GraphTy& graph_next,
             GNode dst     = graph.getEdgeDst(ii);
             auto dst_data = graph.getData(dst, flag_no_lock);
             assert(dst_data.curr_subcomm_ass != UNASSIGNED);
-            auto stored_already = cluster_local_map.find(
-                dst_data.curr_subcomm_ass); // Check if it already exists
-            if (stored_already != cluster_local_map.end()) {
-              edges_data[c][stored_already->second] += graph.getEdgeData(ii);
-            } else {
-              cluster_local_map[dst_data.curr_subcomm_ass] =
-                  num_unique_clusters;
-              edges_id[c].push_back(dst_data.curr_subcomm_ass);
-              edges_data[c].push_back(graph.getEdgeData(ii));
-              num_unique_clusters++;
-            }
+            clusters.add(dst_data.curr_subcomm_ass, graph.getEdgeData(ii));
           } // End edge loop
         }
+        edges_id[c].assign(clusters.clusters().begin(),
+                           clusters.clusters().end());
+        edges_data[c] = clusters.clusterWeights();
       },
       galois::steal(), galois::loopname("BuildGrah: Find edges"));
 
-  /* Serial loop to reduce all the edge counts */
+  /* Reduce all the edge counts */
   std::vector<uint64_t> prefix_edges_count(num_unique_clusters);
   galois::GAccumulator<uint64_t> num_edges_acc;
   galois::do_all(galois::iterate((uint32_t)0, num_nodes_next), [&](uint32_t c) {
@@ -1257,9 +1306,9 @@ void buildNextLevelGraphSubComm(GraphTy& graph, GraphTy& graph_next,
   });
 
   num_edges_next = num_edges_acc.reduce();
-  for (uint32_t c = 1; c < num_nodes_next; ++c) {
-    prefix_edges_count[c] += prefix_edges_count[c - 1];
-  }
+  galois::ParallelSTL::partial_sum(prefix_edges_count.begin(),
+                                   prefix_edges_count.begin() + num_nodes_next,
+                                   prefix_edges_count.begin());
 
   assert(prefix_edges_count[num_unique_clusters - 1] == num_edges_next);
   galois::gPrint("#nodes : ", num_nodes_next, ", #edges : ", num_edges_next,
@@ -87,6 +87,7 @@ double algoLeidenWithLocking(Graph& graph, double lower, double threshold,
 
   CommArray c_info;   // Community info
   CommArray c_update; // Used for updating community
+  ClusterAccumulators accumulators; // Per-thread neighbor cluster weights
 
   /* Variables needed for Modularity calculation */
   double constant_for_second_term;
@@ -146,21 +147,17 @@ double algoLeidenWithLocking(Graph& graph, double lower, double threshold,
                                           graph.edge_end(n, flag_write_lock));
 
           uint64_t local_target = UNASSIGNED;
-          std::map<uint64_t, uint64_t>
-              cluster_local_map; // Map each neighbor's cluster to local number:
-                                 // Community --> Index
-          std::vector<EdgeTy> counter; // Number of edges to each unique cluster
+          ClusterAccumulator& clusters = *accumulators.getLocal();
           EdgeTy self_loop_wt = 0;
 
           if (degree > 0) {
-            findNeighboringClusters(graph, n, cluster_local_map, counter,
-                                    self_loop_wt);
+            findNeighboringClusters(graph, n, clusters, self_loop_wt);
             local_target =
-                maxModularity(cluster_local_map, counter, self_loop_wt, c_info,
+                maxModularity(clusters, self_loop_wt, c_info,
                               n_data.degree_wt, n_data.curr_comm_ass,
                               constant_for_second_term);
-            // local_target = maxCPMQuality<Graph, CommArray>(cluster_local_map,
-            // counter, self_loop_wt, c_info, n_data.node_wt,
+            // local_target = maxCPMQuality<Graph, CommArray>(clusters,
+            // self_loop_wt, c_info, n_data.node_wt,
             // n_data.curr_comm_ass);
           } else {
             local_target = UNASSIGNED;
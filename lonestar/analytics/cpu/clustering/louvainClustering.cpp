@@ -88,6 +88,7 @@ double algoLouvainWithLocking(Graph& graph, double lower, double threshold,
 
   CommArray c_info;   // Community info
   CommArray c_update; // Used for updating community
+  ClusterAccumulators accumulators; // Per-thread neighbor cluster weights
 
   /* Variables needed for Modularity calculation */
   double constant_for_second_term;
@@ -139,18 +140,14 @@ double algoLouvainWithLocking(Graph& graph, double lower, double threshold,
           uint64_t degree = std::distance(graph.edge_begin(n, flag_write_lock),
                                           graph.edge_end(n, flag_write_lock));
           uint64_t local_target = UNASSIGNED;
-          std::map<uint64_t, uint64_t>
-              cluster_local_map; // Map each neighbor's cluster to local number:
-                                 // Community --> Index
-          std::vector<EdgeTy> counter; // Number of edges to each unique cluster
+          ClusterAccumulator& clusters = *accumulators.getLocal();
           EdgeTy self_loop_wt = 0;
           if (degree > 0) {
 
-            findNeighboringClusters(graph, n, cluster_local_map, counter,
-                                    self_loop_wt);
+            findNeighboringClusters(graph, n, clusters, self_loop_wt);
             // Find the max gain in modularity
             local_target =
-                maxModularity(cluster_local_map, counter, self_loop_wt, c_info,
+                maxModularity(clusters, self_loop_wt, c_info,
                               n_data.degree_wt, n_data.curr_comm_ass,
                               constant_for_second_term);
 
@@ -219,6 +216,7 @@ double algoLouvainWithoutLockingDoAll(Graph& graph, double lower,
 
   CommArray c_info;   // Community info
   CommArray c_update; // Used for updating community
+  ClusterAccumulators accumulators; // Per-thread neighbor cluster weights
 
   /* Variables needed for Modularity calculation */
   double constant_for_second_term;
@@ -271,18 +269,14 @@ double algoLouvainWithoutLockingDoAll(Graph& graph, double lower,
           uint64_t degree = std::distance(graph.edge_begin(n, flag_no_lock),
                                           graph.edge_end(n, flag_no_lock));
           uint64_t local_target = UNASSIGNED;
-          std::map<uint64_t, uint64_t>
-              cluster_local_map; // Map each neighbor's cluster to local number:
-                                 // Community --> Index
-          std::vector<EdgeTy> counter; // Number of edges to each unique cluster
+          ClusterAccumulator& clusters = *accumulators.getLocal();
           EdgeTy self_loop_wt = 0;
 
           if (degree > 0) {
-            findNeighboringClusters(graph, n, cluster_local_map, counter,
-                                    self_loop_wt);
+            findNeighboringClusters(graph, n, clusters, self_loop_wt);
             // Find the max gain in modularity
             local_target = maxModularityWithoutSwaps(
-                cluster_local_map, counter, self_loop_wt, c_info,
+                clusters, self_loop_wt, c_info,
                 n_data.degree_wt, n_data.curr_comm_ass,
                 constant_for_second_term);
 
@@ -350,6 +344,7 @@ double algoLouvainWithLockingDelayUpdate(Graph& graph, double lower,
 
   CommArray c_info;   // Community info
   CommArray c_update; // Used for updating community
+  ClusterAccumulators accumulators; // Per-thread neighbor cluster weights
 
   /* Variables needed for Modularity calculation */
   double constant_for_second_term;
@@ -403,18 +398,14 @@ double algoLouvainWithLockingDelayUpdate(Graph& graph, double lower,
           auto& n_data    = graph.getData(n, flag_write_lock);
           uint64_t degree = std::distance(graph.edge_begin(n, flag_no_lock),
                                           graph.edge_end(n, flag_no_lock));
-          std::map<uint64_t, uint64_t>
-              cluster_local_map; // Map each neighbor's cluster to local number:
-                                 // Community --> Index
-          std::vector<EdgeTy> counter; // Number of edges to each unique cluster
+          ClusterAccumulator& clusters = *accumulators.getLocal();
           EdgeTy self_loop_wt = 0;
 
           if (degree > 0) {
-            findNeighboringClusters(graph, n, cluster_local_map, counter,
-                                    self_loop_wt);
+            findNeighboringClusters(graph, n, clusters, self_loop_wt);
             // Find the max gain in modularity
             local_target[n] =
-                maxModularity(cluster_local_map, counter, self_loop_wt, c_info,
+                maxModularity(clusters, self_loop_wt, c_info,
                               n_data.degree_wt, n_data.curr_comm_ass,
                               constant_for_second_term);
           } else {
@@ -573,6 +564,7 @@ double algoLouvainWithColoring(Graph& graph, double lower, double threshold,
 
   CommArray c_info;   // Community info
   CommArray c_update; // Used for updating community
+  ClusterAccumulators accumulators; // Per-thread neighbor cluster weights
 
   /* Variables needed for Modularity calculation */
   double constant_for_second_term;
@@ -634,19 +626,14 @@ double algoLouvainWithColoring(Graph& graph, double lower, double threshold,
               uint64_t degree = std::distance(graph.edge_begin(n, flag_no_lock),
                                               graph.edge_end(n, flag_no_lock));
               uint64_t local_target = UNASSIGNED;
-              std::map<uint64_t, uint64_t>
-                  cluster_local_map; // Map each neighbor's cluster to local
-                                     // number: Community --> Index
-              std::vector<EdgeTy>
-                  counter; // Number of edges to each unique cluster
+              ClusterAccumulator& clusters = *accumulators.getLocal();
               EdgeTy self_loop_wt = 0;
 
               if (degree > 0) {
-                findNeighboringClusters(graph, n, cluster_local_map, counter,
-                                        self_loop_wt);
+                findNeighboringClusters(graph, n, clusters, self_loop_wt);
                 // Find the max gain in modularity
                 local_target = maxModularity(
-                    cluster_local_map, counter, self_loop_wt, c_info,
+                    clusters, self_loop_wt, c_info,
                     n_data.degree_wt, n_data.curr_comm_ass,
                     constant_for_second_term);
               } else {
@@ -24,6 +24,8 @@
 #include "galois/Reduction.h"
 #include "galois/Timer.h"
 #include "galois/UnionFind.h"
+#include "galois/UnionFindArray.h"
+#include "galois/graphs/Frontier.h"
 #include "galois/graphs/LCGraph.h"
 #include "galois/graphs/OCGraph.h"
 #include "galois/graphs/TypeTraits.h"
@@ -32,6 +34,7 @@
 
 #include "llvm/Support/CommandLine.h"
 
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include <algorithm>
@@ -56,6 +59,7 @@ enum Algo {
   afforest,
   edgeafforest,
   edgetiledafforest,
+  incremental,
 };
 
 static cll::opt<std::string>
@@ -76,11 +80,23 @@ static cll::opt<Algo> algo(
         clEnumValN(Algo::edgeafforest, "EdgeAfforest",
                    "Using Afforest sampling, Edge-wise"),
         clEnumValN(Algo::edgetiledafforest, "EdgetiledAfforest",
-                   "Using Afforest sampling, EdgeTiled")
+                   "Using Afforest sampling, EdgeTiled"),
+        clEnumValN(Algo::incremental, "Incremental",
+                   "Union-find absorbing the edges in batches")
 
             ),
     cll::init(Algo::edgetiledasync));
 
+enum GraphType { csr, compressed };
+
+static cll::opt<GraphType> graphType(
+    "graphType", cll::desc("Graph representation:"),
+    cll::values(clEnumValN(GraphType::csr, "CSR", "CSR (default)"),
+                clEnumValN(GraphType::compressed, "Compressed",
+                           "Varint gap-compressed adjacency lists, read from "
+                           ".gr or .vgr (LabelProp only)")),
+    cll::init(GraphType::csr));
+
 static cll::opt<std::string>
     largestComponentFilename("outputLargestComponent",
                              cll::desc("[output graph file]"), cll::init(""));
@@ -131,6 +147,13 @@ static cll::opt<uint32_t> COMPONENT_SAMPLES(
               "(default 1024)"),
     // cll::cat(ParamCat),
     cll::init(1024));
+//! parameter for the Incremental algorithm
+static cll::opt<uint32_t> INCREMENTAL_BATCHES(
+    "incrementalBatches",
+    cll::desc("(For Incremental) number of batches the edges are inserted "
+              "in (default 8)"),
+    // cll::cat(ParamCat),
+    cll::init(8));
 
 struct Node : public galois::UnionFindNode<Node> {
   using component_type = Node*;
@@ -148,8 +171,6 @@ struct Node : public galois::UnionFindNode<Node> {
   bool isRepComp(unsigned int) { return false; }
 };
 
-const unsigned int LABEL_INF = std::numeric_limits<unsigned int>::max();
-
 /**
  * Serial connected components algorithm. Just use union-find.
  */
@@ -180,52 +201,67 @@ struct SerialAlgo {
   }
 };
 
+/**
+ * Label propagation. With Compressed, the graph is an LC_Compressed_Graph,
+ * which trades decoding work for less memory traffic per edge.
+ */
+template <bool Compressed>
 struct LabelPropAlgo {
 
   struct LNode {
     using component_type = unsigned int;
     std::atomic<unsigned int> comp_current;
-    unsigned int comp_old;
 
     component_type component() { return comp_current; }
     bool isRep() { return false; }
     bool isRepComp(unsigned int x) { return x == comp_current; }
   };
 
-  using Graph =
-      galois::graphs::LC_CSR_Graph<LNode, void>::with_no_lockable<true>::type;
-  using GNode          = Graph::GraphNode;
-  using component_type = LNode::component_type;
+  using Graph = typename std::conditional<
+      Compressed, galois::graphs::LC_Compressed_Graph<LNode, void>,
+      galois::graphs::LC_CSR_Graph<LNode, void>>::type::
+      template with_no_lockable<true>::type;
+  using GNode          = typename Graph::GraphNode;
+  using component_type = typename LNode::component_type;
 
   template <typename G>
   void readGraph(G& graph) {
     galois::graphs::readGraph(graph, inputFile);
   }
 
-  void operator()(Graph& graph) {
-    galois::GReduceLogicalOr changed;
-    do {
-      changed.reset();
-      galois::do_all(
-          galois::iterate(graph),
-          [&](const GNode& src) {
-            LNode& sdata = graph.getData(src, galois::MethodFlag::UNPROTECTED);
-            if (sdata.comp_old > sdata.comp_current) {
-              sdata.comp_old = sdata.comp_current;
+  //! Lowers the label of dst to that of src; dst is active again if it did
+  struct MinLabel {
+    Graph& graph;
 
-              changed.update(true);
+    bool cond(GNode) { return true; }
 
-              for (auto e : graph.edges(src, galois::MethodFlag::UNPROTECTED)) {
-                GNode dst              = graph.getEdgeDst(e);
-                auto& ddata            = graph.getData(dst);
-                unsigned int label_new = sdata.comp_current;
-                galois::atomicMin(ddata.comp_current, label_new);
-              }
-            }
-          },
-          galois::disable_conflict_detection(), galois::steal(),
-          galois::loopname("LabelPropAlgo"));
-    } while (changed.reduce());
+    bool update(GNode src, GNode dst) {
+      return updateAtomic(src, dst);
+    }
+
+    bool updateAtomic(GNode src, GNode dst) {
+      unsigned int label_new =
+          graph.getData(src, galois::MethodFlag::UNPROTECTED).comp_current;
+      auto& ddata = graph.getData(dst, galois::MethodFlag::UNPROTECTED);
+      return galois::atomicMin(ddata.comp_current, label_new) > label_new;
+    }
+  };
+
+  void operator()(Graph& graph) {
+    galois::graphs::Frontier a(graph.size()), b(graph.size());
+    galois::graphs::Frontier* curr = &a;
+    galois::graphs::Frontier* next = &b;
+    curr->fill();
+
+    galois::graphs::EdgeMapOptions options;
+    options.symmetric = true;
+    options.loopname  = "LabelPropAlgo";
+
+    MinLabel fn{graph};
+    while (!curr->empty()) {
+      galois::graphs::edgeMap(graph, *curr, *next, fn, options);
+      std::swap(curr, next);
+    }
   }
 };
 
@@ -352,7 +388,7 @@ struct AsyncAlgo {
     galois::GAccumulator<size_t> emptyMerges;
 
     galois::do_all(
-        galois::iterate(graph),
+        galois::iterate_edge_balanced(graph),
         [&](const GNode& src) {
           Node& sdata = graph.getData(src, galois::MethodFlag::UNPROTECTED);
 
@@ -1035,6 +1071,70 @@ struct EdgeTiledAfforestAlgo {
   }
 };
 
+/**
+ * Incremental CC: edges are inserted in batches, and each batch is merged into
+ * the same index-based union-find (@link{UnionFindArray}) instead of
+ * recomputing the components. The number of components follows from the
+ * number of merges, so it is known after every batch.
+ */
+struct IncrementalAlgo {
+  struct NodeData {
+    using component_type = uint32_t;
+    component_type comp;
+
+    component_type component() { return comp; }
+    bool isRep() { return false; }
+    bool isRepComp(unsigned int x) { return x == comp; }
+  };
+  using Graph =
+      galois::graphs::LC_CSR_Graph<NodeData,
+                                   void>::with_no_lockable<true>::type;
+  using GNode = Graph::GraphNode;
+  using Edge  = std::pair<GNode, GNode>;
+
+  template <typename G>
+  void readGraph(G& graph) {
+    galois::graphs::readGraph(graph, inputFile);
+  }
+
+  void operator()(Graph& graph) {
+    galois::UnionFindArray<> uf(graph.size());
+    size_t components = graph.size();
+    uint32_t batches  = std::max(INCREMENTAL_BATCHES.getValue(), 1u);
+
+    // the edges of each block of nodes arrive as one batch
+    for (uint32_t b = 0; b < batches; ++b) {
+      auto range = galois::block_range(graph.begin(), graph.end(), b, batches);
+      galois::InsertBag<Edge> batch;
+      galois::do_all(
+          galois::iterate(range.first, range.second),
+          [&](const GNode& src) {
+            for (auto ii : graph.edges(src, galois::MethodFlag::UNPROTECTED)) {
+              GNode dst = graph.getEdgeDst(ii);
+              if (src < dst)
+                batch.push(Edge(src, dst));
+            }
+          },
+          galois::steal(), galois::loopname("CC-Incremental-Batch"));
+
+      components -= uf.unite(batch);
+      galois::gDebug("Components after batch ", b, ": ", components);
+    }
+
+    uf.compress();
+    galois::do_all(
+        galois::iterate(graph),
+        [&](const GNode& src) {
+          graph.getData(src, galois::MethodFlag::UNPROTECTED).comp =
+              uf.component(src);
+        },
+        galois::loopname("CC-Incremental-Label"));
+
+    galois::runtime::reportStat_Single("CC-Incremental", "components",
+                                       components);
+  }
+};
+
 template <typename Graph>
 bool verify(
     Graph&,
@@ -1103,7 +1203,8 @@ typename Graph::node_data_type::component_type findLargest(Graph& graph) {
       [&](const GNode& x) {
         auto& n = graph.getData(x, galois::MethodFlag::UNPROTECTED);
 
-        if (std::is_same<Algo, LabelPropAlgo>::value) {
+        // node labels are node ids; the representative is labeled itself
+        if (std::is_integral<component_type>::value) {
           if (n.isRepComp((unsigned int)x)) {
             accumReps += 1;
             return;
@@ -1159,18 +1260,28 @@ typename Graph::node_data_type::component_type findLargest(Graph& graph) {
 template <typename Graph>
 void initialize(Graph&) {}
 
-template <>
-void initialize<LabelPropAlgo::Graph>(typename LabelPropAlgo::Graph& graph) {
+template <typename Graph>
+void initializeLabels(Graph& graph) {
   unsigned int id = 0;
 
-  for (typename LabelPropAlgo::Graph::iterator ii = graph.begin(),
-                                               ei = graph.end();
-       ii != ei; ++ii, ++id) {
+  for (typename Graph::iterator ii = graph.begin(), ei = graph.end(); ii != ei;
+       ++ii, ++id) {
     graph.getData(*ii).comp_current = id;
-    graph.getData(*ii).comp_old     = LABEL_INF;
   }
 }
 
+template <>
+void initialize<LabelPropAlgo<false>::Graph>(
+    typename LabelPropAlgo<false>::Graph& graph) {
+  initializeLabels(graph);
+}
+
+template <>
+void initialize<LabelPropAlgo<true>::Graph>(
+    typename LabelPropAlgo<true>::Graph& graph) {
+  initializeLabels(graph);
+}
+
 template <typename Algo>
 void run() {
   using Graph = typename Algo::Graph;
@@ -1217,6 +1328,10 @@ int main(int argc, char** argv) {
                " to indicate the input is a symmetric graph.");
   }
 
+  if (graphType == GraphType::compressed && algo != Algo::labelProp) {
+    GALOIS_DIE("-graphType=Compressed is only supported by -algo=LabelProp");
+  }
+
   switch (algo) {
   case Algo::async:
     run<AsyncAlgo>();
@@ -1231,7 +1346,11 @@ int main(int argc, char** argv) {
     run<BlockedAsyncAlgo>();
     break;
   case Algo::labelProp:
-    run<LabelPropAlgo>();
+    if (graphType == GraphType::compressed) {
+      run<LabelPropAlgo<true>>();
+    } else {
+      run<LabelPropAlgo<false>>();
+    }
     break;
   case Algo::serial:
     run<SerialAlgo>();
@@ -1248,6 +1367,9 @@ int main(int argc, char** argv) {
   case Algo::edgetiledafforest:
     run<EdgeTiledAfforestAlgo>();
     break;
+  case Algo::incremental:
+    run<IncrementalAlgo>();
+    break;
 
   default:
     std::cerr << "Unknown algorithm\n";
@@ -21,6 +21,7 @@
 #include "galois/gstl.h"
 #include "galois/AtomicHelpers.h"
 #include "galois/Reduction.h"
+#include "galois/graphs/Frontier.h"
 #include "galois/graphs/LCGraph.h"
 #include "Lonestar/BoilerPlate.h"
 
@@ -98,64 +99,76 @@ void degreeCounting(Graph& graph) {
  * Setup initial worklist of dead nodes.
  *
  * @param graph Graph to operate on
- * @param initialWorklist Empty worklist to be filled with dead nodes.
+ * @param initialWorklist Empty worklist or frontier to be filled with dead
+ * nodes.
  */
-void setupInitialWorklist(Graph& graph,
-                          galois::InsertBag<GNode>& initialWorklist) {
+template <typename WL>
+void setupInitialWorklist(Graph& graph, WL& initialWorklist) {
   galois::do_all(
       galois::iterate(graph.begin(), graph.end()),
       [&](GNode curNode) {
         NodeData& curData = graph.getData(curNode);
         if (curData.currentDegree < k_core_num) {
           //! Dead node, add to initialWorklist for processing later.
-          initialWorklist.emplace(curNode);
+          initialWorklist.push(curNode);
         }
       },
       galois::loopname("InitialWorklistSetup"), galois::no_stats());
 }
 
+//! Decrements the degree of the neighbors of dead nodes and activates those
+//! it puts below k
+struct CascadeFn {
+  Graph& graph;
+
+  bool cond(GNode dst) {
+    return graph.getData(dst).currentDegree >= k_core_num;
+  }
+
+  //! Only one thread pulls into dst
+  bool update(GNode, GNode dst) {
+    NodeData& destData = graph.getData(dst);
+    uint32_t oldDegree = destData.currentDegree.load(std::memory_order_relaxed);
+    destData.currentDegree.store(oldDegree - 1, std::memory_order_relaxed);
+    return oldDegree == k_core_num;
+  }
+
+  bool updateAtomic(GNode, GNode dst) {
+    NodeData& destData = graph.getData(dst);
+    uint32_t oldDegree = galois::atomicSubtract(destData.currentDegree, 1u);
+    //! This thread was responsible for putting degree of destination below
+    //! threshold; add to the next frontier.
+    return oldDegree == k_core_num;
+  }
+};
+
 /**
- * Starting with initial dead nodes as current worklist; decrement degree;
- * add to next worklist; switch next with current and repeat until worklist
+ * Starting with initial dead nodes as current frontier; decrement degree;
+ * add to next frontier; switch next with current and repeat until frontier
  * is empty (i.e. no more dead nodes).
  *
  * @param graph Graph to operate on
  */
 void syncCascadeKCore(Graph& graph) {
-  galois::InsertBag<GNode>* current = new galois::InsertBag<GNode>;
-  galois::InsertBag<GNode>* next    = new galois::InsertBag<GNode>;
-
-  //! Setup worklist.
-  setupInitialWorklist(graph, *next);
-
-  while (!next->empty()) {
+  galois::graphs::Frontier a(graph.size()), b(graph.size());
+  galois::graphs::Frontier* current = &a;
+  galois::graphs::Frontier* next    = &b;
+
+  //! Setup frontier.
+  setupInitialWorklist(graph, *current);
+
+  //! The graph is symmetric, so large frontiers can be pulled by the nodes
+  //! still alive.
+  galois::graphs::EdgeMapOptions options;
+  options.symmetric = true;
+  options.loopname  = "SyncCascadeDeadNodes";
+
+  CascadeFn fn{graph};
+  while (!current->empty()) {
+    galois::graphs::edgeMap(graph, *current, *next, fn, options);
     //! Make "next" into current.
     std::swap(current, next);
-    next->clear();
-
-    galois::do_all(
-        galois::iterate(*current),
-        [&](GNode deadNode) {
-          //! Decrement degree of all neighbors.
-          for (auto e : graph.edges(deadNode)) {
-            GNode dest         = graph.getEdgeDst(e);
-            NodeData& destData = graph.getData(dest);
-            uint32_t oldDegree =
-                galois::atomicSubtract(destData.currentDegree, 1u);
-
-            if (oldDegree == k_core_num) {
-              //! This thread was responsible for putting degree of destination
-              //! below threshold; add to worklist.
-              next->emplace(dest);
-            }
-          }
-        },
-        galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
-        galois::loopname("SyncCascadeDeadNodes"));
   }
-
-  delete current;
-  delete next;
 }
 
 /**
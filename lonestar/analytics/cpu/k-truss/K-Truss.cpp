@@ -22,6 +22,7 @@
 #include "galois/Bag.h"
 #include "galois/Timer.h"
 #include "galois/graphs/Graph.h"
+#include "galois/graphs/GraphCache.h"
 #include "galois/graphs/TypeTraits.h"
 #include "galois/runtime/Statistics.h"
 #include "Lonestar/BoilerPlate.h"
@@ -265,12 +266,10 @@ struct AsyncTrussTxAlgo {
 #endif
 
 /**
- * Initialize edge data to valid.
+ * Initialize edge data to valid. Edges must already be sorted by destination.
  */
 template <typename Graph>
 void initialize(Graph& g) {
-  g.sortAllEdgesByDst();
-
   //! Initializa all edges to valid.
   galois::do_all(
       galois::iterate(g),
@@ -612,7 +611,8 @@ void run() {
   Algo algo;
 
   std::cout << "Reading from file: " << inputFile << "\n";
-  galois::graphs::readGraph(graph, inputFile, true);
+  galois::graphs::readGraphCached(graph, inputFile, galois::graphs::SortByDst,
+                                  true);
   std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
             << " edges\n";
   std::cout << "Running " << algo.name() << " algorithm for maximal "
@@ -125,22 +125,23 @@ struct BoldStepFunction : public StepFunction {
 };
 
 template <typename Graph>
-double sumSquaredError(Graph& g) {
+double sumSquaredError(Graph& g, const LatentMatrix& latent) {
   typedef typename Graph::GraphNode GNode;
   // computing Root Mean Square Error
   // Assuming only item nodes have edges
   galois::GAccumulator<double> error;
 
-  galois::do_all(
-      galois::iterate(g.begin(), g.begin() + NUM_ITEM_NODES), [&](GNode n) {
-        for (auto ii = g.edge_begin(n), ei = g.edge_end(n); ii != ei; ++ii) {
-          GNode dst = g.getEdgeDst(ii);
-          LatentValue e =
-              predictionError(g.getData(n).latentVector,
-                              g.getData(dst).latentVector, g.getEdgeData(ii));
-          error += (e * e);
-        }
-      });
+  latent.withKernel([&](auto kernel) {
+    galois::do_all(
+        galois::iterate(g.begin(), g.begin() + NUM_ITEM_NODES), [&](GNode n) {
+          for (auto ii = g.edge_begin(n), ei = g.edge_end(n); ii != ei; ++ii) {
+            GNode dst     = g.getEdgeDst(ii);
+            LatentValue e = latent.predictionError(kernel, n, dst,
+                                                   g.getEdgeData(ii));
+            error += (e * e);
+          }
+        });
+  });
   return error.reduce();
 }
 
@@ -159,13 +160,13 @@ size_t countEdges(Graph& g) {
 }
 
 template <typename Graph>
-void verify(Graph& g, const std::string& prefix) {
+void verify(Graph& g, const LatentMatrix& latent, const std::string& prefix) {
   std::cout << countEdges(g) << " : " << g.sizeEdges() << "\n";
   if (countEdges(g) != g.sizeEdges()) {
     GALOIS_DIE("edge list of input graph probably not sorted");
   }
 
-  double error = sumSquaredError(g);
+  double error = sumSquaredError(g, latent);
   double rmse  = std::sqrt(error / g.sizeEdges());
 
   std::cout << prefix << "RMSE: " << rmse << "\n";
@@ -253,11 +254,15 @@ double countFlops(size_t nnz, int rounds, int k) {
  *
  * @param StepFunction to be used
  * @param Graph
+ * @param latent latent vectors of the nodes of the graph
  * @param fn (algorithm)
+ * @param algoName region to report the edge update throughput in
  *
  */
 template <typename Graph, typename Fn>
-void executeUntilConverged(const StepFunction& sf, Graph& g, Fn fn) {
+void executeUntilConverged(const StepFunction& sf, Graph& g,
+                           const LatentMatrix& latent, Fn fn,
+                           const std::string& algoName) {
   galois::GAccumulator<double> errorAccum;
   std::vector<LatentValue> steps(updatesPerEdge);
   LatentValue last    = -1.0;
@@ -266,6 +271,9 @@ void executeUntilConverged(const StepFunction& sf, Graph& g, Fn fn) {
 
   galois::StatTimer executeAlgoTimer("Algorithm Execution Time");
   galois::TimeAccumulator elapsed;
+  // time spent in fn only, to measure the throughput of the updates
+  galois::TimeAccumulator updateTime;
+  size_t numUpdates = 0;
   elapsed.start();
 
   unsigned long lastTime = 0;
@@ -285,9 +293,13 @@ void executeUntilConverged(const StepFunction& sf, Graph& g, Fn fn) {
     }
 
     executeAlgoTimer.start();
+    updateTime.start();
     fn(&steps[0], round + deltaRound, useExactError ? &errorAccum : NULL);
+    updateTime.stop();
     executeAlgoTimer.stop();
-    double error = useExactError ? errorAccum.reduce() : sumSquaredError(g);
+    numUpdates += g.sizeEdges() * deltaRound;
+    double error =
+        useExactError ? errorAccum.reduce() : sumSquaredError(g, latent);
 
     elapsed.stop();
 
@@ -296,12 +308,13 @@ void executeUntilConverged(const StepFunction& sf, Graph& g, Fn fn) {
     unsigned long millis = curElapsed - lastTime;
     lastTime             = curElapsed;
 
-    double gflops = countFlops(g.sizeEdges(), deltaRound, LATENT_VECTOR_SIZE) /
-                    millis / 1e6;
+    double gflops =
+        countFlops(g.sizeEdges(), deltaRound, latent.size()) / millis / 1e6;
+    double mupdates = (double)g.sizeEdges() * deltaRound / millis / 1e3;
 
     int curRound = round + deltaRound;
     galois::gPrint("R: ", curRound, " elapsed (ms): ", curElapsed,
-                   " GFLOP/s: ", gflops);
+                   " GFLOP/s: ", gflops, " MUpdates/s: ", mupdates);
     if (useExactError) {
       galois::gPrint(" RMSE (R ", curRound,
                      "): ", std::sqrt(error / g.sizeEdges()), "\n");
@@ -325,6 +338,12 @@ void executeUntilConverged(const StepFunction& sf, Graph& g, Fn fn) {
     }
     last = error;
   }
+
+  // updates of latent vector pairs (one per edge and round) per second
+  double updatesPerSec = numUpdates / (updateTime.get_usec() / 1e6);
+  galois::gPrint("Edge updates per second: ", updatesPerSec, "\n");
+  galois::runtime::reportStat_Single(algoName, "EdgeUpdatesPerSecond",
+                                     updatesPerSec);
 }
 
 /*
@@ -338,11 +357,7 @@ struct SGDBlockJumpAlgo {
 
   std::string name() const { return "sgdBlockJumpAlgo"; }
 
-  struct Node {
-    LatentValue latentVector[LATENT_VECTOR_SIZE];
-  };
-
-  typedef galois::graphs::LC_CSR_Graph<Node, EdgeType>
+  typedef galois::graphs::LC_CSR_Graph<void, EdgeType>
       //    ::with_numa_alloc<true>::type
       ::with_no_lockable<true>::type Graph;
   typedef Graph::GraphNode GNode;
@@ -375,8 +390,10 @@ struct SGDBlockJumpAlgo {
     ~BlockInfo() { delete[] userOffsets; }
   };
 
+  template <typename Kernel>
   struct Process {
     Graph& g;
+    LatentMatrix& latent;
     SpinLock *xLocks, *yLocks;
     BlockInfo* blocks;
     size_t numXBlocks, numYBlocks;
@@ -423,7 +440,6 @@ struct SGDBlockJumpAlgo {
       // For each item in the range
       for (; mm != em; ++mm, ++itemId) {
         GNode item      = *mm;
-        Node& itemData  = g.getData(item);
         size_t lastUser = si.userEnd + NUM_ITEM_NODES;
 
         edge_dst_iterator start(no_deref_iterator(g.edge_begin(
@@ -442,9 +458,9 @@ struct SGDBlockJumpAlgo {
           if (user >= lastUser)
             break;
 
-          LatentValue e = doGradientUpdate(itemData.latentVector,
-                                           g.getData(user).latentVector, lambda,
-                                           g.getEdgeData(*ii.base()), stepSize);
+          LatentValue e =
+              latent.doGradientUpdate(Kernel(), item, user, lambda,
+                                      g.getEdgeData(*ii.base()), stepSize);
           if (errorAccum)
             error += e * e;
           ++seen;
@@ -480,7 +496,6 @@ struct SGDBlockJumpAlgo {
           continue;
 
         GNode item      = *mm;
-        Node& itemData  = g.getData(item);
         size_t lastUser = si.userEnd + NUM_ITEM_NODES;
 
         // For each edge in the range
@@ -492,9 +507,8 @@ struct SGDBlockJumpAlgo {
           if (user >= lastUser)
             break;
 
-          LatentValue e = doGradientUpdate(itemData.latentVector,
-                                           g.getData(user).latentVector, lambda,
-                                           g.getEdgeData(ii), stepSize);
+          LatentValue e = latent.doGradientUpdate(
+              Kernel(), item, user, lambda, g.getEdgeData(ii), stepSize);
           if (errorAccum)
             error += e * e;
           ++seen;
@@ -567,7 +581,7 @@ struct SGDBlockJumpAlgo {
     }
   };
 
-  void operator()(Graph& g, const StepFunction& sf) {
+  void operator()(Graph& g, LatentMatrix& latent, const StepFunction& sf) {
     galois::StatTimer preProcessTimer("PreProcessingTime");
     preProcessTimer.start();
     const size_t numUsers = g.size() - NUM_ITEM_NODES;
@@ -636,14 +650,19 @@ struct SGDBlockJumpAlgo {
 
     galois::StatTimer executeTimer("Time");
     executeTimer.start();
-    executeUntilConverged(sf, g,
-                          [&](LatentValue* steps, size_t maxUpdates,
-                              galois::GAccumulator<double>* errorAccum) {
-                            Process fn{g,      xLocks,     yLocks,
-                                       blocks, numXBlocks, numYBlocks,
-                                       steps,  maxUpdates, errorAccum};
-                            galois::on_each(fn);
-                          });
+    latent.withKernel([&](auto kernel) {
+      executeUntilConverged(
+          sf, g, latent,
+          [&](LatentValue* steps, size_t maxUpdates,
+              galois::GAccumulator<double>* errorAccum) {
+            Process<decltype(kernel)> fn{g,          latent,     xLocks,
+                                         yLocks,     blocks,     numXBlocks,
+                                         numYBlocks, steps,      maxUpdates,
+                                         errorAccum};
+            galois::on_each(fn);
+          },
+          name());
+    });
     executeTimer.stop();
 
     delete[] xLocks;
@@ -659,16 +678,10 @@ struct SGDBlockJumpAlgo {
 class SGDItemsAlgo {
   static const bool makeSerializable = false;
 
-  struct BasicNode {
-    LatentValue latentVector[LATENT_VECTOR_SIZE];
-  };
-
-  using Node = BasicNode;
-
 public:
   bool isSgd() const { return true; }
 
-  typedef typename galois::graphs::LC_CSR_Graph<Node, EdgeType>
+  typedef typename galois::graphs::LC_CSR_Graph<void, EdgeType>
       //::template with_numa_alloc<true>::type
       ::template with_out_of_line_lockable<true>::type ::
           template with_no_lockable<!makeSerializable>::type Graph;
@@ -683,8 +696,10 @@ private:
   using GNode         = typename Graph::GraphNode;
   using edge_iterator = typename Graph::edge_iterator;
 
+  template <typename Kernel>
   struct Execute {
     Graph& g;
+    LatentMatrix& latent;
     galois::GAccumulator<unsigned>& edgesVisited;
 
     void operator()(LatentValue* steps, int,
@@ -697,10 +712,8 @@ private:
             for (auto ii : g.edges(src)) {
 
               GNode dst         = g.getEdgeDst(ii);
-              LatentValue error = doGradientUpdate(
-                  g.getData(src, galois::MethodFlag::UNPROTECTED).latentVector,
-                  g.getData(dst).latentVector, lambda, g.getEdgeData(ii),
-                  stepSize);
+              LatentValue error = latent.doGradientUpdate(
+                  Kernel(), src, dst, lambda, g.getEdgeData(ii), stepSize);
 
               edgesVisited += 1;
               if (useExactError)
@@ -713,15 +726,17 @@ private:
   };
 
 public:
-  void operator()(Graph& g, const StepFunction& sf) {
-    verify(g, "sgdItemsAlgo");
+  void operator()(Graph& g, LatentMatrix& latent, const StepFunction& sf) {
+    verify(g, latent, "sgdItemsAlgo");
     galois::GAccumulator<unsigned> edgesVisited;
 
     galois::StatTimer executeTimer("Time");
     executeTimer.start();
 
-    Execute fn{g, edgesVisited};
-    executeUntilConverged(sf, g, fn);
+    latent.withKernel([&](auto kernel) {
+      Execute<decltype(kernel)> fn{g, latent, edgesVisited};
+      executeUntilConverged(sf, g, latent, fn, name());
+    });
 
     executeTimer.stop();
 
@@ -738,8 +753,6 @@ class SGDEdgeItem {
   static const bool makeSerializable = false;
 
   struct BasicNode {
-    // latent vector to be learned.
-    LatentValue latentVector[LATENT_VECTOR_SIZE];
     // if a item's update is interrupted, where to start when resuming.
     unsigned int edge_offset;
   };
@@ -764,8 +777,10 @@ private:
   using GNode         = typename Graph::GraphNode;
   using edge_iterator = typename Graph::edge_iterator;
 
+  template <typename Kernel>
   struct Execute {
     Graph& g;
+    LatentMatrix& latent;
     galois::GAccumulator<unsigned>& edgesVisited;
     void operator()(LatentValue* steps, int,
                     galois::GAccumulator<double>* errorAccum) {
@@ -786,10 +801,10 @@ private:
             std::advance(ii, srcData.edge_offset);
             // Take lock on the destination as multiple source may update the
             // same destination.
-            auto& dstData = g.getData(g.getEdgeDst(ii));
-            LatentValue error =
-                doGradientUpdate(srcData.latentVector, dstData.latentVector,
-                                 lambda, g.getEdgeData(ii), stepSize);
+            GNode dst = g.getEdgeDst(ii);
+            g.getData(dst);
+            LatentValue error = latent.doGradientUpdate(
+                Kernel(), src, dst, lambda, g.getEdgeData(ii), stepSize);
 
             ++srcData.edge_offset;
             ++ii;
@@ -815,15 +830,17 @@ private:
   };
 
 public:
-  void operator()(Graph& g, const StepFunction& sf) {
-    verify(g, "sgdEdgeItem");
+  void operator()(Graph& g, LatentMatrix& latent, const StepFunction& sf) {
+    verify(g, latent, "sgdEdgeItem");
     galois::GAccumulator<unsigned> edgesVisited;
 
     galois::StatTimer executeTimer("Time");
     executeTimer.start();
 
-    Execute fn{g, edgesVisited};
-    executeUntilConverged(sf, g, fn);
+    latent.withKernel([&](auto kernel) {
+      Execute<decltype(kernel)> fn{g, latent, edgesVisited};
+      executeUntilConverged(sf, g, latent, fn, name());
+    });
 
     executeTimer.stop();
 
@@ -841,16 +858,10 @@ public:
 class SGDBlockEdgeAlgo {
   static const bool makeSerializable = false;
 
-  struct BasicNode {
-    LatentValue latentVector[LATENT_VECTOR_SIZE];
-  };
-
-  using Node = BasicNode;
-
 public:
   bool isSgd() const { return true; }
 
-  typedef typename galois::graphs::LC_CSR_Graph<Node, EdgeType>
+  typedef typename galois::graphs::LC_CSR_Graph<void, EdgeType>
       //::template with_numa_alloc<true>::type
       ::template with_out_of_line_lockable<true>::type ::
           template with_no_lockable<!makeSerializable>::type Graph;
@@ -865,8 +876,10 @@ private:
   using GNode         = typename Graph::GraphNode;
   using edge_iterator = typename Graph::edge_iterator;
 
+  template <typename Kernel>
   struct Execute {
     Graph& g;
+    LatentMatrix& latent;
     galois::GAccumulator<unsigned>& edgesVisited;
 
     void operator()(LatentValue* steps, int,
@@ -877,9 +890,8 @@ private:
           g.end(), itemsPerBlock, usersPerBlock,
           [&](GNode src, GNode dst, edge_iterator edge) {
             const LatentValue stepSize = steps[0];
-            LatentValue error          = doGradientUpdate(
-                g.getData(src).latentVector, g.getData(dst).latentVector,
-                lambda, g.getEdgeData(edge), stepSize);
+            LatentValue error          = latent.doGradientUpdate(
+                Kernel(), src, dst, lambda, g.getEdgeData(edge), stepSize);
             edgesVisited += 1;
             if (useExactError)
               *errorAccum += error;
@@ -890,15 +902,17 @@ private:
   };
 
 public:
-  void operator()(Graph& g, const StepFunction& sf) {
-    verify(g, "sgdBlockEdgeAlgo");
+  void operator()(Graph& g, LatentMatrix& latent, const StepFunction& sf) {
+    verify(g, latent, "sgdBlockEdgeAlgo");
     galois::GAccumulator<unsigned> edgesVisited;
 
     galois::StatTimer executeTimer("Time");
     executeTimer.start();
 
-    Execute fn{g, edgesVisited};
-    executeUntilConverged(sf, g, fn);
+    latent.withKernel([&](auto kernel) {
+      Execute<decltype(kernel)> fn{g, latent, edgesVisited};
+      executeUntilConverged(sf, g, latent, fn, name());
+    });
 
     executeTimer.stop();
 
@@ -916,17 +930,13 @@ public:
 struct SimpleALSalgo {
   bool isSgd() const { return false; }
   std::string name() const { return "AlternatingLeastSquares"; }
-  struct Node {
-    LatentValue latentVector[LATENT_VECTOR_SIZE];
-  };
-
   typedef typename galois::graphs::LC_CSR_Graph<
-      Node, EdgeType>::with_no_lockable<true>::type Graph;
+      void, EdgeType>::with_no_lockable<true>::type Graph;
   typedef Graph::GraphNode GNode;
   // Column-major access
   typedef Eigen::SparseMatrix<LatentValue> Sp;
-  typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, Eigen::Dynamic> MT;
-  typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, 1> V;
+  typedef Eigen::Matrix<LatentValue, Eigen::Dynamic, Eigen::Dynamic> MT;
+  typedef Eigen::Matrix<LatentValue, Eigen::Dynamic, 1> V;
   typedef Eigen::Map<V> MapV;
 
   Sp A;
@@ -934,11 +944,10 @@ struct SimpleALSalgo {
 
   void readGraph(Graph& g) { galois::graphs::readGraph(g, inputFile); }
 
-  void copyToGraph(Graph& g, MT& WT, MT& HT) {
+  void copyToGraph(Graph& g, LatentMatrix& latent, MT& WT, MT& HT) {
     // Copy out
     for (GNode n : g) {
-      LatentValue* ptr = &g.getData(n).latentVector[0];
-      MapV mapV{ptr};
+      MapV mapV{latent.row(n), (Eigen::Index)latent.size()};
       if (n < NUM_ITEM_NODES) {
         mapV = WT.col(n);
       } else {
@@ -947,10 +956,9 @@ struct SimpleALSalgo {
     }
   }
 
-  void copyFromGraph(Graph& g, MT& WT, MT& HT) {
+  void copyFromGraph(Graph& g, LatentMatrix& latent, MT& WT, MT& HT) {
     for (GNode n : g) {
-      LatentValue* ptr = &g.getData(n).latentVector[0];
-      MapV mapV{ptr};
+      MapV mapV{latent.row(n), (Eigen::Index)latent.size()};
       if (n < NUM_ITEM_NODES) {
         WT.col(n) = mapV;
       } else {
@@ -974,26 +982,26 @@ struct SimpleALSalgo {
     AT = A.transpose();
   }
 
-  void operator()(Graph& g, const StepFunction&) {
+  void operator()(Graph& g, LatentMatrix& latent, const StepFunction&) {
     galois::TimeAccumulator elapsed;
     elapsed.start();
+    const Eigen::Index k = latent.size();
 
     // Find W, H that minimize ||W H^T - A||_2^2 by solving alternating least
     // squares problems:
     //   (W^T W + lambda I) H^T = W^T A (solving for H^T)
     //   (H^T H + lambda I) W^T = H^T A^T (solving for W^T)
-    MT WT{LATENT_VECTOR_SIZE, NUM_ITEM_NODES};
-    MT HT{LATENT_VECTOR_SIZE, g.size() - NUM_ITEM_NODES};
-    typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, LATENT_VECTOR_SIZE>
-        XTX;
-    typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, Eigen::Dynamic> XTSp;
+    MT WT{k, (Eigen::Index)NUM_ITEM_NODES};
+    MT HT{k, (Eigen::Index)(g.size() - NUM_ITEM_NODES)};
+    typedef Eigen::Matrix<LatentValue, Eigen::Dynamic, Eigen::Dynamic> XTX;
+    typedef Eigen::Matrix<LatentValue, Eigen::Dynamic, Eigen::Dynamic> XTSp;
     typedef galois::substrate::PerThreadStorage<XTX> PerThrdXTX;
 
     galois::gPrint("ALS::Start initializeA\n");
     initializeA(g);
     galois::gPrint("ALS::End initializeA\n");
     galois::gPrint("ALS::Start copyFromGraph\n");
-    copyFromGraph(g, WT, HT);
+    copyFromGraph(g, latent, WT, HT);
     galois::gPrint("ALS::End copyFromGraph\n");
 
     double last = -1.0;
@@ -1021,11 +1029,11 @@ struct SimpleALSalgo {
           [&](int col, galois::UserContext<int>&) {
             // Compute WTW = W^T * W for sparse A
             XTX& WTW = *xtxs.getLocal();
-            WTW.setConstant(0);
+            WTW.setZero(k, k);
             for (Sp::InnerIterator it(A, col); it; ++it)
               WTW.triangularView<Eigen::Upper>() +=
                   WT.col(it.row()) * WT.col(it.row()).transpose();
-            for (int i = 0; i < LATENT_VECTOR_SIZE; ++i)
+            for (Eigen::Index i = 0; i < k; ++i)
               WTW(i, i) += lambda;
             HT.col(col) =
                 WTW.selfadjointView<Eigen::Upper>().llt().solve(WTA.col(col));
@@ -1043,11 +1051,11 @@ struct SimpleALSalgo {
           [&](int col, galois::UserContext<int>&) {
             // Compute HTH = H^T * H for sparse A
             XTX& HTH = *xtxs.getLocal();
-            HTH.setConstant(0);
+            HTH.setZero(k, k);
             for (Sp::InnerIterator it(AT, col); it; ++it)
               HTH.triangularView<Eigen::Upper>() +=
                   HT.col(it.row()) * HT.col(it.row()).transpose();
-            for (int i = 0; i < LATENT_VECTOR_SIZE; ++i)
+            for (Eigen::Index i = 0; i < k; ++i)
               HTH(i, i) += lambda;
             WT.col(col) =
                 HTH.selfadjointView<Eigen::Upper>().llt().solve(HTAT.col(col));
@@ -1055,11 +1063,11 @@ struct SimpleALSalgo {
       update2Time.stop();
 
       copyTime.start();
-      copyToGraph(g, WT, HT);
+      copyToGraph(g, latent, WT, HT);
       copyTime.stop();
       totalExecTime.stop();
 
-      double error = sumSquaredError(g);
+      double error = sumSquaredError(g, latent);
       elapsed.stop();
       std::cout << "R: " << round << " elapsed (ms): " << elapsed.get()
                 << " RMSE (R " << round
@@ -1084,12 +1092,8 @@ struct SyncALSalgo {
 
   std::string name() const { return "SynchronousAlternatingLeastSquares"; }
 
-  struct Node {
-    LatentValue latentVector[LATENT_VECTOR_SIZE];
-  };
-
   static const bool NEEDS_LOCKS = false;
-  typedef typename galois::graphs::LC_CSR_Graph<Node, EdgeType> BaseGraph;
+  typedef typename galois::graphs::LC_CSR_Graph<void, EdgeType> BaseGraph;
   typedef typename std::conditional<
       NEEDS_LOCKS,
       typename BaseGraph::template with_out_of_line_lockable<true>::type,
@@ -1097,12 +1101,11 @@ struct SyncALSalgo {
   typedef typename Graph::GraphNode GNode;
   // Column-major access
   typedef Eigen::SparseMatrix<LatentValue> Sp;
-  typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, Eigen::Dynamic> MT;
-  typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, 1> V;
+  typedef Eigen::Matrix<LatentValue, Eigen::Dynamic, Eigen::Dynamic> MT;
+  typedef Eigen::Matrix<LatentValue, Eigen::Dynamic, 1> V;
   typedef Eigen::Map<V> MapV;
-  typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, LATENT_VECTOR_SIZE>
-      XTX;
-  typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, Eigen::Dynamic> XTSp;
+  typedef Eigen::Matrix<LatentValue, Eigen::Dynamic, Eigen::Dynamic> XTX;
+  typedef Eigen::Matrix<LatentValue, Eigen::Dynamic, Eigen::Dynamic> XTSp;
 
   typedef galois::substrate::PerThreadStorage<XTX> PerThrdXTX;
   typedef galois::substrate::PerThreadStorage<V> PerThrdV;
@@ -1112,11 +1115,10 @@ struct SyncALSalgo {
 
   void readGraph(Graph& g) { galois::graphs::readGraph(g, inputFile); }
 
-  void copyToGraph(Graph& g, MT& WT, MT& HT) {
+  void copyToGraph(Graph& g, LatentMatrix& latent, MT& WT, MT& HT) {
     // Copy out
     for (GNode n : g) {
-      LatentValue* ptr = &g.getData(n).latentVector[0];
-      MapV mapV{ptr};
+      MapV mapV{latent.row(n), (Eigen::Index)latent.size()};
       if (n < NUM_ITEM_NODES) {
         mapV = WT.col(n);
       } else {
@@ -1125,10 +1127,9 @@ struct SyncALSalgo {
     }
   }
 
-  void copyFromGraph(Graph& g, MT& WT, MT& HT) {
+  void copyFromGraph(Graph& g, LatentMatrix& latent, MT& WT, MT& HT) {
     for (GNode n : g) {
-      LatentValue* ptr = &g.getData(n).latentVector[0];
-      MapV mapV{ptr};
+      MapV mapV{latent.row(n), (Eigen::Index)latent.size()};
       if (n < NUM_ITEM_NODES) {
         WT.col(n) = mapV;
       } else {
@@ -1155,32 +1156,33 @@ struct SyncALSalgo {
   void update(Graph& g, size_t col, MT& WT, MT& HT, PerThrdXTX& xtxs,
               PerThrdV& rhs) {
     // Compute WTW = W^T * W for sparse A
-    V& r = *rhs.getLocal();
+    const Eigen::Index k = WT.rows();
+    V& r                 = *rhs.getLocal();
     if (col < NUM_ITEM_NODES) {
-      r.setConstant(0);
+      r.setZero(k);
       // HTAT = HT * AT; r = HTAT.col(col)
       for (Sp::InnerIterator it(AT, col); it; ++it)
         r += it.value() * HT.col(it.row());
       XTX& HTH = *xtxs.getLocal();
-      HTH.setConstant(0);
+      HTH.setZero(k, k);
       for (Sp::InnerIterator it(AT, col); it; ++it)
         HTH.triangularView<Eigen::Upper>() +=
             HT.col(it.row()) * HT.col(it.row()).transpose();
-      for (int i = 0; i < LATENT_VECTOR_SIZE; ++i)
+      for (Eigen::Index i = 0; i < k; ++i)
         HTH(i, i) += lambda;
       WT.col(col) = HTH.selfadjointView<Eigen::Upper>().llt().solve(r);
     } else {
       col = col - NUM_ITEM_NODES;
-      r.setConstant(0);
+      r.setZero(k);
       // WTA = WT * A; x = WTA.col(col)
       for (Sp::InnerIterator it(A, col); it; ++it)
         r += it.value() * WT.col(it.row());
       XTX& WTW = *xtxs.getLocal();
-      WTW.setConstant(0);
+      WTW.setZero(k, k);
       for (Sp::InnerIterator it(A, col); it; ++it)
         WTW.triangularView<Eigen::Upper>() +=
             WT.col(it.row()) * WT.col(it.row()).transpose();
-      for (int i = 0; i < LATENT_VECTOR_SIZE; ++i)
+      for (Eigen::Index i = 0; i < k; ++i)
         WTW(i, i) += lambda;
       HT.col(col) = WTW.selfadjointView<Eigen::Upper>().llt().solve(r);
     }
@@ -1225,7 +1227,7 @@ struct SyncALSalgo {
     }
   };
 
-  void operator()(Graph& g, const StepFunction&) {
+  void operator()(Graph& g, LatentMatrix& latent, const StepFunction&) {
     if (!useSameLatentVector) {
       galois::gWarn("Results are not deterministic with different numbers of "
                     "threads unless -useSameLatentVector is true");
@@ -1237,11 +1239,12 @@ struct SyncALSalgo {
     // squares problems:
     //   (W^T W + lambda I) H^T = W^T A (solving for H^T)
     //   (H^T H + lambda I) W^T = H^T A^T (solving for W^T)
-    MT WT{LATENT_VECTOR_SIZE, NUM_ITEM_NODES};
-    MT HT{LATENT_VECTOR_SIZE, g.size() - NUM_ITEM_NODES};
+    MT WT{(Eigen::Index)latent.size(), (Eigen::Index)NUM_ITEM_NODES};
+    MT HT{(Eigen::Index)latent.size(),
+          (Eigen::Index)(g.size() - NUM_ITEM_NODES)};
 
     initializeA(g);
-    copyFromGraph(g, WT, HT);
+    copyFromGraph(g, latent, WT, HT);
 
     double last = -1.0;
     galois::StatTimer updateTime("UpdateTime");
@@ -1272,11 +1275,11 @@ struct SyncALSalgo {
       updateTime.stop();
 
       copyTime.start();
-      copyToGraph(g, WT, HT);
+      copyToGraph(g, latent, WT, HT);
       copyTime.stop();
       totalExecTime.stop();
 
-      double error = sumSquaredError(g);
+      double error = sumSquaredError(g, latent);
       elapsed.stop();
       std::cout << "R: " << round << " elapsed (ms): " << elapsed.get()
                 << " RMSE (R " << round
@@ -1298,21 +1301,24 @@ struct SyncALSalgo {
 #endif // HAS_EIGEN
 
 /**
- * Initializes latent vector with random values and returns basic graph
- * parameters.
+ * Allocates and initializes latent vectors with random values and returns
+ * basic graph parameters.
  *
  * @tparam Graph type of g
  * @param g Graph to initialize
+ * @param latent latent vectors of the nodes of g
  * @returns number of item nodes, i.e. nodes with outgoing edges. They should
  * be the first nodes of the graph in memory
  */
 
 template <typename Graph>
-size_t initializeGraphData(Graph& g) {
+size_t initializeGraphData(Graph& g, LatentMatrix& latent) {
   galois::gPrint("initializeGraphData\n");
   galois::StatTimer initTimer("InitializeGraph");
   initTimer.start();
-  double top = 1.0 / std::sqrt(LATENT_VECTOR_SIZE);
+  latent.allocate(g.size(), latentVectorSize);
+  const size_t k = latent.size();
+  double top     = 1.0 / std::sqrt(k);
   galois::substrate::PerThreadStorage<std::mt19937> gen;
 
 #if __cplusplus >= 201103L || defined(HAVE_CXX11_UNIFORM_INT_DISTRIBUTION)
@@ -1323,26 +1329,26 @@ size_t initializeGraphData(Graph& g) {
 
   if (useDetInit) {
     galois::do_all(galois::iterate(g), [&](typename Graph::GraphNode n) {
-      auto& data = g.getData(n);
-      auto val   = genVal(n);
-      for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
-        data.latentVector[i] = val;
+      LatentValue* data = latent.row(n);
+      auto val          = genVal(n);
+      for (size_t i = 0; i < k; i++) {
+        data[i] = val;
       }
     });
   } else {
     galois::do_all(galois::iterate(g), [&](typename Graph::GraphNode n) {
-      auto& data = g.getData(n);
+      LatentValue* data = latent.row(n);
 
       // all threads initialize their assignment with same generator or
       // a thread local one
       if (useSameLatentVector) {
         std::mt19937 sameGen;
-        for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
-          data.latentVector[i] = dist(sameGen);
+        for (size_t i = 0; i < k; i++) {
+          data[i] = dist(sameGen);
         }
       } else {
-        for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
-          data.latentVector[i] = dist(*gen.getLocal());
+        for (size_t i = 0; i < k; i++) {
+          data[i] = dist(*gen.getLocal());
         }
       }
     });
@@ -1399,11 +1405,12 @@ StepFunction* newStepFunction() {
 }
 
 template <typename Graph>
-void writeBinaryLatentVectors(Graph& g, const std::string& filename) {
+void writeBinaryLatentVectors(Graph& g, LatentMatrix& latent,
+                              const std::string& filename) {
   std::ofstream file(filename);
   for (auto ii = g.begin(), ei = g.end(); ii != ei; ++ii) {
-    auto& v = g.getData(*ii).latentVector;
-    for (int i = 0; i < LATENT_VECTOR_SIZE; ++i) {
+    LatentValue* v = latent.row(*ii);
+    for (size_t i = 0; i < latent.size(); ++i) {
       file.write(reinterpret_cast<char*>(&v[i]), sizeof(v[i]));
     }
   }
@@ -1411,11 +1418,12 @@ void writeBinaryLatentVectors(Graph& g, const std::string& filename) {
 }
 
 template <typename Graph>
-void writeAsciiLatentVectors(Graph& g, const std::string& filename) {
+void writeAsciiLatentVectors(Graph& g, LatentMatrix& latent,
+                             const std::string& filename) {
   std::ofstream file(filename);
   for (auto ii = g.begin(), ei = g.end(); ii != ei; ++ii) {
-    auto& v = g.getData(*ii).latentVector;
-    for (int i = 0; i < LATENT_VECTOR_SIZE; ++i) {
+    LatentValue* v = latent.row(*ii);
+    for (size_t i = 0; i < latent.size(); ++i) {
       file << v[i] << " ";
     }
     file << "\n";
@@ -1431,6 +1439,7 @@ void writeAsciiLatentVectors(Graph& g, const std::string& filename) {
 template <typename Algo>
 void run() {
   typename Algo::Graph g;
+  LatentMatrix latent;
   Algo algo;
 
   galois::runtime::reportNumaAlloc("NumaAlloc0");
@@ -1444,7 +1453,7 @@ void run() {
   galois::runtime::reportNumaAlloc("NumaAlloc1");
 
   // initialize latent vectors and get number of item nodes
-  NUM_ITEM_NODES = initializeGraphData(g);
+  NUM_ITEM_NODES = initializeGraphData(g, latent);
 
   galois::runtime::reportNumaAlloc("NumaAlloc2");
 
@@ -1453,8 +1462,9 @@ void run() {
             << " num ratings: " << g.sizeEdges() << "\n";
 
   std::unique_ptr<StepFunction> sf{newStepFunction()};
-  std::cout << "latent vector size: " << LATENT_VECTOR_SIZE
-            << " algo: " << algo.name() << " lambda: " << lambda;
+  std::cout << "latent vector size: " << latent.size()
+            << " kernel: " << latent.kernelName() << " algo: " << algo.name()
+            << " lambda: " << lambda;
 
   if (algo.isSgd()) {
     std::cout << " learning rate: " << learningRate
@@ -1465,27 +1475,27 @@ void run() {
   std::cout << "\n";
 
   if (!skipVerify) {
-    verify(g, "Initial");
+    verify(g, latent, "Initial");
   }
 
   // algorithm call
   galois::StatTimer execTime("Timer_0");
   execTime.start();
-  algo(g, *sf);
+  algo(g, latent, *sf);
   execTime.stop();
 
   if (!skipVerify) {
-    verify(g, "Final");
+    verify(g, latent, "Final");
   }
 
   if (outputFilename != "") {
     std::cout << "Writing latent vectors to " << outputFilename << "\n";
     switch (outputType) {
     case OutputType::binary:
-      writeBinaryLatentVectors(g, outputFilename);
+      writeBinaryLatentVectors(g, latent, outputFilename);
       break;
     case OutputType::ascii:
-      writeAsciiLatentVectors(g, outputFilename);
+      writeAsciiLatentVectors(g, latent, outputFilename);
       break;
     default:
       GALOIS_DIE("invalid output type for latent vector output");
@@ -1499,6 +1509,9 @@ int main(int argc, char** argv) {
   galois::SharedMemSys G;
   LonestarStart(argc, argv, name, desc, nullptr, &inputFile);
 
+  if (latentVectorSize == 0)
+    GALOIS_DIE("latent vector size must be positive");
+
   galois::StatTimer totalTime("TimerTotal");
   totalTime.start();
 
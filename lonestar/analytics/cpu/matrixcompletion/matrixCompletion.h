@@ -20,18 +20,23 @@
 #ifndef LONESTAR_MATRIXCOMPLETION_H
 #define LONESTAR_MATRIXCOMPLETION_H
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <galois/Galois.h>
 #include <galois/gstl.h>
+#include <galois/LargeArray.h>
 #include <string>
 #include "llvm/Support/CommandLine.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MATRIXCOMPLETION_X86
+#include <immintrin.h>
+#endif
+
 typedef float LatentValue;
 typedef float EdgeType;
 
-// Purdue, CSGD: 100; Intel: 20
-// static const int LATENT_VECTOR_SIZE = 100;
-static const int LATENT_VECTOR_SIZE = 20; // Purdue, CSGD: 100; Intel: 20
-
 /**
  * Common commandline parameters to for matrix completion algorithms
  */
@@ -58,6 +63,12 @@ static cll::opt<float> decayRate("decayRate",
                                            "Intel and Purdue step size "
                                            "function"),
                                  cll::init(0.015));
+// Purdue, CSGD: 100; Intel: 20
+static cll::opt<unsigned>
+    latentVectorSize("latentVectorSize",
+                     cll::desc("length of the latent vectors (default 20)"),
+                     cll::init(20));
+
 /*
  * (Purdue, Netflix): 0.05, (Purdue, Yahoo Music): 1.0, (Purdue, HugeWiki): 0.01
  * Intel: 0.001
@@ -120,71 +131,380 @@ static cll::opt<bool>
  *
  * Like std::inner_product but rewritten here to check vectorization
  *
+ * @tparam K length of the vectors if not 0, which lets the compiler unroll
+ * the loop completely; n is used otherwise
  * @param first1 Pointer to beginning of vector 1
- * @param last1 Pointer to end of vector 1. Should be exactly LATENT_VECTOR_SIZE
- * away from first1
- * @param first2 Pointer to beginning of vector 2. Should have at least
- * LATENT_VECTOR_SIZE elements from this point.
+ * @param first2 Pointer to beginning of vector 2
+ * @param n length of the vectors
  * @param init Initial value to accumulate sum into
  *
  * @returns init + the inner product (i.e. the inner product if init is 0, error
  * if init is -"ground truth"
  */
-template <typename T>
-T innerProduct(T* __restrict__ first1,
-               T* __restrict__ GALOIS_USED_ONLY_IN_DEBUG(last1),
-               T* __restrict__ first2, T init) {
-  assert(first1 + LATENT_VECTOR_SIZE == last1);
-  for (int i = 0; i < LATENT_VECTOR_SIZE; ++i) {
+template <unsigned K>
+LatentValue innerProduct(const LatentValue* __restrict__ first1,
+                         const LatentValue* __restrict__ first2, size_t n,
+                         LatentValue init) {
+  const size_t len = K ? K : n;
+  for (size_t i = 0; i < len; ++i) {
     init += first1[i] * first2[i];
   }
   return init;
 }
 
-template <typename T>
-T predictionError(T* __restrict__ itemLatent, T* __restrict__ userLatent,
-                  double actual) {
-  T v = actual;
-  return innerProduct(itemLatent, itemLatent + LATENT_VECTOR_SIZE, userLatent,
-                      -v);
-}
-
 /**
  * Objective: squared loss with weighted-square-norm regularization
  *
  * Updates latent vectors to reduce the error from the edge value.
  *
+ * @tparam K length of the vectors if not 0; n is used otherwise
  * @param itemLatent latent vector of the item
  * @param userLatent latent vector of the user
+ * @param n length of the vectors
  * @param lambda learning parameter
- * @param edgeRating Data on the edge, i.e. the number that the inner product
+ * @param rating Data on the edge, i.e. the number that the inner product
  * of the 2 latent vectors should eventually get to
- * @param stepSize learning parameter: how much to adjust vectors by to
+ * @param step learning parameter: how much to adjust vectors by to
  * correct for erro
  *
  * @return Error before gradient update
  */
-template <typename T>
-T doGradientUpdate(T* __restrict__ itemLatent, T* __restrict__ userLatent,
-                   double lambda, double edgeRating, double stepSize) {
-  // Implicit cast to type T
-  T l      = lambda;
-  T step   = stepSize;
-  T rating = edgeRating;
-  T error  = innerProduct(itemLatent, itemLatent + LATENT_VECTOR_SIZE,
-                         userLatent, -rating);
+template <unsigned K>
+LatentValue doGradientUpdate(LatentValue* __restrict__ itemLatent,
+                             LatentValue* __restrict__ userLatent, size_t n,
+                             LatentValue lambda, LatentValue rating,
+                             LatentValue step) {
+  const size_t len  = K ? K : n;
+  LatentValue error = innerProduct<K>(itemLatent, userLatent, len, -rating);
 
   // Take gradient step to reduce error
-  for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
-    T prevItem = itemLatent[i];
-    T prevUser = userLatent[i];
-    itemLatent[i] -= step * (error * prevUser + l * prevItem);
-    userLatent[i] -= step * (error * prevItem + l * prevUser);
+  for (size_t i = 0; i < len; i++) {
+    LatentValue prevItem = itemLatent[i];
+    LatentValue prevUser = userLatent[i];
+    itemLatent[i] -= step * (error * prevUser + lambda * prevItem);
+    userLatent[i] -= step * (error * prevItem + lambda * prevUser);
   }
 
   return error;
 }
 
+#ifdef MATRIXCOMPLETION_X86
+/*
+ * Vector versions of innerProduct and doGradientUpdate. They are compiled for
+ * their instruction sets with target attributes and chosen at runtime, so the
+ * rest of the program does not require them. The vectors must be 32-byte
+ * aligned and padded with zeros to a multiple of 8 elements, which
+ * LatentMatrix guarantees; zeros stay zero under gradient updates. 512-bit
+ * accesses may still straddle cache lines, so they are unaligned.
+ */
+
+__attribute__((target("avx2,fma"))) inline LatentValue
+horizontalSumAVX2(__m256 v) {
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  s        = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s        = _mm_add_ss(s, _mm_movehdup_ps(s));
+  return _mm_cvtss_f32(s);
+}
+
+template <unsigned K>
+__attribute__((target("avx2,fma"))) LatentValue
+innerProductAVX2(const LatentValue* __restrict__ first1,
+                 const LatentValue* __restrict__ first2, size_t n,
+                 LatentValue init) {
+  const size_t len = K ? K : n;
+  // two accumulators to overlap the latency of dependent FMAs
+  __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    acc0 = _mm256_fmadd_ps(_mm256_load_ps(first1 + i),
+                           _mm256_load_ps(first2 + i), acc0);
+    acc1 = _mm256_fmadd_ps(_mm256_load_ps(first1 + i + 8),
+                           _mm256_load_ps(first2 + i + 8), acc1);
+  }
+  if (i < len) {
+    acc0 = _mm256_fmadd_ps(_mm256_load_ps(first1 + i),
+                           _mm256_load_ps(first2 + i), acc0);
+  }
+  return init + horizontalSumAVX2(_mm256_add_ps(acc0, acc1));
+}
+
+template <unsigned K>
+__attribute__((target("avx2,fma"))) LatentValue
+doGradientUpdateAVX2(LatentValue* __restrict__ itemLatent,
+                     LatentValue* __restrict__ userLatent, size_t n,
+                     LatentValue lambda, LatentValue rating, LatentValue step) {
+  const size_t len = K ? K : n;
+  LatentValue error =
+      innerProductAVX2<K>(itemLatent, userLatent, len, -rating);
+
+  const __m256 e = _mm256_set1_ps(error);
+  const __m256 l = _mm256_set1_ps(lambda);
+  const __m256 s = _mm256_set1_ps(step);
+  for (size_t i = 0; i < len; i += 8) {
+    __m256 prevItem = _mm256_load_ps(itemLatent + i);
+    __m256 prevUser = _mm256_load_ps(userLatent + i);
+    __m256 gradItem =
+        _mm256_fmadd_ps(e, prevUser, _mm256_mul_ps(l, prevItem));
+    __m256 gradUser =
+        _mm256_fmadd_ps(e, prevItem, _mm256_mul_ps(l, prevUser));
+    _mm256_store_ps(itemLatent + i, _mm256_fnmadd_ps(s, gradItem, prevItem));
+    _mm256_store_ps(userLatent + i, _mm256_fnmadd_ps(s, gradUser, prevUser));
+  }
+  return error;
+}
+
+template <unsigned K>
+__attribute__((target("avx512f,avx2,fma"))) LatentValue
+innerProductAVX512(const LatentValue* __restrict__ first1,
+                   const LatentValue* __restrict__ first2, size_t n,
+                   LatentValue init) {
+  const size_t len = K ? K : n;
+  __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(first1 + i),
+                           _mm512_loadu_ps(first2 + i), acc0);
+    acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(first1 + i + 16),
+                           _mm512_loadu_ps(first2 + i + 16), acc1);
+  }
+  if (i + 16 <= len) {
+    acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(first1 + i),
+                           _mm512_loadu_ps(first2 + i), acc0);
+    i += 16;
+  }
+  // the 512-bit reductions and extracts draw a spurious -Wuninitialized from
+  // GCC 12, so reduce through memory
+  alignas(64) LatentValue sum[16];
+  _mm512_store_ps(sum, _mm512_add_ps(acc0, acc1));
+  __m256 acc = _mm256_add_ps(_mm256_load_ps(sum), _mm256_load_ps(sum + 8));
+  if (i < len) {
+    acc = _mm256_fmadd_ps(_mm256_load_ps(first1 + i),
+                          _mm256_load_ps(first2 + i), acc);
+  }
+  return init + horizontalSumAVX2(acc);
+}
+
+template <unsigned K>
+__attribute__((target("avx512f,avx2,fma"))) LatentValue
+doGradientUpdateAVX512(LatentValue* __restrict__ itemLatent,
+                       LatentValue* __restrict__ userLatent, size_t n,
+                       LatentValue lambda, LatentValue rating,
+                       LatentValue step) {
+  const size_t len = K ? K : n;
+  LatentValue error =
+      innerProductAVX512<K>(itemLatent, userLatent, len, -rating);
+
+  const __m512 e = _mm512_set1_ps(error);
+  const __m512 l = _mm512_set1_ps(lambda);
+  const __m512 s = _mm512_set1_ps(step);
+  size_t i       = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m512 prevItem = _mm512_loadu_ps(itemLatent + i);
+    __m512 prevUser = _mm512_loadu_ps(userLatent + i);
+    __m512 gradItem =
+        _mm512_fmadd_ps(e, prevUser, _mm512_mul_ps(l, prevItem));
+    __m512 gradUser =
+        _mm512_fmadd_ps(e, prevItem, _mm512_mul_ps(l, prevUser));
+    _mm512_storeu_ps(itemLatent + i, _mm512_fnmadd_ps(s, gradItem, prevItem));
+    _mm512_storeu_ps(userLatent + i, _mm512_fnmadd_ps(s, gradUser, prevUser));
+  }
+  if (i < len) {
+    const __m256 e8 = _mm256_set1_ps(error);
+    const __m256 l8 = _mm256_set1_ps(lambda);
+    const __m256 s8 = _mm256_set1_ps(step);
+    __m256 prevItem = _mm256_load_ps(itemLatent + i);
+    __m256 prevUser = _mm256_load_ps(userLatent + i);
+    __m256 gradItem =
+        _mm256_fmadd_ps(e8, prevUser, _mm256_mul_ps(l8, prevItem));
+    __m256 gradUser =
+        _mm256_fmadd_ps(e8, prevItem, _mm256_mul_ps(l8, prevUser));
+    _mm256_store_ps(itemLatent + i, _mm256_fnmadd_ps(s8, gradItem, prevItem));
+    _mm256_store_ps(userLatent + i, _mm256_fnmadd_ps(s8, gradUser, prevUser));
+  }
+  return error;
+}
+#endif
+
+/**
+ * innerProduct and doGradientUpdate for vectors of K elements (any length if
+ * K is 0) in portable code. The kernel types are passed as tags to
+ * LatentMatrix, so that loops templated on them call the kernel directly.
+ */
+template <unsigned K>
+struct ScalarKernel {
+  static const char* name() { return "scalar"; }
+
+  static LatentValue innerProduct(const LatentValue* first1,
+                                  const LatentValue* first2, size_t n,
+                                  LatentValue init) {
+    return ::innerProduct<K>(first1, first2, n, init);
+  }
+
+  static LatentValue gradientUpdate(LatentValue* itemLatent,
+                                    LatentValue* userLatent, size_t n,
+                                    LatentValue lambda, LatentValue rating,
+                                    LatentValue step) {
+    return ::doGradientUpdate<K>(itemLatent, userLatent, n, lambda, rating,
+                                 step);
+  }
+};
+
+#ifdef MATRIXCOMPLETION_X86
+//! Kernel for AVX2 and FMA; see ScalarKernel
+template <unsigned K>
+struct AVX2Kernel {
+  static const char* name() { return "avx2"; }
+
+  static LatentValue innerProduct(const LatentValue* first1,
+                                  const LatentValue* first2, size_t n,
+                                  LatentValue init) {
+    return innerProductAVX2<K>(first1, first2, n, init);
+  }
+
+  static LatentValue gradientUpdate(LatentValue* itemLatent,
+                                    LatentValue* userLatent, size_t n,
+                                    LatentValue lambda, LatentValue rating,
+                                    LatentValue step) {
+    return doGradientUpdateAVX2<K>(itemLatent, userLatent, n, lambda, rating,
+                                   step);
+  }
+};
+
+//! Kernel for AVX-512; see ScalarKernel
+template <unsigned K>
+struct AVX512Kernel {
+  static const char* name() { return "avx512"; }
+
+  static LatentValue innerProduct(const LatentValue* first1,
+                                  const LatentValue* first2, size_t n,
+                                  LatentValue init) {
+    return innerProductAVX512<K>(first1, first2, n, init);
+  }
+
+  static LatentValue gradientUpdate(LatentValue* itemLatent,
+                                    LatentValue* userLatent, size_t n,
+                                    LatentValue lambda, LatentValue rating,
+                                    LatentValue step) {
+    return doGradientUpdateAVX512<K>(itemLatent, userLatent, n, lambda, rating,
+                                     step);
+  }
+};
+#endif
+
+/**
+ * Latent vectors of all nodes, one row per node.
+ *
+ * Rows are padded with zeros to a multiple of ROW_ALIGN values, so that the
+ * kernels only use whole, aligned vectors (LargeArray memory is page
+ * aligned) and need no remainder loop. The padding takes part in the
+ * kernels but stays zero. Padding rows to whole cache lines instead costs
+ * more in memory traffic than it saves in false sharing for the default
+ * length of 20.
+ *
+ * The kernel for the row length and the processor is chosen once per loop
+ * with withKernel, which passes it to a generic lambda; the lambda
+ * instantiates the loop for that kernel.
+ */
+class LatentMatrix {
+  static const size_t ROW_ALIGN = 32 / sizeof(LatentValue);
+
+  enum InstructionSet { SCALAR, AVX2, AVX512 };
+
+  galois::LargeArray<LatentValue> values;
+  size_t numCols = 0;
+  size_t stride  = 0;
+  InstructionSet isa = SCALAR;
+
+  static InstructionSet detectInstructionSet() {
+#ifdef MATRIXCOMPLETION_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+      return AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return AVX2;
+#endif
+    return SCALAR;
+  }
+
+  template <unsigned K, typename F>
+  void withKernelFor(F& f) const {
+#ifdef MATRIXCOMPLETION_X86
+    if (isa == AVX512)
+      return f(AVX512Kernel<K>());
+    if (isa == AVX2)
+      return f(AVX2Kernel<K>());
+#endif
+    f(ScalarKernel<K>());
+  }
+
+public:
+  //! Allocates numRows rows of numCols values; contents are zero
+  void allocate(size_t numRows, size_t numCols_) {
+    numCols = numCols_;
+    stride  = (numCols + ROW_ALIGN - 1) / ROW_ALIGN * ROW_ALIGN;
+    values.allocateInterleaved(numRows * stride);
+    assert(reinterpret_cast<uintptr_t>(values.data()) % 32 == 0);
+    galois::do_all(
+        galois::iterate(size_t{0}, numRows),
+        [&](size_t n) { std::fill_n(row(n), stride, LatentValue(0)); },
+        galois::no_stats(), galois::loopname("LatentMatrixZero"));
+    isa = detectInstructionSet();
+  }
+
+  //! Length of the latent vectors
+  size_t size() const { return numCols; }
+
+  const char* kernelName() const {
+    const char* name = nullptr;
+    withKernel([&](auto kernel) { name = kernel.name(); });
+    return name;
+  }
+
+  /**
+   * Calls f with the kernel for the rows; unrolled for common padded
+   * lengths.
+   */
+  template <typename F>
+  void withKernel(F&& f) const {
+    switch (stride) {
+    case 16:
+      return withKernelFor<16>(f);
+    case 24:
+      return withKernelFor<24>(f);
+    case 32:
+      return withKernelFor<32>(f);
+    case 64:
+      return withKernelFor<64>(f);
+    case 104:
+      return withKernelFor<104>(f);
+    case 128:
+      return withKernelFor<128>(f);
+    case 256:
+      return withKernelFor<256>(f);
+    default:
+      return withKernelFor<0>(f);
+    }
+  }
+
+  LatentValue* row(size_t n) { return &values[n * stride]; }
+  const LatentValue* row(size_t n) const { return &values[n * stride]; }
+
+  //! Inner product of the latent vectors of item and user minus actual
+  template <typename Kernel>
+  LatentValue predictionError(Kernel, size_t item, size_t user,
+                              double actual) const {
+    return Kernel::innerProduct(row(item), row(user), stride, -actual);
+  }
+
+  //! doGradientUpdate on the latent vectors of item and user
+  template <typename Kernel>
+  LatentValue doGradientUpdate(Kernel, size_t item, size_t user, double lambda,
+                               double edgeRating, double stepSize) {
+    return Kernel::gradientUpdate(row(item), row(user), stride, lambda,
+                                  edgeRating, stepSize);
+  }
+};
+
 struct StepFunction {
   virtual LatentValue stepSize(int round) const = 0;
   virtual std::string name() const              = 0;
@@ -203,6 +523,6 @@ static double genVal(uint32_t n) {
 StepFunction* newStepFunction();
 
 template <typename Graph>
-size_t initializeGraphData(Graph& g);
+size_t initializeGraphData(Graph& g, LatentMatrix& latent);
 
 #endif
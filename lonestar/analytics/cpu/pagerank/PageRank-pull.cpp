@@ -22,6 +22,7 @@
 #include "galois/Galois.h"
 #include "galois/LargeArray.h"
 #include "galois/Timer.h"
+#include "galois/graphs/GraphCache.h"
 #include "galois/graphs/LCGraph.h"
 #include "galois/graphs/TypeTraits.h"
 #include "galois/gstl.h"
@@ -43,7 +44,14 @@ static cll::opt<bool>
                     cll::desc("Specify that the input graph is transposed"),
                     cll::init(false));
 
-constexpr static const unsigned CHUNK_SIZE = 32;
+enum GraphType { CSR, Compressed };
+
+static cll::opt<GraphType> graphType(
+    "graphType", cll::desc("Graph representation:"),
+    cll::values(clEnumVal(CSR, "CSR (default)"),
+                clEnumVal(Compressed, "Varint gap-compressed adjacency lists, "
+                                      "read from .gr or .vgr")),
+    cll::init(CSR));
 
 struct LNode {
   PRTy value;
@@ -54,11 +62,15 @@ typedef galois::graphs::LC_CSR_Graph<LNode, void>::with_no_lockable<
     true>::type ::with_numa_alloc<true>::type Graph;
 typedef typename Graph::GraphNode GNode;
 
+typedef galois::graphs::LC_Compressed_Graph<LNode, void>::with_no_lockable<
+    true>::type ::with_numa_alloc<true>::type CompressedGraph;
+
 using DeltaArray    = galois::LargeArray<PRTy>;
 using ResidualArray = galois::LargeArray<PRTy>;
 
 //! Initialize nodes for the topological algorithm.
-void initNodeDataTopological(Graph& g) {
+template <typename GraphTy>
+void initNodeDataTopological(GraphTy& g) {
   PRTy init_value = 1.0f / g.size();
   galois::do_all(
       galois::iterate(g),
@@ -71,7 +83,8 @@ void initNodeDataTopological(Graph& g) {
 }
 
 //! Initialize nodes for the residual algorithm.
-void initNodeDataResidual(Graph& g, DeltaArray& delta,
+template <typename GraphTy>
+void initNodeDataResidual(GraphTy& g, DeltaArray& delta,
                           ResidualArray& residual) {
   galois::do_all(
       galois::iterate(g),
@@ -87,7 +100,8 @@ void initNodeDataResidual(Graph& g, DeltaArray& delta,
 
 //! Computing outdegrees in the tranpose graph is equivalent to computing the
 //! indegrees in the original graph.
-void computeOutDeg(Graph& graph) {
+template <typename GraphTy>
+void computeOutDeg(GraphTy& graph) {
   galois::StatTimer outDegreeTimer("computeOutDegFunc");
   outDegreeTimer.start();
 
@@ -100,15 +114,14 @@ void computeOutDeg(Graph& graph) {
       galois::loopname("InitDegVec"));
 
   galois::do_all(
-      galois::iterate(graph),
+      galois::iterate_edge_balanced(graph),
       [&](const GNode& src) {
         for (auto nbr : graph.edges(src)) {
           GNode dst = graph.getEdgeDst(nbr);
           vec[dst].fetch_add(1ul);
         };
       },
-      galois::steal(), galois::chunk_size<CHUNK_SIZE>(), galois::no_stats(),
-      galois::loopname("computeOutDeg"));
+      galois::no_stats(), galois::loopname("computeOutDeg"));
 
   galois::do_all(
       galois::iterate(graph),
@@ -129,7 +142,8 @@ void computeOutDeg(Graph& graph) {
  * the next pagerank.
  */
 //! [scalarreduction]
-void computePRResidual(Graph& graph, DeltaArray& delta,
+template <typename GraphTy>
+void computePRResidual(GraphTy& graph, DeltaArray& delta,
                        ResidualArray& residual) {
   unsigned int iterations = 0;
   galois::GAccumulator<unsigned int> accum;
@@ -156,7 +170,7 @@ void computePRResidual(Graph& graph, DeltaArray& delta,
         galois::no_stats(), galois::loopname("PageRank_delta"));
 
     galois::do_all(
-        galois::iterate(graph),
+        galois::iterate_edge_balanced(graph),
         [&](const GNode& src) {
           float sum = 0;
           for (auto nbr : graph.edges(src)) {
@@ -169,8 +183,7 @@ void computePRResidual(Graph& graph, DeltaArray& delta,
             residual[src] = sum;
           }
         },
-        galois::steal(), galois::chunk_size<CHUNK_SIZE>(), galois::no_stats(),
-        galois::loopname("PageRank"));
+        galois::no_stats(), galois::loopname("PageRank"));
 
 #if DEBUG
     std::cout << "iteration: " << iterations << "\n";
@@ -193,14 +206,15 @@ void computePRResidual(Graph& graph, DeltaArray& delta,
  * PageRank pull topological.
  * Always calculate the new pagerank for each iteration.
  */
-void computePRTopological(Graph& graph) {
+template <typename GraphTy>
+void computePRTopological(GraphTy& graph) {
   unsigned int iteration = 0;
   galois::GAccumulator<float> accum;
 
   float base_score = (1.0f - ALPHA) / graph.size();
   while (true) {
     galois::do_all(
-        galois::iterate(graph),
+        galois::iterate_edge_balanced(graph),
         [&](const GNode& src) {
           constexpr const galois::MethodFlag flag =
               galois::MethodFlag::UNPROTECTED;
@@ -228,8 +242,7 @@ void computePRTopological(Graph& graph) {
           sdata.value = value;
           accum += diff;
         },
-        galois::no_stats(), galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
-        galois::loopname("PageRank"));
+        galois::no_stats(), galois::loopname("PageRank"));
 
 #if DEBUG
     std::cout << "iteration: " << iteration << " max delta: " << delta << "\n";
@@ -250,7 +263,8 @@ void computePRTopological(Graph& graph) {
   }
 }
 
-void prTopological(Graph& graph) {
+template <typename GraphTy>
+void prTopological(GraphTy& graph) {
   initNodeDataTopological(graph);
   computeOutDeg(graph);
 
@@ -260,7 +274,8 @@ void prTopological(Graph& graph) {
   execTime.stop();
 }
 
-void prResidual(Graph& graph) {
+template <typename GraphTy>
+void prResidual(GraphTy& graph) {
   DeltaArray delta;
   delta.allocateInterleaved(graph.size());
   ResidualArray residual;
@@ -275,31 +290,26 @@ void prResidual(Graph& graph) {
   execTime.stop();
 }
 
-int main(int argc, char** argv) {
-  galois::SharedMemSys G;
-  LonestarStart(argc, argv, name, desc, url, &inputFile);
-
-  if (!transposedGraph) {
-    GALOIS_DIE("This application requires a transposed graph input;"
-               " please use the -transposedGraph flag "
-               " to indicate the input is a transposed graph.");
-  }
-  galois::StatTimer totalTime("TimerTotal");
-  totalTime.start();
-
-  Graph transposeGraph;
+template <typename GraphTy>
+void run() {
+  GraphTy transposeGraph;
   std::cout << "WARNING: pull style algorithms work on the transpose of the "
-               "actual graph\n"
-            << "WARNING: this program assumes that " << inputFile
-            << " contains transposed representation\n\n"
-            << "Reading graph: " << inputFile << "\n";
-
-  galois::graphs::readGraph(transposeGraph, inputFile);
+               "actual graph\n";
+  if (transposedGraph) {
+    std::cout << "WARNING: this program assumes that " << inputFile
+              << " contains transposed representation\n\n"
+              << "Reading graph: " << inputFile << "\n";
+    galois::graphs::readGraph(transposeGraph, inputFile);
+  } else {
+    std::cout << "Reading transpose of graph: " << inputFile << "\n";
+    galois::graphs::readGraphCached(transposeGraph, inputFile,
+                                    galois::graphs::Transpose);
+  }
   std::cout << "Read " << transposeGraph.size() << " nodes, "
             << transposeGraph.sizeEdges() << " edges\n";
 
   galois::preAlloc(2 * numThreads + (3 * transposeGraph.size() *
-                                     sizeof(typename Graph::node_data_type)) /
+                                     sizeof(typename GraphTy::node_data_type)) /
                                         galois::runtime::pagePoolSize());
   galois::reportPageAlloc("MeminfoPre");
 
@@ -355,6 +365,20 @@ int main(int argc, char** argv) {
 #if DEBUG
   printPageRank(transposeGraph);
 #endif
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  galois::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (graphType == Compressed) {
+    run<CompressedGraph>();
+  } else {
+    run<Graph>();
+  }
 
   totalTime.stop();
 
@@ -60,6 +60,7 @@ enum Algo {
   deltaTile = 0,
   deltaStep,
   deltaStepBarrier,
+  deltaStepLockFree,
   serDeltaTile,
   serDelta,
   dijkstraTile,
@@ -70,15 +71,16 @@ enum Algo {
 };
 
 const char* const ALGO_NAMES[] = {
-    "deltaTile", "deltaStep",    "deltaStepBarrier", "serDeltaTile",
-    "serDelta",  "dijkstraTile", "dijkstra",         "topo",
-    "topoTile",  "Auto"};
+    "deltaTile",    "deltaStep",    "deltaStepBarrier", "deltaStepLockFree",
+    "serDeltaTile", "serDelta",     "dijkstraTile",     "dijkstra",
+    "topo",         "topoTile",     "Auto"};
 
 static cll::opt<Algo> algo(
     "algo", cll::desc("Choose an algorithm (default value auto):"),
     cll::values(clEnumVal(deltaTile, "deltaTile"),
                 clEnumVal(deltaStep, "deltaStep"),
                 clEnumVal(deltaStepBarrier, "deltaStepBarrier"),
+                clEnumVal(deltaStepLockFree, "deltaStepLockFree"),
                 clEnumVal(serDeltaTile, "serDeltaTile"),
                 clEnumVal(serDelta, "serDelta"),
                 clEnumVal(dijkstraTile, "dijkstraTile"),
@@ -115,6 +117,8 @@ using OBIM    = gwl::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
 using OBIM_Barrier =
     gwl::OrderedByIntegerMetric<UpdateRequestIndexer,
                                 PSchunk>::with_barrier<true>::type;
+using OBIM_LockFree =
+    gwl::LockFreeOrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
 
 template <typename T, typename OBIMTy = OBIM, typename P, typename R>
 void deltaStepAlgo(Graph& graph, GNode source, const P& pushWrap,
@@ -396,7 +400,7 @@ int main(int argc, char** argv) {
   galois::reportPageAlloc("MeminfoPre");
 
   if (algo == deltaStep || algo == deltaTile || algo == serDelta ||
-      algo == serDeltaTile) {
+      algo == serDeltaTile || algo == deltaStepLockFree) {
     std::cout << "INFO: Using delta-step of " << delta << "\n";
     std::cout
         << "WARNING: Performance varies considerably due to delta parameter.\n";
@@ -467,6 +471,11 @@ int main(int argc, char** argv) {
                                                OutEdgeRangeFn{graph});
     break;
 
+  case deltaStepLockFree:
+    deltaStepAlgo<UpdateRequest, OBIM_LockFree>(graph, source, ReqPushWrap(),
+                                                OutEdgeRangeFn{graph});
+    break;
+
   default:
     std::abort();
   }
@@ -19,12 +19,13 @@
 
 #include "galois/Galois.h"
 #include "galois/Bag.h"
-#include "galois/ParallelSTL.h"
 #include "galois/Reduction.h"
 #include "galois/Timer.h"
 #include "galois/graphs/LCGraph.h"
-#include "galois/graphs/BufferedGraph.h"
+#include "galois/graphs/GraphCache.h"
+#include "galois/graphs/Intersect.h"
 #include "galois/runtime/Profile.h"
+#include "galois/substrate/PerThreadStorage.h"
 #include "llvm/Support/CommandLine.h"
 #include "Lonestar/Utils.h"
 #include "Lonestar/BoilerPlate.h"
@@ -94,30 +95,6 @@ Iterator lowerBound(Iterator first, Iterator last, Compare comp) {
   return first;
 }
 
-/**
- * std::set_intersection over edge_iterators.
- */
-template <typename G>
-size_t countEqual(G& g, typename G::edge_iterator aa,
-                  typename G::edge_iterator ea, typename G::edge_iterator bb,
-                  typename G::edge_iterator eb) {
-  size_t retval = 0;
-  while (aa != ea && bb != eb) {
-    typename G::GraphNode a = g.getEdgeDst(aa);
-    typename G::GraphNode b = g.getEdgeDst(bb);
-    if (a < b) {
-      ++aa;
-    } else if (b < a) {
-      ++bb;
-    } else {
-      retval += 1;
-      ++aa;
-      ++bb;
-    }
-  }
-  return retval;
-}
-
 template <typename G>
 struct LessThan {
   G& g;
@@ -236,41 +213,70 @@ void nodeIteratingAlgo(Graph& graph) {
   std::cout << "Num Triangles: " << numTriangles.reduce() << "\n";
 }
 
+//! Nodes with at least this many neighbors are intersected through a bitmap
+constexpr static const size_t HUB_DEGREE = 1024;
+
 /**
  * Lambda function to count triangles
+ *
+ * The graph is oriented, so every triangle is counted once as a common
+ * out-neighbor of n and one of its out-neighbors v. The neighbors of a hub n
+ * are set in a per-thread bitmap first so that each intersection only costs
+ * the degree of v.
  */
 void orderedCountFunc(Graph& graph, GNode n,
-                      galois::GAccumulator<size_t>& numTriangles) {
+                      galois::GAccumulator<size_t>& numTriangles,
+                      galois::substrate::PerThreadStorage<
+                          std::vector<uint64_t>>& bitmaps) {
+  const uint32_t* dsts = graph.getEdgeDsts();
+  const uint32_t* nBegin =
+      dsts + *graph.edge_begin(n, galois::MethodFlag::UNPROTECTED);
+  const uint32_t* nEnd =
+      dsts + *graph.edge_end(n, galois::MethodFlag::UNPROTECTED);
+
+  std::vector<uint64_t>* bits = nullptr;
+  if (size_t(nEnd - nBegin) >= HUB_DEGREE) {
+    bits = bitmaps.getLocal();
+    bits->resize(graph.size() / 64 + 1);
+    for (const uint32_t* it = nBegin; it != nEnd; ++it)
+      (*bits)[*it / 64] |= uint64_t(1) << (*it % 64);
+  }
+
   size_t numTriangles_local = 0;
-  for (auto it_v : graph.edges(n)) {
-    auto v = graph.getEdgeDst(it_v);
-    if (v > n)
-      break;
-    Graph::edge_iterator it_n =
-        graph.edge_begin(n, galois::MethodFlag::UNPROTECTED);
-
-    for (auto it_vv : graph.edges(v)) {
-      auto vv = graph.getEdgeDst(it_vv);
-      if (vv > v)
-        break;
-      while (graph.getEdgeDst(it_n) < vv)
-        it_n++;
-      if (vv == graph.getEdgeDst(it_n)) {
-        numTriangles_local += 1;
-      }
-    }
+  for (const uint32_t* it = nBegin; it != nEnd; ++it) {
+    GNode v = *it;
+    const uint32_t* vBegin =
+        dsts + *graph.edge_begin(v, galois::MethodFlag::UNPROTECTED);
+    const uint32_t* vEnd =
+        dsts + *graph.edge_end(v, galois::MethodFlag::UNPROTECTED);
+    if (bits)
+      numTriangles_local +=
+          galois::graphs::intersectCount(bits->data(), vBegin, vEnd - vBegin);
+    else
+      numTriangles_local += galois::graphs::intersectCount(
+          nBegin, nEnd - nBegin, vBegin, vEnd - vBegin);
+  }
+
+  if (bits) {
+    for (const uint32_t* it = nBegin; it != nEnd; ++it)
+      (*bits)[*it / 64] = 0;
   }
   numTriangles += numTriangles_local;
 }
 
 /*
- * Simple counting loop, instead of binary searching.
+ * Simple counting loop over a graph oriented by degree, instead of binary
+ * searching.
  */
 void orderedCountAlgo(Graph& graph) {
   galois::GAccumulator<size_t> numTriangles;
+  galois::substrate::PerThreadStorage<std::vector<uint64_t>> bitmaps;
+  // work grows faster than the degree, so keep stealing from balanced blocks
   galois::do_all(
-      galois::iterate(graph),
-      [&](const GNode& n) { orderedCountFunc(graph, n, numTriangles); },
+      galois::iterate_edge_balanced(graph),
+      [&](const GNode& n) {
+        orderedCountFunc(graph, n, numTriangles, bitmaps);
+      },
       galois::chunk_size<CHUNK_SIZE>(), galois::steal(),
       galois::loopname("orderedCountAlgo"));
 
@@ -340,7 +346,8 @@ void edgeIteratingAlgo(Graph& graph) {
               Graph::edge_iterator eb =
                   lowerBound(bbegin, bend, LessThan<Graph>(graph, w.dst));
 
-              numTriangles += countEqual(graph, aa, ea, bb, eb);
+              numTriangles +=
+                  galois::graphs::countCommonNeighbors(graph, aa, ea, bb, eb);
             },
             galois::loopname("edgeIteratingAlgo"),
             galois::chunk_size<CHUNK_SIZE>(), galois::steal());
@@ -352,108 +359,13 @@ void edgeIteratingAlgo(Graph& graph) {
 }
 
 //! Sorts read graph by degree (high degree nodes are reindexed to beginning)
-void makeSortedGraph(Graph& graph) {
-  galois::StatTimer readTimer("ReadGraphTimer");
-  readTimer.start();
-  // read original graph
-  galois::graphs::BufferedGraph<void> initial;
-  initial.loadGraph(inputFile);
-  readTimer.stop();
-
+void makeSortedGraph(Graph& graph, unsigned transforms) {
   galois::StatTimer Trelabel("GraphRelabelTimer");
   Trelabel.start();
-
-  size_t numGraphNodes = initial.size();
-  // create node -> degree pairs
-  using DegreeNodePair = std::pair<uint64_t, uint32_t>;
-  std::vector<DegreeNodePair> dnPairs(numGraphNodes);
-  galois::do_all(
-      galois::iterate(size_t{0}, numGraphNodes),
-      [&](size_t nodeID) {
-        size_t nodeDegree =
-            std::distance(initial.edgeBegin(nodeID), initial.edgeEnd(nodeID));
-        dnPairs[nodeID] = DegreeNodePair(nodeDegree, nodeID);
-      },
-      galois::loopname("CreateDegreeNodeVector"));
-
-  galois::StatTimer degSortTimer("DegreeSortTimer");
-  degSortTimer.start();
-  // sort by degree (first item)
-  galois::ParallelSTL::sort(dnPairs.begin(), dnPairs.end(),
-                            std::greater<DegreeNodePair>());
-  degSortTimer.stop();
-
-  // create mapping, get degrees out to another vector to get prefix sum
-  std::vector<uint32_t> oldToNewMapping(numGraphNodes);
-  std::vector<uint64_t> inProgressPrefixSum(numGraphNodes);
-  galois::do_all(
-      galois::iterate(size_t{0}, numGraphNodes),
-      [&](size_t index) {
-        // save degree, which is pair.first
-        inProgressPrefixSum[index] = dnPairs[index].first;
-        // save mapping; original index is in .second, map it to current index
-        oldToNewMapping[dnPairs[index].second] = index;
-      },
-      galois::loopname("CreateRemappingGetPrefixSum"));
-
-  std::vector<uint64_t> newPrefixSum(numGraphNodes);
-  galois::ParallelSTL::partial_sum(inProgressPrefixSum.begin(),
-                                   inProgressPrefixSum.end(),
-                                   newPrefixSum.begin());
-
-  // allocate graph
-  graph.allocateFrom(numGraphNodes, initial.sizeEdges());
-  // construct nodes
-  graph.constructNodes();
-  // set edge endpoints using prefix sum
-  galois::do_all(
-      galois::iterate(size_t{0}, numGraphNodes),
-      [&](size_t nodeIndex) {
-        graph.fixEndEdge(nodeIndex, newPrefixSum[nodeIndex]);
-      },
-      galois::loopname("SetEdgeEndpoints"));
-
-  // construct edges by looping through filegraph and saving to correct
-  // locations
-  galois::do_all(
-      galois::iterate(0u, initial.size()),
-      [&](uint32_t oldNodeID) {
-        uint32_t newIndex = oldToNewMapping[oldNodeID];
-
-        // get the start location of this reindex'd nodes edges
-        uint64_t currentEdgeIndex;
-        if (newIndex != 0) {
-          currentEdgeIndex = newPrefixSum[newIndex - 1];
-        } else {
-          currentEdgeIndex = 0;
-        }
-
-        // construct the graph, reindexing as it goes along
-        for (auto e = initial.edgeBegin(oldNodeID);
-             e < initial.edgeEnd(oldNodeID); e++) {
-          // get destination, reindex
-          uint32_t oldEdgeDst       = initial.edgeDestination(*e);
-          uint32_t reindexedEdgeDst = oldToNewMapping[oldEdgeDst];
-
-          // construct edge
-          graph.constructEdge(currentEdgeIndex, reindexedEdgeDst);
-          currentEdgeIndex++;
-        }
-        // this assert makes sure reindex was correct + makes sure all edges
-        // are accounted for
-        assert(currentEdgeIndex == newPrefixSum[newIndex]);
-      },
-      galois::steal(), galois::loopname("ReindexingGraph"));
-
-  galois::StatTimer edgeSortTimer("EdgeSortTimer");
-  edgeSortTimer.start();
-  // sort by destinations
-  graph.sortAllEdgesByDst();
-  edgeSortTimer.stop();
-
-  // initialize local ranges
-  graph.initializeLocalRanges();
-
+  galois::graphs::readGraphCached(graph, inputFile,
+                                  transforms |
+                                      galois::graphs::RelabelByDegree |
+                                      galois::graphs::SortByDst);
   Trelabel.stop();
 }
 
@@ -467,13 +379,17 @@ void readGraph(Graph& graph) {
     relabel = isApproximateDegreeDistributionPowerLaw(degreeGraph);
     autoAlgoTimer.stop();
   }
+  // orderedCount only needs each edge from its lower to higher degree end
+  unsigned transforms = 0;
+  if (algo == orderedCount)
+    transforms = galois::graphs::OrientByDegree;
   if (relabel) {
     galois::gInfo("Relabeling and sorting graph...");
-    makeSortedGraph(graph);
+    makeSortedGraph(graph, transforms);
   } else {
-    galois::graphs::readGraph(graph, inputFile);
     // algorithm correctness requires sorting edges by destination
-    graph.sortAllEdgesByDst();
+    galois::graphs::readGraphCached(graph, inputFile,
+                                    transforms | galois::graphs::SortByDst);
   }
 }
 
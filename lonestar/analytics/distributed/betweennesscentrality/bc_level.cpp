@@ -29,6 +29,7 @@
 #include "galois/DistGalois.h"
 #include "galois/gstl.h"
 #include "galois/DReducible.h"
+#include "galois/graphs/GluonCheckpoint.h"
 #include "galois/runtime/Tracer.h"
 
 #include <iomanip>
@@ -629,6 +630,13 @@ int main(int argc, char** argv) {
 
   auto& net = galois::runtime::getSystemNetworkInterface();
 
+  if (!checkpointDir.empty() && (singleSourceBC || personality == GPU_CUDA)) {
+    GALOIS_DIE("checkpointing requires multiple sources on CPUs");
+  }
+  if (checkpointInterval == 0) {
+    GALOIS_DIE("checkpointInterval must be positive");
+  }
+
   galois::StatTimer StatTimer_total("TimerTotal", REGION_NAME);
 
   StatTimer_total.start();
@@ -694,7 +702,25 @@ int main(int argc, char** argv) {
 
     galois::StatTimer StatTimer_main(timer_str.c_str(), REGION_NAME);
 
-    for (uint64_t i = 0; i < loop_end; i++) {
+    // each source reinitializes all but the accumulated centrality, so
+    // snapshots are taken between sources and a restart skips the sources
+    // already accumulated
+    uint64_t first_source = 0;
+    std::unique_ptr<galois::graphs::GluonCheckpoint<NodeData, void>>
+        checkpoint;
+    if (!checkpointDir.empty()) {
+      checkpoint =
+          std::make_unique<galois::graphs::GluonCheckpoint<NodeData, void>>(
+              *h_graph, checkpointDir);
+      uint64_t round;
+      if (restart && run == 0 && checkpoint->restore(round)) {
+        galois::gPrint("[", net.ID, "] Restarting after source ", round,
+                       "\n");
+        first_source = round + 1;
+      }
+    }
+
+    for (uint64_t i = first_source; i < loop_end; i++) {
       if (singleSourceBC) {
         // only 1 source; specified start source in command line
         assert(loop_end == 1);
@@ -736,6 +762,14 @@ int main(int argc, char** argv) {
             REGION_NAME, std::string("TotalRounds_") + std::to_string(run),
             globalRoundNumber + backRounds);
       }
+
+      if (checkpoint && (i + 1) % checkpointInterval == 0) {
+        checkpoint->save(i);
+      }
+    }
+
+    if (checkpoint) {
+      checkpoint->finish();
     }
 
     Sanity::go(*h_graph, dga_max, dga_min, dga_sum);
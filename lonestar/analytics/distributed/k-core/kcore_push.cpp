@@ -26,6 +26,7 @@
 #include "galois/DistGalois.h"
 #include "galois/DReducible.h"
 #include "galois/DTerminationDetector.h"
+#include "galois/graphs/GluonCheckpoint.h"
 #include "galois/gstl.h"
 #include "galois/runtime/Tracer.h"
 
@@ -244,6 +245,22 @@ struct KCoreStep1 {
 
     const auto& nodesWithEdges = _graph.allNodesWithEdgesRange();
 
+    // rounds of the asynchronous variant do not end on a consistent state
+    std::unique_ptr<galois::graphs::GluonCheckpoint<NodeData, void>>
+        checkpoint;
+    if (!async && !checkpointDir.empty()) {
+      checkpoint =
+          std::make_unique<galois::graphs::GluonCheckpoint<NodeData, void>>(
+              _graph, checkpointDir);
+      uint64_t round;
+      if (restart && syncSubstrate->get_run_num() == 0 &&
+          checkpoint->restore(round)) {
+        galois::gPrint("[", galois::runtime::getSystemNetworkInterface().ID,
+                       "] Restarting after round ", round, "\n");
+        iterations = round + 1;
+      }
+    }
+
     do {
       syncSubstrate->set_num_round(iterations);
       dga.reset();
@@ -277,10 +294,18 @@ struct KCoreStep1 {
       // handle trimming (locally)
       KCoreStep2::go(_graph);
 
+      if (checkpoint && (iterations + 1) % checkpointInterval == 0) {
+        checkpoint->save(iterations);
+      }
+
       iterations++;
     } while ((async || (iterations < maxIterations)) &&
              dga.reduce(syncSubstrate->get_run_identifier()));
 
+    if (checkpoint) {
+      checkpoint->finish();
+    }
+
     if (galois::runtime::getSystemNetworkInterface().ID == 0) {
       galois::runtime::reportStat_Single(
           REGION_NAME,
@@ -424,6 +449,14 @@ int main(int argc, char** argv) {
     galois::runtime::reportParam(REGION_NAME, "Max Iterations", maxIterations);
   }
 
+  if (!checkpointDir.empty() &&
+      (execution == Async || personality == GPU_CUDA)) {
+    GALOIS_DIE("checkpointing requires -exec=Sync on CPUs");
+  }
+  if (checkpointInterval == 0) {
+    GALOIS_DIE("checkpointInterval must be positive");
+  }
+
   galois::StatTimer StatTimer_total("TimerTotal", REGION_NAME);
 
   StatTimer_total.start();
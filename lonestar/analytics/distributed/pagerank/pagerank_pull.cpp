@@ -23,6 +23,7 @@
 #include "galois/gstl.h"
 #include "galois/DReducible.h"
 #include "galois/DTerminationDetector.h"
+#include "galois/graphs/GluonCheckpoint.h"
 #include "galois/runtime/Tracer.h"
 
 #include <algorithm>
@@ -250,6 +251,22 @@ struct PageRank {
     const auto& nodesWithEdges = _graph.allNodesWithEdgesRange();
     DGTerminatorDetector dga;
 
+    // rounds of the asynchronous variant do not end on a consistent state
+    std::unique_ptr<galois::graphs::GluonCheckpoint<NodeData, void>>
+        checkpoint;
+    if (!async && !checkpointDir.empty()) {
+      checkpoint = std::make_unique<
+          galois::graphs::GluonCheckpoint<NodeData, void>>(_graph,
+                                                           checkpointDir);
+      uint64_t round;
+      if (restart && syncSubstrate->get_run_num() == 0 &&
+          checkpoint->restore(round)) {
+        galois::gPrint("[", galois::runtime::getSystemNetworkInterface().ID,
+                       "] Restarting after round ", round, "\n");
+        _num_iterations = round + 1;
+      }
+    }
+
     // unsigned int reduced = 0;
 
     do {
@@ -285,10 +302,18 @@ struct PageRank {
           REGION_NAME, "NumWorkItems_" + (syncSubstrate->get_run_identifier()),
           (unsigned long)_graph.sizeEdges());
 
+      if (checkpoint && (_num_iterations + 1) % checkpointInterval == 0) {
+        checkpoint->save(_num_iterations);
+      }
+
       ++_num_iterations;
     } while ((async || (_num_iterations < maxIterations)) &&
              dga.reduce(syncSubstrate->get_run_identifier()));
 
+    if (checkpoint) {
+      checkpoint->finish();
+    }
+
     galois::runtime::reportStat_Tmax(
         REGION_NAME,
         "NumIterations_" + std::to_string(syncSubstrate->get_run_num()),
@@ -494,6 +519,14 @@ int main(int argc, char** argv) {
     galois::runtime::reportParam(REGION_NAME, "Tolerance", ss.str());
   }
 
+  if (!checkpointDir.empty() &&
+      (execution == Async || personality == GPU_CUDA)) {
+    GALOIS_DIE("checkpointing requires -exec=Sync on CPUs");
+  }
+  if (checkpointInterval == 0) {
+    GALOIS_DIE("checkpointInterval must be positive");
+  }
+
   galois::StatTimer StatTimer_total("TimerTotal", REGION_NAME);
 
   StatTimer_total.start();
@@ -22,6 +22,7 @@
 #include "galois/DistGalois.h"
 #include "galois/DReducible.h"
 #include "galois/DTerminationDetector.h"
+#include "galois/graphs/GluonCheckpoint.h"
 #include "galois/gstl.h"
 #include "galois/runtime/Tracer.h"
 
@@ -217,6 +218,23 @@ struct SSSP {
     DGTerminatorDetector dga;
     DGAccumulatorTy work_edges;
 
+    // rounds of the asynchronous variant do not end on a consistent state
+    std::unique_ptr<galois::graphs::GluonCheckpoint<NodeData, uint32_t>>
+        checkpoint;
+    if (!async && !checkpointDir.empty()) {
+      checkpoint = std::make_unique<
+          galois::graphs::GluonCheckpoint<NodeData, uint32_t>>(_graph,
+                                                               checkpointDir);
+      uint64_t round;
+      if (restart && syncSubstrate->get_run_num() == 0 &&
+          checkpoint->restore(round)) {
+        galois::gPrint("[", galois::runtime::getSystemNetworkInterface().ID,
+                       "] Restarting after round ", round, "\n");
+        _num_iterations = round + 1;
+        priority += delta * round;
+      }
+    }
+
     do {
 
       // if (work_edges.reduce() == 0)
@@ -253,10 +271,19 @@ struct SSSP {
       galois::runtime::reportStat_Tsum(
           "SSSP", "NumWorkItems_" + (syncSubstrate->get_run_identifier()),
           work_edges.read_local());
+
+      if (checkpoint && _num_iterations % checkpointInterval == 0) {
+        checkpoint->save(_num_iterations);
+      }
+
       ++_num_iterations;
     } while ((async || (_num_iterations < maxIterations)) &&
              dga.reduce(syncSubstrate->get_run_identifier()));
 
+    if (checkpoint) {
+      checkpoint->finish();
+    }
+
     galois::runtime::reportStat_Tmax(
         "SSSP", "NumIterations_" + std::to_string(syncSubstrate->get_run_num()),
         _num_iterations);
@@ -423,6 +450,14 @@ int main(int argc, char** argv) {
     galois::runtime::reportParam("SSSP", "Source Node ID", src_node);
   }
 
+  if (!checkpointDir.empty() &&
+      (execution == Async || personality == GPU_CUDA)) {
+    GALOIS_DIE("checkpointing requires -exec=Sync on CPUs");
+  }
+  if (checkpointInterval == 0) {
+    GALOIS_DIE("checkpointInterval must be positive");
+  }
+
   galois::StatTimer StatTimer_total("TimerTotal", REGION_NAME);
 
   StatTimer_total.start();
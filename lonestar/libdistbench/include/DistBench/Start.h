@@ -45,9 +45,17 @@ extern cll::opt<std::string> statFile;
 extern cll::opt<bool> partitionAgnostic;
 //! Set method for metadata sends
 extern cll::opt<DataCommMode> commMetadata;
+//! Varint-encode integer values in compact sync messages
+extern cll::opt<bool> compressValues;
 //! Where to write output if output is set
 extern cll::opt<std::string> outputLocation;
 extern cll::opt<bool> output;
+//! Directory to save checkpoints in; empty to disable checkpointing
+extern cll::opt<std::string> checkpointDir;
+//! Rounds between checkpoints
+extern cll::opt<unsigned> checkpointInterval;
+//! If set, resume from the last checkpoint in checkpointDir
+extern cll::opt<bool> restart;
 
 #ifdef GALOIS_ENABLE_GPU
 enum Personality { CPU, GPU_CUDA };
@@ -152,8 +160,8 @@ loadDistGraph(std::vector<unsigned>& scaleFactor) {
   dGraphTimer.stop();
 
   // Save local graph structure
-  // if (saveLocalGraph)
-  //  (*loadedGraph).save_local_graph_to_file(localGraphFileName);
+  if (saveLocalGraph)
+    (*loadedGraph).save_local_graph_to_file(localGraphFile());
 
   return loadedGraph;
 }
@@ -194,8 +202,8 @@ loadSymmetricDistGraph(std::vector<unsigned>& scaleFactor) {
   dGraphTimer.stop();
 
   // Save local graph structure
-  // if (saveLocalGraph)
-  //  (*loadedGraph).save_local_graph_to_file(localGraphFileName);
+  if (saveLocalGraph)
+    (*loadedGraph).save_local_graph_to_file(localGraphFile());
 
   return loadedGraph;
 }
@@ -237,7 +245,7 @@ distGraphInitialization() {
   const auto& net = galois::runtime::getSystemNetworkInterface();
   s = std::make_unique<Substrate>(*g, net.ID, net.Num, g->isTransposed(),
                                   g->cartesianGrid(), partitionAgnostic,
-                                  commMetadata);
+                                  commMetadata, compressValues);
 
 // marshal graph to GPU as necessary
 #ifdef GALOIS_ENABLE_GPU
@@ -282,7 +290,7 @@ symmetricDistGraphInitialization() {
   const auto& net = galois::runtime::getSystemNetworkInterface();
   s = std::make_unique<Substrate>(*g, net.ID, net.Num, g->isTransposed(),
                                   g->cartesianGrid(), partitionAgnostic,
-                                  commMetadata);
+                                  commMetadata, compressValues);
 
 // marshal graph to GPU as necessary
 #ifdef GALOIS_ENABLE_GPU
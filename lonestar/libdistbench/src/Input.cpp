@@ -61,20 +61,21 @@ cll::opt<PARTITIONING_SCHEME> partitionScheme(
     cll::init(OEC));
 
 cll::opt<bool> readFromFile("readFromFile",
-                            cll::desc("Set this flag if graph is to be "
-                                      "constructed from file (file must be "
-                                      "created by Abelian CSR)"),
+                            cll::desc("Set this flag to read each host's "
+                                      "partition from the files saved with "
+                                      "-saveLocalGraph instead of "
+                                      "partitioning the input"),
                             cll::init(false), cll::Hidden);
 
 cll::opt<std::string>
     localGraphFileName("localGraphFileName",
-                       cll::desc("Name of the local file to construct "
-                                 "local graph (file must be created by "
-                                 "Abelian CSR)"),
+                       cll::desc("Prefix of the files holding the partition "
+                                 "of each host; the host id is appended"),
                        cll::init("local_graph"), cll::Hidden);
 
 cll::opt<bool> saveLocalGraph("saveLocalGraph",
-                              cll::desc("Set to save the local CSR graph"),
+                              cll::desc("Set to save the partition of each "
+                                        "host after partitioning"),
                               cll::init(false), cll::Hidden);
 
 cll::opt<std::string> mastersFile("mastersFile",
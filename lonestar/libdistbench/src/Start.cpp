@@ -54,6 +54,12 @@ cll::opt<DataCommMode> commMetadata(
                            "non-updated values)")),
     cll::init(noData), cll::Hidden);
 
+cll::opt<bool> compressValues(
+    "compressValues",
+    cll::desc("Varint-encode integer values of sync messages sent with "
+              "compact metadata when that makes them smaller"),
+    cll::init(false), cll::Hidden);
+
 cll::opt<std::string> outputLocation(
     "outputLocation",
     cll::desc("Location (directory) to write results to when output is true"));
@@ -61,6 +67,23 @@ cll::opt<std::string> outputLocation(
 cll::opt<bool> output("output", cll::desc("Write result (default false)"),
                       cll::init(false));
 
+cll::opt<std::string>
+    checkpointDir("checkpointDir",
+                  cll::desc("Directory to save checkpoints of the node data "
+                            "in; checkpointing is off if empty"),
+                  cll::init(""));
+
+cll::opt<unsigned>
+    checkpointInterval("checkpointInterval",
+                       cll::desc("Rounds between checkpoints (default 10)"),
+                       cll::init(10));
+
+cll::opt<bool> restart("restart",
+                       cll::desc("Resume from the last checkpoint in "
+                                 "checkpointDir; use with -readFromFile to "
+                                 "skip repartitioning"),
+                       cll::init(false));
+
 #ifdef GALOIS_ENABLE_GPU
 std::string personality_str(Personality p) {
   switch (p) {
@@ -18,6 +18,7 @@
  */
 
 #include "Lonestar/BoilerPlate.h"
+#include "galois/substrate/HWTopo.h"
 
 #include <sstream>
 
@@ -86,6 +87,19 @@ void LonestarStart(int argc, char** argv, const char* app, const char* desc,
 
   galois::runtime::reportParam("(NULL)", "CommandLine", cmdout.str());
   galois::runtime::reportParam("(NULL)", "Threads", numThreads);
+
+  // Effective topology after affinity, cgroup limits and thread placement
+  auto topo = galois::substrate::getHWTopo();
+  std::ostringstream cpus;
+  for (int i = 0; i < numThreads; ++i) {
+    cpus << (i ? "," : "") << topo.threadTopoInfo[i].osContext;
+  }
+  galois::runtime::reportParam("(NULL)", "MaxThreads",
+                               topo.machineTopoInfo.maxThreads);
+  galois::runtime::reportParam(
+      "(NULL)", "Sockets",
+      topo.threadTopoInfo[numThreads - 1].cumulativeMaxSocket + 1);
+  galois::runtime::reportParam("(NULL)", "CPUs", cpus.str());
   galois::runtime::reportParam("(NULL)", "Hosts", 1);
   if (input) {
     galois::runtime::reportParam("(NULL)", "Input", input->getValue());
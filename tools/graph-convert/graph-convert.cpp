@@ -20,6 +20,7 @@
 #include "galois/Galois.h"
 #include "galois/LargeArray.h"
 #include "galois/graphs/FileGraph.h"
+#include "galois/graphs/LCGraph.h"
 
 #include <llvm/Support/CommandLine.h>
 
@@ -29,12 +30,19 @@
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <optional>
+#include <cctype>
 #include <cstdint>
+#include <cstring>
+#include <sstream>
 #include <vector>
 #include <random>
 #include <string>
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <cstdlib>
 
 // TODO: move these enums to a common location for all graph convert tools
@@ -77,6 +85,7 @@ enum ConvertMode {
   gr2treegr,
   gr2trigr,
   gr2totem,
+  gr2vgr,
   gr2neo4j,
   mtx2gr,
   nodelist2gr,
@@ -175,6 +184,7 @@ static cll::opt<ConvertMode> convertMode(
         clEnumVal(gr2trigr, "Convert symmetric binary gr to triangular form by "
                             "removing reverse edges"),
         clEnumVal(gr2totem, "Convert binary gr totem input format"),
+        clEnumVal(gr2vgr, "Convert binary gr to varint gap-compressed vgr"),
         clEnumVal(gr2neo4j, "Convert binary gr to a vertex/edge csv for neo4j"),
         clEnumVal(mtx2gr, "Convert matrix market format to binary gr"),
         clEnumVal(nodelist2gr, "Convert node list to binary gr"),
@@ -200,6 +210,9 @@ static cll::opt<int>
              cll::init(1));
 static cll::opt<int> maxDegree("maxDegree", cll::desc("maximum degree to keep"),
                                cll::init(2 * 1024));
+static cll::opt<unsigned> numThreads(
+    "t", cll::desc("Number of threads for parsing text formats (default: 1)"),
+    cll::init(1));
 
 struct Conversion {};
 struct HasOnlyVoidSpecialization {};
@@ -338,192 +351,377 @@ void skipLine(std::ifstream& infile) {
 }
 
 /**
- * Common parsing for edgelist style text files.
- *
- * src dst [weight]
- * ...
- *
- * If delim is set, this function expects that each entry is separated by delim
- * surrounded by optional whitespace.
+ * Read-only memory map of a text file.
  */
-template <typename EdgeTy>
-void convertEdgelist(const std::string& infilename,
-                     const std::string& outfilename, const bool skipFirstLine,
-                     std::optional<char> delim) {
-  typedef galois::graphs::FileGraphWriter Writer;
+class MappedText {
+  int fd;
+  char* base;
+  size_t length;
+
+public:
+  explicit MappedText(const std::string& filename) : base(nullptr), length(0) {
+    fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+      GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+    struct stat buf;
+    if (fstat(fd, &buf) == -1)
+      GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+    length = buf.st_size;
+    if (length) {
+      void* m = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (m == MAP_FAILED)
+        GALOIS_SYS_DIE("failed mapping ", "'", filename, "'");
+      base = static_cast<char*>(m);
+      madvise(base, length, MADV_SEQUENTIAL);
+    }
+  }
 
-  Writer p;
-  std::ifstream infile(infilename.c_str());
+  ~MappedText() {
+    if (base)
+      munmap(base, length);
+    close(fd);
+  }
 
-  size_t numNodes   = 0;
-  size_t numEdges   = 0;
-  size_t lineNumber = 0;
+  MappedText(const MappedText&) = delete;
+  MappedText& operator=(const MappedText&) = delete;
 
-  if (skipFirstLine) {
-    galois::gWarn(
-        "first line is assumed to contain labels and will be ignored\n");
-    skipLine(infile);
-    ++lineNumber;
-  }
+  const char* begin() const { return base; }
+  const char* end() const { return base + length; }
+};
 
-  const bool hasDelim = static_cast<bool>(delim);
-  std::optional<size_t> skippedLine;
-  std::string line;
-  char readDelim;
+//! Returns the position after the line starting at p
+inline const char* nextLine(const char* p, const char* end) {
+  const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+  return nl ? nl + 1 : end;
+}
 
-  for (; std::getline(infile, line); ++lineNumber) {
-    std::stringstream iss(line);
+inline const char* skipSpace(const char* p, const char* end) {
+  while (p != end && (*p == ' ' || *p == '\t' || *p == '\r'))
+    ++p;
+  return p;
+}
 
-    size_t src;
-    if (!(iss >> src)) {
-      skippedLine = lineNumber;
-      continue;
+/**
+ * Parses the unsigned integer at p. Eight digits at a time are converted with
+ * a few word operations instead of one multiply per digit.
+ *
+ * @returns the position after the integer, or nullptr if p does not start
+ * with a digit or the integer does not fit in 64 bits; in the latter case,
+ * val is set to UINT64_MAX
+ */
+inline const char* parseUint(const char* p, const char* end, uint64_t& val) {
+  if (p == end || static_cast<unsigned>(*p - '0') > 9)
+    return nullptr;
+
+  const char* start = p;
+  uint64_t x        = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (end - p >= 8) {
+    uint64_t chunk;
+    std::memcpy(&chunk, p, sizeof(chunk));
+    if ((chunk & 0xF0F0F0F0F0F0F0F0) != 0x3030303030303030 ||
+        ((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) !=
+            0x3030303030303030)
+      break;
+    chunk -= 0x3030303030303030;
+    chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FF;
+    chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFF;
+    chunk = (chunk * 10000 + (chunk >> 32)) & 0x00000000FFFFFFFF;
+    x     = x * 100000000 + chunk;
+    p += 8;
+  }
+#endif
+  while (p != end && static_cast<unsigned>(*p - '0') <= 9)
+    x = x * 10 + (*p++ - '0');
+
+  // x wrapped around if there are more digits than in UINT64_MAX, ignoring
+  // leading zeros, or as many but they compare larger
+  if (p - start >= 20) {
+    while (start != p && *start == '0')
+      ++start;
+    if (p - start > 20 ||
+        (p - start == 20 &&
+         std::memcmp(start, "18446744073709551615", 20) > 0)) {
+      val = std::numeric_limits<uint64_t>::max();
+      return nullptr;
     }
+  }
+  val = x;
+  return p;
+}
 
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        skippedLine = lineNumber;
-        continue;
-      }
-    }
+/**
+ * Parses the number at p as T.
+ *
+ * @returns the position after the number, or nullptr if there is none
+ */
+template <typename T>
+const char* parseValue(const char* p, const char* end, T& val) {
+  if constexpr (std::is_integral<T>::value) {
+    bool negative = p != end && *p == '-';
+    if (p != end && (*p == '-' || *p == '+'))
+      ++p;
+    uint64_t x;
+    p   = parseUint(p, end, x);
+    val = negative ? static_cast<T>(-static_cast<int64_t>(x))
+                   : static_cast<T>(x);
+    return p;
+  } else {
+    char buf[64];
+    size_t n = 0;
+    while (p + n != end && n + 1 < sizeof(buf) &&
+           std::strchr("0123456789+-.eEinfatyINFATY", p[n]))
+      ++n;
+    if (n == 0)
+      return nullptr;
+    std::memcpy(buf, p, n);
+    buf[n] = '\0';
+    char* last;
+    double d = std::strtod(buf, &last);
+    if (last == buf)
+      return nullptr;
+    val = static_cast<T>(d);
+    return p + (last - buf);
+  }
+}
 
-    size_t dst;
-    if (!(iss >> dst)) {
-      skippedLine = lineNumber;
-      continue;
-    }
+//! Data of a parsed edge; int for graphs without edge data
+template <typename EdgeTy>
+using EdgeValue =
+    typename std::conditional<std::is_void<EdgeTy>::value, int, EdgeTy>::type;
+
+//! Result of parsing a line of a text graph
+enum class LineKind { Edge, Ignored, Malformed, Overflow };
+
+//! Kind of a line on which parsing src or dst failed
+inline LineKind failedLine(uint64_t src, uint64_t dst) {
+  return src == std::numeric_limits<uint64_t>::max() ||
+                 dst == std::numeric_limits<uint64_t>::max()
+             ? LineKind::Overflow
+             : LineKind::Malformed;
+}
 
-    if constexpr (!std::is_void<EdgeTy>::value) {
-      EdgeTy data{};
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          skippedLine = lineNumber;
-          continue;
-        }
-      }
+//! Orders edges by destination and then by data
+template <typename GraphNode, typename EdgeTy>
+struct DstThenDataLess {
+  bool
+  operator()(const galois::graphs::EdgeSortValue<GraphNode, EdgeTy>& e1,
+             const galois::graphs::EdgeSortValue<GraphNode, EdgeTy>& e2) const {
+    if (e1.dst != e2.dst)
+      return e1.dst < e2.dst;
+    if constexpr (!std::is_void<EdgeTy>::value)
+      return e1.get() < e2.get();
+    return false;
+  }
+};
 
-      if (!(iss >> data)) {
-        skippedLine = lineNumber;
-        continue;
-      }
-    }
+/**
+ * Converts the edges in [begin, end) of a memory mapped text file to a binary
+ * graph in parallel.
+ *
+ * The text is split into chunks on line boundaries. The chunks are parsed
+ * three times: to count edges and find the largest node id, to count
+ * degrees, and to place edges directly into the output graph. Since edges are
+ * placed concurrently, the edges of each node are sorted by destination (and
+ * then data) at the end, which makes the output independent of the number of
+ * threads.
+ *
+ * @param parse parses the line [p, e) into src, dst and data; returns the
+ * kind of line
+ * @param numNodes number of nodes, or 0 to use the largest node id plus one
+ * @param numEdges expected number of edges, or 0 to accept any
+ * @param firstLine line number of begin, used in messages
+ */
+template <typename EdgeTy, typename ParseFn>
+void convertText(const char* begin, const char* end,
+                 const std::string& outfilename, const ParseFn& parse,
+                 size_t numNodes, size_t numEdges, size_t firstLine) {
+  typedef galois::graphs::FileGraphWriter Writer;
+  typedef Writer::GraphNode GNode;
+
+  struct Chunk {
+    const char* begin;
+    const char* end;
+    size_t lines          = 0;
+    size_t edges          = 0;
+    uint64_t maxId        = 0;
+    size_t firstMalformed = std::numeric_limits<size_t>::max();
+    size_t firstOverflow  = std::numeric_limits<size_t>::max();
+  };
 
-    if (infile) {
-      ++numEdges;
-      if (src > numNodes)
-        numNodes = src;
-      if (dst > numNodes)
-        numNodes = dst;
+  // Aim for a few chunks per thread and at most 64MB per chunk
+  size_t bytes   = end - begin;
+  size_t nchunks = std::max<size_t>(
+      {1, 8 * galois::getActiveThreads(), bytes / (64 << 20)});
+  nchunks = std::min(nchunks, std::max<size_t>(1, bytes / 4096));
+  std::vector<Chunk> chunks(nchunks);
+  // chunks start after the line break nearest to an even split
+  for (size_t i = 0; i < nchunks; ++i)
+    chunks[i].begin = i ? nextLine(begin + bytes * i / nchunks - 1, end) : begin;
+  for (size_t i = 0; i < nchunks; ++i)
+    chunks[i].end = i + 1 < nchunks ? chunks[i + 1].begin : end;
+
+  auto forEachLine = [&](Chunk& c, auto fn) {
+    for (const char* p = c.begin; p != c.end;) {
+      const char* next = nextLine(p, c.end);
+      const char* e    = next;
+      if (e != p && e[-1] == '\n')
+        --e;
+      uint64_t src = 0, dst = 0;
+      EdgeValue<EdgeTy> data{};
+      LineKind kind = parse(p, e, src, dst, data);
+      fn(kind, src, dst, data);
+      p = next;
     }
+  };
+
+  galois::do_all(
+      galois::iterate(chunks),
+      [&](Chunk& c) {
+        forEachLine(c, [&](LineKind kind, uint64_t src, uint64_t dst,
+                           const EdgeValue<EdgeTy>&) {
+          if (kind == LineKind::Edge) {
+            c.edges += 1;
+            c.maxId = std::max({c.maxId, src, dst});
+          } else if (kind == LineKind::Malformed &&
+                     c.firstMalformed == std::numeric_limits<size_t>::max()) {
+            c.firstMalformed = c.lines;
+          } else if (kind == LineKind::Overflow &&
+                     c.firstOverflow == std::numeric_limits<size_t>::max()) {
+            c.firstOverflow = c.lines;
+          }
+          c.lines += 1;
+        });
+      },
+      galois::steal(), galois::no_stats());
+
+  size_t edges = 0;
+  size_t lines = firstLine;
+  uint64_t maxId = 0;
+  std::optional<size_t> malformed;
+  std::optional<size_t> overflow;
+  for (auto& c : chunks) {
+    if (!malformed && c.firstMalformed != std::numeric_limits<size_t>::max())
+      malformed = lines + c.firstMalformed;
+    if (!overflow && c.firstOverflow != std::numeric_limits<size_t>::max())
+      overflow = lines + c.firstOverflow;
+    edges += c.edges;
+    lines += c.lines;
+    maxId = std::max(maxId, c.maxId);
   }
 
-  if (skippedLine) {
-    galois::gWarn("ignored at least one line (line ", *skippedLine,
+  if (overflow) {
+    GALOIS_DIE("node id on line ", *overflow, " does not fit in 64 bits");
+  }
+  if (malformed) {
+    galois::gWarn("ignored at least one line (line ", *malformed,
                   ") because it did not match the expected format\n");
   }
+  if (numEdges && edges != numEdges) {
+    GALOIS_DIE("expected ", numEdges, " edges but found ", edges);
+  }
+  if (!numNodes) {
+    numNodes = maxId + 1;
+  } else if (edges && maxId >= numNodes) {
+    GALOIS_DIE("node id out of range: ", maxId);
+  }
 
-  numNodes++;
+  Writer p;
   p.setNumNodes(numNodes);
-  p.setNumEdges<EdgeTy>(numEdges);
-
-  infile.clear();
-  infile.seekg(0, std::ios::beg);
+  p.setNumEdges<EdgeTy>(edges);
   p.phase1();
 
-  if (skipFirstLine) {
-    skipLine(infile);
-  }
+  galois::do_all(
+      galois::iterate(chunks),
+      [&](Chunk& c) {
+        forEachLine(c, [&](LineKind kind, uint64_t src, uint64_t,
+                           const EdgeValue<EdgeTy>&) {
+          if (kind == LineKind::Edge)
+            p.incrementDegreeAtomic(src);
+        });
+      },
+      galois::steal(), galois::no_stats());
 
-  while (std::getline(infile, line)) {
-    std::stringstream iss(line);
-
-    size_t src;
-    if (!(iss >> src)) {
-      continue;
-    }
-
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        continue;
-      }
-    }
+  p.phase2();
 
-    size_t dst;
-    if (!(iss >> dst)) {
-      continue;
-    }
+  galois::do_all(
+      galois::iterate(chunks),
+      [&](Chunk& c) {
+        forEachLine(c, [&](LineKind kind, uint64_t src, uint64_t dst,
+                           const EdgeValue<EdgeTy>& data) {
+          if (kind != LineKind::Edge)
+            return;
+          if constexpr (std::is_void<EdgeTy>::value) {
+            p.addNeighborAtomic(src, dst);
+          } else {
+            p.addNeighborAtomic<EdgeTy>(src, dst, data);
+          }
+        });
+      },
+      galois::steal(), galois::no_stats());
 
-    if constexpr (!std::is_void<EdgeTy>::value) {
-      EdgeTy data{};
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          continue;
-        }
-      }
+  p.finish();
 
-      if (!(iss >> data)) {
-        continue;
-      }
-    }
+  galois::do_all(
+      galois::iterate(p),
+      [&](GNode n) { p.sortEdges<EdgeTy>(n, DstThenDataLess<GNode, EdgeTy>()); },
+      galois::steal(), galois::no_stats());
 
-    if (infile) {
-      p.incrementDegree(src);
-    }
-  }
+  p.toFile(outfilename);
+  printStatus(numNodes, edges);
+}
 
-  infile.clear();
-  infile.seekg(0, std::ios::beg);
-  p.phase2();
+/**
+ * Common parsing for edgelist style text files.
+ *
+ * src dst [weight]
+ * ...
+ *
+ * If delim is set, this function expects that each entry is separated by delim
+ * surrounded by optional whitespace. Lines that do not match are ignored.
+ */
+template <typename EdgeTy>
+void convertEdgelist(const std::string& infilename,
+                     const std::string& outfilename, const bool skipFirstLine,
+                     std::optional<char> delim) {
+  MappedText text(infilename);
+  const char* begin = text.begin();
 
   if (skipFirstLine) {
-    skipLine(infile);
+    galois::gWarn(
+        "first line is assumed to contain labels and will be ignored\n");
+    begin = nextLine(begin, text.end());
   }
 
-  while (std::getline(infile, line)) {
-    std::stringstream iss(line);
-
-    size_t src;
-    if (!(iss >> src)) {
-      continue;
-    }
-
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        continue;
-      }
-    }
-
-    size_t dst;
-    if (!(iss >> dst)) {
-      continue;
+  // Skips whitespace and, if set, the delimiter; returns nullptr if missing
+  auto separator = [&](const char* p, const char* e) -> const char* {
+    const char* q = skipSpace(p, e);
+    if (delim) {
+      if (q == e || *q != *delim)
+        return nullptr;
+      return skipSpace(q + 1, e);
     }
+    return q == p ? nullptr : q;
+  };
 
+  auto parse = [&](const char* p, const char* e, uint64_t& src, uint64_t& dst,
+                   EdgeValue<EdgeTy>& data) {
+    p = parseUint(skipSpace(p, e), e, src);
+    if (p)
+      p = separator(p, e);
+    if (p)
+      p = parseUint(p, e, dst);
     if constexpr (!std::is_void<EdgeTy>::value) {
-      EdgeTy data{};
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          continue;
-        }
-      }
-
-      if (!(iss >> data)) {
-        continue;
-      }
-
-      if (infile) {
-        p.addNeighbor<EdgeTy>(src, dst, data);
-      }
-    } else {
-      if (infile) {
-        p.addNeighbor(src, dst);
-      }
+      if (p)
+        p = separator(p, e);
+      if (p)
+        p = parseValue(p, e, data);
     }
-  }
-
-  p.finish();
+    return p ? LineKind::Edge : failedLine(src, dst);
+  };
 
-  p.toFile(outfilename);
-  printStatus(numNodes, numEdges);
+  convertText<EdgeTy>(begin, text.end(), outfilename, parse, 0, 0,
+                      skipFirstLine ? 1 : 0);
 }
 
 template <typename EdgeTy>
@@ -533,6 +731,16 @@ void convertEdgelist(const std::string& infilename,
                           std::optional<char>());
 }
 
+//! Splits a line into whitespace separated tokens
+std::vector<std::string> tokenize(const char* p, const char* e) {
+  std::istringstream line(std::string(p, e));
+  std::vector<std::string> tokens;
+  std::string tmp;
+  while (line >> tmp)
+    tokens.push_back(tmp);
+  return tokens;
+}
+
 /**
  * Assumption: First line has labels
  * Just a bunch of pairs or triples:
@@ -635,98 +843,57 @@ struct Edgelist2Binary : public Conversion {
 struct Mtx2Gr : public HasNoVoidSpecialization {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    typedef galois::graphs::FileGraphWriter Writer;
-
-    Writer p;
-    uint32_t nnodes;
-    size_t nedges;
-
-    for (int phase = 0; phase < 2; ++phase) {
-      std::ifstream infile(infilename.c_str());
-      if (!infile) {
-        GALOIS_DIE("failed to open input file");
-      }
-
-      // Skip comments
-      while (infile) {
-        if (infile.peek() != '%') {
-          break;
-        }
-        skipLine(infile);
-      }
-
-      // Read header
-      char header[256];
-      infile.getline(header, 256);
-      std::istringstream line(header, std::istringstream::in);
-      std::vector<std::string> tokens;
-      while (line) {
-        std::string tmp;
-        line >> tmp;
-        if (line) {
-          tokens.push_back(tmp);
-        }
-      }
-      if (tokens.size() != 3) {
-        GALOIS_DIE("unknown problem specification line: ", line.str());
-      }
-      // Prefer C functions for maximum compatibility
-      // nnodes = std::stoull(tokens[0]);
-      // nedges = std::stoull(tokens[2]);
-      nnodes = strtoull(tokens[0].c_str(), NULL, 0);
-      nedges = strtoull(tokens[2].c_str(), NULL, 0);
-
-      // Parse edges
-      if (phase == 0) {
-        p.setNumNodes(nnodes);
-        p.setNumEdges<EdgeTy>(nedges);
-        p.phase1();
-      } else {
-        p.phase2();
-      }
-
-      for (size_t edge_num = 0; edge_num < nedges; ++edge_num) {
-        if ((edge_num % (nedges / 500)) == 0) {
-          printf("Phase %d: current edge progress %lf%%\n", phase,
-                 ((double)edge_num / nedges) * 100);
-        }
-        uint32_t cur_id, neighbor_id;
-        double weight = 1;
-
-        infile >> cur_id >> neighbor_id >> weight;
-        if (cur_id == 0 || cur_id > nnodes) {
-          GALOIS_DIE("node id out of range: ", cur_id);
-        }
-        if (neighbor_id == 0 || neighbor_id > nnodes) {
-          GALOIS_DIE("neighbor id out of range: ", neighbor_id);
-        }
-
-        // 1 indexed
-        if (phase == 0) {
-          p.incrementDegree(cur_id - 1);
-        } else {
-          if constexpr (std::is_void<EdgeTy>::value) {
-            p.addNeighbor(cur_id - 1, neighbor_id - 1);
-          } else {
-            p.addNeighbor<EdgeTy>(cur_id - 1, neighbor_id - 1,
-                                  static_cast<EdgeTy>(weight));
-          }
-        }
-
-        skipLine(infile);
-      }
-
-      infile.peek();
-      if (!infile.eof()) {
-        GALOIS_DIE("additional lines in file");
-      }
-    }
-    // this is for the progress print
-
-    p.finish();
+    MappedText text(infilename);
+    const char* begin = text.begin();
+    size_t lines      = 0;
+
+    // Skip comments
+    while (begin != text.end() && *begin == '%') {
+      begin = nextLine(begin, text.end());
+      ++lines;
+    }
+
+    // Read header
+    const char* headerEnd = nextLine(begin, text.end());
+    std::vector<std::string> tokens = tokenize(begin, headerEnd);
+    if (tokens.size() != 3) {
+      GALOIS_DIE("unknown problem specification line: ",
+                 std::string(begin, headerEnd));
+    }
+    // Prefer C functions for maximum compatibility
+    uint64_t nnodes = strtoull(tokens[0].c_str(), NULL, 0);
+    uint64_t nedges = strtoull(tokens[2].c_str(), NULL, 0);
+
+    // src and dst are 1 indexed; the weight is optional
+    auto parse = [&](const char* p, const char* e, uint64_t& src,
+                     uint64_t& dst, EdgeValue<EdgeTy>& data) {
+      const char* q = skipSpace(p, e);
+      if (q == e)
+        return LineKind::Ignored;
+      q = parseUint(q, e, src);
+      if (q)
+        q = parseUint(skipSpace(q, e), e, dst);
+      if (!q && failedLine(src, dst) == LineKind::Overflow)
+        return LineKind::Overflow;
+      if (!q)
+        GALOIS_DIE("malformed edge: ", std::string(p, e));
+      if (src == 0 || src > nnodes)
+        GALOIS_DIE("node id out of range: ", src);
+      if (dst == 0 || dst > nnodes)
+        GALOIS_DIE("neighbor id out of range: ", dst);
+      src -= 1;
+      dst -= 1;
+
+      double weight = 1;
+      q             = skipSpace(q, e);
+      if (q != e && !parseValue(q, e, weight))
+        GALOIS_DIE("malformed edge: ", std::string(p, e));
+      data = static_cast<EdgeValue<EdgeTy>>(weight);
+      return LineKind::Edge;
+    };
 
-    p.toFile(outfilename);
-    printStatus(p.size(), p.sizeEdges());
+    convertText<EdgeTy>(headerEnd, text.end(), outfilename, parse, nnodes,
+                        nedges, lines + 1);
   }
 };
 
@@ -1877,6 +2044,25 @@ struct Transpose : public Conversion {
   }
 };
 
+/**
+ * Compresses the adjacency lists of a graph; see LC_Compressed_Graph for
+ * the file layout.
+ */
+struct Gr2Vgr : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    typedef galois::graphs::LC_Compressed_Graph<void, EdgeTy> Graph;
+
+    Graph graph;
+    galois::graphs::readGraph(graph, infilename);
+    graph.writeToVGRFile(outfilename);
+
+    printStatus(graph.size(), graph.sizeEdges());
+    std::cout << "Adjacency bytes: " << graph.sizeEdgeBytes() << " (vs "
+              << graph.sizeEdges() * sizeof(uint32_t) << " uncompressed)\n";
+  }
+};
+
 template <typename GraphNode, typename EdgeTy>
 struct IdLess {
   bool
@@ -2109,98 +2295,55 @@ struct MakeUnsymmetric : public Conversion {
 struct Dimacs2Gr : public HasNoVoidSpecialization {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    typedef galois::graphs::FileGraphWriter Writer;
-
-    Writer p;
-    uint32_t nnodes;
-    size_t nedges;
-
-    for (int phase = 0; phase < 2; ++phase) {
-      std::ifstream infile(infilename.c_str());
-
-      // Skip comments
-      while (infile) {
-        if (infile.peek() == 'p') {
-          break;
-        }
-        skipLine(infile);
-      }
-
-      // Read header
-      char header[256];
-      infile.getline(header, 256);
-      std::istringstream line(header, std::istringstream::in);
-      std::vector<std::string> tokens;
-      while (line) {
-        std::string tmp;
-        line >> tmp;
-        if (line) {
-          tokens.push_back(tmp);
-        }
-      }
-      if (tokens.size() < 3 || tokens[0].compare("p") != 0) {
-        GALOIS_DIE("unknown problem specification line: ", line.str());
-      }
-      // Prefer C functions for maximum compatibility
-      // nnodes = std::stoull(tokens[tokens.size() - 2]);
-      // nedges = std::stoull(tokens[tokens.size() - 1]);
-      nnodes = strtoull(tokens[tokens.size() - 2].c_str(), NULL, 0);
-      nedges = strtoull(tokens[tokens.size() - 1].c_str(), NULL, 0);
-
-      // Parse edges
-      if (phase == 0) {
-        p.setNumNodes(nnodes);
-        p.setNumEdges<EdgeTy>(nedges);
-        p.phase1();
-      } else {
-        p.phase2();
-      }
-
-      for (size_t edge_num = 0; edge_num < nedges; ++edge_num) {
-        uint32_t cur_id;
-        uint32_t neighbor_id;
-        int32_t weight;
-        std::string tmp;
-        infile >> tmp;
-
-        if (tmp.compare("a") != 0) {
-          --edge_num;
-          skipLine(infile);
-          continue;
-        }
-
-        infile >> cur_id >> neighbor_id >> weight;
-        if (cur_id == 0 || cur_id > nnodes) {
-          GALOIS_DIE("node id out of range: ", cur_id);
-        }
-        if (neighbor_id == 0 || neighbor_id > nnodes) {
-          GALOIS_DIE("neighbor id out of range: ", neighbor_id);
-        }
-
-        // 1 indexed
-        if (phase == 0) {
-          p.incrementDegree(cur_id - 1);
-        } else {
-          if constexpr (std::is_void<EdgeTy>::value) {
-            p.addNeighbor(cur_id - 1, neighbor_id - 1);
-          } else {
-            p.addNeighbor<EdgeTy>(cur_id - 1, neighbor_id - 1, weight);
-          }
-        }
-
-        skipLine(infile);
-      }
-
-      infile.peek();
-      if (!infile.eof()) {
-        GALOIS_DIE("additional lines in file");
-      }
-    }
-
-    p.finish();
+    MappedText text(infilename);
+    const char* begin = text.begin();
+    size_t lines      = 0;
+
+    // Skip comments
+    while (begin != text.end() && *begin != 'p') {
+      begin = nextLine(begin, text.end());
+      ++lines;
+    }
+
+    // Read header
+    const char* headerEnd = nextLine(begin, text.end());
+    std::vector<std::string> tokens = tokenize(begin, headerEnd);
+    if (tokens.size() < 3 || tokens[0].compare("p") != 0) {
+      GALOIS_DIE("unknown problem specification line: ",
+                 std::string(begin, headerEnd));
+    }
+    // Prefer C functions for maximum compatibility
+    uint64_t nnodes = strtoull(tokens[tokens.size() - 2].c_str(), NULL, 0);
+    uint64_t nedges = strtoull(tokens[tokens.size() - 1].c_str(), NULL, 0);
+
+    // only arc lines hold edges; src and dst are 1 indexed
+    auto parse = [&](const char* p, const char* e, uint64_t& src,
+                     uint64_t& dst, EdgeValue<EdgeTy>& data) {
+      const char* q = skipSpace(p, e);
+      if (q == e || *q != 'a' || (q + 1 != e && !std::isspace(q[1])))
+        return LineKind::Ignored;
+      int32_t weight;
+      q = parseUint(skipSpace(q + 1, e), e, src);
+      if (q)
+        q = parseUint(skipSpace(q, e), e, dst);
+      if (!q && failedLine(src, dst) == LineKind::Overflow)
+        return LineKind::Overflow;
+      if (q)
+        q = parseValue(skipSpace(q, e), e, weight);
+      if (!q)
+        GALOIS_DIE("malformed edge: ", std::string(p, e));
+      if (src == 0 || src > nnodes)
+        GALOIS_DIE("node id out of range: ", src);
+      if (dst == 0 || dst > nnodes)
+        GALOIS_DIE("neighbor id out of range: ", dst);
+      src -= 1;
+      dst -= 1;
+      data = static_cast<EdgeValue<EdgeTy>>(weight);
+      return LineKind::Edge;
+    };
 
-    p.toFile(outfilename);
-    printStatus(p.size(), p.sizeEdges());
+    convertText<EdgeTy>(headerEnd, text.end(), outfilename, parse, nnodes,
+                        nedges, lines + 1);
   }
 };
 
@@ -2890,6 +3033,7 @@ int main(int argc, char** argv) {
   galois::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
   std::ios_base::sync_with_stdio(false);
+  galois::setActiveThreads(numThreads);
   switch (convertMode) {
   case bipartitegr2bigpetsc:
     convert<Bipartitegr2Petsc<double, false>>();
@@ -3005,6 +3149,9 @@ int main(int argc, char** argv) {
   case gr2totem:
     convert<Gr2Totem<IdLess>>();
     break;
+  case gr2vgr:
+    convert<Gr2Vgr>();
+    break;
   case gr2neo4j:
     convert<Gr2Neo4j>();
     break;
@@ -23,6 +23,7 @@
 
 #include "llvm/Support/CommandLine.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <vector>
@@ -62,6 +63,36 @@ static cll::opt<int> columns("columns", cll::desc("Columns for sparsity"),
 typedef galois::graphs::OfflineGraph Graph;
 typedef Graph::GraphNode GNode;
 
+//! Number of nodes or edges read at a time by the scans below
+static const uint64_t chunkSize = 1 << 20;
+
+//! Calls fn(n, degree of n) for every node, reading the prefix sum in bulk
+template <typename Fn>
+void forEachDegree(Graph& graph, Fn fn) {
+  std::vector<uint64_t> index(chunkSize);
+  uint64_t prev = 0;
+  for (uint64_t begin = 0; begin < graph.size(); begin += chunkSize) {
+    uint64_t end = std::min<uint64_t>(begin + chunkSize, graph.size());
+    graph.readIndexRange(begin, end, index.data());
+    for (uint64_t n = begin; n < end; ++n) {
+      fn(n, index[n - begin] - prev);
+      prev = index[n - begin];
+    }
+  }
+}
+
+//! Calls fn(dst) for every edge, reading the destinations in bulk
+template <typename Fn>
+void forEachEdgeDst(Graph& graph, Fn fn) {
+  std::vector<uint64_t> dsts(chunkSize);
+  for (uint64_t begin = 0; begin < graph.sizeEdges(); begin += chunkSize) {
+    uint64_t end = std::min<uint64_t>(begin + chunkSize, graph.sizeEdges());
+    graph.readEdgeRange(begin, end, dsts.data());
+    for (uint64_t i = 0; i < end - begin; ++i)
+      fn(dsts[i]);
+  }
+}
+
 void doSummary(Graph& graph) {
   std::cout << "NumNodes: " << graph.size() << "\n";
   std::cout << "NumEdges: " << graph.sizeEdges() << "\n";
@@ -69,23 +100,19 @@ void doSummary(Graph& graph) {
 }
 
 void doDegrees(Graph& graph) {
-  for (auto n : graph) {
-    std::cout << std::distance(graph.edge_begin(n), graph.edge_end(n)) << "\n";
-  }
+  forEachDegree(graph,
+                [](uint64_t, uint64_t degree) { std::cout << degree << "\n"; });
 }
 
 void findMaxDegreeNode(Graph& graph) {
-  uint64_t nodeId        = 0;
   size_t MaxDegree       = 0;
   uint64_t MaxDegreeNode = 0;
-  for (auto n : graph) {
-    size_t degree = std::distance(graph.edge_begin(n), graph.edge_end(n));
+  forEachDegree(graph, [&](uint64_t n, uint64_t degree) {
     if (MaxDegree < degree) {
       MaxDegree     = degree;
-      MaxDegreeNode = nodeId;
+      MaxDegreeNode = n;
     }
-    ++nodeId;
-  }
+  });
   std::cout << "MaxDegreeNode : " << MaxDegreeNode
             << " , MaxDegree : " << MaxDegree << "\n";
 }
@@ -141,20 +168,14 @@ void doSparsityPattern(Graph& graph,
 
 void doDegreeHistogram(Graph& graph) {
   std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    ++hist[std::distance(graph.edge_begin(ii), graph.edge_end(ii))];
-  }
+  forEachDegree(graph, [&](uint64_t, uint64_t degree) { ++hist[degree]; });
   printHistogram("Degree", hist);
 }
 
 void doInDegreeHistogram(Graph& graph) {
   std::vector<uint64_t> inv(graph.size());
   std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++inv[graph.getEdgeDst(jj)];
-    }
-  }
+  forEachEdgeDst(graph, [&](uint64_t dst) { ++inv[dst]; });
   for (uint64_t n : inv) {
     ++hist[n];
   }
@@ -231,11 +252,7 @@ void doSortedLogOffsetHistogram(Graph& GALOIS_UNUSED(graph)) {
 
 void doDestinationHistogram(Graph& graph) {
   std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++hist[graph.getEdgeDst(jj)];
-    }
-  }
+  forEachEdgeDst(graph, [&](uint64_t dst) { ++hist[dst]; });
   printHistogram("DestinationBin", hist);
 }
 